@@ -26,6 +26,8 @@ std::vector<double> taillat_vec;
 std::vector<double> lock_durations;
 std::vector<uint64_t> total_try_times;
 std::vector<uint64_t> total_commit_times;
+PageAddrCacheStat page_addr_cache_stat{};
+IndexCacheStat index_cache_stat{};
 
 void Handler::ConfigureComputeNode(int argc, char* argv[]) {
   std::string config_file = "../../../config/compute_node_config.json";
@@ -77,9 +79,11 @@ void Handler::GenThreads(std::string bench_name) {
   auto* global_vcache = new VersionCache();
   auto* global_lcache = new LockCache();
 
-  // hcy add node local free list
-  auto* global_node_free_list = new std::list<PageAddress>();
-  auto* global_node_free_list_mutex = new std::mutex();
+  // 计算节点上所有线程共享一个到存储层的客户端
+  auto* global_storage_client = new StorageClient();
+  // 计算节点上所有线程共享页地址缓存和索引缓存
+  auto* global_page_addr_cache = new PageAddrCache();
+  auto* global_index_cache = new IndexCache();
 
   RDMA_LOG(INFO) << "Alloc local memory: " << (size_t)(thread_num_per_machine * PER_THREAD_ALLOC_SIZE) / (1024 * 1024) << " MB. Waiting...";
   auto* global_rdma_region = new RDMARegionAllocator(global_meta_man->GetGlobalRdmaCtrl(), global_meta_man->GetOpenedRnic(), thread_num_per_machine);
@@ -117,8 +121,9 @@ void Handler::GenThreads(std::string bench_name) {
     param_arr[i].global_rdma_region = global_rdma_region;
     param_arr[i].thread_num_per_machine = thread_num_per_machine;
     param_arr[i].total_thread_num = thread_num_per_machine * machine_num;
-    param_arr[i].free_list = global_node_free_list;
-    param_arr[i].free_page_list_mutex = global_node_free_list_mutex;
+    param_arr[i].storage_client = global_storage_client;
+    param_arr[i].page_addr_cache = global_page_addr_cache;
+    param_arr[i].index_cache = global_index_cache;
     thread_arr[i] = std::thread(run_thread,
                                 &param_arr[i],
                                 tatp_client,
@@ -142,12 +147,17 @@ void Handler::GenThreads(std::string bench_name) {
   }
 
   RDMA_LOG(INFO) << "DONE";
+  page_addr_cache_stat = global_page_addr_cache->GetStat();
+  index_cache_stat = global_index_cache->GetStat();
 
   delete[] param_arr;
   delete global_rdma_region;
   delete global_meta_man;
   delete global_vcache;
   delete global_lcache;
+  delete global_storage_client;
+  delete global_page_addr_cache;
+  delete global_index_cache;
   if (tatp_client) delete tatp_client;
   if (smallbank_client) delete smallbank_client;
   if (tpcc_client) delete tpcc_client;
@@ -219,6 +229,31 @@ void Handler::OutputResult(std::string bench_name, std::string system_name) {
 
   std::cerr << system_name << " " << total_attemp_tp / 1000 << " " << total_tp / 1000 << " " << avg_median << " " << avg_tail << std::endl;
 
+  // 页地址缓存的统计
+  std::string page_addr_cache_file = "../../../bench_results/" + bench_name + "/page_addr_cache.txt";
+  of.open(page_addr_cache_file.c_str(), std::ios::app);
+  uint64_t page_addr_lookup_num = page_addr_cache_stat.hit_num + page_addr_cache_stat.miss_num;
+  double page_addr_hit_rate = page_addr_lookup_num == 0 ? 0 : (double)page_addr_cache_stat.hit_num / page_addr_lookup_num;
+  of << system_name << " hit miss hit_rate lease_expire saved_round_trip" << std::endl;
+  of << page_addr_cache_stat.hit_num << " " << page_addr_cache_stat.miss_num << " " << page_addr_hit_rate << " "
+     << page_addr_cache_stat.lease_expire_num << " " << page_addr_cache_stat.saved_round_trip_num << std::endl;
+  of.close();
+  std::cerr << "page addr cache hit rate: " << page_addr_hit_rate << ", lease expire: " << page_addr_cache_stat.lease_expire_num
+            << ", saved round trip: " << page_addr_cache_stat.saved_round_trip_num << std::endl;
+
+  // 索引缓存的统计
+  std::string index_cache_file = "../../../bench_results/" + bench_name + "/index_cache.txt";
+  of.open(index_cache_file.c_str(), std::ios::app);
+  uint64_t index_lookup_num = index_cache_stat.hit_num + index_cache_stat.miss_num;
+  double index_hit_rate = index_lookup_num == 0 ? 0 : (double)index_cache_stat.hit_num / index_lookup_num;
+  of << system_name << " hit miss hit_rate stale false_hit" << std::endl;
+  of << index_cache_stat.hit_num << " " << index_cache_stat.miss_num << " " << index_hit_rate << " "
+     << index_cache_stat.stale_num << " " << index_cache_stat.false_hit_num << std::endl;
+  of.close();
+  std::cerr << "index cache hit: " << index_cache_stat.hit_num << ", miss: " << index_cache_stat.miss_num
+            << ", hit rate: " << index_hit_rate << ", stale: " << index_cache_stat.stale_num
+            << ", false hit: " << index_cache_stat.false_hit_num << std::endl;
+
   // Open it when testing the duration
 #if LOCK_WAIT
   if (bench_name == "MICRO") {
@@ -289,6 +324,10 @@ void Handler::GenThreadsForMICRO() {
   RDMA_LOG(INFO) << "Alloc local memory: " << (size_t)(thread_num_per_machine * PER_THREAD_ALLOC_SIZE) / (1024 * 1024) << " MB. Waiting...";
   auto* global_rdma_region = new RDMARegionAllocator(global_meta_man->GetGlobalRdmaCtrl(), global_meta_man->GetOpenedRnic(), thread_num_per_machine);
 
+  auto* global_storage_client = new StorageClient();
+  auto* global_page_addr_cache = new PageAddrCache();
+  auto* global_index_cache = new IndexCache();
+
   auto* param_arr = new struct thread_params[thread_num_per_machine];
 
   RDMA_LOG(INFO) << "spawn threads...";
@@ -303,6 +342,9 @@ void Handler::GenThreadsForMICRO() {
     param_arr[i].thread_num_per_machine = thread_num_per_machine;
     param_arr[i].total_thread_num = thread_num_per_machine * machine_num;
     param_arr[i].bench_name = "micro";
+    param_arr[i].storage_client = global_storage_client;
+    param_arr[i].page_addr_cache = global_page_addr_cache;
+    param_arr[i].index_cache = global_index_cache;
     thread_arr[i] = std::thread(run_thread,
                                 &param_arr[i],
                                 nullptr,
@@ -322,10 +364,14 @@ void Handler::GenThreadsForMICRO() {
     }
   }
   RDMA_LOG(INFO) << "Done";
+  page_addr_cache_stat = global_page_addr_cache->GetStat();
+  index_cache_stat = global_index_cache->GetStat();
 
   delete[] param_arr;
   delete global_rdma_region;
   delete global_meta_man;
   delete global_vcache;
   delete global_lcache;
+  delete global_page_addr_cache;
+  delete global_index_cache;
 }
@@ -58,12 +58,15 @@ __thread QPManager* qp_man;
 __thread VersionCache* status;
 __thread LockCache* lock_table;
 
-__thread std::list<PageAddress>* free_page_list;
-__thread std::mutex* free_page_list_mutex;
+__thread StorageClient* storage_client;
+__thread PageAddrCache* page_addr_cache;
+__thread IndexCache* index_cache;
 
 __thread RDMABufferAllocator* rdma_buffer_allocator;
 __thread LogOffsetAllocator* log_offset_allocator;
 __thread AddrCache* addr_cache;
+__thread FrameMagazine* frame_magazine;  // Thread-local free frames refilled from the page table ring buffer
+__thread ReadAheadDetector* read_ahead_detector;  // Thread-local sequential read-ahead, one stream per coroutine and table
 
 // __thread TATPTxType* tatp_workgen_arr;
 __thread SmallBankTxType* smallbank_workgen_arr;
@@ -146,8 +149,11 @@ void RunTATP(coro_yield_t& yield, coro_id_t coro_id) {
                      rdma_buffer_allocator,
                      log_offset_allocator,
                      addr_cache,
-                     free_page_list,
-                     free_page_list_mutex);
+                     frame_magazine,
+                     storage_client,
+                     page_addr_cache,
+                     read_ahead_detector,
+                     index_cache);
   struct timespec tx_start_time, tx_end_time;
   bool tx_committed = false;
 
@@ -304,8 +310,11 @@ void RunSmallBank(coro_yield_t& yield, coro_id_t coro_id) {
                      rdma_buffer_allocator,
                      log_offset_allocator,
                      addr_cache,
-                     free_page_list,
-                     free_page_list_mutex);
+                     frame_magazine,
+                     storage_client,
+                     page_addr_cache,
+                     read_ahead_detector,
+                     index_cache);
   struct timespec tx_start_time, tx_end_time;
   bool tx_committed = false;
 
@@ -448,8 +457,11 @@ void RunTPCC(coro_yield_t& yield, coro_id_t coro_id) {
                      rdma_buffer_allocator,
                      log_offset_allocator,
                      addr_cache,
-                     free_page_list,
-                     free_page_list_mutex);
+                     frame_magazine,
+                     storage_client,
+                     page_addr_cache,
+                     read_ahead_detector,
+                     index_cache);
   struct timespec tx_start_time, tx_end_time;
   bool tx_committed = false;
 
@@ -581,8 +593,11 @@ void RunMICRO(coro_yield_t& yield, coro_id_t coro_id) {
                      rdma_buffer_allocator,
                      log_offset_allocator,
                      addr_cache,
-                     free_page_list,
-                     free_page_list_mutex);
+                     frame_magazine,
+                     storage_client,
+                     page_addr_cache,
+                     read_ahead_detector,
+                     index_cache);
   struct timespec tx_start_time, tx_end_time;
   bool tx_committed = false;
 
@@ -755,14 +770,17 @@ void run_thread(thread_params* params,
   status = params->global_status;
   lock_table = params->global_lcache;
 
-  free_page_list = params->free_list; 
-  free_page_list_mutex = params->free_page_list_mutex;
+  storage_client = params->storage_client;
+  page_addr_cache = params->page_addr_cache;
+  index_cache = params->index_cache;
 
   coro_num = (coro_id_t)params->coro_num;
   coro_sched = new CoroutineScheduler(thread_gid, coro_num);
 
   auto alloc_rdma_region_range = params->global_rdma_region->GetThreadLocalRegion(thread_local_id);
   addr_cache = new AddrCache();
+  frame_magazine = new FrameMagazine();
+  read_ahead_detector = new ReadAheadDetector();
   rdma_buffer_allocator = new RDMABufferAllocator(alloc_rdma_region_range.first, alloc_rdma_region_range.second);
   log_offset_allocator = new LogOffsetAllocator(thread_gid, params->total_thread_num);
   timer = new double[ATTEMPTED_NUM]();
@@ -831,10 +849,22 @@ void run_thread(thread_params* params,
   stop_run = true;
 
   // RDMA_LOG(DBG) << "Thread: " << thread_gid << ". Loop RDMA alloc times: " << rdma_buffer_allocator->loop_times;
+  auto& magazine_stat = frame_magazine->GetStat();
+  RDMA_LOG(DBG) << "Thread: " << thread_gid << ". Frame magazine alloc: " << magazine_stat.alloc_num
+                << ", refill: " << magazine_stat.refill_num << ", refill wait: " << magazine_stat.refill_wait_num
+                << ", latch released for refill: " << magazine_stat.refill_under_latch_num;
+  auto& read_ahead_stat = read_ahead_detector->GetStat();
+  RDMA_LOG(DBG) << "Thread: " << thread_gid << ". Read-ahead trigger: " << read_ahead_stat.trigger_num
+                << ", issued pages: " << read_ahead_stat.issued_page_num
+                << ", installed pages: " << read_ahead_stat.installed_page_num
+                << ", used pages: " << read_ahead_stat.used_page_num
+                << ", wasted pages: " << read_ahead_stat.wasted_page_num;
 
   // Clean
   delete[] timer;
   delete addr_cache;
+  delete frame_magazine;
+  delete read_ahead_detector;
   // if (tatp_workgen_arr) delete[] tatp_workgen_arr;
   if (smallbank_workgen_arr) delete[] smallbank_workgen_arr;
   // if (tpcc_workgen_arr) delete[] tpcc_workgen_arr;
@@ -5,9 +5,12 @@
 
 #include "allocator/region_allocator.h"
 #include "base/common.h"
+#include "cache/index_cache.h"
 #include "cache/lock_status.h"
+#include "cache/page_addr_cache.h"
 #include "cache/version_status.h"
 #include "connection/meta_manager.h"
+#include "storage/storage_client.h"
 
 #include "tatp/tatp_db.h"
 #include "smallbank/smallbank_db.h"
@@ -25,8 +28,9 @@ struct thread_params {
   RDMARegionAllocator* global_rdma_region;
   int coro_num;
   std::string bench_name;
-  std::list<PageAddress>* free_list;
-  std::mutex* free_page_list_mutex;
+  StorageClient* storage_client;
+  PageAddrCache* page_addr_cache;
+  IndexCache* index_cache;
 };
 
 void run_thread(thread_params* params,
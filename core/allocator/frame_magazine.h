@@ -0,0 +1,120 @@
+// Copyright (c) 2023
+
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+#include "memstore/page_table.h"
+
+// 计算节点两级空闲frame分配器的第一级
+// 每个线程一个弹匣(magazine), 只被本线程的协程访问, 分配和归还都不需要加锁
+// 第二级是页表节点上的环形缓冲区(RingFreeFrameBuffer), 弹匣不足时由DTX通过协程调度器异步地批量补充,
+// 补充期间同一线程的其他协程可以继续执行, 不会像全局链表那样在持锁时阻塞轮询
+
+// 每次从环形缓冲区领取的位置数量
+#define FRAME_MAGAZINE_REFILL_BATCH 100
+// 获取桶latch之前保证弹匣中至少还有这么多余量, 让插入页表的路径尽量不在持有latch时补充
+#define FRAME_MAGAZINE_LOW_WATERMARK 32
+
+struct FrameMagazineStat {
+  uint64_t alloc_num;
+  uint64_t refill_num;
+  // 领取的槽位还没有被页表节点写入, 需要重新读取的次数
+  uint64_t refill_wait_num;
+  // 持有桶latch时弹匣不足, 释放latch补充之后重新查找页表的次数
+  uint64_t refill_under_latch_num;
+};
+
+// 已经通过FAA领取但还没有取完的位置, 领取之后不能撤销, 留到下次补充时继续读取
+struct FrameClaim {
+  uint64_t pos = 0;
+  size_t num = 0;
+};
+
+class FrameMagazine {
+ public:
+  FrameMagazine() : refill_node_idx(0), stat{} {
+    frames.reserve(FRAME_MAGAZINE_REFILL_BATCH + FRAME_MAGAZINE_LOW_WATERMARK);
+  }
+
+  size_t Size() const {
+    return frames.size();
+  }
+
+  bool Pop(PageAddress& page_address) {
+    if (frames.empty()) return false;
+    page_address = frames.back();
+    frames.pop_back();
+    stat.alloc_num++;
+    return true;
+  }
+
+  void Push(PageAddress page_address) {
+    frames.push_back(page_address);
+  }
+
+  // 轮流从各个页表节点的环形缓冲区补充, 平均各节点空闲frame的消耗
+  size_t NextRefillNodeIdx(size_t node_num) {
+    return refill_node_idx++ % node_num;
+  }
+
+  FrameMagazineStat& GetStat() {
+    return stat;
+  }
+
+  // 从node_id的环形缓冲区补充frame, 取得至少need_num个之后立即返回, 不等待领取的一批位置全部被生产者写入,
+  // 没有取完的位置作为pending claim留在弹匣中, 下次补充这个节点时先读取这些位置, 领取的位置仍然不会被撤销
+  // RingAccessor封装对环形缓冲区的访问, DTX通过协程调度器发出RDMA请求, free_frame_ring_test直接访问内存:
+  //   uint64_t Capacity(): 环形缓冲区的槽位数
+  //   uint64_t Claim(size_t num): FAA领取num个位置, 返回第一个位置
+  //   RingBufferItem* Read(uint64_t pos, size_t num): 读取num个槽位到本地, 等待读取完成
+  //   void Write(uint64_t pos, size_t num, RingBufferItem* local_slots): 写回释放后的序号, 不需要等待完成
+  //   void Backoff(int wait_num): 槽位还没有被写入, 重新读取之前等待, wait_num为连续等待的次数
+  // 生产者暂停时会一直等待, 不能在持有桶latch时调用
+  template <class RingAccessor>
+  size_t Refill(RingAccessor& ring_accessor, node_id_t node_id, size_t need_num) {
+    FreeFrameRing ring(ring_accessor.Capacity());
+    FrameClaim& claim = pending_claims[node_id];
+    size_t got = 0;
+    int wait_num = 0;
+    while (got < need_num) {
+      if (claim.num == 0) {
+        claim.pos = ring_accessor.Claim(FRAME_MAGAZINE_REFILL_BATCH);
+        claim.num = FRAME_MAGAZINE_REFILL_BATCH;
+        stat.refill_num++;
+      }
+      RingBufferItem* local_slots = ring_accessor.Read(claim.pos, claim.num);
+      size_t ready = 0;
+      node_id_t frame_node_id;
+      frame_id_t frame_id;
+      while (ready < claim.num && ring.Consume(local_slots[ready], claim.pos + ready, frame_node_id, frame_id)) {
+        frames.push_back({frame_node_id, frame_id});
+        ready++;
+      }
+      if (ready == 0) {
+        stat.refill_wait_num++;
+        ring_accessor.Backoff(++wait_num);
+        continue;
+      }
+      wait_num = 0;
+      ring_accessor.Write(claim.pos, ready, local_slots);
+      claim.pos += ready;
+      claim.num -= ready;
+      got += ready;
+    }
+    return got;
+  }
+
+  // node_id上领取了但还没有取完的位置
+  FrameClaim PendingClaim(node_id_t node_id) const {
+    auto it = pending_claims.find(node_id);
+    return it == pending_claims.end() ? FrameClaim() : it->second;
+  }
+
+ private:
+  std::vector<PageAddress> frames;
+  std::unordered_map<node_id_t, FrameClaim> pending_claims;
+  size_t refill_node_idx;
+  FrameMagazineStat stat;
+};
@@ -27,19 +27,15 @@ bool LocalBatch::ExeBatchRW(coro_yield_t& yield) {
   for (auto& dtx : txn_list) {
     for (auto& item : dtx->dtx->read_write_set) {
       auto it = item.item_ptr;
-      readonly_tableid.push_back(it->table_id);
-      readonly_keyid.push_back(it->key);
+      readwrite_tableid.push_back(it->table_id);
+      readwrite_keyid.push_back(it->key);
     }
   }
   
-  std::vector<table_id_t> all_tableid;
-  std::vector<itemkey_t> all_keyid;
-  std::merge(readonly_tableid.begin(), readonly_tableid.end(),
-             readwrite_tableid.begin(), readwrite_tableid.end(),
-             all_tableid.begin());
-  std::merge(readonly_keyid.begin(), readonly_keyid.end(),
-             readwrite_keyid.begin(), readwrite_keyid.end(),
-             all_keyid.begin());
+  std::vector<table_id_t> all_tableid(readonly_tableid);
+  std::vector<itemkey_t> all_keyid(readonly_keyid);
+  all_tableid.insert(all_tableid.end(), readwrite_tableid.begin(), readwrite_tableid.end());
+  all_keyid.insert(all_keyid.end(), readwrite_keyid.begin(), readwrite_keyid.end());
   
   //! 1. 对事务访问的数据项加锁
   // 只读加锁
@@ -58,7 +54,18 @@ bool LocalBatch::ExeBatchRW(coro_yield_t& yield) {
     return res;
   }
   //! 2. 获取数据项索引
-  auto index = first_dtx->GetHashIndex(yield, all_tableid, all_keyid);
+  // 索引缓存命中的记录已经知道所在的页面, 先发起这些页面的地址转换和读取, 再读取未命中的远程索引,
+  // 远程索引的round trip与已经发出的数据页读取重叠, ReadData直接使用发出的请求
+  std::unordered_map<table_id_t, std::unordered_map<itemkey_t, Rid>> index;
+  std::vector<table_id_t> miss_tableid;
+  std::vector<itemkey_t> miss_keyid;
+  PrefetchData(yield, first_dtx, all_tableid, all_keyid, index, miss_tableid, miss_keyid);
+  if (!miss_keyid.empty()) {
+    auto miss_index = first_dtx->GetRemoteHashIndex(yield, miss_tableid, miss_keyid);
+    for (auto& rid_map : miss_index) {
+      index[rid_map.first].insert(rid_map.second.begin(), rid_map.second.end());
+    }
+  }
   //! 3. 读取数据项
   auto data_list = ReadData(yield, first_dtx,index);
   //! 4. 从页中取出数据，将数据存入local，还没想好存到哪
@@ -79,22 +86,39 @@ bool LocalBatch::ExeBatchRW(coro_yield_t& yield) {
   return res;
 }
 
-std::vector<DataItemPtr> LocalBatch::ReadData(coro_yield_t& yield, DTX* first_dtx, std::unordered_map<table_id_t, std::unordered_map<itemkey_t, Rid>> index) {
-  // 遍历index，获取其中的页表地址
+void LocalBatch::PrefetchData(coro_yield_t& yield, DTX* first_dtx, const std::vector<table_id_t>& tableid, const std::vector<itemkey_t>& keyid,
+                              std::unordered_map<table_id_t, std::unordered_map<itemkey_t, Rid>>& index,
+                              std::vector<table_id_t>& miss_tableid, std::vector<itemkey_t>& miss_keyid) {
   std::vector<Rid> id_list;
   std::vector<table_id_t> tid_list;
   std::vector<DTX::FetchPageType> fetch_type;
-  std::vector<PageAddress> page_address;
-  for (auto& rid_map : index) {
-    table_id_t tid = rid_map.first;
-    for (auto& rid : rid_map.second) {
-      id_list.push_back(rid.second);
-      tid_list.push_back(tid);
-      fetch_type.push_back(DTX::FetchPageType::kReadPage);
+  for (size_t i = 0; i < keyid.size(); i++) {
+    Rid rid;
+    if (!first_dtx->SearchIndexCache(tableid[i], keyid[i], rid)) {
+      miss_tableid.push_back(tableid[i]);
+      miss_keyid.push_back(keyid[i]);
+      continue;
     }
+    index[tableid[i]][keyid[i]] = rid;
+    id_list.push_back(rid);
+    tid_list.push_back(tableid[i]);
+    fetch_type.push_back(DTX::FetchPageType::kReadPage);
   }
-  std::vector<DataItemPtr> data_list = first_dtx->FetchTuple(yield, tid_list, id_list, fetch_type, batch_id, page_address);
-  return data_list;
+  if (id_list.empty()) return;
+  first_dtx->PrefetchPages(yield, tid_list, id_list, fetch_type, batch_id);
+}
+
+std::vector<DataItemPtr> LocalBatch::ReadData(coro_yield_t& yield, DTX* first_dtx, std::unordered_map<table_id_t, std::unordered_map<itemkey_t, Rid>>& index) {
+  // 来自过期索引缓存项的记录不是要找的key, ReadRecords会重新获取这些key的索引并读取, 同时更新index
+  std::vector<PageAddress> page_address;
+  auto fetch = [&](std::vector<table_id_t>& tid_list, std::vector<Rid>& id_list) {
+    std::vector<DTX::FetchPageType> fetch_type(id_list.size(), DTX::FetchPageType::kReadPage);
+    return first_dtx->FetchTuple(yield, tid_list, id_list, fetch_type, batch_id, page_address);
+  };
+  auto lookup = [&](std::vector<table_id_t>& tid_list, std::vector<itemkey_t>& key_list) {
+    return first_dtx->GetHashIndex(yield, tid_list, key_list);
+  };
+  return first_dtx->index_cache->ReadRecords(index, fetch, lookup);
 }
 
 bool LocalBatch::FlushWrite(coro_yield_t& yield, DTX* first_dtx, std::vector<DataItemPtr> data_list, std::unordered_map<table_id_t, std::unordered_map<itemkey_t, Rid>> index) {
@@ -26,7 +26,12 @@ public:
         } else return false;
     }
     bool ExeBatchRW(coro_yield_t& yield);
-    std::vector<DataItemPtr> ReadData(coro_yield_t& yield, DTX* first_dtx, std::unordered_map<table_id_t, std::unordered_map<itemkey_t, Rid>> index);
+    // 查找索引缓存, 命中的key填入index并提前发起所在页面的读取, 未命中的key放入miss_tableid/miss_keyid
+    void PrefetchData(coro_yield_t& yield, DTX* first_dtx, const std::vector<table_id_t>& tableid, const std::vector<itemkey_t>& keyid,
+                      std::unordered_map<table_id_t, std::unordered_map<itemkey_t, Rid>>& index,
+                      std::vector<table_id_t>& miss_tableid, std::vector<itemkey_t>& miss_keyid);
+    // 索引缓存过期时会重新获取索引, 同时更新index
+    std::vector<DataItemPtr> ReadData(coro_yield_t& yield, DTX* first_dtx, std::unordered_map<table_id_t, std::unordered_map<itemkey_t, Rid>>& index);
     bool FlushWrite(coro_yield_t& yield, DTX* first_dtx, std::vector<DataItemPtr> data_list, std::unordered_map<table_id_t, std::unordered_map<itemkey_t, Rid>> index);
 private:
     // bool IssueReadRO(std::vector<DirectRead>& pending_direct_ro, std::vector<HashRead>& pending_hash_ro);
@@ -0,0 +1,201 @@
+// Copyright (c) 2023
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "base/common.h"
+#include "base/page.h"
+#include "cache/lru_map.h"
+#include "memstore/data_item.h"
+
+// 计算节点上的索引缓存, 缓存热点key到Rid的映射, 命中时GetHashIndex不需要读取远程哈希索引
+// Rid只在插入和删除时改变, 缓存项可能过期, 通过两种方式发现:
+// 1. 桶的version: 缓存项记录填入时所在桶的version, 本节点之后读取或修改这个桶时记录桶的最新version,
+//    两者不同说明桶被修改过, 查找时当作未命中, 重新读取远程索引
+// 2. 记录的key: 其他节点修改的桶在本节点再次读取之前发现不了, 读取记录之后比较DataItem中的key,
+//    不匹配时是一次false hit, 使缓存项失效并重新读取远程索引
+
+#define INDEX_CACHE_SHARD_NUM 64
+#define MAX_INDEX_CACHE_ITEM_PER_SHARD 16384
+#define MAX_INDEX_CACHE_BUCKET_PER_SHARD 16384
+
+struct IndexCacheStat {
+  uint64_t hit_num;
+  uint64_t miss_num;
+  // 因为桶的version变化而失效的缓存项, 同时计入miss_num
+  uint64_t stale_num;
+  // 命中之后读到的记录的key不匹配
+  uint64_t false_hit_num;
+};
+
+class IndexCache {
+ public:
+  IndexCache() : hit_num(0), miss_num(0), stale_num(0), false_hit_num(0) {}
+
+  bool Search(table_id_t table_id, itemkey_t key, Rid& rid) {
+    auto& shard = GetShard(table_id, key);
+    std::unique_lock<std::mutex> lock(shard.mutex);
+    CacheItem* cached = shard.items.Find(std::make_pair(table_id, key));
+    if (cached == nullptr) {
+      miss_num.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    CacheItem item = *cached;
+    lock.unlock();
+    version_t bucket_version;
+    if (!GetBucketVersion(item.node_id, item.bucket_off, bucket_version) || bucket_version != item.bucket_version) {
+      Invalidate(table_id, key, item.rid);
+      stale_num.fetch_add(1, std::memory_order_relaxed);
+      miss_num.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    rid = item.rid;
+    hit_num.fetch_add(1, std::memory_order_relaxed);
+    return true;
+  }
+
+  // bucket_version是读到key时桶的version, 需要先用UpdateBucketVersion记录
+  void Insert(table_id_t table_id, itemkey_t key, Rid rid, node_id_t node_id, offset_t bucket_off, version_t bucket_version) {
+    auto& shard = GetShard(table_id, key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    shard.items.Put(std::make_pair(table_id, key), {rid, node_id, bucket_off, bucket_version});
+  }
+
+  // 本节点读取或修改了一个桶, 记录它的最新version
+  void UpdateBucketVersion(node_id_t node_id, offset_t bucket_off, version_t bucket_version) {
+    auto& shard = GetBucketShard(node_id, bucket_off);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    shard.versions.Put(std::make_pair(node_id, bucket_off), bucket_version);
+  }
+
+  // 读到的记录与缓存的Rid不匹配, 只有缓存项仍然是这个Rid时才计为false hit
+  void ReportFalseHit(table_id_t table_id, itemkey_t key, Rid rid) {
+    if (Invalidate(table_id, key, rid)) false_hit_num.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  // 读到的记录不是要找的key时, 说明缓存的Rid已经过期(其他节点修改了桶), 计为false hit并使缓存项失效
+  bool CheckItem(table_id_t table_id, itemkey_t key, Rid rid, const DataItemPtr& item) {
+    if (item->table_id == table_id && item->key == key && item->valid) return true;
+    ReportFalseHit(table_id, key, rid);
+    return false;
+  }
+
+  // LocalBatch::ReadData读取记录的步骤, 远程访问由调用者提供:
+  //   fetch(tid_list, id_list) -> std::vector<DataItemPtr>: 读取记录
+  //   lookup(tid_list, key_list) -> table_id -> key -> Rid: 获取索引
+  // index中的Rid可能来自过期的缓存项, 读到的记录不是要找的key时重新获取这些key的索引并再次读取,
+  // 新的Rid写回index, 之后FlushWrite按index写回. 返回的记录与index的遍历顺序一致
+  template <class FetchFn, class LookupFn>
+  std::vector<DataItemPtr> ReadRecords(std::unordered_map<table_id_t, std::unordered_map<itemkey_t, Rid>>& index,
+                                       FetchFn fetch, LookupFn lookup) {
+    std::vector<Rid> id_list;
+    std::vector<table_id_t> tid_list;
+    std::vector<itemkey_t> key_list;
+    for (auto& rid_map : index) {
+      for (auto& rid : rid_map.second) {
+        id_list.push_back(rid.second);
+        tid_list.push_back(rid_map.first);
+        key_list.push_back(rid.first);
+      }
+    }
+    std::vector<DataItemPtr> data_list = fetch(tid_list, id_list);
+
+    std::vector<size_t> stale_pos;
+    std::vector<table_id_t> stale_tid_list;
+    std::vector<itemkey_t> stale_key_list;
+    for (size_t i = 0; i < data_list.size(); i++) {
+      if (id_list[i].page_no_ == INVALID_PAGE_ID) continue;
+      if (!CheckItem(tid_list[i], key_list[i], id_list[i], data_list[i])) {
+        stale_pos.push_back(i);
+        stale_tid_list.push_back(tid_list[i]);
+        stale_key_list.push_back(key_list[i]);
+      }
+    }
+    if (stale_pos.empty()) return data_list;
+
+    auto fresh_index = lookup(stale_tid_list, stale_key_list);
+    std::vector<Rid> fresh_id_list;
+    for (size_t i = 0; i < stale_pos.size(); i++) {
+      Rid rid = fresh_index[stale_tid_list[i]][stale_key_list[i]];
+      index[stale_tid_list[i]][stale_key_list[i]] = rid;
+      fresh_id_list.push_back(rid);
+    }
+    auto fresh_data_list = fetch(stale_tid_list, fresh_id_list);
+    for (size_t i = 0; i < stale_pos.size(); i++) {
+      data_list[stale_pos[i]] = fresh_data_list[i];
+    }
+    return data_list;
+  }
+
+  IndexCacheStat GetStat() const {
+    return {hit_num.load(), miss_num.load(), stale_num.load(), false_hit_num.load()};
+  }
+
+ private:
+  struct CacheItem {
+    Rid rid;
+    node_id_t node_id;
+    offset_t bucket_off;
+    version_t bucket_version;
+  };
+
+  template <typename T1, typename T2>
+  struct PairHash {
+    size_t operator()(const std::pair<T1, T2>& x) const {
+      return std::hash<T1>()(x.first) * 31 + std::hash<T2>()(x.second);
+    }
+  };
+
+  struct Shard {
+    std::mutex mutex;
+    // 已满时淘汰最久未被访问的项, 热点key不会被扫描的冷数据挤出
+    LRUMap<std::pair<table_id_t, itemkey_t>, CacheItem, PairHash<table_id_t, itemkey_t>> items{MAX_INDEX_CACHE_ITEM_PER_SHARD};
+  };
+
+  struct BucketShard {
+    std::mutex mutex;
+    // 被淘汰的桶上的缓存项查找时当作过期, 命中的缓存项会访问它所在的桶, 热点桶不会被淘汰
+    LRUMap<std::pair<node_id_t, offset_t>, version_t, PairHash<node_id_t, offset_t>> versions{MAX_INDEX_CACHE_BUCKET_PER_SHARD};
+  };
+
+  Shard& GetShard(table_id_t table_id, itemkey_t key) {
+    return shards[PairHash<table_id_t, itemkey_t>()(std::make_pair(table_id, key)) % INDEX_CACHE_SHARD_NUM];
+  }
+
+  BucketShard& GetBucketShard(node_id_t node_id, offset_t bucket_off) {
+    return bucket_shards[PairHash<node_id_t, offset_t>()(std::make_pair(node_id, bucket_off)) % INDEX_CACHE_SHARD_NUM];
+  }
+
+  bool GetBucketVersion(node_id_t node_id, offset_t bucket_off, version_t& bucket_version) {
+    auto& shard = GetBucketShard(node_id, bucket_off);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    version_t* version = shard.versions.Find(std::make_pair(node_id, bucket_off));
+    if (version == nullptr) return false;
+    bucket_version = *version;
+    return true;
+  }
+
+  bool Invalidate(table_id_t table_id, itemkey_t key, Rid rid) {
+    auto& shard = GetShard(table_id, key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto cache_key = std::make_pair(table_id, key);
+    CacheItem* item = shard.items.Find(cache_key);
+    if (item == nullptr || item->rid != rid) return false;
+    shard.items.Erase(cache_key);
+    return true;
+  }
+
+  Shard shards[INDEX_CACHE_SHARD_NUM];
+  BucketShard bucket_shards[INDEX_CACHE_SHARD_NUM];
+
+  std::atomic<uint64_t> hit_num;
+  std::atomic<uint64_t> miss_num;
+  std::atomic<uint64_t> stale_num;
+  std::atomic<uint64_t> false_hit_num;
+};
@@ -0,0 +1,58 @@
+// Copyright (c) 2023
+
+#pragma once
+
+#include <functional>
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+// 容量固定的LRU映射, 用作计算节点上各种缓存的一个分片, 由分片的mutex保护, 本身不加锁
+// 与LRUReplacer一样用链表记录访问顺序, 首部是最近访问的项, 已满时淘汰尾部最久未被访问的项,
+// 热点项不会因为分片被冷数据填满而被随机淘汰
+template <class Key, class Value, class Hash = std::hash<Key>>
+class LRUMap {
+ public:
+  explicit LRUMap(size_t max_size) : max_size(max_size) {}
+
+  // 查找key并把它移到链表首部, 不存在时返回nullptr
+  Value* Find(const Key& key) {
+    auto it = items.find(key);
+    if (it == items.end()) return nullptr;
+    lru_list.splice(lru_list.begin(), lru_list, it->second);
+    return &it->second->second;
+  }
+
+  // 插入或者更新key, 已满时先淘汰最久未被访问的项
+  void Put(const Key& key, const Value& value) {
+    auto it = items.find(key);
+    if (it != items.end()) {
+      it->second->second = value;
+      lru_list.splice(lru_list.begin(), lru_list, it->second);
+      return;
+    }
+    if (lru_list.size() >= max_size) {
+      items.erase(lru_list.back().first);
+      lru_list.pop_back();
+    }
+    lru_list.emplace_front(key, value);
+    items.emplace(key, lru_list.begin());
+  }
+
+  bool Erase(const Key& key) {
+    auto it = items.find(key);
+    if (it == items.end()) return false;
+    lru_list.erase(it->second);
+    items.erase(it);
+    return true;
+  }
+
+  size_t Size() const { return lru_list.size(); }
+
+ private:
+  using ListType = std::list<std::pair<Key, Value>>;
+
+  ListType lru_list;
+  std::unordered_map<Key, typename ListType::iterator, Hash> items;
+  size_t max_size;
+};
@@ -0,0 +1,106 @@
+// Copyright (c) 2023
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+
+#include "base/page.h"
+#include "cache/lru_map.h"
+#include "memstore/page_table.h"
+
+// 计算节点上的页地址缓存, 类似TLB, 缓存PageId到PageAddress的转换, 命中时FetchPage不需要访问远程页表
+// 正确性依赖租约: 页表节点的VictimPageThread只淘汰last_access_time早于PAGE_EVICT_IDLE_SEC秒之前的页面,
+// 计算节点在UnpinPageTable更新last_access_time时开始租约, 租约长度比淘汰阈值短, 留出时钟偏差的余量,
+// 因此缓存项在它指向的frame可能被回收之前就已经过期
+// 命中的页面不在页表中pin, 也不需要unpin, 所以只用于只读请求, 修改页面的请求需要经过页表获取latch并记录脏页
+
+#define PAGE_ADDR_CACHE_SHARD_NUM 64
+#define MAX_PAGE_ADDR_CACHE_ITEM_PER_SHARD 16384
+#define PAGE_ADDR_LEASE_MS 2000
+#define PAGE_ADDR_LEASE_CLOCK_SKEW_MS 2000
+
+static_assert(PAGE_ADDR_LEASE_MS + PAGE_ADDR_LEASE_CLOCK_SKEW_MS < PAGE_EVICT_IDLE_SEC * 1000,
+              "page address lease must expire before the victim thread can recycle the frame");
+
+// 命中时省去的页表round trip: 乐观路径的FAA+READ和rwcount的FAA, 以及UnpinPageTable获取桶latch
+#define PAGE_TABLE_PIN_ROUND_TRIPS 2
+#define PAGE_TABLE_UNPIN_ROUND_TRIPS 1
+
+struct PageAddrCacheStat {
+  uint64_t hit_num;
+  uint64_t miss_num;
+  uint64_t lease_expire_num;
+  uint64_t saved_round_trip_num;
+};
+
+class PageAddrCache {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  PageAddrCache() : hit_num(0), miss_num(0), lease_expire_num(0), saved_round_trip_num(0) {}
+
+  // lease_start必须取在last_access_time的时间戳生成之前
+  void Insert(PageId page_id, PageAddress page_address, Clock::time_point lease_start) {
+    auto& shard = GetShard(page_id);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    shard.items.Put(page_id, {page_address, lease_start + std::chrono::milliseconds(PAGE_ADDR_LEASE_MS)});
+  }
+
+  bool Search(PageId page_id, PageAddress& page_address) {
+    auto& shard = GetShard(page_id);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    CacheItem* item = shard.items.Find(page_id);
+    if (item == nullptr) {
+      miss_num.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    if (Clock::now() >= item->lease_expire) {
+      shard.items.Erase(page_id);
+      lease_expire_num.fetch_add(1, std::memory_order_relaxed);
+      miss_num.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    page_address = item->page_address;
+    hit_num.fetch_add(1, std::memory_order_relaxed);
+    return true;
+  }
+
+  void Invalidate(PageId page_id) {
+    auto& shard = GetShard(page_id);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    shard.items.Erase(page_id);
+  }
+
+  void AddSavedRoundTrips(uint64_t num) {
+    saved_round_trip_num.fetch_add(num, std::memory_order_relaxed);
+  }
+
+  PageAddrCacheStat GetStat() const {
+    return {hit_num.load(), miss_num.load(), lease_expire_num.load(), saved_round_trip_num.load()};
+  }
+
+ private:
+  struct CacheItem {
+    PageAddress page_address;
+    Clock::time_point lease_expire;
+  };
+
+  struct Shard {
+    std::mutex mutex;
+    // 已满时淘汰最久未被访问的项; 过期的项在查找时删除, 没有再被访问的过期项会沉到链表尾部先被淘汰
+    LRUMap<PageId, CacheItem> items{MAX_PAGE_ADDR_CACHE_ITEM_PER_SHARD};
+  };
+
+  Shard& GetShard(PageId page_id) {
+    return shards[std::hash<PageId>()(page_id) % PAGE_ADDR_CACHE_SHARD_NUM];
+  }
+
+  Shard shards[PAGE_ADDR_CACHE_SHARD_NUM];
+
+  std::atomic<uint64_t> hit_num;
+  std::atomic<uint64_t> miss_num;
+  std::atomic<uint64_t> lease_expire_num;
+  std::atomic<uint64_t> saved_round_trip_num;
+};
@@ -0,0 +1,133 @@
+// Copyright (c) 2023
+
+#pragma once
+
+#include <algorithm>
+#include <map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "base/common.h"
+#include "base/page.h"
+
+// 计算节点上的顺序预读检测, 每个线程一个, 只被本线程的协程访问
+// 每个协程对每个表是一个stream, 连续READ_AHEAD_TRIGGER_MISS次顺序缺页之后, 对之后window个页面发起预读:
+// 存储层异步地把这些页面读入page cache并返回哪些页面存在, 协程不等待;
+// 之后的FetchPage把存在的页面和自己的缺页一起插入页表(page_valid=false并pin住), 合并到同一个GetPages请求中读取,
+// 写入分配的空闲frame之后unpin, page_valid变为true. 页面在pin住之后才读取内容, 与按需读取的一致性相同
+// 和Linux的异步预读一样, 访问到上一个预读窗口的第一个页面时发起下一个窗口, 窗口每次翻倍, 直到READ_AHEAD_MAX_WINDOW
+// 预读的页面在stream中断之前没有被访问, 或者已经在共享内存池中/超出表的末尾, 都计为浪费
+
+#define READ_AHEAD_TRIGGER_MISS 2
+#define READ_AHEAD_INIT_WINDOW 4
+#define READ_AHEAD_MAX_WINDOW 64
+
+struct ReadAheadStat {
+  // 发起预读的次数和页面数
+  uint64_t trigger_num;
+  uint64_t issued_page_num;
+  // 成功装入共享内存池的页面数
+  uint64_t installed_page_num;
+  // 装入之后被stream访问到的页面数
+  uint64_t used_page_num;
+  uint64_t wasted_page_num;
+};
+
+class ReadAheadDetector {
+ public:
+  ReadAheadDetector() : stat{} {}
+
+  // 记录stream对一个页面的访问, miss表示页面不在共享内存池中, 需要从存储层读取
+  // 同一个表的页面需要按页号从小到大调用, 需要预读的页号追加到read_ahead_page_nos
+  void OnAccess(coro_id_t stream_id, table_id_t table_id, page_id_t page_no, bool miss,
+                std::vector<page_id_t>& read_ahead_page_nos) {
+    Stream& stream = streams[std::make_pair(stream_id, table_id)];
+    auto it = stream.outstanding.find(page_no);
+    if (it != stream.outstanding.end()) {
+      stream.outstanding.erase(it);
+      stat.used_page_num++;
+      stream.last_page_no = page_no;
+      if (page_no >= stream.trigger_page_no) Issue(stream, read_ahead_page_nos);
+      return;
+    }
+    if (!miss) {
+      stream.last_page_no = page_no;
+      return;
+    }
+    if (page_no == stream.last_page_no + 1) {
+      stream.seq_miss_num++;
+    } else {
+      // 随机访问, stream重新开始, 还没有被访问的预读页面都浪费了
+      stat.wasted_page_num += stream.outstanding.size();
+      stream.outstanding.clear();
+      stream.seq_miss_num = 1;
+      stream.window = READ_AHEAD_INIT_WINDOW;
+    }
+    stream.last_page_no = page_no;
+    if (stream.seq_miss_num >= READ_AHEAD_TRIGGER_MISS && stream.outstanding.empty()) {
+      stream.ahead_end = page_no + 1;
+      Issue(stream, read_ahead_page_nos);
+    }
+  }
+
+  // 记录一次请求中的所有页面访问, 同一个表的访问按页号顺序交给OnAccess, 需要预读的页面追加到read_ahead_page_ids
+  void OnAccesses(coro_id_t stream_id, std::vector<std::pair<PageId, bool>> accesses,
+                  std::vector<PageId>& read_ahead_page_ids) {
+    std::sort(accesses.begin(), accesses.end(),
+              [](const std::pair<PageId, bool>& a, const std::pair<PageId, bool>& b) {
+                if (a.first.table_id != b.first.table_id) return a.first.table_id < b.first.table_id;
+                return a.first.page_no < b.first.page_no;
+              });
+    std::vector<page_id_t> read_ahead_page_nos;
+    for (auto& access : accesses) {
+      read_ahead_page_nos.clear();
+      OnAccess(stream_id, access.first.table_id, access.first.page_no, access.second, read_ahead_page_nos);
+      for (auto page_no : read_ahead_page_nos) read_ahead_page_ids.emplace_back(access.first.table_id, page_no);
+    }
+  }
+
+  // 预读的页面装入完成, installed为false表示页面已经在共享内存池中或者不存在
+  void OnInstalled(coro_id_t stream_id, table_id_t table_id, page_id_t page_no, bool installed) {
+    if (installed) {
+      stat.installed_page_num++;
+      return;
+    }
+    stat.wasted_page_num++;
+    auto it = streams.find(std::make_pair(stream_id, table_id));
+    if (it != streams.end()) it->second.outstanding.erase(page_no);
+  }
+
+  ReadAheadStat& GetStat() {
+    return stat;
+  }
+
+ private:
+  struct Stream {
+    page_id_t last_page_no = INVALID_PAGE_ID;
+    int seq_miss_num = 0;
+    page_id_t window = READ_AHEAD_INIT_WINDOW;
+    // 访问到这个页面时发起下一个窗口
+    page_id_t trigger_page_no = 0;
+    // 已经发起预读的最后一个页面之后的页号
+    page_id_t ahead_end = 0;
+    // 已经发起预读, 还没有被访问的页面
+    std::unordered_set<page_id_t> outstanding;
+  };
+
+  void Issue(Stream& stream, std::vector<page_id_t>& read_ahead_page_nos) {
+    page_id_t start = std::max(stream.ahead_end, stream.last_page_no + 1);
+    for (page_id_t page_no = start; page_no < start + stream.window; page_no++) {
+      read_ahead_page_nos.push_back(page_no);
+      stream.outstanding.insert(page_no);
+    }
+    stat.trigger_num++;
+    stat.issued_page_num += stream.window;
+    stream.trigger_page_no = start;
+    stream.ahead_end = start + stream.window;
+    stream.window = std::min(stream.window * 2, (page_id_t)READ_AHEAD_MAX_WINDOW);
+  }
+
+  std::map<std::pair<coro_id_t, table_id_t>, Stream> streams;
+  ReadAheadStat stat;
+};
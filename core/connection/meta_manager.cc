@@ -179,7 +179,6 @@ node_id_t MetaManager::GetAddrStoreMeta(std::string& remote_ip, int remote_port)
   }
 
   /* --------------- Receiving Addr metadata ----------------- */
-  // todo:下面的元信息还需要修改
   size_t hash_meta_size = (size_t)1024 * 1024 * 1024;
   char* recv_buf = (char*)malloc(hash_meta_size);
   auto retlen = recv(client_socket, recv_buf, hash_meta_size, 0);
@@ -199,13 +198,51 @@ node_id_t MetaManager::GetAddrStoreMeta(std::string& remote_ip, int remote_port)
     RDMA_LOG(FATAL) << "remote machine id " << remote_machine_id << " exceeds the max machine number";
   }
   snooper += sizeof(remote_machine_id);
-  uint64_t bucket_num = *((uint64_t*)snooper);
-  page_addr_node_bucket_num[remote_machine_id] = bucket_num;
-  snooper += sizeof(bucket_num);
+  // 页表节点发送的是PageTableMeta, 见PageTableServer::PreparePageTableStoreMeta
+  // 其中的vector在对端的地址空间中没有意义, 只取出标量字段
+  PageTableMeta* remote_meta = (PageTableMeta*)snooper;
+  PageTableMeta meta(remote_meta->page_table_ptr, remote_meta->bucket_num, remote_meta->node_size, remote_meta->base_off);
+  snooper += sizeof(PageTableMeta);
+  if (*((uint64_t*)snooper) != MEM_STORE_META_END) {
+    RDMA_LOG(FATAL) << "page table meta from " << remote_ip << " is truncated";
+  }
+  page_addr_node_bucket_num[remote_machine_id] = meta.bucket_num;
+  AddPageTableNode(remote_machine_id, meta);
+  // 空闲frame环形缓冲区单独注册为SERVER_PAGETABLE_RING_FREE_FRAME_BUFFER_ID, 偏移相对于RingFreeFrameBuffer
+  free_ring_base_off[remote_machine_id] = offsetof(RingFreeFrameBuffer, free_list_buffer_);
+  free_ring_dequeue_ticket_off[remote_machine_id] = offsetof(RingFreeFrameBuffer, dequeue_ticket_);
   free(recv_buf);
   return remote_machine_id;
 }
 
+void MetaManager::AddPageTableNode(node_id_t node_id, const PageTableMeta& meta, bool rehash) {
+  if (page_table_meta.count(node_id) != 0) {
+    RDMA_LOG(ERROR) << "page table node " << node_id << " has been added";
+    return;
+  }
+  if (rehash && !page_table_ring.empty()) {
+    if (page_table_rehashing) {
+      RDMA_LOG(FATAL) << "add page table node " << node_id << " while the previous rehash is not finished";
+    }
+    prev_page_table_ring = page_table_ring;
+    page_table_rehashing = true;
+  }
+  page_table_nodes.push_back(node_id);
+  page_table_meta.emplace(node_id, meta);
+  // 扩展桶紧跟在bucket_num个桶之后, 见PageTableStore::LocalInsertPageTableItem
+  page_table_node_expanded_base_off[node_id] = meta.base_off + meta.bucket_num * meta.node_size;
+  for (uint64_t i = 0; i < PAGE_TABLE_VIRTUAL_NODE_NUM; i++) {
+    // 虚拟节点的哈希值与页面使用不同的种子, 冲突时保留先加入的虚拟节点
+    page_table_ring.emplace(MurmurHash64A(((uint64_t)node_id << 32) | i, 0x5bd1e995), node_id);
+  }
+  RDMA_LOG(INFO) << "add page table node " << node_id << ", bucket_num: " << meta.bucket_num << ", rehash: " << rehash;
+}
+
+void MetaManager::FinishPageTableRehash() {
+  prev_page_table_ring.clear();
+  page_table_rehashing = false;
+}
+
 void MetaManager::GetMRMeta(const RemoteNode& node) {
   // Get remote node's memory region information via TCP
   MemoryAttr remote_hash_mr{}, remote_log_mr{};
@@ -4,12 +4,14 @@
 #pragma once
 
 #include <atomic>
+#include <map>
 #include <unordered_map>
 #include <string>
 
 #include "base/common.h"
 #include "memstore/hash_store.h"
 #include "memstore/hash_index_store.h"
+#include "memstore/btree_index_store.h"
 #include "memstore/lock_table_store.h"
 #include "memstore/page_table.h"
 #include "rlib/rdma_ctrl.hpp"
@@ -17,6 +19,9 @@
 
 using namespace rdmaio;
 
+// 每个页表节点在一致性哈希环上的虚拟节点个数
+#define PAGE_TABLE_VIRTUAL_NODE_NUM 128
+
 // const size_t LOG_BUFFER_SIZE = 1024 * 1024 * 512;
 
 // 这个结构体作用是在计算层维护Table的元信息, 用于计算层和内存层交互
@@ -149,6 +154,27 @@ class MetaManager {
     return search->second;
   }
 
+  /*** B+-tree Index Node id ***/
+  ALWAYS_INLINE
+  node_id_t GetBTreeIndexNode(const table_id_t table_id) const {
+    auto search = btree_index_nodes.find(table_id);
+    assert(search != btree_index_nodes.end());
+    return search->second;
+  }
+
+  /*** B+-tree Index Meta ***/
+  ALWAYS_INLINE
+  const BTreeIndexMeta& GetBTreeIndexMeta(const table_id_t table_id) const {
+    auto search = btree_index_meta.find(table_id);
+    assert(search != btree_index_meta.end());
+    return search->second;
+  }
+
+  ALWAYS_INLINE
+  bool HasBTreeIndex(const table_id_t table_id) const {
+    return btree_index_meta.count(table_id) != 0;
+  }
+
   /*** Lock Table Node id ***/
   ALWAYS_INLINE
   node_id_t GetLockTableNode(const table_id_t table_id) const {
@@ -180,6 +206,31 @@ class MetaManager {
     return page_table_nodes;
   }
 
+  /*** Page Table Meta ***/
+  // 注册一个页表节点, 把它的虚拟节点加入一致性哈希环
+  // rehash为true表示集群运行中新增的节点: 在FinishPageTableRehash之前页面仍然按旧的哈希环路由,
+  // 迁移线程通过GetPageTableRehashHomeNode找出需要搬到新节点的页表项, 只有落在新节点区间内的页面需要迁移
+  void AddPageTableNode(node_id_t node_id, const PageTableMeta& meta, bool rehash = false);
+
+  void FinishPageTableRehash();
+
+  // 页面的home页表节点, 页面的查找和插入只访问这一个节点
+  ALWAYS_INLINE
+  node_id_t GetPageTableHomeNode(PageId page_id) const {
+    return GetRingNode(page_table_rehashing ? prev_page_table_ring : page_table_ring, page_id);
+  }
+
+  // rehash期间页面在新哈希环上的home节点, 与GetPageTableHomeNode不同时说明该页表项需要迁移
+  ALWAYS_INLINE
+  node_id_t GetPageTableRehashHomeNode(PageId page_id) const {
+    return GetRingNode(page_table_ring, page_id);
+  }
+
+  ALWAYS_INLINE
+  bool IsPageTableRehashing() const {
+    return page_table_rehashing;
+  }
+
   /*** Page Table Meta ***/
   ALWAYS_INLINE
   const PageTableMeta& GetPageTableMeta(const node_id_t node_id) const {
@@ -189,8 +240,8 @@ class MetaManager {
   }
   /*** Page Table Meta ***/
   const offset_t GetPageTableExpandBase(const node_id_t node_id) const {
-    auto search = lock_node_expanded_base_off.find(node_id);
-    assert(search != lock_node_expanded_base_off.end());
+    auto search = page_table_node_expanded_base_off.find(node_id);
+    assert(search != page_table_node_expanded_base_off.end());
     return search->second;
   }
   const offset_t GetFreeRingBase(const node_id_t node_id) const {
@@ -198,19 +249,10 @@ class MetaManager {
     assert(search != free_ring_base_off.end());
     return search->second;
   }
-  const offset_t GetFreeRingHead(const node_id_t node_id) const {
-    auto search = free_ring_head_off.find(node_id);
-    assert(search != free_ring_head_off.end());
-    return search->second;
-  }
-  const offset_t GetFreeRingTail(const node_id_t node_id) const {
-    auto search = free_ring_tail_off.find(node_id);
-    assert(search != free_ring_tail_off.end());
-    return search->second;
-  }
-  const offset_t GetFreeRingCnt(const node_id_t node_id) const {
-    auto search = free_ring_cnt_off.find(node_id);
-    assert(search != free_ring_cnt_off.end());
+  // 计算节点通过FAA领取空闲frame的ticket, 见FreeFrameRing
+  const offset_t GetFreeRingDequeueTicket(const node_id_t node_id) const {
+    auto search = free_ring_dequeue_ticket_off.find(node_id);
+    assert(search != free_ring_dequeue_ticket_off.end());
     return search->second;
   }
 
@@ -229,6 +271,15 @@ class MetaManager {
   }
   
  private:
+  static node_id_t GetRingNode(const std::map<uint64_t, node_id_t>& ring, PageId page_id) {
+    if (ring.empty()) {
+      RDMA_LOG(FATAL) << "no page table node is registered, check remote_address_nodes in compute_node_config.json";
+    }
+    auto it = ring.lower_bound(MurmurHash64A(page_id.Get(), 0xdeadbeef));
+    if (it == ring.end()) it = ring.begin();
+    return it->second;
+  }
+
   // std::unordered_map<table_id_t, HashMeta> primary_hash_metas;
 
   // std::unordered_map<table_id_t, std::vector<HashMeta>> backup_hash_metas;
@@ -252,18 +303,24 @@ class MetaManager {
   std::unordered_map<table_id_t, node_id_t> hash_index_nodes;
   std::unordered_map<table_id_t, offset_t> hash_index_node_expanded_base_off;
 
+  // 有序索引, 只有需要范围扫描的表才有
+  std::unordered_map<table_id_t, BTreeIndexMeta> btree_index_meta;
+  std::unordered_map<table_id_t, node_id_t> btree_index_nodes;
+
   std::unordered_map<table_id_t, LockTableMeta> lock_table_meta;
   std::unordered_map<table_id_t, node_id_t> lock_table_nodes;
   std::unordered_map<node_id_t, offset_t> lock_node_expanded_base_off;
 
   std::vector<node_id_t> page_table_nodes;
   std::unordered_map<node_id_t, PageTableMeta> page_table_meta;
+  // 一致性哈希环, key为虚拟节点的哈希值, 页面由哈希值之后的第一个虚拟节点所属的页表节点管理
+  std::map<uint64_t, node_id_t> page_table_ring;
+  std::map<uint64_t, node_id_t> prev_page_table_ring;  // rehash期间仍然用于路由的旧哈希环
+  bool page_table_rehashing = false;
   std::unordered_map<node_id_t, offset_t> page_table_node_expanded_base_off;
 
   std::unordered_map<node_id_t, offset_t> free_ring_base_off;
-  std::unordered_map<node_id_t, offset_t> free_ring_head_off;
-  std::unordered_map<node_id_t, offset_t> free_ring_tail_off;
-  std::unordered_map<node_id_t, offset_t> free_ring_cnt_off;
+  std::unordered_map<node_id_t, offset_t> free_ring_dequeue_ticket_off;
 
   std::unordered_map<table_id_t, std::string> table_name_map;
   std::unordered_map<table_id_t, TableMeta> table_meta_map;
@@ -382,4 +382,73 @@ bool ComparatorUpdateRemote::SendReqs(CoroutineScheduler* coro_sched, RCQP* qp,
 
   if (!coro_sched->RDMABatch(coro_id, qp, &(sr[0]), &bad_sr, 2)) return false;
   return true;
-}
\ No newline at end of file
+}
+
+// ----------------------------------------------------------------
+// 任意数量请求的doorbell
+void ChainedDoorbellBatch::AddReadReq(char* local_addr, uint64_t remote_off, size_t size) {
+  struct ibv_send_wr wr{};
+  wr.opcode = IBV_WR_RDMA_READ;
+  wr.wr.rdma.remote_addr = remote_off;
+  sr.push_back(wr);
+  sge.push_back({(uint64_t)local_addr, (uint32_t)size, 0});
+}
+
+void ChainedDoorbellBatch::AddWriteReq(char* local_addr, uint64_t remote_off, size_t size) {
+  struct ibv_send_wr wr{};
+  wr.opcode = IBV_WR_RDMA_WRITE;
+  wr.wr.rdma.remote_addr = remote_off;
+  if (size < 64) {
+    wr.send_flags |= IBV_SEND_INLINE;
+  }
+  sr.push_back(wr);
+  sge.push_back({(uint64_t)local_addr, (uint32_t)size, 0});
+}
+
+void ChainedDoorbellBatch::AddFAAReq(char* local_addr, uint64_t remote_off, uint64_t add) {
+  struct ibv_send_wr wr{};
+  wr.opcode = IBV_WR_ATOMIC_FETCH_AND_ADD;
+  wr.wr.atomic.remote_addr = remote_off;
+  wr.wr.atomic.compare_add = add;
+  sr.push_back(wr);
+  sge.push_back({(uint64_t)local_addr, sizeof(uint64_t), 0});
+}
+
+void ChainedDoorbellBatch::AddCASReq(char* local_addr, uint64_t remote_off, uint64_t compare, uint64_t swap) {
+  struct ibv_send_wr wr{};
+  wr.opcode = IBV_WR_ATOMIC_CMP_AND_SWP;
+  wr.wr.atomic.remote_addr = remote_off;
+  wr.wr.atomic.compare_add = compare;
+  wr.wr.atomic.swap = swap;
+  sr.push_back(wr);
+  sge.push_back({(uint64_t)local_addr, sizeof(uint64_t), 0});
+}
+
+bool ChainedDoorbellBatch::SendReqs(CoroutineScheduler* coro_sched, RCQP* qp, coro_id_t coro_id, coro_yield_t& yield) {
+  // 所有请求添加完之后才链接, vector扩容会改变地址
+  for (size_t i = 0; i < sr.size(); i++) {
+    sr[i].num_sge = 1;
+    sr[i].sg_list = &sge[i];
+    sge[i].lkey = qp->local_mr_.key;
+    if (sr[i].opcode == IBV_WR_RDMA_WRITE || sr[i].opcode == IBV_WR_RDMA_READ) {
+      sr[i].wr.rdma.remote_addr += qp->remote_mr_.buf;
+      sr[i].wr.rdma.rkey = qp->remote_mr_.key;
+    } else {
+      sr[i].wr.atomic.remote_addr += qp->remote_mr_.buf;
+      sr[i].wr.atomic.rkey = qp->remote_mr_.key;
+    }
+  }
+  size_t share = coro_sched->SendQueueShare();
+  for (size_t start = 0; start < sr.size(); start += share) {
+    size_t end = std::min(sr.size(), start + share);
+    // 加上这个链表会超出本协程在发送队列中的份额, 先等待之前发出的请求完成, 它们在远端已经执行, 不影响请求的顺序
+    if (coro_sched->PostedWRs(coro_id, qp) + (end - start) > share) coro_sched->Yield(yield, coro_id);
+    for (size_t i = start; i < end - 1; i++) {
+      sr[i].next = &sr[i + 1];
+    }
+    sr[end - 1].next = NULL;
+    sr[end - 1].send_flags |= IBV_SEND_SIGNALED;
+    if (!coro_sched->RDMABatch(coro_id, qp, &(sr[start]), &bad_sr, end - 1 - start)) return false;
+  }
+  return true;
+}
@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include <vector>
+
 #include "base/common.h"
 #include "rlib/rdma_ctrl.hpp"
 #include "scheduler/corotine_scheduler.h"
@@ -214,4 +216,32 @@ class ComparatorUpdateRemote {
   struct ibv_sge sge[3];
 
   struct ibv_send_wr* bad_sr;
-};
\ No newline at end of file
+};
+
+// 任意数量请求的doorbell, 同一个QP上的READ/WRITE/FAA/CAS请求串成一个链表, 通过一次ibv_post_send发出,
+// 只有最后一个请求signaled, 协程只需要等待一个完成事件. 请求在远端按照添加的顺序执行
+// 发送队列中的请求(无论是否signaled)要等到它自己或者之后的signaled请求完成才被释放, 一个线程的各个协程共用QP,
+// 所以每个协程在一个QP上未完成的请求数不超过coro_sched->SendQueueShare(), 即RC_MAX_SEND_SIZE按协程数平分,
+// 请求更多时拆成多个doorbell, 每个doorbell的最后一个请求signaled, 超出份额之前先Yield等待已经发出的请求完成
+class ChainedDoorbellBatch {
+ public:
+  void AddReadReq(char* local_addr, uint64_t remote_off, size_t size);
+
+  void AddWriteReq(char* local_addr, uint64_t remote_off, size_t size);
+
+  void AddFAAReq(char* local_addr, uint64_t remote_off, uint64_t add);
+
+  void AddCASReq(char* local_addr, uint64_t remote_off, uint64_t compare, uint64_t swap);
+
+  size_t Size() const { return sr.size(); }
+
+  // Send doorbelled requests to the queue pair, may yield when the requests exceed the coroutine's share of the send queue
+  bool SendReqs(CoroutineScheduler* coro_sched, RCQP* qp, coro_id_t coro_id, coro_yield_t& yield);
+
+ private:
+  std::vector<struct ibv_send_wr> sr;
+
+  std::vector<struct ibv_sge> sge;
+
+  struct ibv_send_wr* bad_sr;
+};
@@ -13,8 +13,11 @@ DTX::DTX(MetaManager* meta_man,
          RDMABufferAllocator* rdma_buffer_allocator,
          LogOffsetAllocator* remote_log_offset_allocator,
          AddrCache* addr_buf,
-         std::list<PageAddress>* free_page_list, 
-         std::mutex* free_page_list_mutex) {
+         FrameMagazine* frame_magazine,
+         StorageClient* storage_client,
+         PageAddrCache* page_addr_cache,
+         ReadAheadDetector* read_ahead_detector,
+         IndexCache* index_cache) {
   // Transaction setup
   tx_id = 0;
   t_id = tid;
@@ -30,6 +33,11 @@ DTX::DTX(MetaManager* meta_man,
   select_backup = 0;
   thread_remote_log_offset_alloc = remote_log_offset_allocator;
   addr_cache = addr_buf;
+  this->frame_magazine = frame_magazine;
+  this->storage_client = storage_client;
+  this->page_addr_cache = page_addr_cache;
+  this->read_ahead_detector = read_ahead_detector;
+  this->index_cache = index_cache;
 
   hit_local_cache_times = 0;
   miss_local_cache_times = 0;
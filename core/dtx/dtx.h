@@ -4,6 +4,7 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <cstdio>
 #include <iostream>
@@ -18,10 +19,14 @@
 #include <vector>
 
 #include "allocator/buffer_allocator.h"
+#include "allocator/frame_magazine.h"
 #include "allocator/log_allocator.h"
 #include "base/common.h"
 #include "cache/addr_cache.h"
+#include "cache/index_cache.h"
 #include "cache/lock_status.h"
+#include "cache/page_addr_cache.h"
+#include "cache/read_ahead.h"
 #include "cache/version_status.h"
 #include "connection/meta_manager.h"
 #include "connection/qp_manager.h"
@@ -29,8 +34,10 @@
 #include "dtx/structs.h"
 #include "memstore/hash_store.h"
 #include "memstore/hash_index_store.h"
+#include "memstore/btree_index_store.h"
 #include "memstore/lock_table_store.h"
 #include "memstore/page_table.h"
+#include "storage/storage_client.h"
 #include "util/debug.h"
 #include "util/hash.h"
 #include "util/json_config.h"
@@ -74,9 +81,14 @@ class DTX {
       RDMABufferAllocator* rdma_buffer_allocator,
       LogOffsetAllocator* log_offset_allocator,
       AddrCache* addr_buf,
-      std::list<PageAddress>* free_page_list, 
-      std::mutex* free_page_list_mutex);
+      FrameMagazine* frame_magazine,
+      StorageClient* storage_client,
+      PageAddrCache* page_addr_cache,
+      ReadAheadDetector* read_ahead_detector,
+      IndexCache* index_cache);
   ~DTX() {
+    // 还没有完成的预读探测由请求的回调持有, 不需要等待, 只通知检测器这些页面不会装入
+    DropReadAheads();
     Clean();
   }
 
@@ -104,10 +116,23 @@ class DTX {
   // for hash index
   std::unordered_map<table_id_t, std::unordered_map<itemkey_t, Rid>> GetHashIndex(coro_yield_t& yield, std::vector<table_id_t> table_id, std::vector<itemkey_t> item_key);
 
+  // 只查找计算节点上的索引缓存, 未命中时返回false
+  bool SearchIndexCache(table_id_t table_id, itemkey_t key, Rid& rid);
+  // 不查找索引缓存, 直接读取远程索引, 找到的Rid填入缓存
+  std::unordered_map<table_id_t, std::unordered_map<itemkey_t, Rid>> GetRemoteHashIndex(coro_yield_t& yield, std::vector<table_id_t> table_id, std::vector<itemkey_t> item_key);
+
   bool InsertHashIndex(coro_yield_t& yield, std::vector<table_id_t> table_id, std::vector<itemkey_t> item_key, std::vector<Rid> rids);
 
   bool DeleteHashIndex(coro_yield_t& yield, std::vector<table_id_t> table_id, std::vector<itemkey_t> item_key);
 
+  // for ordered index, 返回[lo, hi]范围内按key升序排列的前limit项
+  std::vector<std::pair<itemkey_t, Rid>> ScanIndex(coro_yield_t& yield, table_id_t table_id, itemkey_t lo, itemkey_t hi, size_t limit);
+
+  // key已经存在时覆盖它的Rid, 内存池中没有空闲节点时返回false
+  bool InsertBTreeIndex(coro_yield_t& yield, table_id_t table_id, itemkey_t key, Rid rid);
+
+  bool DeleteBTreeIndex(coro_yield_t& yield, table_id_t table_id, itemkey_t key);
+
   // for lock table
   bool LockSharedOnTable(coro_yield_t& yield, std::vector<table_id_t> table_id);
   
@@ -141,7 +166,10 @@ class DTX {
     int size;
   };
   std::unordered_map<PageId, char*> FetchPage(coro_yield_t &yield, std::unordered_map<PageId, FetchPageType> ids, batch_id_t request_batch_id, std::vector<PageAddress>& page_addr_vec);
-  bool UnpinPage(coro_yield_t &yield, std::unordered_map<PageId, UnpinPageArgs> ids);
+  // 提前发起页面的地址转换和读取, 数据页的RDMA READ和存储层的GetPages请求发出后不等待完成,
+  // 之后对这些页面的FetchPage/FetchTuple直接使用已经发出的请求, 页面的FetchPageType需要与之后的FetchPage一致
+  void PrefetchPages(coro_yield_t &yield, std::vector<table_id_t> table_id, std::vector<Rid> rids, std::vector<FetchPageType> types, batch_id_t request_batch_id);
+  bool UnpinPage(coro_yield_t &yield, std::unordered_map<PageId, UnpinPageArgs> ids, batch_id_t request_batch_id);
   
   std::vector<DataItemPtr> FetchTuple(coro_yield_t &yield, std::vector<table_id_t> table_id, std::vector<Rid> rids, std::vector<FetchPageType> types, batch_id_t request_batch_id, std::vector<PageAddress>& page_addr_vec);
 
@@ -150,16 +178,77 @@ class DTX {
  private:
   // 用来记录每次要批获取hash node latch的offset
   std::unordered_set<NodeOffset> pending_hash_node_latch_offs;
+
+  // 有序索引的根节点编号, 根节点分裂之后旧的根仍然可以作为遍历的起点
+  std::unordered_map<table_id_t, int64_t> btree_root_cache;
   
+  // FetchPage在页表中pin住的页表项的位置, UnpinPage时不需要重新查找页表
+  // 页表项被pin住期间不会被淘汰, 位置不会改变
+  struct PinnedPageTableItem {
+    // 页表项所在的PageTableNode, 它的lock保护这个页表项
+    NodeOffset node_off;
+    int item_idx;
+    // pin时看到的dirty_batch_id, 作为unpin时CAS的预期值
+    batch_id_t dirty_batch_id;
+  };
+
+  // 已经发起读取, 还没有被FetchPage取走的页面
+  struct PrefetchedPage {
+    // 页面读取到的本地缓冲区, 页面正在被其他计算节点从磁盘读取时为nullptr
+    char* page;
+    PageAddress page_addr;
+    FetchPageType type;
+    // 页面从存储层读取, FetchPage取走时需要写入页表分配的frame
+    bool from_disk;
+  };
+  // 已经发出的GetPages请求, 失败时FetchPage用相同的参数重新发起, 从磁盘读到的页面只有成功之后才写入frame
+  struct PendingDiskRead {
+    std::vector<std::pair<std::string, page_id_t>> page_ids;
+    std::vector<char*> pages;
+    batch_id_t request_batch_id;
+    bool failed;
+  };
+  // 重新发起失败的GetPages请求, 直到全部成功
+  void WaitDiskReads(coro_yield_t &yield);
+  // 地址转换并pin住页面, 然后发出数据页的读取请求, 不等待读取完成
+  void IssuePageReads(coro_yield_t &yield, const std::unordered_map<PageId, FetchPageType>& ids, batch_id_t request_batch_id);
+  // 已经发出的预读探测, 协程不等待它完成, 之后的地址转换发现完成时把存在的页面一起装入共享内存池
+  struct PendingReadAhead {
+    std::vector<PageId> page_ids;
+    std::shared_ptr<ReadAheadProbe> probe;
+  };
+  // 把本次访问交给预读检测, 需要预读时通知存储层把页面读入page cache
+  void IssueReadAhead(const std::vector<std::pair<PageId, bool>>& accesses);
+  void DropReadAheads();
+  // 把探测完成的预读页面加入本次请求的地址转换
+  void CollectReadAheadPages(const std::unordered_map<PageId, FetchPageType>& ids, std::vector<PageId>& table_page_ids, std::vector<bool>& table_is_write);
+  // 把预读的页面写入分配的frame并unpin
+  void InstallReadAheadPages(coro_yield_t &yield, batch_id_t request_batch_id);
+
   // for page table
+  // 空闲frame先从本线程的弹匣中分配, 弹匣不足时从页表节点的环形缓冲区批量补充
+  void PostRingSlotsReq(RCQP* qp, offset_t ring_base_off, uint64_t pos, size_t num, char* local_slots, bool is_read);
+  struct FrameRingAccessor;
+  void RefillFrameMagazine(coro_yield_t& yield, node_id_t node_id, size_t need_num);
+  void ReserveFreePageSlots(coro_yield_t& yield, size_t need_num);
   PageAddress GetFreePageSlot();
-  PageAddress InsertPageTableIntoHashNodeList(std::unordered_map<NodeOffset, char*>& local_hash_nodes, 
+  PageAddress InsertPageTableIntoHashNodeList(coro_yield_t& yield, std::unordered_map<NodeOffset, char*>& local_hash_nodes, 
         PageId page_id, bool is_write, NodeOffset last_node_off, 
-         std::unordered_map<NodeOffset, NodeOffset>& hold_latch_to_previouse_node_off);
+         std::unordered_map<NodeOffset, NodeOffset>& hold_latch_to_previouse_node_off, NodeOffset& item_node_off, int& item_idx);
          
+  NodeOffset GetPageTableBucketOff(PageId page_id);
+  // 只读请求的乐观查页表路径, 命中的页面只需要一次读桶和一次rwcount的FAA, 不获取桶的排他latch
+  void OptimisticGetPageAddr(coro_yield_t& yield, std::vector<PageId>& page_ids, std::vector<bool>& is_write, 
+      std::unordered_map<PageId, PageAddress>& res, std::unordered_map<PageId,bool>& need_fetch_from_disk, std::unordered_map<PageId,bool>& now_valid);
   std::vector<PageAddress> GetPageAddrOrAddIntoPageTable(coro_yield_t& yield, std::vector<PageId> page_ids, 
       std::unordered_map<PageId,bool>& need_fetch_from_disk, std::unordered_map<PageId,bool>& now_valid, std::vector<bool> is_write);
-  void UnpinPageTable(coro_yield_t& yield, std::vector<PageId> page_ids, std::vector<bool> is_write);
+  void UnpinPageTable(coro_yield_t& yield, std::vector<PageId> page_ids, std::vector<bool> is_write, std::vector<bool> is_dirty, batch_id_t batch_id);
+  // 对在本DTX中pin住的页表项, 在桶的共享latch保护下直接FAA rwcount, 和数据页的写回一起按节点doorbell批量发出
+  // 返回无法走这条路径的页面, 由UnpinPageTable处理
+  std::vector<PageId> BatchUnpinPinnedItems(coro_yield_t& yield, std::vector<PageId>& page_ids, std::unordered_map<PageId, UnpinPageArgs>& ids, 
+      std::unordered_map<node_id_t, ChainedDoorbellBatch>& data_write_batches, batch_id_t batch_id);
+  // CAS dirty_batch_id失败并且远端的值仍然比batch_id小时, 在桶的共享latch下重试, 直到远端的值不小于batch_id
+  void RaiseDirtyBatchId(coro_yield_t& yield, std::vector<PinnedPageTableItem> items, batch_id_t batch_id);
 
   // for private function for LockManager, 实际执行批量加锁的函数
   std::vector<LockDataId> LockShared(coro_yield_t& yield, std::vector<LockDataId> lock_data_id, std::vector<NodeOffset> node_offs);
@@ -171,14 +260,34 @@ class DTX {
   bool UnlockExclusive(coro_yield_t& yield, std::vector<LockDataId> lock_data_id, std::vector<NodeOffset> node_offs);
 
   // for rwlatch in hash node
+  // node_size是桶的大小, 加latch的同时读取整个桶, 排他latch释放时写回除lock之外的整个桶
   std::vector<NodeOffset> ShardLockHashNode(coro_yield_t& yield, std::unordered_map<NodeOffset, char*>& local_hash_nodes, 
-            std::unordered_map<NodeOffset, char*>& faa_bufs);
+            std::unordered_map<NodeOffset, char*>& faa_bufs, size_t node_size);
   void ShardUnLockHashNode(NodeOffset node_off);
+  void ShardUnLockHashNodeBatch(coro_yield_t& yield, const std::vector<NodeOffset>& node_offs);
+  // 哈希索引的查找不加latch, 读取之后检查桶的version
+  std::vector<NodeOffset> OptimisticReadHashNode(coro_yield_t& yield, std::unordered_map<NodeOffset, char*>& local_hash_nodes);
   // Exclusive lock hash node 是一个关键路径，因此需要切换到其他协程，也需要记录下来哪些桶已经上锁成功以及RDMA操作返回值在本机的地址
   std::vector<NodeOffset> ExclusiveLockHashNode(coro_yield_t& yield, std::unordered_map<NodeOffset, char*>& local_hash_nodes, 
-            std::unordered_map<NodeOffset, char*>& cas_bufs);
+            std::unordered_map<NodeOffset, char*>& cas_bufs, size_t node_size);
   void ExclusiveUnlockHashNode_NoWrite(NodeOffset node_off);
-  void ExclusiveUnlockHashNode_WithWrite(NodeOffset node_off, char* write_back_data);
+  void ExclusiveUnlockHashNode_WithWrite(NodeOffset node_off, char* write_back_data, size_t node_size);
+  void ExclusiveUnlockHashNodeBatch_WithWrite(coro_yield_t& yield, const std::unordered_set<NodeOffset>& node_offs, 
+            std::unordered_map<NodeOffset, char*>& local_hash_nodes, size_t node_size);
+  // 同一个内存节点的请求串成一个doorbell, 只有最后一个请求signaled
+  void SendDoorbellBatches(coro_yield_t& yield, std::unordered_map<node_id_t, ChainedDoorbellBatch>& batches);
+
+  // for B+-tree node, btree_node_id是节点在索引区域中的编号
+  // 读取索引头部并更新缓存的根
+  BTreeHeader* ReadBTreeHeader(coro_yield_t& yield, table_id_t table_id);
+  int64_t GetBTreeRoot(coro_yield_t& yield, table_id_t table_id, bool refresh);
+  BTreeNode* ReadBTreeNode(coro_yield_t& yield, table_id_t table_id, int64_t btree_node_id);
+  // 对负责key的节点加排他latch, 加latch之前节点可能已经分裂, 沿sibling_id向右移动, btree_node_id返回最终加latch的节点
+  BTreeNode* LockBTreeNode(coro_yield_t& yield, table_id_t table_id, itemkey_t key, int64_t& btree_node_id);
+  int64_t AllocBTreeNode(coro_yield_t& yield, table_id_t table_id);
+  // 从根遍历到level层负责key的节点, 不加latch, 节点已经分配完并且树没有level层时返回BTREE_NULL_NODE
+  int64_t TraverseBTree(coro_yield_t& yield, table_id_t table_id, itemkey_t key, uint16_t level, BTreeNode*& node);
+  bool InsertBTreeLevel(coro_yield_t& yield, table_id_t table_id, itemkey_t key, uint64_t value, uint16_t level, int64_t btree_node_id);
 
   DataItemPtr GetDataItemFromPage(table_id_t table_id, char* data, Rid rid);
 
@@ -245,8 +354,38 @@ class DTX {
   // Global <key, lock> lock table
   LockCache* global_lcache;
 
-  std::list<PageAddress>* free_page_list;
-  std::mutex* free_page_list_mutex;
+  // Thread-local free frames, shared by all coroutines of this thread
+  FrameMagazine* frame_magazine;
+
+  // Node-wide client of the storage pool, shared by all threads
+  StorageClient* storage_client;
+
+  // Node-wide PageId -> PageAddress cache, shared by all threads
+  PageAddrCache* page_addr_cache;
+
+  // 通过页地址缓存获取, 没有在页表中pin的页面
+  std::unordered_set<PageId> lease_pages;
+
+  // FetchPage在页表中pin住的页表项, UnpinPage时不需要重新查找页表
+  std::unordered_map<PageId, PinnedPageTableItem> pinned_page_items;
+
+  // PrefetchPages发起读取的页面
+  std::unordered_map<PageId, PrefetchedPage> prefetched_pages;
+
+  // 还没有被FetchPage确认成功的GetPages请求, std::list保证请求期间failed的地址不变
+  std::list<PendingDiskRead> pending_disk_reads;
+
+  // Thread-local sequential read-ahead detector, shared by all coroutines of this thread
+  ReadAheadDetector* read_ahead_detector;
+
+  // Node-wide key -> Rid cache of the hash index, shared by all threads
+  IndexCache* index_cache;
+
+  // 还没有完成探测的预读请求
+  std::list<PendingReadAhead> pending_read_aheads;
+
+  // 已经在页表中pin住, 等待写入frame并unpin的预读页面
+  std::unordered_map<PageId, PrefetchedPage> read_ahead_installs;
 };
 
 /*************************************************************
@@ -0,0 +1,227 @@
+#include "dtx/dtx.h"
+
+#include <cstddef>
+
+// 有序索引(B-link树)的远程操作, 节点布局和节点内的查找见memstore/btree_index_store.h
+// 读者不加latch, 每层读取一个节点, 头尾version不一致时重新读取, key不在节点的范围内时沿sibling_id向右移动
+// 范围扫描的round trip数是树高加上扫描的叶子数
+// 写者对叶子加排他latch, 分裂时持有子节点的latch向上插入分隔key, latch总是从低层到高层获取
+
+BTreeHeader* DTX::ReadBTreeHeader(coro_yield_t& yield, table_id_t table_id) {
+    auto btree_meta = global_meta_man->GetBTreeIndexMeta(table_id);
+    auto remote_node_id = global_meta_man->GetBTreeIndexNode(table_id);
+    char* header_buf = thread_rdma_buffer_alloc->Alloc(sizeof(BTreeHeader));
+    if (!coro_sched->RDMARead(coro_id, thread_qp_man->GetRemoteDataQPWithNodeID(remote_node_id), header_buf, btree_meta.base_off, sizeof(BTreeHeader))) {
+        assert(false);
+    }
+    coro_sched->Yield(yield, coro_id);
+    BTreeHeader* header = (BTreeHeader*)header_buf;
+    btree_root_cache[table_id] = header->root_id;
+    return header;
+}
+
+int64_t DTX::GetBTreeRoot(coro_yield_t& yield, table_id_t table_id, bool refresh) {
+    if(!refresh){
+        auto search = btree_root_cache.find(table_id);
+        if(search != btree_root_cache.end()) return search->second;
+    }
+    return ReadBTreeHeader(yield, table_id)->root_id;
+}
+
+BTreeNode* DTX::ReadBTreeNode(coro_yield_t& yield, table_id_t table_id, int64_t btree_node_id) {
+    auto btree_meta = global_meta_man->GetBTreeIndexMeta(table_id);
+    auto remote_node_id = global_meta_man->GetBTreeIndexNode(table_id);
+    offset_t node_off = BTreeIndexStore::GetNodeOff(btree_meta.base_off, btree_node_id);
+    char* node_buf = thread_rdma_buffer_alloc->Alloc(sizeof(BTreeNode));
+    while (true) {
+        if (!coro_sched->RDMARead(coro_id, thread_qp_man->GetRemoteDataQPWithNodeID(remote_node_id), node_buf, node_off, sizeof(BTreeNode))) {
+            assert(false);
+        }
+        coro_sched->Yield(yield, coro_id);
+        BTreeNode* node = (BTreeNode*)node_buf;
+        // 读到了写者正在写回的节点, 重新读取
+        if(node->version == node->rear_version) return node;
+    }
+}
+
+BTreeNode* DTX::LockBTreeNode(coro_yield_t& yield, table_id_t table_id, itemkey_t key, int64_t& btree_node_id) {
+    auto btree_meta = global_meta_man->GetBTreeIndexMeta(table_id);
+    auto remote_node_id = global_meta_man->GetBTreeIndexNode(table_id);
+    RCQP* qp = thread_qp_man->GetRemoteDataQPWithNodeID(remote_node_id);
+    char* cas_buf = thread_rdma_buffer_alloc->Alloc(sizeof(lock_t));
+    char* node_buf = thread_rdma_buffer_alloc->Alloc(sizeof(BTreeNode));
+    while (true) {
+        offset_t node_off = BTreeIndexStore::GetNodeOff(btree_meta.base_off, btree_node_id);
+        std::shared_ptr<ExclusiveLock_SharedMutex_Batch> doorbell = std::make_shared<ExclusiveLock_SharedMutex_Batch>();
+        doorbell->SetLockReq(cas_buf, node_off);
+        doorbell->SetReadReq(node_buf, node_off, sizeof(BTreeNode));
+        if (!doorbell->SendReqs(coro_sched, qp, coro_id)) {
+            RDMA_LOG(ERROR) << "LockBTreeNode get Exclusive mutex sendreqs failed";
+            assert(false);
+        }
+        // 切换到其他协程，等待其他协程释放锁
+        coro_sched->Yield(yield, coro_id);
+        if(*(lock_t*)cas_buf != UNLOCKED) continue;
+
+        BTreeNode* node = (BTreeNode*)node_buf;
+        if(!BTreeIndexStore::NeedMoveRight(node, key)) return node;
+        // 加latch之前节点已经分裂, key在右兄弟中
+        ExclusiveUnlockHashNode_NoWrite(NodeOffset{remote_node_id, node_off});
+        btree_node_id = node->sibling_id;
+    }
+}
+
+int64_t DTX::AllocBTreeNode(coro_yield_t& yield, table_id_t table_id) {
+    auto btree_meta = global_meta_man->GetBTreeIndexMeta(table_id);
+    auto remote_node_id = global_meta_man->GetBTreeIndexNode(table_id);
+    char* faa_buf = thread_rdma_buffer_alloc->Alloc(sizeof(uint64_t));
+    if (!coro_sched->RDMAFAA(coro_id, thread_qp_man->GetRemoteDataQPWithNodeID(remote_node_id), faa_buf,
+            btree_meta.base_off + offsetof(BTreeHeader, next_free_id), 1)) {
+        assert(false);
+    }
+    coro_sched->Yield(yield, coro_id);
+    uint64_t btree_node_id = *(uint64_t*)faa_buf;
+    if(btree_node_id >= btree_meta.max_node_num){
+        RDMA_LOG(ERROR) << "B+-tree index of table " << table_id << " runs out of nodes";
+        return BTREE_NULL_NODE;
+    }
+    return (int64_t)btree_node_id;
+}
+
+int64_t DTX::TraverseBTree(coro_yield_t& yield, table_id_t table_id, itemkey_t key, uint16_t level, BTreeNode*& node) {
+    int64_t btree_node_id = GetBTreeRoot(yield, table_id, false);
+    node = ReadBTreeNode(yield, table_id, btree_node_id);
+    while(node->level < level){
+        // 缓存的根已经不是根了, 重新读取头部
+        // 向上插入分隔key时, 另一个写者可能分裂了同一层的根节点, 持有旧根的latch但还没有写入新的根,
+        // 它一定会写入新的根, 所以一直重新读取直到根高于level, 除非节点已经分配完, 新的根无法分配
+        BTreeHeader* header = ReadBTreeHeader(yield, table_id);
+        if(header->next_free_id >= header->max_node_num) return BTREE_NULL_NODE;
+        btree_node_id = header->root_id;
+        node = ReadBTreeNode(yield, table_id, btree_node_id);
+    }
+    while (true) {
+        if(BTreeIndexStore::NeedMoveRight(node, key)){
+            btree_node_id = node->sibling_id;
+        }
+        else if(node->level == level){
+            return btree_node_id;
+        }
+        else{
+            btree_node_id = BTreeIndexStore::FindChild(node, key);
+        }
+        node = ReadBTreeNode(yield, table_id, btree_node_id);
+    }
+}
+
+std::vector<std::pair<itemkey_t, Rid>> DTX::ScanIndex(coro_yield_t& yield, table_id_t table_id, itemkey_t lo, itemkey_t hi, size_t limit) {
+    std::vector<std::pair<itemkey_t, Rid>> res;
+    if(lo > hi || limit == 0) return res;
+
+    BTreeNode* leaf;
+    TraverseBTree(yield, table_id, lo, 0, leaf);
+    // 叶子的lowest不会改变, 后续叶子中的key都不小于前一个叶子读到时的highest, 不会重复返回
+    while (BTreeIndexStore::ScanLeaf(leaf, lo, hi, limit, res)) {
+        leaf = ReadBTreeNode(yield, table_id, leaf->sibling_id);
+    }
+    return res;
+}
+
+bool DTX::InsertBTreeIndex(coro_yield_t& yield, table_id_t table_id, itemkey_t key, Rid rid) {
+    assert(key != BTREE_KEY_MAX);
+    BTreeNode* leaf;
+    int64_t leaf_id = TraverseBTree(yield, table_id, key, 0, leaf);
+    return InsertBTreeLevel(yield, table_id, key, BTreeIndexStore::PackRid(rid), 0, leaf_id);
+}
+
+bool DTX::InsertBTreeLevel(coro_yield_t& yield, table_id_t table_id, itemkey_t key, uint64_t value, uint16_t level, int64_t btree_node_id) {
+    auto btree_meta = global_meta_man->GetBTreeIndexMeta(table_id);
+    auto remote_node_id = global_meta_man->GetBTreeIndexNode(table_id);
+    RCQP* qp = thread_qp_man->GetRemoteDataQPWithNodeID(remote_node_id);
+
+    BTreeNode* node = LockBTreeNode(yield, table_id, key, btree_node_id);
+    NodeOffset node_off{remote_node_id, BTreeIndexStore::GetNodeOff(btree_meta.base_off, btree_node_id)};
+    if(BTreeIndexStore::InsertEntry(node, key, value)){
+        node->version++;
+        node->rear_version = node->version;
+        ExclusiveUnlockHashNode_WithWrite(node_off, (char*)node, sizeof(BTreeNode));
+        return true;
+    }
+
+    // 节点已满, 分裂到新分配的右兄弟
+    int64_t right_id = AllocBTreeNode(yield, table_id);
+    if(right_id == BTREE_NULL_NODE){
+        ExclusiveUnlockHashNode_NoWrite(node_off);
+        return false;
+    }
+    BTreeNode* right = (BTreeNode*)thread_rdma_buffer_alloc->Alloc(sizeof(BTreeNode));
+    itemkey_t sep = BTreeIndexStore::SplitNode(node, right, right_id);
+    bool inserted = BTreeIndexStore::InsertEntry(key < sep ? node : right, key, value);
+    assert(inserted);
+
+    // 先写入完整的右兄弟, 再写回左节点, 读者经过左节点的sibling_id时右兄弟已经可读
+    if (!coro_sched->RDMAWrite(coro_id, qp, (char*)right, BTreeIndexStore::GetNodeOff(btree_meta.base_off, right_id), sizeof(BTreeNode))) {
+        assert(false);
+    }
+    coro_sched->Yield(yield, coro_id);
+    node->version++;
+    node->rear_version = node->version;
+    // 不写lock, 继续持有左节点的latch直到分隔key插入父节点
+    if (!coro_sched->RDMAWrite(coro_id, qp, (char*)node + sizeof(lock_t), node_off.offset + sizeof(lock_t), sizeof(BTreeNode) - sizeof(lock_t))) {
+        assert(false);
+    }
+
+    bool ret = true;
+    if(GetBTreeRoot(yield, table_id, true) == btree_node_id){
+        // 分裂的是根节点, 持有旧根的latch, 没有其他写者同时修改根指针
+        int64_t root_id = AllocBTreeNode(yield, table_id);
+        if(root_id == BTREE_NULL_NODE){
+            // 右兄弟仍然可以通过旧根的sibling_id访问到
+            ret = false;
+        }
+        else{
+            BTreeNode* root = (BTreeNode*)thread_rdma_buffer_alloc->Alloc(sizeof(BTreeNode));
+            BTreeIndexStore::InitNode(root, level + 1, 0, BTREE_KEY_MAX);
+            root->leftmost_child = btree_node_id;
+            BTreeIndexStore::InsertEntry(root, sep, (uint64_t)right_id);
+            if (!coro_sched->RDMAWrite(coro_id, qp, (char*)root, BTreeIndexStore::GetNodeOff(btree_meta.base_off, root_id), sizeof(BTreeNode))) {
+                assert(false);
+            }
+            coro_sched->Yield(yield, coro_id);
+            char* root_buf = thread_rdma_buffer_alloc->Alloc(sizeof(int64_t));
+            *(int64_t*)root_buf = root_id;
+            if (!coro_sched->RDMAWrite(coro_id, qp, root_buf, btree_meta.base_off + offsetof(BTreeHeader, root_id), sizeof(int64_t))) {
+                assert(false);
+            }
+            coro_sched->Yield(yield, coro_id);
+            btree_root_cache[table_id] = root_id;
+        }
+    }
+    else{
+        BTreeNode* parent;
+        int64_t parent_id = TraverseBTree(yield, table_id, sep, level + 1, parent);
+        // 新的根没有分配成功时, 右兄弟仍然可以通过sibling_id访问到
+        ret = parent_id != BTREE_NULL_NODE && InsertBTreeLevel(yield, table_id, sep, (uint64_t)right_id, level + 1, parent_id);
+    }
+    ExclusiveUnlockHashNode_NoWrite(node_off);
+    return ret;
+}
+
+bool DTX::DeleteBTreeIndex(coro_yield_t& yield, table_id_t table_id, itemkey_t key) {
+    auto btree_meta = global_meta_man->GetBTreeIndexMeta(table_id);
+    auto remote_node_id = global_meta_man->GetBTreeIndexNode(table_id);
+
+    BTreeNode* leaf;
+    int64_t leaf_id = TraverseBTree(yield, table_id, key, 0, leaf);
+    leaf = LockBTreeNode(yield, table_id, key, leaf_id);
+    NodeOffset node_off{remote_node_id, BTreeIndexStore::GetNodeOff(btree_meta.base_off, leaf_id)};
+    // 节点不合并, 只移除叶子中的项
+    if(!BTreeIndexStore::RemoveEntry(leaf, key)){
+        ExclusiveUnlockHashNode_NoWrite(node_off);
+        return false;
+    }
+    leaf->version++;
+    leaf->rear_version = leaf->version;
+    ExclusiveUnlockHashNode_WithWrite(node_off, (char*)leaf, sizeof(BTreeNode));
+    return true;
+}
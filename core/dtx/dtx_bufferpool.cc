@@ -1,15 +1,7 @@
-#include <brpc/channel.h>
 #include "dtx/dtx.h"
-#include "storage/storage_service.pb.h"
+#include "storage/storage_client.h"
 #include "log/record.h"
 
-DEFINE_string(protocol, "baidu_std", "Protocol type");
-DEFINE_string(connection_type, "", "Connection type. Available values: single, pooled, short");
-DEFINE_string(server, "127.0.0.1:12348", "IP address of server");
-DEFINE_int32(timeout_ms, 0x7fffffff, "RPC timeout in milliseconds");
-DEFINE_int32(max_retry, 3, "Max retries(not including the first RPC)");
-DEFINE_int32(interval_ms, 10, "Milliseconds between consecutive requests");
-
 // 在页表中添加数据项的基本逻辑：
 // 1. 如果Fetch的Page在页表中，则需要针对Fetch的类型进行判断是否可以读取，是否需要更改wlatch的状态
 // 2. 如果Fetch的Page不在页表中，并且是一个增加record或删除record的操作，则必须需要将该Page加入页表中，防止多个对页面的修改造成的冲突，
@@ -28,116 +20,299 @@ DEFINE_int32(interval_ms, 10, "Milliseconds between consecutive requests");
 // 只有当页面的pin count为0时，才可以将该页面从页表中删除
 // 存在一个后台线程，定期扫描页表，将pin count为0并且超时的页面从页表中删除
 
-// 返回的page_addr_vec中的PageAddress是作为返回值使用，因此传入空vector即可
-std::unordered_map<PageId, char*> DTX::FetchPage(coro_yield_t &yield, std::unordered_map<PageId, FetchPageType> ids, batch_id_t request_batch_id, std::vector<PageAddress>& page_addr_vec){
-    std::vector<PageId> page_ids;
-    std::unordered_map<PageId, bool> need_fetch_from_disk;
-    std::unordered_map<PageId, bool> now_valid;
-    std::vector<bool> is_write;
-    // to store res
-    std::unordered_map<PageId, char*> pages;
+// 地址转换并发出读取请求, 结果记录在prefetched_pages中, 由FetchPage等待完成并取走
+// 页地址缓存命中的页面不依赖页表, 在访问页表之前就发出读取, 与其他页面的地址转换重叠
+// 已经完成探测的预读页面搭本次请求的便车, 一起做地址转换并合并到同一个GetPages请求中
+void DTX::IssuePageReads(coro_yield_t &yield, const std::unordered_map<PageId, FetchPageType>& ids, batch_id_t request_batch_id){
+    std::vector<PageId> table_page_ids;
+    std::vector<bool> table_is_write;
+    // 交给预读检测的访问, bool表示是否需要从存储层读取
+    std::vector<std::pair<PageId, bool>> accesses;
     for(auto id : ids){
-        page_ids.push_back(id.first);
+        bool is_write;
         if(id.second == FetchPageType::kReadPage || id.second == FetchPageType::kUpdateRecord){
             // 这两种类型的操作，无页面粒度的写入冲突，因此不需要检查wlatch的状态
             // 如果不在页表，则顺便将该页面加入页表，并将valid状态置为false，wlatch状态置为false, rcount+1
-            is_write.push_back(true);
+            is_write = false;
         }
         else if(id.second == FetchPageType::kInsertRecord || id.second == FetchPageType::kDeleteRecord ){
             // 如果不在页表，则顺便将该页面加入页表，并将valid状态置为false，wlatch状态置为true, wcount+1
-            is_write.push_back(false);
+            is_write = true;
         }
         else{
             assert(false);
         }
+        PageAddress cached_addr;
+        if(id.second == FetchPageType::kReadPage && page_addr_cache->Search(id.first, cached_addr)){
+            // 租约保证frame在租约内不会被回收, 不需要pin, UnpinPage时也不需要访问页表
+            lease_pages.insert(id.first);
+            char* page = thread_rdma_buffer_alloc->Alloc(PAGE_SIZE);
+            RCQP* qp = thread_qp_man->GetRemoteDataQPWithNodeID(cached_addr.node_id);
+            if(!coro_sched->RDMARead(coro_id, qp, page, global_meta_man->GetDataOff(cached_addr.node_id) + cached_addr.frame_id * PAGE_SIZE, PAGE_SIZE)){
+                assert(false);
+            }
+            prefetched_pages[id.first] = {page, cached_addr, id.second, false};
+            accesses.emplace_back(id.first, false);
+        }
+        else{
+            table_page_ids.push_back(id.first);
+            table_is_write.push_back(is_write);
+            lease_pages.erase(id.first);
+        }
     }
-    page_addr_vec = GetPageAddrOrAddIntoPageTable(yield, page_ids, need_fetch_from_disk, now_valid, is_write);
-    
-    for(int i=0; i<need_fetch_from_disk.size(); i++) {
-        if (need_fetch_from_disk[page_ids[i]]) {
-            // 从磁盘中读取数据页
-            brpc::ChannelOptions options;
-            brpc::Channel channel;
-            
-            options.use_rdma = true;
-            options.protocol = FLAGS_protocol;
-            options.connection_type = FLAGS_connection_type;
-            options.timeout_ms = FLAGS_timeout_ms;
-            options.max_retry = FLAGS_max_retry;
-            if(channel.Init(FLAGS_server.c_str(), &options) != 0) {
-                RDMA_LOG(FATAL) << "Fail to initialize channel";
+    size_t demand_page_num = table_page_ids.size();
+    if(demand_page_num == 0 && !ids.empty()){
+        page_addr_cache->AddSavedRoundTrips(PAGE_TABLE_PIN_ROUND_TRIPS);
+    }
+    // 每次都取走探测完成的预读页面, 本次请求全部命中页地址缓存时预读的页面单独做地址转换
+    CollectReadAheadPages(ids, table_page_ids, table_is_write);
+    if(table_page_ids.empty()){
+        IssueReadAhead(accesses);
+        return;
+    }
+
+    std::unordered_map<PageId, bool> need_fetch_from_disk;
+    std::unordered_map<PageId, bool> now_valid;
+    std::vector<PageAddress> table_addr_vec = GetPageAddrOrAddIntoPageTable(yield, table_page_ids, need_fetch_from_disk, now_valid, table_is_write);
+
+    // 所有缺失的页面合并成一个GetPages请求, 与共享内存池的读请求一起发出
+    std::vector<std::pair<std::string, page_id_t>> disk_page_ids;
+    std::vector<char*> disk_pages;
+    for(int i=0; i<table_page_ids.size(); i++) {
+        auto& page_id = table_page_ids[i];
+        auto& page_addr = table_addr_vec[i];
+        char* page = nullptr;
+        if (need_fetch_from_disk[page_id]) {
+            page = thread_rdma_buffer_alloc->Alloc(PAGE_SIZE);
+            disk_page_ids.emplace_back(global_meta_man->GetTableName(page_id.table_id), page_id.page_no);
+            disk_pages.push_back(page);
+        }
+        else if(i < demand_page_num && now_valid[page_id] == true){
+            // 从共享内存池中读取数据页
+            RCQP* qp = thread_qp_man->GetRemoteDataQPWithNodeID(page_addr.node_id);
+            page = thread_rdma_buffer_alloc->Alloc(PAGE_SIZE);
+            if(!coro_sched->RDMARead(coro_id, qp, page, global_meta_man->GetDataOff(page_addr.node_id) + page_addr.frame_id * PAGE_SIZE, PAGE_SIZE)){
+                assert(false);
             }
-            storage_service::StorageService_Stub stub(&channel);
+        }
+        if(i < demand_page_num){
+            prefetched_pages[page_id] = {page, page_addr, ids.at(page_id), need_fetch_from_disk[page_id]};
+            accesses.emplace_back(page_id, need_fetch_from_disk[page_id]);
+        }
+        else{
+            // 预读的页面已经在共享内存池中时只需要unpin
+            read_ahead_installs[page_id] = {page, page_addr, FetchPageType::kReadPage, need_fetch_from_disk[page_id]};
+        }
+    }
+    // 从磁盘中读取数据页, 复用计算节点共享的StorageClient
+    if(!disk_page_ids.empty()){
+        pending_disk_reads.push_back({disk_page_ids, disk_pages, request_batch_id, false});
+        auto& disk_read = pending_disk_reads.back();
+        storage_client->AsyncGetPages(coro_sched, coro_id, disk_read.page_ids, request_batch_id, disk_read.pages, &disk_read.failed);
+    }
+    IssueReadAhead(accesses);
+}
+
+// 调用者已经Yield等待了所有的GetPages请求
+// 失败的请求读到的页面不能写入frame, 否则其他计算节点会读到错误的数据, 这里重新发起直到成功,
+// 期间这些页面在页表中仍然是page_valid=false, 其他访问者等待
+void DTX::WaitDiskReads(coro_yield_t &yield){
+    while(true){
+        bool retry = false;
+        for(auto& disk_read : pending_disk_reads){
+            if(!disk_read.failed) continue;
+            RDMA_LOG(WARNING) << "GetPages of " << disk_read.page_ids.size() << " pages fails, retry";
+            storage_client->AsyncGetPages(coro_sched, coro_id, disk_read.page_ids, disk_read.request_batch_id, disk_read.pages, &disk_read.failed);
+            retry = true;
+        }
+        if(!retry) break;
+        coro_sched->Yield(yield, coro_id);
+    }
+    pending_disk_reads.clear();
+}
 
-            storage_service::GetPageRequest request;
-            storage_service::GetPageResponse response;
-            brpc::Controller cntl;
+void DTX::IssueReadAhead(const std::vector<std::pair<PageId, bool>>& accesses){
+    if(read_ahead_detector == nullptr) return;
+    std::vector<PageId> read_ahead_page_ids;
+    read_ahead_detector->OnAccesses(coro_id, accesses, read_ahead_page_ids);
+    if(read_ahead_page_ids.empty()) return;
 
-            request.mutable_page_id()->set_table_name(global_meta_man->GetTableName(page_ids[i].table_id));
-            request.mutable_page_id()->set_page_no(page_ids[i].page_no);
+    std::vector<std::pair<std::string, page_id_t>> disk_page_ids;
+    for(auto& page_id : read_ahead_page_ids){
+        disk_page_ids.emplace_back(global_meta_man->GetTableName(page_id.table_id), page_id.page_no);
+    }
+    auto probe = std::make_shared<ReadAheadProbe>();
+    pending_read_aheads.push_back({read_ahead_page_ids, probe});
+    storage_client->AsyncReadAheadPages(disk_page_ids, probe);
+}
 
-            request.set_require_batch_id(request_batch_id);
-            
-            stub.GetPage(&cntl, &request, &response, NULL);
+// DTX结束时还没有取走的预读页面不再装入, 检测器不再把它们当作正在预读的页面
+void DTX::DropReadAheads(){
+    if(read_ahead_detector == nullptr) return;
+    for(auto& pending : pending_read_aheads){
+        for(auto& page_id : pending.page_ids){
+            read_ahead_detector->OnInstalled(coro_id, page_id.table_id, page_id.page_no, false);
+        }
+    }
+    pending_read_aheads.clear();
+}
 
-            const char *constPage = response.data().c_str();
-            char *page = thread_rdma_buffer_alloc->Alloc(PAGE_SIZE);
-            std::strcpy(page, constPage);
-            pages.emplace(page_ids[i], page);
+// 探测已经完成的预读页面以只读方式加入本次的地址转换, 超出表末尾的页面丢弃
+// 本DTX已经pin住或者正在读取的页面不预读, 否则它们的unpin会混在一起
+void DTX::CollectReadAheadPages(const std::unordered_map<PageId, FetchPageType>& ids, std::vector<PageId>& table_page_ids, std::vector<bool>& table_is_write){
+    std::unordered_set<PageId> collected;
+    for(auto it = pending_read_aheads.begin(); it != pending_read_aheads.end(); ){
+        if(!it->probe->done.load(std::memory_order_acquire)){
+            it++;
+            continue;
         }
-        else if(now_valid[page_ids[i]] == true){
-            // 从共享内存池中读取数据页
-            auto remote_node_id = page_addr_vec[i].node_id;
-            auto frame_id = page_addr_vec[i].frame_id;
-            
-            auto remote_offset = global_meta_man->GetDataOff(remote_node_id);
-            RCQP* qp = thread_qp_man->GetRemoteDataQPWithNodeID(remote_node_id);
-            
-            char* page = thread_rdma_buffer_alloc->Alloc(PAGE_SIZE);
-            if(!coro_sched->RDMARead(coro_id, qp, page, remote_offset + frame_id * PAGE_SIZE, PAGE_SIZE)){
-                assert(false);
+        for(size_t i = 0; i < it->page_ids.size(); i++){
+            auto& page_id = it->page_ids[i];
+            if(!it->probe->page_exists[i] || ids.count(page_id) != 0 || collected.count(page_id) != 0 || prefetched_pages.count(page_id) != 0 || 
+                    read_ahead_installs.count(page_id) != 0 || pinned_page_items.count(page_id) != 0 || lease_pages.count(page_id) != 0){
+                read_ahead_detector->OnInstalled(coro_id, page_id.table_id, page_id.page_no, false);
+                continue;
             }
-            pages.emplace(page_ids[i], page);
+            collected.insert(page_id);
+            table_page_ids.push_back(page_id);
+            table_is_write.push_back(false);
         }
+        it = pending_read_aheads.erase(it);
     }
+}
+
+// 预读的页面在地址转换时以page_valid=false插入页表并pin住, 和本次请求的缺页一起从存储层读取,
+// 这里把数据写入分配的frame并unpin, 页面变为valid
+void DTX::InstallReadAheadPages(coro_yield_t &yield, batch_id_t request_batch_id){
+    std::unordered_map<PageId, UnpinPageArgs> unpin_args;
+    for(auto& install : read_ahead_installs){
+        auto& page_id = install.first;
+        // 页面已经在共享内存池中, 只需要unpin, 不写入数据
+        int size = install.second.from_disk ? PAGE_SIZE : 0;
+        unpin_args[page_id] = {install.second.page_addr, FetchPageType::kReadPage, install.second.page, 0, size};
+        read_ahead_detector->OnInstalled(coro_id, page_id.table_id, page_id.page_no, install.second.from_disk);
+    }
+    read_ahead_installs.clear();
+    UnpinPage(yield, unpin_args, request_batch_id);
+}
+
+void DTX::PrefetchPages(coro_yield_t &yield, std::vector<table_id_t> table_id, std::vector<Rid> rids, std::vector<FetchPageType> types, batch_id_t request_batch_id){
+    assert(table_id.size() == rids.size());
+    assert(rids.size() == types.size());
+    std::unordered_map<PageId, FetchPageType> ids;
+    for(int i=0; i<rids.size(); i++){
+        PageId page_id;
+        page_id.table_id = table_id[i];
+        page_id.page_no = rids[i].page_no_;
+        // 已经在读取中的页面不重复发起
+        if(prefetched_pages.count(page_id) != 0) continue;
+        ids[page_id] = types[i];
+    }
+    IssuePageReads(yield, ids, request_batch_id);
+}
+
+// 返回的page_addr_vec中的PageAddress是作为返回值使用，因此传入空vector即可
+std::unordered_map<PageId, char*> DTX::FetchPage(coro_yield_t &yield, std::unordered_map<PageId, FetchPageType> ids, batch_id_t request_batch_id, std::vector<PageAddress>& page_addr_vec){
+    // 没有被预取的页面现在发起读取
+    std::unordered_map<PageId, FetchPageType> issue_ids;
+    for(auto id : ids){
+        auto it = prefetched_pages.find(id.first);
+        if(it == prefetched_pages.end()){
+            issue_ids.emplace(id);
+            continue;
+        }
+        // 预取时pin的类型需要和现在的请求一致
+        assert((it->second.type == FetchPageType::kInsertRecord || it->second.type == FetchPageType::kDeleteRecord) ==
+               (id.second == FetchPageType::kInsertRecord || id.second == FetchPageType::kDeleteRecord));
+    }
+    if(!issue_ids.empty()) IssuePageReads(yield, issue_ids, request_batch_id);
+
+    // 预取和刚刚发出的读取请求只Yield一次, 等待期间本线程的其他协程可以继续执行
     coro_sched->Yield(yield, coro_id);
+    WaitDiskReads(yield);
+
+    // to store res
+    std::unordered_map<PageId, char*> pages;
+    page_addr_vec.clear();
+    bool written_to_frame = false;
+    for(auto id : ids){
+        auto it = prefetched_pages.find(id.first);
+        assert(it != prefetched_pages.end());
+        auto& prefetched = it->second;
+        page_addr_vec.push_back(prefetched.page_addr);
+        if(prefetched.page != nullptr) pages.emplace(id.first, prefetched.page);
+        if(prefetched.from_disk){
+            // 将从磁盘读到的页面写入页表中分配的frame, 页面在UnpinPage时被置为valid
+            auto remote_offset = global_meta_man->GetDataOff(prefetched.page_addr.node_id);
+            RCQP* qp = thread_qp_man->GetRemoteDataQPWithNodeID(prefetched.page_addr.node_id);
+            if(!coro_sched->RDMAWrite(coro_id, qp, prefetched.page, remote_offset + prefetched.page_addr.frame_id * PAGE_SIZE, PAGE_SIZE)){
+                assert(false);
+            }
+            written_to_frame = true;
+        }
+        prefetched_pages.erase(it);
+    }
+    // 预读的页面写入frame并unpin, 页表的round trip同时也等待了上面的写入
+    if(!read_ahead_installs.empty()) InstallReadAheadPages(yield, request_batch_id);
+    if(written_to_frame) coro_sched->Yield(yield, coro_id);
     return pages;
 }
 
-bool DTX::UnpinPage(coro_yield_t &yield, std::unordered_map<PageId, UnpinPageArgs> ids){
+bool DTX::UnpinPage(coro_yield_t &yield, std::unordered_map<PageId, UnpinPageArgs> ids, batch_id_t request_batch_id){
 
     std::vector<PageId> page_ids;
-    std::vector<bool> is_write;
     for(auto id : ids){
+        // 通过页地址缓存获取的页面没有在页表中pin, 只需要写回数据
+        if(lease_pages.erase(id.first) != 0) continue;
         page_ids.push_back(id.first);
-        if(id.second.type == FetchPageType::kReadPage || id.second.type == FetchPageType::kUpdateRecord){
-            // 这两种类型的操作，无页面粒度的写入冲突，因此不需要检查wlatch的状态
-            // 如果不在页表，则顺便将该页面加入页表，并将valid状态置为false，wlatch状态置为false, rcount+1
-            is_write.push_back(true);
-        }
-        else if(id.second.type == FetchPageType::kInsertRecord || id.second.type == FetchPageType::kDeleteRecord ){
-            // 如果不在页表，则顺便将该页面加入页表，并将valid状态置为false，wlatch状态置为true, wcount+1
-            is_write.push_back(false);
-        }
-        else{
-            assert(false);
-        }
     }
 
+    // 数据页的写回按内存节点放入doorbell, 和页表的unpin请求一起发出
+    std::unordered_map<node_id_t, ChainedDoorbellBatch> data_write_batches;
     for(auto id:ids){
         char* page = id.second.page;
         auto remote_node_id = id.second.page_addr.node_id;
-
+        // 预读时页面已经在共享内存池中, 只需要unpin
+        if(id.second.size == 0) continue;
         auto remote_base_offset = global_meta_man->GetDataOff(remote_node_id);
-        RCQP* qp = thread_qp_man->GetRemoteDataQPWithNodeID(remote_node_id);  
-        
         // write back, TODO: 写入page的两个slot应该对接口做出一定的修改
-        if(!coro_sched->RDMAWrite(coro_id, qp, page+id.second.offset, id.second.offset + remote_base_offset + id.second.page_addr.frame_id * PAGE_SIZE, id.second.size)){ 
-            assert(false); 
+        data_write_batches[remote_node_id].AddWriteReq(page+id.second.offset, id.second.offset + remote_base_offset + id.second.page_addr.frame_id * PAGE_SIZE, id.second.size);
+    }
+
+    if(page_ids.empty()){
+        for(auto& batch : data_write_batches){
+            if (!batch.second.SendReqs(coro_sched, thread_qp_man->GetRemoteDataQPWithNodeID(batch.first), coro_id, yield)) {
+                assert(false);
+            }
         }
+        if(!ids.empty()) page_addr_cache->AddSavedRoundTrips(PAGE_TABLE_UNPIN_ROUND_TRIPS);
+        return true;
+    }
+
+    std::vector<PageId> fallback_page_ids = BatchUnpinPinnedItems(yield, page_ids, ids, data_write_batches, request_batch_id);
+    for(auto& page_id : page_ids){
+        pinned_page_items.erase(page_id);
     }
+    if(fallback_page_ids.empty()) return true;
 
-    UnpinPageTable(yield, page_ids, is_write);
+    std::vector<bool> is_write;
+    // 除了只读之外的操作都修改了页面, 页表中记录修改页面的batch, 存储层重放这个batch之前frame不能被回收
+    std::vector<bool> is_dirty;
+    for(auto& page_id : fallback_page_ids){
+        auto type = ids.at(page_id).type;
+        is_dirty.push_back(type != FetchPageType::kReadPage);
+        if(type == FetchPageType::kReadPage || type == FetchPageType::kUpdateRecord){
+            // 这两种类型的操作，无页面粒度的写入冲突，因此不需要检查wlatch的状态
+            is_write.push_back(false);
+        }
+        else if(type == FetchPageType::kInsertRecord || type == FetchPageType::kDeleteRecord ){
+            is_write.push_back(true);
+        }
+        else{
+            assert(false);
+        }
+    }
+    UnpinPageTable(yield, fallback_page_ids, is_write, is_dirty, request_batch_id);
     return true;
 }
     
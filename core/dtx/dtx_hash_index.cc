@@ -1,54 +1,74 @@
 #include "dtx/dtx.h"
 
-// 如果出现初始桶中没有itemkey的情况，似乎无法使用桶尾部的多个指针
-// 并行加多个锁，因为可能会造成死锁, 无法保证按顺序加锁
+// 查找不加latch: 每次读取整个桶并检查version, 读到不一致的桶时重新读取这个桶
+// 桶中没有要找的itemkey时继续读取链表上的下一个桶, 写者不会移动已经插入的索引项, 所以只需要保证每个桶自身一致
+// 先查找计算节点上的索引缓存, 只有未命中的itemkey需要读取远程索引, 读到的桶的version和找到的Rid填入缓存
 std::unordered_map<table_id_t, std::unordered_map<itemkey_t, Rid>> 
     DTX::GetHashIndex(coro_yield_t& yield, std::vector<table_id_t> table_id, std::vector<itemkey_t> item_key) {
     
+    std::unordered_map<table_id_t, std::unordered_map<itemkey_t, Rid>> res;
+    std::vector<table_id_t> miss_table_id;
+    std::vector<itemkey_t> miss_item_key;
+    for(int i=0; i<table_id.size(); i++){
+        Rid cached_rid;
+        if(index_cache->Search(table_id[i], item_key[i], cached_rid)){
+            res[table_id[i]][item_key[i]] = cached_rid;
+            continue;
+        }
+        miss_table_id.push_back(table_id[i]);
+        miss_item_key.push_back(item_key[i]);
+    }
+    if(miss_item_key.empty()) return res;
+    auto remote_res = GetRemoteHashIndex(yield, miss_table_id, miss_item_key);
+    for(auto& table_res : remote_res){
+        res[table_res.first].insert(table_res.second.begin(), table_res.second.end());
+    }
+    return res;
+}
+
+bool DTX::SearchIndexCache(table_id_t table_id, itemkey_t key, Rid& rid) {
+    return index_cache->Search(table_id, key, rid);
+}
+
+std::unordered_map<table_id_t, std::unordered_map<itemkey_t, Rid>> 
+    DTX::GetRemoteHashIndex(coro_yield_t& yield, std::vector<table_id_t> table_id, std::vector<itemkey_t> item_key) {
+    
+    std::unordered_map<table_id_t, std::unordered_map<itemkey_t, Rid>> res;
+
     // 计算每个itemkey的hash值和对应的NodeOffset
     std::vector<NodeOffset> node_offs;
+    std::vector<std::pair<table_id_t, itemkey_t>> miss_keys;
     for(int i=0; i<table_id.size(); i++){
         auto hash_meta = global_meta_man->GetHashIndexMeta(table_id[i]);
         auto remote_node_id = global_meta_man->GetHashIndexNode(table_id[i]);
         auto hash = MurmurHash64A(item_key[i], 0xdeadbeef) % hash_meta.bucket_num;
         offset_t node_off = hash_meta.base_off + hash * sizeof(IndexNode);
         node_offs.push_back(NodeOffset{remote_node_id, node_off});
+        miss_keys.push_back(std::make_pair(table_id[i], item_key[i]));
     }
 
-    std::unordered_map<table_id_t, std::unordered_map<itemkey_t, Rid>> res;
-
     assert(pending_hash_node_latch_offs.size() == 0);
     std::unordered_map<NodeOffset, char*> local_hash_nodes;
-    std::unordered_map<NodeOffset, char*> faa_bufs;
     std::unordered_map<NodeOffset, std::list<std::pair<table_id_t, itemkey_t>>> find_index_request_list;    
 
-    // init local_hash_nodes and faa_bufs, and find_index_request_list , and pending_hash_node_latch_offs
+    // init local_hash_nodes and find_index_request_list , and pending_hash_node_latch_offs
     for(int i=0; i<node_offs.size(); i++){
         auto node_off = node_offs[i];
         if(local_hash_nodes.find(node_off) == local_hash_nodes.end()){
             local_hash_nodes[node_off] = thread_rdma_buffer_alloc->Alloc(sizeof(IndexNode));
         }
-        if(faa_bufs.find(node_off) == faa_bufs.end()){
-            faa_bufs[node_off] = thread_rdma_buffer_alloc->Alloc(sizeof(lock_t));
-        }
-        find_index_request_list[node_off].push_back(std::make_pair(table_id[i], item_key[i]));
+        find_index_request_list[node_off].push_back(miss_keys[i]);
         pending_hash_node_latch_offs.emplace(node_off);
     }
-    std::unordered_set<NodeOffset> unlock_shared_node_off;
-    std::unordered_set<NodeOffset> hold_node_off_latch;
-    std::unordered_map<NodeOffset, NodeOffset> hold_latch_to_previouse_node_off; //维护了反向链表<node_off, previouse_node_off>
 
     while (pending_hash_node_latch_offs.size()!=0) {
-        // lock hash node bucket, and remove latch successfully from pending_hash_node_latch_offs
-        auto succ_node_off = ShardLockHashNode(yield, local_hash_nodes, faa_bufs);
-        // init hold_node_off_latch
-        for(auto node_off : succ_node_off ){
-            hold_node_off_latch.emplace(node_off);
-        }
+        // read hash node bucket, and remove consistent bucket from pending_hash_node_latch_offs
+        auto succ_node_off = OptimisticReadHashNode(yield, local_hash_nodes);
 
         for(auto node_off : succ_node_off ){
             // read now
             IndexNode* index_node = reinterpret_cast<IndexNode*>(local_hash_nodes[node_off]);
+            index_cache->UpdateBucketVersion(node_off.nodeId, node_off.offset, index_node->version);
             // 遍历这个node_off上的所有请求即所有的hash index item 
             // 如果找到, 就从列表中移除
             for(auto it = find_index_request_list[node_off].begin(); it != find_index_request_list[node_off].end(); ){
@@ -58,70 +78,44 @@ std::unordered_map<table_id_t, std::unordered_map<itemkey_t, Rid>>
                     if (index_node->index_items[i].key == (*it).second && index_node->index_items[i].valid == true) {
                         // find
                         res[(*it).first][(*it).second] = index_node->index_items[i].rid;
-                        find_index_request_list[node_off].erase(it);
+                        index_cache->Insert((*it).first, (*it).second, index_node->index_items[i].rid, node_off.nodeId, node_off.offset, index_node->version);
+                        it = find_index_request_list[node_off].erase(it);
                         is_find = true;
+                        break;
                     }
                 }
                 // not find
                 if(!is_find) it++;
             }
 
-            // 如果这个node_off上的所有请求都被处理了, 可以释放这个node_off的latch以及之前所有的latch
-            if(find_index_request_list[node_off].size() == 0){
-                // release latch and write back
-                auto release_node_off = node_off;
-                while(true){
-                    unlock_shared_node_off.emplace(release_node_off);
-                    if(hold_latch_to_previouse_node_off.count(release_node_off) == 0) break;
-                    release_node_off = hold_latch_to_previouse_node_off.at(release_node_off);
-                }
-            }
-            else{
-                // 存在未处理的请求, 保留latch
+            if(find_index_request_list[node_off].size() != 0){
                 // if HashIndex not exist, find next bucket
                 node_id_t node_id = global_meta_man->GetHashIndexNode(find_index_request_list[node_off].front().first);
                 auto expand_node_id = index_node->next_expand_node_id[0];
                 offset_t expand_base_off = global_meta_man->GetHashIndexExpandBase(find_index_request_list[node_off].front().first);
                 offset_t next_off = expand_base_off + expand_node_id * sizeof(IndexNode);
                 if(expand_node_id < 0){
-                    // find to the bucket end, here latch is already get and insert it
+                    // find to the bucket end
                     for(auto index_request: find_index_request_list[node_off]){
                         // not find
                         res[index_request.first][index_request.second] = {INVALID_PAGE_ID, -1};
                     }
-                    auto release_node_off = node_off;
-                    while(true){
-                        unlock_shared_node_off.emplace(release_node_off);
-                        if(hold_latch_to_previouse_node_off.count(release_node_off) == 0) break;
-                        release_node_off = hold_latch_to_previouse_node_off.at(release_node_off);
-                    }
                 }
                 else{
-                    // alloc next node read buffer and cas buffer
+                    // alloc next node read buffer
                     NodeOffset next_node_off{node_id, next_off};
                     pending_hash_node_latch_offs.emplace(next_node_off);
                     find_index_request_list.emplace(next_node_off, find_index_request_list.at(node_off));
-                    hold_latch_to_previouse_node_off.emplace(next_node_off, node_off);
                     assert(local_hash_nodes.count(next_node_off) == 0);
-                    assert(faa_bufs.count(next_node_off) == 0);
                     local_hash_nodes[next_node_off] = thread_rdma_buffer_alloc->Alloc(sizeof(IndexNode));
-                    faa_bufs[next_node_off] = thread_rdma_buffer_alloc->Alloc(sizeof(lock_t));
                 }
             }
         }
-        // release all latch and write back
-        for (auto node_off : unlock_shared_node_off){
-            ShardUnLockHashNode(node_off);
-            hold_node_off_latch.erase(node_off);
-        }
-        unlock_shared_node_off.clear();
     }
-    // 这里所有的latch都已经释放了
     assert(pending_hash_node_latch_offs.size() == 0);
-    assert(hold_node_off_latch.size() == 0);
     // 检查请求的HashIndex是否都被处理了
     for(int i=0; i<table_id.size(); i++){
-        assert(res[table_id[i]].count(item_key[i] == 1)); 
+        assert(res[table_id[i]].count(item_key[i]) == 1); 
     }
     return res;
 }
@@ -162,7 +156,7 @@ bool DTX::InsertHashIndex(coro_yield_t& yield, std::vector<table_id_t> table_id,
 
     while (pending_hash_node_latch_offs.size()!=0) {
         // lock hash node bucket, and remove latch successfully from pending_hash_node_latch_offs
-        auto succ_node_off = ExclusiveLockHashNode(yield, local_hash_nodes, cas_bufs);
+        auto succ_node_off = ExclusiveLockHashNode(yield, local_hash_nodes, cas_bufs, sizeof(IndexNode));
         // init hold_node_off_latch
         for(auto node_off : succ_node_off ){
             hold_node_off_latch.emplace(node_off);
@@ -183,8 +177,9 @@ bool DTX::InsertHashIndex(coro_yield_t& yield, std::vector<table_id_t> table_id,
                         index_node->index_items[i].rid = (*it).second;
                         index_node->index_items[i].valid = true;
                         // erase会返回下一个元素的迭代器
-                        insert_index_request_list[node_off].erase(it);
+                        it = insert_index_request_list[node_off].erase(it);
                         is_find = true;
+                        break;
                     }
                 }
                 // not find
@@ -234,9 +229,14 @@ bool DTX::InsertHashIndex(coro_yield_t& yield, std::vector<table_id_t> table_id,
         }
         // release all latch and write back
         for (auto node_off : unlock_node_off_with_write){
-            ExclusiveUnlockHashNode_WithWrite(node_off, local_hash_nodes[node_off]);
+            // 持有排他latch, 修改桶的version, 让并发的无latch查找重新读取
+            IndexNode* index_node = reinterpret_cast<IndexNode*>(local_hash_nodes[node_off]);
+            index_node->version++;
+            index_node->rear_version = index_node->version;
+            index_cache->UpdateBucketVersion(node_off.nodeId, node_off.offset, index_node->version);
             hold_node_off_latch.erase(node_off);
         }
+        ExclusiveUnlockHashNodeBatch_WithWrite(yield, unlock_node_off_with_write, local_hash_nodes, sizeof(IndexNode));
         unlock_node_off_with_write.clear();
     }
     // 这里所有的latch都已经释放了
@@ -281,7 +281,7 @@ bool DTX::DeleteHashIndex(coro_yield_t& yield, std::vector<table_id_t> table_id,
 
     while (pending_hash_node_latch_offs.size()!=0) {
         // lock hash node bucket, and remove latch successfully from pending_hash_node_latch_offs
-        auto succ_node_off = ExclusiveLockHashNode(yield, local_hash_nodes, cas_bufs);
+        auto succ_node_off = ExclusiveLockHashNode(yield, local_hash_nodes, cas_bufs, sizeof(IndexNode));
         // init hold_node_off_latch
         for(auto node_off : succ_node_off ){
             hold_node_off_latch.emplace(node_off);
@@ -302,8 +302,9 @@ bool DTX::DeleteHashIndex(coro_yield_t& yield, std::vector<table_id_t> table_id,
                         index_node->index_items[i].rid = {INVALID_PAGE_ID, -1};
                         index_node->index_items[i].valid = false;
                         // erase会返回下一个元素的迭代器
-                        delete_index_request_list[node_off].erase(it);
+                        it = delete_index_request_list[node_off].erase(it);
                         is_find = true;
+                        break;
                     }
                 }
                 // not find
@@ -352,13 +353,18 @@ bool DTX::DeleteHashIndex(coro_yield_t& yield, std::vector<table_id_t> table_id,
         }
         // release all latch and write back
         for (auto node_off : unlock_node_off_with_write){
-            ExclusiveUnlockHashNode_WithWrite(node_off, local_hash_nodes[node_off]);
+            // 持有排他latch, 修改桶的version, 让并发的无latch查找重新读取
+            IndexNode* index_node = reinterpret_cast<IndexNode*>(local_hash_nodes[node_off]);
+            index_node->version++;
+            index_node->rear_version = index_node->version;
+            index_cache->UpdateBucketVersion(node_off.nodeId, node_off.offset, index_node->version);
             hold_node_off_latch.erase(node_off);
         }
+        ExclusiveUnlockHashNodeBatch_WithWrite(yield, unlock_node_off_with_write, local_hash_nodes, sizeof(IndexNode));
         unlock_node_off_with_write.clear();
     }
     // 这里所有的latch都已经释放了
     assert(pending_hash_node_latch_offs.size() == 0);
     assert(hold_node_off_latch.size() == 0);
     return true;
-}
\ No newline at end of file
+}
@@ -105,7 +105,7 @@ std::vector<LockDataId> DTX::LockShared(coro_yield_t& yield, std::vector<LockDat
 
     while (pending_hash_node_latch_offs.size()!=0){
         // lock hash node bucket, and remove latch successfully from pending_hash_node_latch_offs
-        auto succ_node_off = ExclusiveLockHashNode(yield, local_hash_nodes, cas_bufs);
+        auto succ_node_off = ExclusiveLockHashNode(yield, local_hash_nodes, cas_bufs, sizeof(LockNode));
         // init hold_node_off_latch
         for(auto node_off : succ_node_off ){
             hold_node_off_latch.emplace(node_off);
@@ -187,9 +187,9 @@ std::vector<LockDataId> DTX::LockShared(coro_yield_t& yield, std::vector<LockDat
         }
         // release all latch and write back
         for (auto node_off : unlock_node_off_with_write){
-            ExclusiveUnlockHashNode_WithWrite(node_off, local_hash_nodes.at(node_off));
             hold_node_off_latch.erase(node_off);
         }
+        ExclusiveUnlockHashNodeBatch_WithWrite(yield, unlock_node_off_with_write, local_hash_nodes, sizeof(LockNode));
         unlock_node_off_with_write.clear();
     }
     // 这里所有的latch都已经释放了
@@ -229,7 +229,7 @@ std::vector<LockDataId> DTX::LockExclusive(coro_yield_t& yield, std::vector<Lock
 
     while (pending_hash_node_latch_offs.size()!=0){
         // lock hash node bucket, and remove latch successfully from pending_hash_node_latch_offs
-        auto succ_node_off = ExclusiveLockHashNode(yield, local_hash_nodes, cas_bufs);
+        auto succ_node_off = ExclusiveLockHashNode(yield, local_hash_nodes, cas_bufs, sizeof(LockNode));
         // init hold_node_off_latch
         for(auto node_off : succ_node_off ){
             hold_node_off_latch.emplace(node_off);
@@ -311,9 +311,9 @@ std::vector<LockDataId> DTX::LockExclusive(coro_yield_t& yield, std::vector<Lock
         }
         // release all latch and write back
         for (auto node_off : unlock_node_off_with_write){
-            ExclusiveUnlockHashNode_WithWrite(node_off, local_hash_nodes.at(node_off));
             hold_node_off_latch.erase(node_off);
         }
+        ExclusiveUnlockHashNodeBatch_WithWrite(yield, unlock_node_off_with_write, local_hash_nodes, sizeof(LockNode));
         unlock_node_off_with_write.clear();
     }
     // 这里所有的latch都已经释放了
@@ -350,7 +350,7 @@ bool DTX::UnlockShared(coro_yield_t& yield, std::vector<LockDataId> lock_data_id
 
     while (pending_hash_node_latch_offs.size()!=0){
         // lock hash node bucket, and remove latch successfully from pending_hash_node_latch_offs
-        auto succ_node_off = ExclusiveLockHashNode(yield, local_hash_nodes, cas_bufs);
+        auto succ_node_off = ExclusiveLockHashNode(yield, local_hash_nodes, cas_bufs, sizeof(LockNode));
         // init hold_node_off_latch
         for(auto node_off : succ_node_off ){
             hold_node_off_latch.emplace(node_off);
@@ -425,9 +425,9 @@ bool DTX::UnlockShared(coro_yield_t& yield, std::vector<LockDataId> lock_data_id
         }
         // release all latch and write back
         for (auto node_off : unlock_node_off_with_write){
-            ExclusiveUnlockHashNode_WithWrite(node_off, local_hash_nodes.at(node_off));
             hold_node_off_latch.erase(node_off);
         }
+        ExclusiveUnlockHashNodeBatch_WithWrite(yield, unlock_node_off_with_write, local_hash_nodes, sizeof(LockNode));
         unlock_node_off_with_write.clear();
     }
     // 这里所有的latch都已经释放了
@@ -464,7 +464,7 @@ bool DTX::UnlockExclusive(coro_yield_t& yield, std::vector<LockDataId> lock_data
 
     while (pending_hash_node_latch_offs.size()!=0){
         // lock hash node bucket, and remove latch successfully from pending_hash_node_latch_offs
-        auto succ_node_off = ExclusiveLockHashNode(yield, local_hash_nodes, cas_bufs);
+        auto succ_node_off = ExclusiveLockHashNode(yield, local_hash_nodes, cas_bufs, sizeof(LockNode));
         // init hold_node_off_latch
         for(auto node_off : succ_node_off ){
             hold_node_off_latch.emplace(node_off);
@@ -539,9 +539,9 @@ bool DTX::UnlockExclusive(coro_yield_t& yield, std::vector<LockDataId> lock_data
         }
         // release all latch and write back
         for (auto node_off : unlock_node_off_with_write){
-            ExclusiveUnlockHashNode_WithWrite(node_off, local_hash_nodes.at(node_off));
             hold_node_off_latch.erase(node_off);
         }
+        ExclusiveUnlockHashNodeBatch_WithWrite(yield, unlock_node_off_with_write, local_hash_nodes, sizeof(LockNode));
         unlock_node_off_with_write.clear();
     }
     // 这里所有的latch都已经释放了
@@ -1,6 +1,7 @@
 // author: huang chunyue
 #include "dtx/dtx.h"
 #include <chrono>
+#include <cstddef>
 #include <future>
 
 // dtx_page_table.cc 用于实现计算节点访问内存节点页表的方法
@@ -14,112 +15,92 @@
 // 因此，计算节点要访问所有内存节点的页表去找到对应的帧号frame_id_t
 // 为了提高性能，使用多线程并行访问所有内存节点的页表
 
-#define BATCH_GET_FREE_PAGE_SIZE 100
+// 读或写环形缓冲区中从pos开始的num个槽位, 跨过缓冲区末尾时拆成两个请求
+void DTX::PostRingSlotsReq(RCQP* qp, offset_t ring_base_off, uint64_t pos, size_t num, char* local_slots, bool is_read){
+    uint64_t slot_idx = pos % MAX_FREE_LIST_BUFFER_SIZE;
+    size_t first_num = std::min<size_t>(num, MAX_FREE_LIST_BUFFER_SIZE - slot_idx);
+    std::vector<std::pair<uint64_t, size_t>> reqs{{slot_idx, first_num}};
+    if(first_num < num) reqs.emplace_back(0, num - first_num);
+    for(auto& req : reqs){
+        offset_t off = ring_base_off + req.first * sizeof(RingBufferItem);
+        size_t size = req.second * sizeof(RingBufferItem);
+        bool succ = is_read ? coro_sched->RDMARead(coro_id, qp, local_slots, off, size)
+                            : coro_sched->RDMAWrite(coro_id, qp, local_slots, off, size);
+        if (!succ) {
+            assert(false);
+        }
+        local_slots += size;
+    }
+}
 
-PageAddress DTX::GetFreePageSlot(){
-    auto nodes = global_meta_man->GetPageTableNode();
-    PageAddress res;
-    while (true) {    
-        for(int i=0; i<nodes.size(); i++){
-            RCQP* qp = thread_qp_man->GetRemoteDataQPWithNodeID(nodes[i]);
-            char* faa_cnt_buf = thread_rdma_buffer_alloc->Alloc(sizeof(int64_t));
-            char* faa_tail_buf = thread_rdma_buffer_alloc->Alloc(sizeof(uint64_t));
-            
-            auto ring_buffer_base_off = global_meta_man->GetFreeRingBase(nodes[i]);
-            auto ring_buffer_tail_off = global_meta_man->GetFreeRingTail(nodes[i]);
-            auto ring_buffer_cnt_off = global_meta_man->GetFreeRingCnt(nodes[i]);
-
-            free_page_list_mutex->lock();
-            if(free_page_list->size() > 0){
-                res = free_page_list->front();
-                free_page_list->pop_front();
-                free_page_list_mutex->unlock();
-                return res;
-            }
-            else{
-                auto rc = qp->post_faa(faa_cnt_buf, ring_buffer_cnt_off, -BATCH_GET_FREE_PAGE_SIZE, IBV_SEND_SIGNALED);
-                if (rc != SUCC) {
-                    RDMA_LOG(ERROR) << "client: post cas fail. rc=" << rc << "GetFreePageThread";
-                }
-                rc = qp->post_faa(faa_tail_buf, ring_buffer_tail_off, BATCH_GET_FREE_PAGE_SIZE, IBV_SEND_SIGNALED);
-                if (rc != SUCC) {
-                    RDMA_LOG(ERROR) << "client: post cas fail. rc=" << rc << "GetFreePageThread";
-                }
-                ibv_wc wc{};
-                rc = qp->poll_till_completion(wc, no_timeout);
-                if (rc != SUCC) {
-                    RDMA_LOG(ERROR) << "client: poll read fail. rc=" << rc << "GetFreePageThread";
-                }
+// 通过协程调度器访问一个页表节点上的空闲frame环形缓冲区, 供FrameMagazine::Refill使用
+// 每个请求都通过协程调度器发出, 等待完成时让出CPU给本线程的其他协程
+struct DTX::FrameRingAccessor {
+    DTX* dtx;
+    coro_yield_t& yield;
+    RCQP* qp;
+    offset_t ring_base_off;
+    offset_t dequeue_ticket_off;
 
-                if(*(int64_t*)faa_cnt_buf < BATCH_GET_FREE_PAGE_SIZE){
-                    // buffer has not enough free page
-                    auto rc = qp->post_faa(faa_tail_buf, ring_buffer_tail_off, -BATCH_GET_FREE_PAGE_SIZE, IBV_SEND_SIGNALED);
-                    if (rc != SUCC) {
-                        RDMA_LOG(ERROR) << "client: post cas fail. rc=" << rc << "GetFreePageThread";
-                    }
-                    rc = qp->post_faa(faa_cnt_buf, ring_buffer_cnt_off, BATCH_GET_FREE_PAGE_SIZE, IBV_SEND_SIGNALED);
-                    if (rc != SUCC) {
-                        RDMA_LOG(ERROR) << "client: post cas fail. rc=" << rc << "GetFreePageThread";
-                    }
-                    ibv_wc wc{};
-                    rc = qp->poll_till_completion(wc, no_timeout);
-                    if (rc != SUCC) {
-                        RDMA_LOG(ERROR) << "client: poll read fail. rc=" << rc << "GetFreePageThread";
-                    }
-                    free_page_list_mutex->unlock();
-                    continue;
-                }
-                else{
-                    // buffer has enough page
-                    char* read_free_page = thread_rdma_buffer_alloc->Alloc(sizeof(RingBufferItem) * BATCH_GET_FREE_PAGE_SIZE);
-                    if(*(uint64_t*)faa_tail_buf % MAX_FREE_LIST_BUFFER_SIZE + BATCH_GET_FREE_PAGE_SIZE > MAX_FREE_LIST_BUFFER_SIZE){
-                        offset_t read_off_1 = ring_buffer_base_off + (*(uint64_t*)faa_tail_buf % MAX_FREE_LIST_BUFFER_SIZE) * sizeof(RingBufferItem);
-                        offset_t read_off_2 = ring_buffer_base_off + 0 * sizeof(RingBufferItem);
-                        size_t read_size_1 = sizeof(RingBufferItem) * (MAX_FREE_LIST_BUFFER_SIZE - (*(uint64_t*)faa_tail_buf % MAX_FREE_LIST_BUFFER_SIZE));
-                        size_t read_size_2 = sizeof(RingBufferItem) * (BATCH_GET_FREE_PAGE_SIZE - (MAX_FREE_LIST_BUFFER_SIZE - (*(uint64_t*)faa_tail_buf % MAX_FREE_LIST_BUFFER_SIZE)));
-                        auto rc = qp->post_send(IBV_WR_RDMA_READ, read_free_page, read_size_1, read_off_1, IBV_SEND_SIGNALED);
-                        if (rc != SUCC) {
-                            RDMA_LOG(ERROR) << "client: post cas fail. rc=" << rc << "GetFreePageThread";
-                        }
-                        rc = qp->post_send(IBV_WR_RDMA_READ, read_free_page + read_size_1, read_size_2, read_off_2, IBV_SEND_SIGNALED);
-                        if (rc != SUCC) {
-                            RDMA_LOG(ERROR) << "client: post cas fail. rc=" << rc << "GetFreePageThread";
-                        }
-                        ibv_wc wc{};
-                        rc = qp->poll_till_completion(wc, no_timeout);
-                        if (rc != SUCC) {
-                            RDMA_LOG(ERROR) << "client: poll read fail. rc=" << rc << "GetFreePageThread";
-                        }
-                    }
-                    else{
-                        offset_t read_off = ring_buffer_base_off + (*(uint64_t*)faa_tail_buf % MAX_FREE_LIST_BUFFER_SIZE) * sizeof(RingBufferItem);
-                        size_t read_size = sizeof(RingBufferItem) * BATCH_GET_FREE_PAGE_SIZE;
-                        auto rc = qp->post_send(IBV_WR_RDMA_READ, read_free_page, read_size, read_off, IBV_SEND_SIGNALED);
-                        if (rc != SUCC) {
-                            RDMA_LOG(ERROR) << "client: post cas fail. rc=" << rc << "GetFreePageThread";
-                        }
-                        ibv_wc wc{};
-                        rc = qp->poll_till_completion(wc, no_timeout);
-                        if (rc != SUCC) {
-                            RDMA_LOG(ERROR) << "client: poll read fail. rc=" << rc << "GetFreePageThread";
-                        }
-                    }
-                    for(int i=0; i<BATCH_GET_FREE_PAGE_SIZE; i++){
-                        RingBufferItem* item =  reinterpret_cast<RingBufferItem*>(read_free_page + i * sizeof(RingBufferItem));
-                        assert(item->valid == true);
-                        free_page_list->push_back({item->node_id, item->frame_id});
-                    }
-                    free_page_list_mutex->unlock();
-                }
-            }
+    uint64_t Capacity() const { return MAX_FREE_LIST_BUFFER_SIZE; }
+
+    uint64_t Claim(size_t num){
+        char* faa_ticket_buf = dtx->thread_rdma_buffer_alloc->Alloc(sizeof(uint64_t));
+        if (!dtx->coro_sched->RDMAFAA(dtx->coro_id, qp, faa_ticket_buf, dequeue_ticket_off, num)) {
+            assert(false);
         }
+        dtx->coro_sched->Yield(yield, dtx->coro_id);
+        return *(uint64_t*)faa_ticket_buf;
     }
-    return {-1, INVALID_FRAME_ID};
+
+    RingBufferItem* Read(uint64_t pos, size_t num){
+        RingBufferItem* local_slots = (RingBufferItem*)dtx->thread_rdma_buffer_alloc->Alloc(sizeof(RingBufferItem) * num);
+        dtx->PostRingSlotsReq(qp, ring_base_off, pos, num, (char*)local_slots, true);
+        dtx->coro_sched->Yield(yield, dtx->coro_id);
+        return local_slots;
+    }
+
+    // 写回释放后的序号, 不需要等待完成, 之后的Yield会一起等待
+    void Write(uint64_t pos, size_t num, RingBufferItem* local_slots){
+        dtx->PostRingSlotsReq(qp, ring_base_off, pos, num, (char*)local_slots, false);
+    }
+
+    // 生产者还没有写入领取的槽位, 指数退避之后再读取, 不让等待的协程持续向页表节点发出读请求
+    void Backoff(int wait_num){
+        std::this_thread::sleep_for(std::chrono::microseconds(1 << std::min(wait_num, 6)));
+    }
+};
+
+// 从node_id的环形缓冲区向本线程的弹匣补充至少need_num个frame, 见FrameMagazine::Refill
+void DTX::RefillFrameMagazine(coro_yield_t& yield, node_id_t node_id, size_t need_num){
+    FrameRingAccessor ring_accessor{this, yield, thread_qp_man->GetRemoteDataQPWithNodeID(node_id), 
+        global_meta_man->GetFreeRingBase(node_id), global_meta_man->GetFreeRingDequeueTicket(node_id)};
+    frame_magazine->Refill(ring_accessor, node_id, need_num);
+}
+
+// 保证弹匣中至少有need_num + FRAME_MAGAZINE_LOW_WATERMARK个frame
+// 可能等待页表节点淘汰页面, 调用时不能持有桶latch
+void DTX::ReserveFreePageSlots(coro_yield_t& yield, size_t need_num){
+    auto nodes = global_meta_man->GetPageTableNode();
+    assert(nodes.size() > 0);
+    while(frame_magazine->Size() < need_num + FRAME_MAGAZINE_LOW_WATERMARK){
+        RefillFrameMagazine(yield, nodes[frame_magazine->NextRefillNodeIdx(nodes.size())], 
+            need_num + FRAME_MAGAZINE_LOW_WATERMARK - frame_magazine->Size());
+    }
+}
+
+// 调用者在持有latch时已经检查过弹匣中的frame足够, 这里不会访问环形缓冲区
+PageAddress DTX::GetFreePageSlot(){
+    PageAddress res{-1, INVALID_FRAME_ID};
+    bool succ = frame_magazine->Pop(res);
+    assert(succ);
+    (void)succ;
+    return res;
 }
 
-PageAddress DTX::InsertPageTableIntoHashNodeList(std::unordered_map<NodeOffset, char*>& local_hash_nodes, 
+PageAddress DTX::InsertPageTableIntoHashNodeList(coro_yield_t& yield, std::unordered_map<NodeOffset, char*>& local_hash_nodes, 
         PageId page_id, bool is_write, NodeOffset last_node_off, 
-         std::unordered_map<NodeOffset, NodeOffset>& hold_latch_to_previouse_node_off){
+         std::unordered_map<NodeOffset, NodeOffset>& hold_latch_to_previouse_node_off, NodeOffset& item_node_off, int& item_idx){
     
     NodeOffset node_off = last_node_off;
     std::unordered_map<NodeOffset, NodeOffset> hold_latch_to_next_node_off;
@@ -128,11 +109,11 @@ PageAddress DTX::InsertPageTableIntoHashNodeList(std::unordered_map<NodeOffset,
         node_off = hold_latch_to_previouse_node_off.at(node_off);
     }
 
-    // find empty slot to insert
-    PageTableNode* page_table_node = reinterpret_cast<PageTableNode*>(local_hash_nodes[last_node_off]);
+    // find empty slot to insert, 从桶链的第一个桶开始, node_off和page_table_node保持一致
+    PageTableNode* page_table_node = reinterpret_cast<PageTableNode*>(local_hash_nodes[node_off]);
     while (true) {
         // find lock item
-        for(int i=0; i<MAX_RIDS_NUM_PER_NODE; i++){
+        for(int i=0; i<MAX_PAGETABLE_ITEM_NUM_PER_NODE; i++){
             if (page_table_node->page_table_items[i].valid == false) {
                 page_table_node->page_table_items[i].valid = true;
                 page_table_node->page_table_items[i].page_id = page_id;
@@ -140,12 +121,16 @@ PageAddress DTX::InsertPageTableIntoHashNodeList(std::unordered_map<NodeOffset,
                 page_table_node->page_table_items[i].page_address = GetFreePageSlot();
                 // 当前页面正在从磁盘读取
                 page_table_node->page_table_items[i].page_valid = false;
+                page_table_node->page_table_items[i].referenced = false;
+                page_table_node->page_table_items[i].dirty_batch_id = 0;
                 if(is_write){
                     page_table_node->page_table_items[i].rwcount = EXCLUSIVE_LOCKED;
                 }
                 else{
                     page_table_node->page_table_items[i].rwcount = 1;
                 }
+                item_node_off = node_off;
+                item_idx = i;
                 return page_table_node->page_table_items[i].page_address;
             }
         }
@@ -173,6 +158,82 @@ PageAddress DTX::InsertPageTableIntoHashNodeList(std::unordered_map<NodeOffset,
     return {-1, INVALID_FRAME_ID};
 }
 
+// 页面在home页表节点上的桶
+NodeOffset DTX::GetPageTableBucketOff(PageId page_id){
+    node_id_t home_node = global_meta_man->GetPageTableHomeNode(page_id);
+    auto& hash_meta = global_meta_man->GetPageTableMeta(home_node);
+    auto hash = MurmurHash64A(page_id.Get(), 0xdeadbeef) % hash_meta.bucket_num;
+    return NodeOffset{home_node, hash_meta.base_off + hash * sizeof(PageTableNode)};
+}
+
+// 只读请求的乐观查页表路径:
+// 1. 对home节点上的桶FAA共享latch, 并在同一个doorbell中读取整个桶, 一次RTT
+// 2. 若桶没有被排他latch持有, 在读到的桶中查找页表项, 对命中页表项的rwcount直接FAA(+1), 然后释放共享latch
+// 排他latch的持有者会把整个桶写回, 因此不能只用版本号校验之后FAA页表项, FAA的结果可能被写回覆盖,
+// 持有共享latch期间排他latch无法获取, 保证rwcount的FAA不会和写回冲突
+// 命中的请求写入res, 没有命中(需要插入)或者桶正被修改的请求留给排他latch的路径处理
+void DTX::OptimisticGetPageAddr(coro_yield_t& yield, std::vector<PageId>& page_ids, std::vector<bool>& is_write, 
+        std::unordered_map<PageId, PageAddress>& res, std::unordered_map<PageId,bool>& need_fetch_from_disk, std::unordered_map<PageId,bool>& now_valid){
+
+    std::unordered_map<NodeOffset, std::vector<PageId>> read_request_list;
+    for(int i=0; i<page_ids.size(); i++){
+        if(is_write[i]) continue;
+        read_request_list[GetPageTableBucketOff(page_ids[i])].push_back(page_ids[i]);
+    }
+    if(read_request_list.empty()) return;
+
+    std::unordered_map<NodeOffset, char*> local_hash_nodes;
+    std::unordered_map<NodeOffset, char*> faa_bufs;
+    std::unordered_map<node_id_t, ChainedDoorbellBatch> latch_batches;
+    for(auto& request : read_request_list){
+        auto node_off = request.first;
+        local_hash_nodes[node_off] = thread_rdma_buffer_alloc->Alloc(sizeof(PageTableNode));
+        faa_bufs[node_off] = thread_rdma_buffer_alloc->Alloc(sizeof(lock_t));
+        ChainedDoorbellBatch& batch = latch_batches[node_off.nodeId];
+        batch.AddFAAReq(faa_bufs[node_off], node_off.offset, 1);
+        batch.AddReadReq(local_hash_nodes[node_off], node_off.offset, sizeof(PageTableNode));
+    }
+    SendDoorbellBatches(yield, latch_batches);
+    coro_sched->Yield(yield, coro_id);
+
+    std::vector<NodeOffset> shared_latched_node_offs;
+    std::vector<NodeOffset> revoke_node_offs;
+    std::unordered_map<node_id_t, ChainedDoorbellBatch> pin_batches;
+    for(auto& request : read_request_list){
+        auto node_off = request.first;
+        if((*(lock_t*)faa_bufs[node_off] & MASKED_SHARED_LOCKS) != 0){
+            // 桶正在被排他latch持有, 撤销共享latch, 这些请求走排他latch的路径
+            revoke_node_offs.push_back(node_off);
+            continue;
+        }
+        shared_latched_node_offs.push_back(node_off);
+        PageTableNode* page_table_node = reinterpret_cast<PageTableNode*>(local_hash_nodes[node_off]);
+        for(auto& page_id : request.second){
+            for(int i=0; i<MAX_PAGETABLE_ITEM_NUM_PER_NODE; i++){
+                PageTableItem& item = page_table_node->page_table_items[i];
+                if(item.valid == false || !(item.page_id == page_id)) continue;
+                // 页面正在从磁盘读取, 交给排他latch的路径处理
+                if(item.page_valid == false) break;
+                offset_t rwcount_off = node_off.offset + offsetof(PageTableNode, page_table_items) + 
+                        i * sizeof(PageTableItem) + offsetof(PageTableItem, rwcount);
+                char* faa_buf = thread_rdma_buffer_alloc->Alloc(sizeof(uint64_t));
+                pin_batches[node_off.nodeId].AddFAAReq(faa_buf, rwcount_off, 1);
+                res[page_id] = item.page_address;
+                need_fetch_from_disk[page_id] = false;
+                now_valid[page_id] = true;
+                pinned_page_items[page_id] = {node_off, i, item.dirty_batch_id};
+                break;
+            }
+        }
+    }
+    ShardUnLockHashNodeBatch(yield, revoke_node_offs);
+    SendDoorbellBatches(yield, pin_batches);
+    if(shared_latched_node_offs.empty()) return;
+    // rwcount的FAA完成之后才能释放共享latch
+    coro_sched->Yield(yield, coro_id);
+    ShardUnLockHashNodeBatch(yield, shared_latched_node_offs);
+}
+
 std::vector<PageAddress> DTX::GetPageAddrOrAddIntoPageTable(coro_yield_t& yield, std::vector<PageId> page_ids, 
         std::unordered_map<PageId,bool>& need_fetch_from_disk, std::unordered_map<PageId,bool>& now_valid, std::vector<bool> is_write){
     
@@ -181,20 +242,22 @@ std::vector<PageAddress> DTX::GetPageAddrOrAddIntoPageTable(coro_yield_t& yield,
 
     auto nodes = global_meta_man->GetPageTableNode();
     assert(nodes.size() > 0);
-    // 计算每个itemkey的hash值和对应的NodeOffset, 
+
+    // 只读请求先走乐观路径, 命中的请求不再获取桶的排他latch
+    std::unordered_map<PageId, PageAddress> res;
+    OptimisticGetPageAddr(yield, page_ids, is_write, res, need_fetch_from_disk, now_valid);
+
+    // 计算每个itemkey的hash值和对应的NodeOffset,
     // 页表和哈希索引或锁表的实现略有不用，因为哈希索引和锁表通过采用分库分表的方式
     // 可以假设一个节点可以存放所有的哈希索引或锁表
     // 而页表管理的页数远远大于哈希索引或锁表的数据项数，因此页表需要分布在多个节点上
-    // 在这里，我们需要遍历所有页表可能存在的所有节点来检查页表项是否存在，如果不存在，则需要添加
-    
-    // 首先，我们需要计算每个page_ids的hash值，然后算出对应的NodeOffset，初始化的NodeOffset的node_id为第一个节点
-    // 如果桶链都没有找到，则需要进入下一个节点遍历
+    // 每个页面通过MetaManager的一致性哈希确定唯一的home页表节点, 查找和插入都只访问home节点上的桶链
     std::vector<NodeOffset> node_offs;
+    std::vector<int> latch_request_idx;
     for(int i=0; i<page_ids.size(); i++){
-        auto hash_meta = global_meta_man->GetPageTableMeta(nodes[0]); // 获取第一个节点的页表元数据
-        auto hash = MurmurHash64A(page_ids[i].Get(), 0xdeadbeef) % hash_meta.bucket_num;
-        offset_t node_off = hash_meta.base_off + hash * sizeof(PageTableNode);
-        node_offs.push_back(NodeOffset{nodes[0], node_off});
+        if(res.count(page_ids[i]) != 0) continue;
+        node_offs.push_back(GetPageTableBucketOff(page_ids[i]));
+        latch_request_idx.push_back(i);
     }
 
     assert(pending_hash_node_latch_offs.size() == 0);
@@ -203,8 +266,9 @@ std::vector<PageAddress> DTX::GetPageAddrOrAddIntoPageTable(coro_yield_t& yield,
     std::unordered_map<NodeOffset, std::list<std::pair<PageId, bool>>> get_pagetable_request_list; // bool 存放的是is_write
     
     // init local_hash_nodes and cas_bufs, and get_pagetable_request_list , and pending_hash_node_latch_offs
-    for(int i=0; i<node_offs.size(); i++){
-        auto node_off = node_offs[i];
+    for(int j=0; j<node_offs.size(); j++){
+        auto node_off = node_offs[j];
+        int i = latch_request_idx[j];
         if(local_hash_nodes.find(node_off) == local_hash_nodes.end()){
             local_hash_nodes[node_off] = thread_rdma_buffer_alloc->Alloc(sizeof(PageTableNode));
         }
@@ -215,14 +279,20 @@ std::vector<PageAddress> DTX::GetPageAddrOrAddIntoPageTable(coro_yield_t& yield,
         pending_hash_node_latch_offs.emplace(node_off);
     }
     
+    // 在获取桶latch之前为可能的插入预留空闲frame, 避免持有latch时等待环形缓冲区
+    if(!node_offs.empty()){
+        ReserveFreePageSlots(yield, std::min<size_t>(node_offs.size(), FRAME_MAGAZINE_REFILL_BATCH));
+    }
+
     std::unordered_set<NodeOffset> unlock_node_off_with_write;
     std::unordered_set<NodeOffset> hold_node_off_latch;
     std::unordered_map<NodeOffset, NodeOffset> hold_latch_to_previouse_node_off; //维护了反向链表<node_off, previouse_node_off>
-    std::unordered_map<PageId, PageAddress> res;
+    // 持有latch时因为弹匣不足没有插入的请求, key是桶链的最后一个桶
+    std::unordered_map<NodeOffset, std::list<std::pair<PageId, bool>>> retry_request_list;
 
     while (pending_hash_node_latch_offs.size()!=0) {
         // lock hash node bucket, and remove latch successfully from pending_hash_node_latch_offs
-        auto succ_node_off = ExclusiveLockHashNode(yield, local_hash_nodes, cas_bufs);
+        auto succ_node_off = ExclusiveLockHashNode(yield, local_hash_nodes, cas_bufs, sizeof(PageTableNode));
         // init hold_node_off_latch
         for(auto node_off : succ_node_off ){
             hold_node_off_latch.emplace(node_off);
@@ -236,19 +306,19 @@ std::vector<PageAddress> DTX::GetPageAddrOrAddIntoPageTable(coro_yield_t& yield,
             for(auto it = get_pagetable_request_list[node_off].begin(); it != get_pagetable_request_list[node_off].end(); ){
                 // find empty slot to insert
                 bool is_find = false;
-                for (int i=0; i<MAX_RIDS_NUM_PER_NODE; i++) {
+                for (int i=0; i<MAX_PAGETABLE_ITEM_NUM_PER_NODE; i++) {
                     if (page_table_node->page_table_items[i].page_id == it->first && page_table_node->page_table_items[i].valid == true) {
                         // find, 记录page_address
                         res[it->first] = page_table_node->page_table_items[i].page_address;
                         need_fetch_from_disk[it->first] = false;
                         // this page is not valid, because other thread is fetch this page from disk and haven't write back
-                        if(page_table_node->page_table_items[i].valid == false){
+                        if(page_table_node->page_table_items[i].page_valid == false){
                             now_valid[it->first] = false;
                         }
                         // page is valid now
                         else if(it->second == true){
                             //is write & page is valid & wcount == 0
-                            if(page_table_node->page_table_items[i].rwcount & MASKED_SHARED_LOCKS != EXCLUSIVE_LOCKED){
+                            if((page_table_node->page_table_items[i].rwcount & MASKED_SHARED_LOCKS) != EXCLUSIVE_LOCKED){
                                 now_valid[it->first] = true;
                                 page_table_node->page_table_items[i].rwcount |= EXCLUSIVE_LOCKED;
                             }
@@ -261,9 +331,13 @@ std::vector<PageAddress> DTX::GetPageAddrOrAddIntoPageTable(coro_yield_t& yield,
                             now_valid[it->first] = true;
                             page_table_node->page_table_items[i].rwcount++;
                         }
+                        if(now_valid[it->first]){
+                            pinned_page_items[it->first] = {node_off, i, page_table_node->page_table_items[i].dirty_batch_id};
+                        }
                         // erase会返回下一个元素的迭代器
-                        get_pagetable_request_list[node_off].erase(it);
+                        it = get_pagetable_request_list[node_off].erase(it);
                         is_find = true;
+                        break;
                     }
                 }
                 // not find
@@ -287,41 +361,37 @@ std::vector<PageAddress> DTX::GetPageAddrOrAddIntoPageTable(coro_yield_t& yield,
                 bool continue_search = false;
                 NodeOffset next_node_off;
                 if(expand_node_id < 0){
-                    // 这个节点搜索完成，搜索下一个节点
-                    auto it = std::find(nodes.begin(), nodes.end(), node_off.nodeId);
-                    if(it + 1 != nodes.end()){
-                        node_id_t new_node_id = *(it+1);
-                        auto hash_meta = global_meta_man->GetPageTableMeta(new_node_id); // 获取下一个节点的页表元数据
-                        // 这里必须假定新节点的桶数和旧节点的桶数相同，即原节点的桶中所有元素也在新节点的一个桶中
-                        auto hash = MurmurHash64A(get_pagetable_request_list[node_off].front().first.Get(), 0xdeadbeef) % hash_meta.bucket_num;
-                        offset_t next_off = hash_meta.base_off + hash * sizeof(PageTableNode);
-                        next_node_off = {new_node_id, next_off};
-                        continue_search = true;
-                    }
-                    else{
-                        continue_search = false;
-                        // 所有节点都搜索完了，但没找到，应该插入以保证缓存一致性(多线程)
-                        // 释放所有latch
-                        for(auto pagetable_request : get_pagetable_request_list[node_off]){
-                            PageAddress insert_page_addr = InsertPageTableIntoHashNodeList(local_hash_nodes, pagetable_request.first, 
-                                pagetable_request.second, node_off, hold_latch_to_previouse_node_off);
-                            if(insert_page_addr.frame_id == INVALID_FRAME_ID || insert_page_addr.node_id < 0){
-                                RDMA_LOG(ERROR) << "InsertPageTableIntoHashNodeList failed";
-                            }
-                            else{
-                                res[pagetable_request.first] = insert_page_addr;
-                                need_fetch_from_disk[pagetable_request.first] = true;
-                                now_valid[pagetable_request.first] = false;
-                            }
+                    // home节点的桶链搜索完成, 页面不在页表中, 插入到home节点的桶链中
+                    continue_search = false;
+                    for(auto pagetable_request : get_pagetable_request_list[node_off]){
+                        if(frame_magazine->Size() == 0){
+                            // 弹匣中的frame被本线程的其他协程用完了, 不能持有latch等待环形缓冲区:
+                            // 页表节点可能要淘汰被这些latch保护的页面才能补充空闲frame.
+                            // 剩下的请求在释放整条桶链的latch、补充弹匣之后从第一个桶重新查找
+                            retry_request_list[node_off].push_back(pagetable_request);
+                            continue;
+                        }
+                        NodeOffset item_node_off;
+                        int item_idx;
+                        PageAddress insert_page_addr = InsertPageTableIntoHashNodeList(yield, local_hash_nodes, pagetable_request.first, 
+                            pagetable_request.second, node_off, hold_latch_to_previouse_node_off, item_node_off, item_idx);
+                        if(insert_page_addr.frame_id == INVALID_FRAME_ID || insert_page_addr.node_id < 0){
+                            RDMA_LOG(ERROR) << "InsertPageTableIntoHashNodeList failed";
                         }
-                        // release latch and write back
-                        auto release_node_off = node_off;
-                        while(true){
-                            unlock_node_off_with_write.emplace(release_node_off);
-                            if(hold_latch_to_previouse_node_off.count(release_node_off) == 0) break;
-                            release_node_off = hold_latch_to_previouse_node_off.at(release_node_off);
+                        else{
+                            res[pagetable_request.first] = insert_page_addr;
+                            need_fetch_from_disk[pagetable_request.first] = true;
+                            now_valid[pagetable_request.first] = false;
+                            pinned_page_items[pagetable_request.first] = {item_node_off, item_idx, 0};
                         }
                     }
+                    // release latch and write back
+                    auto release_node_off = node_off;
+                    while(true){
+                        unlock_node_off_with_write.emplace(release_node_off);
+                        if(hold_latch_to_previouse_node_off.count(release_node_off) == 0) break;
+                        release_node_off = hold_latch_to_previouse_node_off.at(release_node_off);
+                    }
                 }
                 else{
                     offset_t expand_base_off = global_meta_man->GetPageTableExpandBase(node_off.nodeId);
@@ -342,41 +412,66 @@ std::vector<PageAddress> DTX::GetPageAddrOrAddIntoPageTable(coro_yield_t& yield,
         }
         // release all latch and write back
         for (auto node_off : unlock_node_off_with_write){
-            ExclusiveUnlockHashNode_WithWrite(node_off, local_hash_nodes[node_off]);
             hold_node_off_latch.erase(node_off);
         }
+        ExclusiveUnlockHashNodeBatch_WithWrite(yield, unlock_node_off_with_write, local_hash_nodes, sizeof(PageTableNode));
         unlock_node_off_with_write.clear();
+
+        // latch已经释放, 补充弹匣之后从第一个桶重新查找没有插入的页面, 期间其他协程可能已经插入了这些页面
+        if(!retry_request_list.empty()){
+            size_t retry_num = 0;
+            for(auto& retry : retry_request_list){
+                retry_num += retry.second.size();
+                // 丢弃这条桶链上除第一个桶之外的状态, 重新查找时再获取latch并读取
+                auto head_node_off = retry.first;
+                while(hold_latch_to_previouse_node_off.count(head_node_off) != 0){
+                    auto prev_node_off = hold_latch_to_previouse_node_off.at(head_node_off);
+                    hold_latch_to_previouse_node_off.erase(head_node_off);
+                    get_pagetable_request_list.erase(head_node_off);
+                    local_hash_nodes.erase(head_node_off);
+                    cas_bufs.erase(head_node_off);
+                    head_node_off = prev_node_off;
+                }
+                get_pagetable_request_list[head_node_off] = std::move(retry.second);
+                pending_hash_node_latch_offs.emplace(head_node_off);
+            }
+            retry_request_list.clear();
+            frame_magazine->GetStat().refill_under_latch_num++;
+            ReserveFreePageSlots(yield, retry_num);
+        }
     }
     // 这里所有的latch都已经释放了
     assert(hold_node_off_latch.size() == 0);
-    // 转化成vector
+    // 转化成vector, 与page_ids的顺序保持一致
     std::vector<PageAddress> res_vec;
-    for(auto it : res){
-        res_vec.push_back(it.second);
+    res_vec.reserve(page_ids.size());
+    for(auto& page_id : page_ids){
+        auto it = res.find(page_id);
+        if(it != res.end()) res_vec.push_back(it->second);
+        else res_vec.push_back({-1, INVALID_FRAME_ID});
     }
     return res_vec;
 }
 
 
-void DTX::UnpinPageTable(coro_yield_t& yield, std::vector<PageId> page_ids, std::vector<bool> is_write){
+void DTX::UnpinPageTable(coro_yield_t& yield, std::vector<PageId> page_ids, std::vector<bool> is_write, std::vector<bool> is_dirty, batch_id_t batch_id){
 
     auto nodes = global_meta_man->GetPageTableNode();
     assert(nodes.size() > 0);
     std::vector<NodeOffset> node_offs;
     for(int i=0; i<page_ids.size(); i++){
-        auto hash_meta = global_meta_man->GetPageTableMeta(nodes[0]); // 获取第一个节点的页表元数据
-        auto hash = MurmurHash64A(page_ids[i].Get(), 0xdeadbeef) % hash_meta.bucket_num;
-        offset_t node_off = hash_meta.base_off + hash * sizeof(PageTableNode);
-        node_offs.push_back(NodeOffset{nodes[0], node_off});
+        node_offs.push_back(GetPageTableBucketOff(page_ids[i]));
     }
 
     assert(pending_hash_node_latch_offs.size() == 0);
     std::unordered_map<NodeOffset, char*> local_hash_nodes;
     std::unordered_map<NodeOffset, char*> cas_bufs;
     std::unordered_map<NodeOffset, std::list<std::pair<PageId, bool>>> get_pagetable_request_list; // bool 存放的是is_write
+    std::unordered_set<PageId> dirty_pages;
     
     // init local_hash_nodes and cas_bufs, and get_pagetable_request_list , and pending_hash_node_latch_offs
     for(int i=0; i<node_offs.size(); i++){
+        if(is_dirty[i]) dirty_pages.insert(page_ids[i]);
         auto node_off = node_offs[i];
         if(local_hash_nodes.find(node_off) == local_hash_nodes.end()){
             local_hash_nodes[node_off] = thread_rdma_buffer_alloc->Alloc(sizeof(PageTableNode));
@@ -392,10 +487,12 @@ void DTX::UnpinPageTable(coro_yield_t& yield, std::vector<PageId> page_ids, std:
     std::unordered_set<NodeOffset> hold_node_off_latch;
     std::unordered_map<NodeOffset, NodeOffset> hold_latch_to_previouse_node_off; //维护了反向链表<node_off, previouse_node_off>
     std::unordered_map<PageId, PageAddress> res;
+    // 页地址缓存的租约从写入last_access_time之前开始计算
+    auto lease_start = PageAddrCache::Clock::now();
 
     while (pending_hash_node_latch_offs.size()!=0) {
         // lock hash node bucket, and remove latch successfully from pending_hash_node_latch_offs
-        auto succ_node_off = ExclusiveLockHashNode(yield, local_hash_nodes, cas_bufs);
+        auto succ_node_off = ExclusiveLockHashNode(yield, local_hash_nodes, cas_bufs, sizeof(PageTableNode));
         // init hold_node_off_latch
         for(auto node_off : succ_node_off ){
             hold_node_off_latch.emplace(node_off);
@@ -409,7 +506,7 @@ void DTX::UnpinPageTable(coro_yield_t& yield, std::vector<PageId> page_ids, std:
             for(auto it = get_pagetable_request_list[node_off].begin(); it != get_pagetable_request_list[node_off].end(); ){
                 // find empty slot to insert
                 bool is_find = false;
-                for (int i=0; i<MAX_RIDS_NUM_PER_NODE; i++) {
+                for (int i=0; i<MAX_PAGETABLE_ITEM_NUM_PER_NODE; i++) {
                     if (page_table_node->page_table_items[i].page_id == it->first && page_table_node->page_table_items[i].valid == true) {
                         // unpin it
                         page_table_node->page_table_items[i].page_valid = true;
@@ -423,9 +520,16 @@ void DTX::UnpinPageTable(coro_yield_t& yield, std::vector<PageId> page_ids, std:
                             page_table_node->page_table_items[i].rwcount--;
                             page_table_node->page_table_items[i].last_access_time = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
                         }
+                        // CLOCK的访问位和脏页标记随桶的写回一起写入, 不需要额外的远程操作
+                        page_table_node->page_table_items[i].referenced = true;
+                        if(dirty_pages.count(it->first) != 0 && page_table_node->page_table_items[i].dirty_batch_id < batch_id){
+                            page_table_node->page_table_items[i].dirty_batch_id = batch_id;
+                        }
+                        page_addr_cache->Insert(it->first, page_table_node->page_table_items[i].page_address, lease_start);
                         // erase会返回下一个元素的迭代器
-                        get_pagetable_request_list[node_off].erase(it);
+                        it = get_pagetable_request_list[node_off].erase(it);
                         is_find = true;
+                        break;
                     }
                 }
                 // not find
@@ -449,28 +553,15 @@ void DTX::UnpinPageTable(coro_yield_t& yield, std::vector<PageId> page_ids, std:
                 bool continue_search = false;
                 NodeOffset next_node_off;
                 if(expand_node_id < 0){
-                    // 这个节点搜索完成，搜索下一个节点
-                    auto it = std::find(nodes.begin(), nodes.end(), node_off.nodeId);
-                    if(it + 1 != nodes.end()){
-                        node_id_t new_node_id = *(it+1);
-                        auto hash_meta = global_meta_man->GetPageTableMeta(new_node_id); // 获取下一个节点的页表元数据
-                        // 这里必须假定新节点的桶数和旧节点的桶数相同，即原节点的桶中所有元素也在新节点的一个桶中
-                        auto hash = MurmurHash64A(get_pagetable_request_list[node_off].front().first.Get(), 0xdeadbeef) % hash_meta.bucket_num;
-                        offset_t next_off = hash_meta.base_off + hash * sizeof(PageTableNode);
-                        next_node_off = {new_node_id, next_off};
-                        continue_search = true;
-                    }
-                    else{
-                        continue_search = false;
-                        // 所有节点都搜索完了，但没找到，报错
-                        RDMA_LOG(ERROR) << "UnpinPageTable: page table item not found";
-                        // release latch and write back
-                        auto release_node_off = node_off;
-                        while(true){
-                            unlock_node_off_with_write.emplace(release_node_off);
-                            if(hold_latch_to_previouse_node_off.count(release_node_off) == 0) break;
-                            release_node_off = hold_latch_to_previouse_node_off.at(release_node_off);
-                        }
+                    continue_search = false;
+                    // home节点的桶链搜索完成, 但没找到，报错
+                    RDMA_LOG(ERROR) << "UnpinPageTable: page table item not found";
+                    // release latch and write back
+                    auto release_node_off = node_off;
+                    while(true){
+                        unlock_node_off_with_write.emplace(release_node_off);
+                        if(hold_latch_to_previouse_node_off.count(release_node_off) == 0) break;
+                        release_node_off = hold_latch_to_previouse_node_off.at(release_node_off);
                     }
                 }
                 else{
@@ -492,11 +583,154 @@ void DTX::UnpinPageTable(coro_yield_t& yield, std::vector<PageId> page_ids, std:
         }
         // release all latch and write back
         for (auto node_off : unlock_node_off_with_write){
-            ExclusiveUnlockHashNode_WithWrite(node_off, local_hash_nodes[node_off]);
             hold_node_off_latch.erase(node_off);
         }
+        ExclusiveUnlockHashNodeBatch_WithWrite(yield, unlock_node_off_with_write, local_hash_nodes, sizeof(PageTableNode));
         unlock_node_off_with_write.clear();
     }
     // 这里所有的latch都已经释放了
     assert(hold_node_off_latch.size() == 0);
-}
\ No newline at end of file
+}
+// 对FetchPage时pin住的页表项, 已经知道页表项的位置, 不需要获取排他latch读取整个桶再写回
+// 1. 数据页的写回和桶的共享latch(FAA +1)按节点放入同一个doorbell, 一次round trip完成;
+//    数据页写完之后才能unpin, 否则其他计算节点可能读到旧的页面
+// 2. 桶没有被排他latch持有时, 每个页表项写入page_valid/last_access_time/referenced, 必要时CAS dirty_batch_id,
+//    再FAA rwcount, 最后FAA释放共享latch, 每个节点一个doorbell, 只有最后一个请求signaled
+// 排他latch的持有者会写回整个桶, 所以对页表项的原子操作必须在共享latch下进行
+// 没有pin记录的页面和桶正被排他latch持有的页面返回给调用者, 走UnpinPageTable的路径
+std::vector<PageId> DTX::BatchUnpinPinnedItems(coro_yield_t& yield, std::vector<PageId>& page_ids, std::unordered_map<PageId, UnpinPageArgs>& ids, 
+        std::unordered_map<node_id_t, ChainedDoorbellBatch>& data_write_batches, batch_id_t batch_id){
+
+    std::vector<PageId> fallback_page_ids;
+    std::unordered_map<NodeOffset, std::vector<PageId>> bucket_pages;
+    for(auto& page_id : page_ids){
+        if(pinned_page_items.count(page_id) == 0){
+            fallback_page_ids.push_back(page_id);
+            continue;
+        }
+        bucket_pages[pinned_page_items.at(page_id).node_off].push_back(page_id);
+    }
+
+    // round 1: 数据页写回 + 共享latch
+    std::unordered_map<NodeOffset, char*> faa_bufs;
+    for(auto& bucket : bucket_pages){
+        auto node_off = bucket.first;
+        faa_bufs[node_off] = thread_rdma_buffer_alloc->Alloc(sizeof(lock_t));
+        data_write_batches[node_off.nodeId].AddFAAReq(faa_bufs[node_off], node_off.offset, 1);
+    }
+    for(auto& batch : data_write_batches){
+        if (!batch.second.SendReqs(coro_sched, thread_qp_man->GetRemoteDataQPWithNodeID(batch.first), coro_id, yield)) {
+            RDMA_LOG(ERROR) << "BatchUnpinPinnedItems write back and get shared latch sendreqs failed";
+            assert(false);
+        }
+    }
+    if(bucket_pages.empty()) return fallback_page_ids;
+    coro_sched->Yield(yield, coro_id);
+
+    // round 2: unpin页表项并释放共享latch
+    std::unordered_map<node_id_t, ChainedDoorbellBatch> unpin_batches;
+    std::vector<std::pair<PinnedPageTableItem, char*>> dirty_cas;
+    auto lease_start = PageAddrCache::Clock::now();
+    timestamp_t now = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    // 字段的顺序由memstore/page_table.h中的static_assert保证
+    const size_t state_off = offsetof(PageTableItem, page_valid);
+    const size_t state_size = offsetof(PageTableItem, referenced) + sizeof(bool) - state_off;
+    for(auto& bucket : bucket_pages){
+        auto node_off = bucket.first;
+        if((*(lock_t*)faa_bufs[node_off] & MASKED_SHARED_LOCKS) != 0){
+            // 桶正在被排他latch持有, 撤销共享latch, 这些页面走排他latch的路径
+            ShardUnLockHashNode(node_off);
+            fallback_page_ids.insert(fallback_page_ids.end(), bucket.second.begin(), bucket.second.end());
+            continue;
+        }
+        ChainedDoorbellBatch& batch = unpin_batches[node_off.nodeId];
+        for(auto& page_id : bucket.second){
+            auto& pinned = pinned_page_items.at(page_id);
+            auto& args = ids.at(page_id);
+            bool is_write = args.type == FetchPageType::kInsertRecord || args.type == FetchPageType::kDeleteRecord;
+            bool is_dirty = args.type != FetchPageType::kReadPage;
+            offset_t item_off = node_off.offset + offsetof(PageTableNode, page_table_items) + pinned.item_idx * sizeof(PageTableItem);
+
+            PageTableItem* local_item = reinterpret_cast<PageTableItem*>(thread_rdma_buffer_alloc->Alloc(sizeof(PageTableItem)));
+            local_item->page_valid = true;
+            local_item->last_access_time = now;
+            local_item->referenced = true;
+            batch.AddWriteReq((char*)local_item + state_off, item_off + state_off, state_size);
+            if(is_dirty && pinned.dirty_batch_id < batch_id){
+                char* cas_buf = thread_rdma_buffer_alloc->Alloc(sizeof(batch_id_t));
+                batch.AddCASReq(cas_buf, item_off + offsetof(PageTableItem, dirty_batch_id), pinned.dirty_batch_id, batch_id);
+                dirty_cas.push_back(std::make_pair(pinned, cas_buf));
+            }
+            char* faa_buf = thread_rdma_buffer_alloc->Alloc(sizeof(uint64_t));
+            batch.AddFAAReq(faa_buf, item_off + offsetof(PageTableItem, rwcount), is_write ? EXCLUSIVE_UNLOCK_TO_BE_ADDED : (uint64_t)-1);
+            page_addr_cache->Insert(page_id, args.page_addr, lease_start);
+        }
+        // 同一个QP上的请求按顺序执行, 释放共享latch放在这个桶的所有请求之后
+        char* unlock_buf = thread_rdma_buffer_alloc->Alloc(sizeof(lock_t));
+        batch.AddFAAReq(unlock_buf, node_off.offset, SHARED_UNLOCK_TO_BE_ADDED);
+    }
+    for(auto& batch : unpin_batches){
+        if (!batch.second.SendReqs(coro_sched, thread_qp_man->GetRemoteDataQPWithNodeID(batch.first), coro_id, yield)) {
+            RDMA_LOG(ERROR) << "BatchUnpinPinnedItems unpin sendreqs failed";
+            assert(false);
+        }
+    }
+    if(dirty_cas.empty()) return fallback_page_ids;
+
+    // 只有脏页需要等待CAS的结果, 其他页面的unpin不需要等待完成
+    coro_sched->Yield(yield, coro_id);
+    std::vector<PinnedPageTableItem> retry_items;
+    for(auto& cas : dirty_cas){
+        batch_id_t old_batch_id = *(batch_id_t*)cas.second;
+        if(old_batch_id == cas.first.dirty_batch_id || old_batch_id >= batch_id) continue;
+        // 其他计算节点在pin之后用更小的batch修改过这个页面
+        cas.first.dirty_batch_id = old_batch_id;
+        retry_items.push_back(cas.first);
+    }
+    if(!retry_items.empty()) RaiseDirtyBatchId(yield, retry_items, batch_id);
+    return fallback_page_ids;
+}
+
+// 页表项已经unpin, 但unpin时写入了last_access_time, 在淘汰阈值之内不会被淘汰, 位置不变
+void DTX::RaiseDirtyBatchId(coro_yield_t& yield, std::vector<PinnedPageTableItem> items, batch_id_t batch_id){
+    while(!items.empty()){
+        std::unordered_map<NodeOffset, char*> faa_bufs;
+        for(auto& item : items){
+            if(faa_bufs.count(item.node_off) != 0) continue;
+            faa_bufs[item.node_off] = thread_rdma_buffer_alloc->Alloc(sizeof(lock_t));
+            if (!coro_sched->RDMAFAA(coro_id, thread_qp_man->GetRemoteDataQPWithNodeID(item.node_off.nodeId), faa_bufs[item.node_off], item.node_off.offset, 1)){
+                assert(false);
+            }
+        }
+        coro_sched->Yield(yield, coro_id);
+
+        std::vector<std::pair<PinnedPageTableItem, char*>> cas_bufs;
+        std::vector<PinnedPageTableItem> remain_items;
+        for(auto& item : items){
+            if((*(lock_t*)faa_bufs[item.node_off] & MASKED_SHARED_LOCKS) != 0){
+                remain_items.push_back(item);
+                continue;
+            }
+            char* cas_buf = thread_rdma_buffer_alloc->Alloc(sizeof(batch_id_t));
+            offset_t dirty_off = item.node_off.offset + offsetof(PageTableNode, page_table_items) + 
+                    item.item_idx * sizeof(PageTableItem) + offsetof(PageTableItem, dirty_batch_id);
+            if (!coro_sched->RDMACAS(coro_id, thread_qp_man->GetRemoteDataQPWithNodeID(item.node_off.nodeId), cas_buf, dirty_off, item.dirty_batch_id, batch_id)){
+                assert(false);
+            }
+            cas_bufs.push_back(std::make_pair(item, cas_buf));
+        }
+        coro_sched->Yield(yield, coro_id);
+        std::vector<NodeOffset> latched_node_offs;
+        for(auto& latch : faa_bufs){
+            latched_node_offs.push_back(latch.first);
+        }
+        ShardUnLockHashNodeBatch(yield, latched_node_offs);
+        for(auto& cas : cas_bufs){
+            batch_id_t old_batch_id = *(batch_id_t*)cas.second;
+            if(old_batch_id == cas.first.dirty_batch_id || old_batch_id >= batch_id) continue;
+            cas.first.dirty_batch_id = old_batch_id;
+            remain_items.push_back(cas.first);
+        }
+        items.swap(remain_items);
+    }
+}
@@ -1,38 +1,47 @@
 #include "dtx/dtx.h"
 
+// 每个内存节点的请求已经串成一个doorbell, 逐个节点发出
+void DTX::SendDoorbellBatches(coro_yield_t& yield, std::unordered_map<node_id_t, ChainedDoorbellBatch>& batches){
+    for(auto& batch : batches){
+        if (!batch.second.SendReqs(coro_sched, thread_qp_man->GetRemoteDataQPWithNodeID(batch.first), coro_id, yield)) {
+            RDMA_LOG(ERROR) << "SendDoorbellBatches sendreqs failed";
+            assert(false);
+        }
+    }
+}
+
+// 对pending_hash_node_latch_offs中的桶加共享latch并读取整个桶, 同一个内存节点的所有桶在一个doorbell中发出, 本函数在一次RTT完成
 std::vector<NodeOffset> DTX::ShardLockHashNode(coro_yield_t& yield, std::unordered_map<NodeOffset, char*>& local_hash_nodes, 
-            std::unordered_map<NodeOffset, char*>& faa_bufs){
+            std::unordered_map<NodeOffset, char*>& faa_bufs, size_t node_size){
 
+    std::unordered_map<node_id_t, ChainedDoorbellBatch> lock_batches;
     for(auto node_off: pending_hash_node_latch_offs) {
-        std::shared_ptr<SharedLock_SharedMutex_Batch> doorbell = std::make_shared<SharedLock_SharedMutex_Batch>();
-
-        // TODO: 统一IndexNode和其他Node的size大小
-        doorbell->SetFAAReq(faa_bufs[node_off], node_off.offset);
-        doorbell->SetReadReq(local_hash_nodes[node_off], node_off.offset, sizeof(LockNode));  // Read a hash index bucket
-        
-        if (!doorbell->SendReqs(coro_sched, thread_qp_man->GetRemoteDataQPWithNodeID(node_off.nodeId), coro_id)) {
-            std::cerr << "GetHashIndex get Exclusive mutex sendreqs faild" << std::endl;
-            assert(false);
-        }
+        ChainedDoorbellBatch& batch = lock_batches[node_off.nodeId];
+        // First Fetch and ADD, then read a hash index bucket
+        batch.AddFAAReq(faa_bufs[node_off], node_off.offset, 1);
+        batch.AddReadReq(local_hash_nodes[node_off], node_off.offset, node_size);
     }
+    SendDoorbellBatches(yield, lock_batches);
     // 切换到其他协程，等待其他协程释放锁
     coro_sched->Yield(yield, coro_id);
 
     std::vector<NodeOffset> success_get_latch_off;
+    std::unordered_map<node_id_t, ChainedDoorbellBatch> revoke_batches;
 
-    for(auto node_off: pending_hash_node_latch_offs){
+    for(auto it = pending_hash_node_latch_offs.begin(); it != pending_hash_node_latch_offs.end(); ){
+        auto node_off = *it;
         if((*(lock_t*)faa_bufs[node_off] & MASKED_SHARED_LOCKS) >> 56 == 0x00){
             // get lock successfully
-            pending_hash_node_latch_offs.erase(node_off);
+            it = pending_hash_node_latch_offs.erase(it);
             success_get_latch_off.push_back(node_off);
         }
         else{
             // 探测性FAA失败，FAA(-1)
-            if (!coro_sched->RDMAFAA(coro_id, thread_qp_man->GetRemoteDataQPWithNodeID(node_off.nodeId), faa_bufs[node_off], node_off.offset, SHARED_UNLOCK_TO_BE_ADDED)){
-                assert(false);
-            };
+            revoke_batches[node_off.nodeId].AddFAAReq(faa_bufs[node_off], node_off.offset, SHARED_UNLOCK_TO_BE_ADDED);
+            it++;
         }
     }
+    SendDoorbellBatches(yield, revoke_batches);
     return success_get_latch_off;
 }
 
@@ -44,32 +53,69 @@ void DTX::ShardUnLockHashNode(NodeOffset node_off){
     };
 }
 
-// 函数根据DTX中的类pending_hash_node_latch_offs, 对这些桶的上锁，本函数在一次RTT完成
+void DTX::ShardUnLockHashNodeBatch(coro_yield_t& yield, const std::vector<NodeOffset>& node_offs){
+    std::unordered_map<node_id_t, ChainedDoorbellBatch> unlock_batches;
+    for(auto node_off : node_offs){
+        char* faa_buf = thread_rdma_buffer_alloc->Alloc(sizeof(lock_t));
+        unlock_batches[node_off.nodeId].AddFAAReq(faa_buf, node_off.offset, SHARED_UNLOCK_TO_BE_ADDED);
+    }
+    SendDoorbellBatches(yield, unlock_batches);
+}
+
+// 无latch读取pending_hash_node_latch_offs中的哈希索引桶, 同一个内存节点的READ在一个doorbell中发出, 本函数在一次RTT完成
+// 返回值为读到一致内容的桶的offset, 读到的桶正在被修改时保留在pending_hash_node_latch_offs中, 由调用者重新读取
+std::vector<NodeOffset> DTX::OptimisticReadHashNode(coro_yield_t& yield, std::unordered_map<NodeOffset, char*>& local_hash_nodes){
+
+    std::unordered_map<node_id_t, ChainedDoorbellBatch> read_batches;
+    for(auto node_off: pending_hash_node_latch_offs) {
+        read_batches[node_off.nodeId].AddReadReq(local_hash_nodes[node_off], node_off.offset, sizeof(IndexNode));
+    }
+    SendDoorbellBatches(yield, read_batches);
+    // 切换到其他协程，等待读取完成
+    coro_sched->Yield(yield, coro_id);
+
+    std::vector<NodeOffset> success_read_off;
+
+    for(auto it = pending_hash_node_latch_offs.begin(); it != pending_hash_node_latch_offs.end(); ){
+        IndexNode* index_node = reinterpret_cast<IndexNode*>(local_hash_nodes[*it]);
+        if((index_node->lock & MASKED_SHARED_LOCKS) == 0 && index_node->version == index_node->rear_version){
+            success_read_off.push_back(*it);
+            it = pending_hash_node_latch_offs.erase(it);
+        }
+        else{
+            // 写者持有排他latch或者读到了写回一半的桶
+            it++;
+        }
+    }
+    return success_read_off;
+}
+
+// 函数根据DTX中的类pending_hash_node_latch_offs, 对这些桶的上锁，同一个内存节点的所有桶在一个doorbell中发出, 本函数在一次RTT完成
 // 返回值为成功获取桶latch的offset
 std::vector<NodeOffset> DTX::ExclusiveLockHashNode(coro_yield_t& yield, std::unordered_map<NodeOffset, char*>& local_hash_nodes, 
-            std::unordered_map<NodeOffset, char*>& cas_bufs){
+            std::unordered_map<NodeOffset, char*>& cas_bufs, size_t node_size){
 
+    std::unordered_map<node_id_t, ChainedDoorbellBatch> lock_batches;
     for(auto node_off: pending_hash_node_latch_offs) {
-        std::shared_ptr<ExclusiveLock_SharedMutex_Batch> doorbell = std::make_shared<ExclusiveLock_SharedMutex_Batch>();
-        doorbell->SetLockReq(cas_bufs[node_off], node_off.offset);
-        // TODO: 统一IndexNode和其他Node的size大小
-        doorbell->SetReadReq(local_hash_nodes[node_off], node_off.offset, sizeof(LockNode));  // Read a hash index bucket
-        
-        if (!doorbell->SendReqs(coro_sched, thread_qp_man->GetRemoteDataQPWithNodeID(node_off.nodeId), coro_id)) {
-            std::cerr << "GetHashIndex get Exclusive mutex sendreqs faild" << std::endl;
-            assert(false);
-        }
+        ChainedDoorbellBatch& batch = lock_batches[node_off.nodeId];
+        // First lock, then read a hash index bucket
+        batch.AddCASReq(cas_bufs[node_off], node_off.offset, UNLOCKED, EXCLUSIVE_LOCKED);
+        batch.AddReadReq(local_hash_nodes[node_off], node_off.offset, node_size);
     }
+    SendDoorbellBatches(yield, lock_batches);
     // 切换到其他协程，等待其他协程释放锁
     coro_sched->Yield(yield, coro_id);
 
     std::vector<NodeOffset> success_get_latch_off;
 
-    for(auto node_off: pending_hash_node_latch_offs){
-        if(*(lock_t*)cas_bufs[node_off] == UNLOCKED){
+    for(auto it = pending_hash_node_latch_offs.begin(); it != pending_hash_node_latch_offs.end(); ){
+        if(*(lock_t*)cas_bufs[*it] == UNLOCKED){
             // latch successful
-            pending_hash_node_latch_offs.erase(node_off);
-            success_get_latch_off.push_back(node_off);
+            success_get_latch_off.push_back(*it);
+            it = pending_hash_node_latch_offs.erase(it);
+        }
+        else{
+            it++;
         }
     }
     return success_get_latch_off;
@@ -93,14 +139,14 @@ void DTX::ExclusiveUnlockHashNode_NoWrite(NodeOffset node_off){
     // }
 }
 
-void DTX::ExclusiveUnlockHashNode_WithWrite(NodeOffset node_off, char* write_back_data){
+void DTX::ExclusiveUnlockHashNode_WithWrite(NodeOffset node_off, char* write_back_data, size_t node_size){
 
     char* faa_buf = thread_rdma_buffer_alloc->Alloc(sizeof(lock_t));
 
     std::shared_ptr<ExclusiveUnlock_SharedMutex_Batch> doorbell = std::make_shared<ExclusiveUnlock_SharedMutex_Batch>();
 
     // 不写lock，写入后面所有字节
-    doorbell->SetWriteReq(write_back_data, node_off.offset + sizeof(lock_t), sizeof(IndexNode)-sizeof(lock_t));  // Read a hash index bucket
+    doorbell->SetWriteReq(write_back_data + sizeof(lock_t), node_off.offset + sizeof(lock_t), node_size-sizeof(lock_t));
     // FAA EXCLUSIVE_UNLOCK_TO_BE_ADDED.
     doorbell->SetUnLockReq(faa_buf, node_off.offset);
 
@@ -119,6 +165,20 @@ void DTX::ExclusiveUnlockHashNode_WithWrite(NodeOffset node_off, char* write_bac
     // }
 }
 
+// 释放node_offs中所有桶的排他latch, 先写回除lock之外的整个桶, 同一个内存节点的请求在一个doorbell中发出
+void DTX::ExclusiveUnlockHashNodeBatch_WithWrite(coro_yield_t& yield, const std::unordered_set<NodeOffset>& node_offs, 
+            std::unordered_map<NodeOffset, char*>& local_hash_nodes, size_t node_size){
+    std::unordered_map<node_id_t, ChainedDoorbellBatch> unlock_batches;
+    for(auto node_off : node_offs){
+        ChainedDoorbellBatch& batch = unlock_batches[node_off.nodeId];
+        char* faa_buf = thread_rdma_buffer_alloc->Alloc(sizeof(lock_t));
+        // 不写lock，写入后面所有字节, 然后FAA EXCLUSIVE_UNLOCK_TO_BE_ADDED
+        batch.AddWriteReq(local_hash_nodes.at(node_off) + sizeof(lock_t), node_off.offset + sizeof(lock_t), node_size - sizeof(lock_t));
+        batch.AddFAAReq(faa_buf, node_off.offset, EXCLUSIVE_UNLOCK_TO_BE_ADDED);
+    }
+    SendDoorbellBatches(yield, unlock_batches);
+}
+
 // // 以下是非batching的上锁函数
 // char* ExclusiveLockHashNode(RDMABufferAllocator* thread_rdma_buffer_alloc, offset_t node_off, DTX* dtx, RCQP* qp){
 
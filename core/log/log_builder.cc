@@ -0,0 +1,62 @@
+#include "log_builder.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+#include "util/debug.h"
+
+void LogBuilder::append(const LogRecord& log) {
+    size_t len = log.log_tot_len_;
+    size_ += len;
+    if (len <= (size_t)cur_len_) {
+        // 大部分日志可以直接序列化到block中
+        log.serialize(cur_);
+        cur_ += len;
+        cur_len_ -= len;
+        return;
+    }
+
+    // 日志需要跨越block, 先序列化到scratch_再分段拷贝
+    if (scratch_.size() < len) scratch_.resize(len);
+    log.serialize(scratch_.data());
+    const char* src = scratch_.data();
+    while (len > 0) {
+        if (cur_len_ == 0) next_block();
+        size_t n = std::min(len, (size_t)cur_len_);
+        memcpy(cur_, src, n);
+        cur_ += n;
+        cur_len_ -= n;
+        src += n;
+        len -= n;
+    }
+}
+
+void LogBuilder::move_to(butil::IOBuf* out) {
+    return_unused();
+    out->append(butil::IOBuf::Movable(buf_));
+    size_ = 0;
+}
+
+void LogBuilder::clear() {
+    return_unused();
+    buf_.clear();
+    size_ = 0;
+}
+
+void LogBuilder::next_block() {
+    void* data;
+    if (!stream_.Next(&data, &cur_len_)) {
+        RDMA_LOG(FATAL) << "LogBuilder: fail to allocate IOBuf block";
+    }
+    cur_ = (char*)data;
+}
+
+// 把当前block中没有使用的空间还给stream, 这样buf_中只包含已经写入的日志
+void LogBuilder::return_unused() {
+    if (cur_len_ > 0) {
+        stream_.BackUp(cur_len_);
+        cur_ = nullptr;
+        cur_len_ = 0;
+    }
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <butil/iobuf.h>
+
+#include <vector>
+
+#include "log_record.h"
+
+/**
+ * 把一个batch的LogRecord直接序列化到butil::IOBuf的block中, 不为每条日志分配临时内存
+ * IOBuf的block来自brpc的内存池, 开启RDMA时就是已经注册的内存, 通过move_to交给LogWrite请求的attachment之后不再拷贝
+ * builder可以重复使用, move_to之后继续写入当前block剩余的空间
+ */
+class LogBuilder {
+public:
+    LogBuilder() : stream_(&buf_) {}
+
+    /**
+     * @description: 在末尾追加一条日志
+     * @param {LogRecord&} log 需要序列化的日志, 长度为log.log_tot_len_
+     */
+    void append(const LogRecord& log);
+
+    // 已经追加的日志总字节数
+    size_t size() const { return size_; }
+
+    /**
+     * @description: 把已经序列化的日志移动到out的末尾, 不拷贝数据, 之后builder为空
+     * @param {IOBuf*} out 一般为brpc::Controller::request_attachment()
+     */
+    void move_to(butil::IOBuf* out);
+
+    void clear();
+
+private:
+    void next_block();
+    void return_unused();
+
+    butil::IOBuf buf_;
+    butil::IOBufAsZeroCopyOutputStream stream_;
+    char* cur_ = nullptr;           // 当前block中下一个可写的位置
+    int cur_len_ = 0;               // 当前block中剩余的可写字节数
+    size_t size_ = 0;
+    std::vector<char> scratch_;     // 放不进当前block剩余空间的日志先序列化到这里
+};
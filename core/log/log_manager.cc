@@ -1,32 +1,166 @@
 #include <unistd.h>
 #include <assert.h>
+#include <errno.h>
+#include <limits.h>
 #include <sys/stat.h>
+#include <sys/uio.h>
 #include <fcntl.h>
 
+#include <algorithm>
+
 #include "log_manager.h"
 
-LogManager::LogManager(DiskManager* disk_manager, LogReplay* log_replay)
-        :disk_manager_(disk_manager), log_replay_(log_replay) {
+LogManager::LogManager(DiskManager* disk_manager, LogReplay* log_replay, GroupCommitConfig config)
+        :disk_manager_(disk_manager), log_replay_(log_replay), config_(config) {
     // if(!disk_manager_->is_file(LOG_FILE_NAME)) {
     //     disk_manager_->create_file(LOG_FILE_NAME);
     // }
     log_file_fd_ = disk_manager_->open_file(LOG_FILE_NAME);
+    append_off_ = disk_manager_->get_file_size(LOG_FILE_NAME);
     // batch_id_t init_batch_id = INVALID_BATCH_ID;
     // size_t init_persist_off = sizeof(batch_id_t) + sizeof(size_t);
     // write(log_file_fd_, &init_batch_id, sizeof(batch_id_t));
     // write(log_file_fd_, &init_persist_off, sizeof(size_t));
+
+    RDMA_LOG(INFO) << "LogManager group commit: flush_interval_us: " << config_.flush_interval_us
+                   << ", max_group_bytes: " << config_.max_group_bytes << ", max_group_size: " << config_.max_group_size;
+    writer_thread_ = std::thread(&LogManager::log_writer, this);
+}
+
+LogManager::~LogManager() {
+    {
+        std::lock_guard<std::mutex> latch(queue_latch_);
+        stop_ = true;
+    }
+    queue_cv_.notify_all();
+    if (writer_thread_.joinable()) {
+        writer_thread_.join();
+    }
+    close(log_file_fd_);
+}
+
+void LogManager::append_batch_log(std::string batch_log, std::function<void()> on_persisted) {
+    bool need_notify;
+    {
+        std::lock_guard<std::mutex> latch(queue_latch_);
+        if (pending_logs_.empty()) {
+            first_pending_time_ = std::chrono::steady_clock::now();
+        }
+        pending_bytes_ += batch_log.length();
+        pending_logs_.push_back({std::move(batch_log), std::move(on_persisted)});
+        // 只有队列从空变为非空(writer开始计时)或者达到阈值时才需要唤醒writer
+        need_notify = pending_logs_.size() == 1 || pending_bytes_ >= config_.max_group_bytes ||
+                      pending_logs_.size() >= config_.max_group_size;
+    }
+    if (need_notify) queue_cv_.notify_one();
 }
 
 void LogManager::write_batch_log_to_disk(std::string batch_log) {
-    if (log_file_fd_ == -1) {
-        log_file_fd_ = disk_manager_->open_file(LOG_FILE_NAME);
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool persisted = false;
+    append_batch_log(std::move(batch_log), [&]() {
+        std::lock_guard<std::mutex> latch(mutex);
+        persisted = true;
+        cv.notify_one();
+    });
+    std::unique_lock<std::mutex> latch(mutex);
+    cv.wait(latch, [&]() { return persisted; });
+}
+
+GroupCommitStats LogManager::get_stats() {
+    std::lock_guard<std::mutex> latch(stats_latch_);
+    return stats_;
+}
+
+void LogManager::log_writer() {
+    std::vector<PendingLog> group;
+    std::unique_lock<std::mutex> latch(queue_latch_);
+    while (true) {
+        if (pending_logs_.empty()) {
+            if (stop_) break;
+            queue_cv_.wait(latch, [&]() { return stop_ || !pending_logs_.empty(); });
+            continue;
+        }
+        // 等待直到group足够大或者第一条日志等待超时
+        auto deadline = first_pending_time_ + std::chrono::microseconds(config_.flush_interval_us);
+        while (!stop_ && pending_bytes_ < config_.max_group_bytes && pending_logs_.size() < config_.max_group_size &&
+               std::chrono::steady_clock::now() < deadline) {
+            queue_cv_.wait_until(latch, deadline);
+        }
+        group.swap(pending_logs_);
+        size_t group_bytes = pending_bytes_;
+        pending_bytes_ = 0;
+
+        latch.unlock();
+        flush_group(group, group_bytes);
+        group.clear();
+        latch.lock();
+    }
+}
+
+/**
+ * @description: 把一个group的日志用pwritev写入日志文件末尾并fdatasync, 然后通知log replay和所有等待的请求
+ * @param {vector<PendingLog>&} group 需要刷盘的batch日志
+ * @param {size_t} group_bytes group中日志的总字节数
+ */
+void LogManager::flush_group(std::vector<PendingLog>& group, size_t group_bytes) {
+    std::vector<struct iovec> iovs;
+    iovs.reserve(group.size());
+    for (auto& pending : group) {
+        if (pending.log.empty()) continue;
+        iovs.push_back({&pending.log[0], pending.log.length()});
+    }
+
+    // pwritev一次最多IOV_MAX个iovec, 并且可能只写入一部分
+    size_t iov_idx = 0;
+    off_t off = append_off_;
+    while (iov_idx < iovs.size()) {
+        int iov_cnt = std::min(iovs.size() - iov_idx, (size_t)IOV_MAX);
+        ssize_t bytes_write = pwritev(log_file_fd_, &iovs[iov_idx], iov_cnt, off);
+        if (bytes_write < 0) {
+            if (errno == EINTR) continue;
+            RDMA_LOG(FATAL) << "LogManager::flush_group Error: pwritev fails, errno: " << errno;
+        }
+        off += bytes_write;
+        while (bytes_write > 0) {
+            if ((size_t)bytes_write >= iovs[iov_idx].iov_len) {
+                bytes_write -= iovs[iov_idx].iov_len;
+                iov_idx++;
+            } else {
+                iovs[iov_idx].iov_base = (char*)iovs[iov_idx].iov_base + bytes_write;
+                iovs[iov_idx].iov_len -= bytes_write;
+                bytes_write = 0;
+            }
+        }
+    }
+    assert((size_t)(off - append_off_) == group_bytes);
+
+    auto fsync_start = std::chrono::steady_clock::now();
+    if (fdatasync(log_file_fd_) != 0) {
+        RDMA_LOG(FATAL) << "LogManager::flush_group Error: fdatasync fails, errno: " << errno;
     }
+    uint64_t fsync_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - fsync_start).count();
+    append_off_ = off;
 
-    lseek(log_file_fd_, 0, SEEK_END);
-    ssize_t bytes_write = write(log_file_fd_, batch_log.c_str(), batch_log.length() * sizeof(char));
-    assert(bytes_write == batch_log.length() * sizeof(char));
+    // 日志已经持久化, 可以被重放
+    log_replay_->add_max_replay_off_(group_bytes);
 
-    RDMA_LOG(INFO) << "Write batch log's size is " << bytes_write;
+    for (auto& pending : group) {
+        if (pending.on_persisted) pending.on_persisted();
+    }
 
-    log_replay_->add_max_replay_off_(bytes_write);
-}
\ No newline at end of file
+    std::lock_guard<std::mutex> latch(stats_latch_);
+    stats_.group_num++;
+    stats_.batch_num += group.size();
+    stats_.bytes += group_bytes;
+    stats_.fsync_total_us += fsync_us;
+    stats_.fsync_max_us = std::max(stats_.fsync_max_us, fsync_us);
+    if (stats_.group_num % 1000 == 0) {
+        RDMA_LOG(INFO) << "LogManager group commit: groups: " << stats_.group_num
+                       << ", avg group size: " << (double)stats_.batch_num / stats_.group_num
+                       << ", avg group bytes: " << stats_.bytes / stats_.group_num
+                       << ", avg fsync us: " << stats_.fsync_total_us / stats_.group_num
+                       << ", max fsync us: " << stats_.fsync_max_us;
+    }
+}
@@ -1,20 +1,81 @@
 #pragma once
 
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include "base/common.h"
 #include "storage/disk_manager.h"
 #include "logreplay.h"
 
+// group commit的触发条件, 满足任意一个就刷盘
+struct GroupCommitConfig {
+    int flush_interval_us = 100;            // 第一条batch日志最多等待的时间
+    size_t max_group_bytes = 1 << 20;       // 一个group累计的日志字节数
+    size_t max_group_size = 256;            // 一个group累计的batch日志条数
+};
+
+struct GroupCommitStats {
+    uint64_t group_num = 0;                 // 刷盘的group个数
+    uint64_t batch_num = 0;                 // 刷盘的batch日志条数
+    uint64_t bytes = 0;                     // 刷盘的日志字节数
+    uint64_t fsync_total_us = 0;            // fdatasync的总耗时
+    uint64_t fsync_max_us = 0;              // fdatasync的最大耗时
+};
+
+/**
+ * 日志的group commit写入: RPC线程把batch日志追加到内存队列后立即返回, 由后台的log writer线程
+ * 把累积的日志用一次pwritev + fdatasync写入磁盘, 然后一起通知所有等待的请求
+ */
 class LogManager {
 public:
-    LogManager(DiskManager* disk_manager, LogReplay* log_replay);
-    ~LogManager(){}
+    LogManager(DiskManager* disk_manager, LogReplay* log_replay, GroupCommitConfig config = GroupCommitConfig());
+    ~LogManager();
 
     // lsn_t add_log_to_buffer(std::string log_record);
+
+    /**
+     * @description: 把batch日志加入group commit队列, 日志持久化之后在log writer线程中调用on_persisted
+     * @param {string} batch_log 一个batch的日志
+     * @param {function<void()>} on_persisted 日志落盘后的回调, 不应阻塞
+     */
+    void append_batch_log(std::string batch_log, std::function<void()> on_persisted);
+
+    // 同步写入batch日志, 返回时日志已经落盘
     void write_batch_log_to_disk(std::string batch_log);
 
+    GroupCommitStats get_stats();
+
     int log_file_fd_;
     DiskManager* disk_manager_;
     LogReplay* log_replay_;
-};
\ No newline at end of file
+
+private:
+    struct PendingLog {
+        std::string log;
+        std::function<void()> on_persisted;
+    };
+
+    void log_writer();
+    void flush_group(std::vector<PendingLog>& group, size_t group_bytes);
+
+    GroupCommitConfig config_;
+
+    std::mutex queue_latch_;                // 保护pending_logs_, pending_bytes_和stop_
+    std::condition_variable queue_cv_;
+    std::vector<PendingLog> pending_logs_;  // 等待刷盘的batch日志
+    size_t pending_bytes_ = 0;
+    std::chrono::steady_clock::time_point first_pending_time_;
+    bool stop_ = false;
+
+    off_t append_off_;                      // 下一个group写入的位置, 只由log writer线程修改
+
+    std::mutex stats_latch_;
+    GroupCommitStats stats_;
+
+    std::thread writer_thread_;
+};
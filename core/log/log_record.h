@@ -2,6 +2,7 @@
 
 #include <string.h>
 #include <string>
+#include <utility>
 
 #include "base/common.h"
 #include "base/page.h"
@@ -190,12 +191,12 @@ public:
         table_name_ = nullptr;
         table_name_size_ = 0;
     }
-    InsertLogRecord(batch_id_t batch_id, node_id_t node_id, tx_id_t txn_id, RmRecord& insert_value, Rid& rid, std::string table_name) 
+    InsertLogRecord(batch_id_t batch_id, node_id_t node_id, tx_id_t txn_id, RmRecord insert_value, Rid& rid, std::string table_name) 
         : InsertLogRecord() {
         log_batch_id_ = batch_id;
         log_tid_ = txn_id;
         log_node_id_ = node_id;
-        insert_value_ = insert_value;
+        insert_value_ = std::move(insert_value);
         rid_ = rid;
         log_tot_len_ += sizeof(itemkey_t);
         log_tot_len_ += sizeof(size_t);
@@ -363,6 +364,8 @@ public:
         offset += table_name_size_;
         page_no_ = *reinterpret_cast<const int*>(src + offset);
         offset += sizeof(int);
+        bucket_offset_ = *reinterpret_cast<const int*>(src + offset);
+        offset += sizeof(int);
         bucket_value_ = *reinterpret_cast<const char*>(src + offset);
         offset += sizeof(char);
         page_hdr_ = *reinterpret_cast<const RmPageHdr*>(src + offset);
@@ -399,13 +402,13 @@ public:
         prev_lsn_ = INVALID_LSN;
         table_name_ = nullptr;
     }
-    UpdateLogRecord(batch_id_t batch_id, node_id_t node_id, tx_id_t txn_id, RmRecord& new_value,const Rid& rid, std::string table_name)
+    UpdateLogRecord(batch_id_t batch_id, node_id_t node_id, tx_id_t txn_id, RmRecord new_value,const Rid& rid, std::string table_name)
         : UpdateLogRecord() {
         log_batch_id_ = batch_id;
         log_tid_ = txn_id;
         log_node_id_ = node_id;
         // old_value_ = old_value;
-        new_value_ = new_value;
+        new_value_ = std::move(new_value);
         log_tot_len_ += sizeof(itemkey_t);
         log_tot_len_ += sizeof(size_t);
         log_tot_len_ += new_value_.value_size_;
@@ -565,4 +568,80 @@ public:
     void format_print() override {
         LogRecord::format_print();
     }
-};
\ No newline at end of file
+};
+/**
+ * 日志记录的只读视图, 直接从序列化的日志中按偏移读取字段, 不拷贝也不分配内存, 用于日志重放
+ * 视图只在src指向的buffer有效期间可用, 只能调用当前日志类型拥有的字段的访问函数
+ */
+class LogRecordView {
+public:
+    explicit LogRecordView(const char* src) : src_(src) {}
+
+    batch_id_t batch_id() const { return load<batch_id_t>(OFFSET_BATCH_ID); }
+    LogType type() const { return load<LogType>(OFFSET_LOG_TYPE); }
+    uint32_t tot_len() const { return load<uint32_t>(OFFSET_LOG_TOT_LEN); }
+
+    // UPDATE, INSERT: 新的记录和记录的位置
+    itemkey_t key() const { return load<itemkey_t>(OFFSET_LOG_DATA); }
+    size_t value_size() const { return load<size_t>(OFFSET_LOG_DATA + sizeof(itemkey_t)); }
+    const char* value() const { return src_ + OFFSET_LOG_DATA + sizeof(itemkey_t) + sizeof(size_t); }
+    Rid rid() const { return load<Rid>(rid_offset()); }
+
+    // UPDATE, INSERT, DELETE, NEWPAGE: 表名, 不以'\0'结尾
+    size_t table_name_size() const { return load<size_t>(table_name_offset()); }
+    const char* table_name() const { return src_ + table_name_offset() + sizeof(size_t); }
+
+    // DELETE, NEWPAGE: 删除记录所在的页面/新分配的页面
+    page_id_t page_no() const {
+        return type() == LogType::NEWPAGE ? load<page_id_t>(OFFSET_LOG_DATA) : load<page_id_t>(meta_offset());
+    }
+    // INSERT, DELETE: 需要修改的bitmap
+    int bucket_offset() const { return load<int>(bucket_offset_offset()); }
+    char bucket_value() const { return load<char>(bucket_offset_offset() + sizeof(int)); }
+    // INSERT: 修改后的page_hdr.num_records
+    int num_records() const { return load<int>(bucket_offset_offset() + sizeof(int) + sizeof(char)); }
+    // DELETE: 修改后的page_hdr
+    RmPageHdr page_hdr() const { return load<RmPageHdr>(bucket_offset_offset() + sizeof(int) + sizeof(char)); }
+    // NEWPAGE: 修改后的file_hdr.num_pages
+    int num_pages() const { return load<int>(meta_offset()); }
+    // INSERT, DELETE, NEWPAGE: 修改后的file_hdr.first_free_page_no
+    int first_free_page_no() const {
+        switch (type()) {
+            case LogType::INSERT:
+                return load<int>(bucket_offset_offset() + sizeof(int) + sizeof(char) + sizeof(int));
+            case LogType::DELETE:
+                return load<int>(bucket_offset_offset() + sizeof(int) + sizeof(char) + sizeof(RmPageHdr));
+            default:
+                return load<int>(meta_offset() + sizeof(int));
+        }
+    }
+
+private:
+    template <typename T>
+    T load(size_t offset) const {
+        T value;
+        memcpy(&value, src_ + offset, sizeof(T));
+        return value;
+    }
+
+    size_t rid_offset() const { return OFFSET_LOG_DATA + sizeof(itemkey_t) + sizeof(size_t) + value_size(); }
+    // 表名长度字段的偏移
+    size_t table_name_offset() const {
+        switch (type()) {
+            case LogType::UPDATE:
+            case LogType::INSERT:
+                return rid_offset() + sizeof(Rid);
+            case LogType::NEWPAGE:
+                return OFFSET_LOG_DATA + sizeof(int);
+            default:
+                return OFFSET_LOG_DATA;
+        }
+    }
+    // 表名之后第一个字段的偏移
+    size_t meta_offset() const { return table_name_offset() + sizeof(size_t) + table_name_size(); }
+    size_t bucket_offset_offset() const {
+        return type() == LogType::DELETE ? meta_offset() + sizeof(int) : meta_offset();
+    }
+
+    const char* src_;
+};
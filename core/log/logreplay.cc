@@ -1,85 +1,263 @@
 #include <assert.h>
+#include <algorithm>
+#include <vector>
 
 #include "logreplay.h"
 
-void LogReplay::apply_sigle_log(LogRecord* log, int curr_offset) {
-    switch(log->log_type_) {
+void LogReplay::apply_sigle_log(const LogRecordView& log, size_t curr_offset) {
+    switch(log.type()) {
         case LogType::INSERT: {
-            InsertLogRecord* insert_log = dynamic_cast<InsertLogRecord*>(log);
-
-            RDMA_LOG(INFO) << "Insert log: insert page_no: " << insert_log->rid_.page_no_;
-
-            std::string table_name(insert_log->table_name_, insert_log->table_name_ + insert_log->table_name_size_);
-            int fd = disk_manager_->get_file_fd(table_name);
+            int fd = get_table_fd(log.table_name(), log.table_name_size());
             // 每个表的元数据应该就放在表的第一页，每个页面的元数据放在页面的头部，所以对元数据的更改直接修改对应页面就行了
-            // disk_manager_->set_bitmap(fd, insert_log->rid_.page_no_, insert_log->slot_no_);
-            disk_manager_->update_value(fd, PAGE_NO_RM_FILE_HDR, OFFSET_FIRST_FREE_PAGE_NO, (char*)(&insert_log->first_free_page_no_), sizeof(int));
-            disk_manager_->update_value(fd, insert_log->rid_.page_no_, OFFSET_NUM_RECORDS, (char*)(&insert_log->num_records_), sizeof(int));
-            disk_manager_->update_value(fd, insert_log->rid_.page_no_, insert_log->bucket_offset_, &insert_log->bucket_value_, sizeof(char));
-            disk_manager_->update_value(fd, insert_log->rid_.page_no_, insert_log->rid_.slot_no_, (char*)&insert_log->insert_value_.key_, sizeof(itemkey_t));
-            disk_manager_->update_value(fd, insert_log->rid_.page_no_, insert_log->rid_.slot_no_ + sizeof(itemkey_t), insert_log->insert_value_.value_, insert_log->insert_value_.value_size_ * sizeof(char));
+            // 修改先应用到重放页面缓存中, BATCHEND时统一写回
+            Rid rid = log.rid();
+            itemkey_t key = log.key();
+            int first_free_page_no = log.first_free_page_no();
+            int num_records = log.num_records();
+            char bucket_value = log.bucket_value();
+            redo_page_update(fd, PAGE_NO_RM_FILE_HDR, OFFSET_FIRST_FREE_PAGE_NO, (char*)&first_free_page_no, sizeof(int));
+            redo_page_update(fd, rid.page_no_, OFFSET_NUM_RECORDS, (char*)&num_records, sizeof(int));
+            redo_page_update(fd, rid.page_no_, log.bucket_offset(), &bucket_value, sizeof(char));
+            redo_page_update(fd, rid.page_no_, rid.slot_no_, (char*)&key, sizeof(itemkey_t));
+            redo_page_update(fd, rid.page_no_, rid.slot_no_ + sizeof(itemkey_t), log.value(), log.value_size());
         } break;
         case LogType::DELETE: {
-            DeleteLogRecord* delete_log = dynamic_cast<DeleteLogRecord*>(log);
-
-            RDMA_LOG(INFO) << "Delete log: page_no: " << delete_log->page_no_;
-            
-            std::string table_name(delete_log->table_name_, delete_log->table_name_ + delete_log->table_name_size_);
-            int fd = disk_manager_->get_file_fd(table_name);
-            disk_manager_->update_value(fd, PAGE_NO_RM_FILE_HDR, OFFSET_FIRST_FREE_PAGE_NO, (char*)(&delete_log->first_free_page_no_), sizeof(int));
-            disk_manager_->update_value(fd, delete_log->page_no_, OFFSET_PAGE_HDR, (char*)&delete_log->page_hdr_, sizeof(RmPageHdr));
-            disk_manager_->update_value(fd, delete_log->page_no_, delete_log->bucket_offset_, &delete_log->bucket_value_, sizeof(char));
+            int fd = get_table_fd(log.table_name(), log.table_name_size());
+            page_id_t page_no = log.page_no();
+            int first_free_page_no = log.first_free_page_no();
+            RmPageHdr page_hdr = log.page_hdr();
+            char bucket_value = log.bucket_value();
+            redo_page_update(fd, PAGE_NO_RM_FILE_HDR, OFFSET_FIRST_FREE_PAGE_NO, (char*)&first_free_page_no, sizeof(int));
+            redo_page_update(fd, page_no, OFFSET_PAGE_HDR, (char*)&page_hdr, sizeof(RmPageHdr));
+            redo_page_update(fd, page_no, log.bucket_offset(), &bucket_value, sizeof(char));
         } break;
         case LogType::UPDATE: {
-            UpdateLogRecord* update_log = dynamic_cast<UpdateLogRecord*>(log);
-            
-            RDMA_LOG(INFO) << "Update log: page_no: " << update_log->rid_.page_no_;
-            
-            std::string table_name(update_log->table_name_, update_log->table_name_ + update_log->table_name_size_);
-            int fd = disk_manager_->get_file_fd(table_name);
-            disk_manager_->update_value(fd, update_log->rid_.page_no_, update_log->rid_.slot_no_ + sizeof(itemkey_t), update_log->new_value_.value_, update_log->new_value_.value_size_ * sizeof(char));
+            int fd = get_table_fd(log.table_name(), log.table_name_size());
+            Rid rid = log.rid();
+            redo_page_update(fd, rid.page_no_, rid.slot_no_ + sizeof(itemkey_t), log.value(), log.value_size());
         } break;
         case LogType::NEWPAGE: {
-            NewPageLogRecord* new_page_log = dynamic_cast<NewPageLogRecord*>(log);
+            int fd = get_table_fd(log.table_name(), log.table_name_size());
+            page_id_t page_no = log.page_no();
+            // next_free_page_no不在日志中, 新页面总是没有下一个空闲页面
+            int next_free_page_no = -1;
+            int num_pages = log.num_pages();
+            int first_free_page_no = log.first_free_page_no();
 
-            RDMA_LOG(INFO) << "New page log: page_no: " << new_page_log->page_no_;
+            // 新页面直接在缓存中初始化, 不需要从磁盘读取
+            redo_new_page(fd, page_no);
+            redo_page_update(fd, page_no, OFFSET_NEXT_FREE_PAGE_NO, (char*)&next_free_page_no, sizeof(int));
+            redo_page_update(fd, PAGE_NO_RM_FILE_HDR, OFFSET_NUM_PAGES, (char*)&num_pages, sizeof(int));
+            redo_page_update(fd, PAGE_NO_RM_FILE_HDR, OFFSET_FIRST_FREE_PAGE_NO, (char*)&first_free_page_no, sizeof(int));
+        } break;
+        case LogType::BATCHEND: {
+            redo_batch_end(log.batch_id(), curr_offset + log.tot_len() - 1);
+        } break;
+        default:
+        break;
+    }
+}
 
-            std::string table_name(new_page_log->table_name_, new_page_log->table_name_ + new_page_log->table_name_size_);
-            int fd = disk_manager_->get_file_fd(table_name);
-            // int page_no = disk_manager_->allocate_page(fd);
-            // assert(page_no == new_page_log->page_no_);
+/**
+ * @description: 根据日志中的表名获取表文件的句柄, 表名只在第一次出现时转换为string并打开文件
+ * @return {int} 表文件的句柄
+ * @param {char*} table_name 日志中的表名, 不以'\0'结尾
+ * @param {size_t} size 表名的长度
+ */
+int LogReplay::get_table_fd(const char* table_name, size_t size) {
+    // 表的数量很少, 线性查找比构造string再查哈希表更快
+    for (auto& table : table_fds_) {
+        if (table.first.size() == size && memcmp(table.first.data(), table_name, size) == 0) {
+            return table.second;
+        }
+    }
+    std::string name(table_name, size);
+    int fd = disk_manager_->get_file_fd(name);
+    table_fds_.emplace_back(std::move(name), fd);
+    return fd;
+}
 
-            char init_value[PAGE_SIZE];
-            memset(init_value, 0, PAGE_SIZE);
-            disk_manager_->write_page(fd, new_page_log->page_no_, (const char*)&init_value, PAGE_SIZE);
+// 串行重放时直接修改页面缓存, 并行重放时交给负责这个页面的applier, 同一个页面的修改总是按日志顺序应用
+void LogReplay::redo_page_update(int fd, page_id_t page_no, int offset, const char* value, size_t size) {
+    if (appliers_.empty()) {
+        page_cache_.update_page(fd, page_no, offset, value, size);
+        return;
+    }
+    ReplayTask& task = get_applier(fd, page_no)->pending_task_;
+    task.ops_.push_back({ReplayOp::UPDATE, fd, page_no, offset, (uint32_t)size, task.data_.size(), nullptr});
+    task.data_.append(value, size);
+}
 
-            disk_manager_->update_value(fd, PAGE_NO_RM_FILE_HDR, OFFSET_NUM_PAGES, (char*)(&new_page_log->num_pages_), sizeof(int));
-            disk_manager_->update_value(fd, PAGE_NO_RM_FILE_HDR, OFFSET_FIRST_FREE_PAGE_NO, (char*)(&new_page_log->first_free_page_no_), sizeof(int));
-            disk_manager_->update_value(fd, new_page_log->page_no_, OFFSET_NEXT_FREE_PAGE_NO, (char*)(&new_page_log->next_free_page_no_), sizeof(int));
-        } break;
-        case LogType::BATCHEND: {
-            BatchEndLogRecord* batch_end_log = dynamic_cast<BatchEndLogRecord*>(log);
+void LogReplay::redo_new_page(int fd, page_id_t page_no) {
+    if (appliers_.empty()) {
+        page_cache_.get_page(fd, page_no, true);
+        return;
+    }
+    ReplayTask& task = get_applier(fd, page_no)->pending_task_;
+    task.ops_.push_back({ReplayOp::NEW_PAGE, fd, page_no, 0, 0, 0, nullptr});
+}
 
-            std::unique_lock<std::mutex> latch(latch2_);
-            persist_batch_id_ = batch_end_log->log_batch_id_;
-            persist_off_ = curr_offset + batch_end_log->log_tot_len_;
-            latch.unlock();
+/**
+ * @description: 重放BATCHEND, 这个batch修改的页面全部落盘之后才能推进persist_batch_id
+ * @param {batch_id_t} batch_id 结束的batch id
+ * @param {size_t} persist_off BATCHEND日志最后一个字节的偏移量
+ */
+void LogReplay::redo_batch_end(batch_id_t batch_id, size_t persist_off) {
+    if (appliers_.empty()) {
+        std::vector<int> fds;
+        page_cache_.write_back(fds);
+        for (int fd : fds) {
+            disk_manager_->sync_file(fd);
+        }
+        advance_persist_batch(batch_id, persist_off);
+        return;
+    }
+    // 每个applier都会处理到这个barrier, 最后一个到达的applier负责fdatasync并推进persist_batch_id
+    ReplayBarrier* barrier = new ReplayBarrier();
+    barrier->batch_id_ = batch_id;
+    barrier->persist_off_ = persist_off;
+    barrier->remaining_ = (int)appliers_.size();
+    for (auto& applier : appliers_) {
+        applier->pending_task_.ops_.push_back({ReplayOp::BARRIER, -1, INVALID_PAGE_ID, 0, 0, 0, barrier});
+    }
+}
 
-            RDMA_LOG(INFO) << "Update persist_batch_id, new persist_batch_id: " << persist_batch_id_;
-            RDMA_LOG(INFO) << "Update persist_off, new persist_off: " << persist_off_;
+/**
+ * @description: 推进persist_batch_id和persist_off, 唤醒等待的请求并把它们写入日志文件头
+ *               并行重放时barrier按日志顺序完成, 所以这个函数不会被并发调用
+ */
+void LogReplay::advance_persist_batch(batch_id_t batch_id, size_t persist_off) {
+    std::vector<std::function<void()>> ready_waiters;
 
-            lseek(log_write_head_fd_, 0, SEEK_SET);
-            ssize_t result = write(log_write_head_fd_, &persist_batch_id_, sizeof(batch_id_t));
-            if (result == -1) {
-                RDMA_LOG(FATAL) << "Fail to write persist_batch_id into log_file";
-            }
-            result = write(log_write_head_fd_, &persist_off_, sizeof(uint64_t));
-            if (result == -1) {
-                RDMA_LOG(FATAL) << "Fail to write persist_off into log_file";
+    std::unique_lock<std::mutex> latch(latch2_);
+    persist_batch_id_.store(batch_id, std::memory_order_release);
+    persist_off_ = persist_off;
+    // 取出所有等待的batch已经持久化的请求
+    auto waiter_end = persist_waiters_.upper_bound(batch_id);
+    for (auto it = persist_waiters_.begin(); it != waiter_end; ++it) {
+        ready_waiters.push_back(std::move(it->second));
+    }
+    persist_waiters_.erase(persist_waiters_.begin(), waiter_end);
+    latch.unlock();
+
+    // 在锁外唤醒等待的请求
+    for (auto& waiter : ready_waiters) {
+        waiter();
+    }
+
+    if (pwrite(log_write_head_fd_, &batch_id, sizeof(batch_id_t), 0) == -1) {
+        RDMA_LOG(FATAL) << "Fail to write persist_batch_id into log_file";
+    }
+    if (pwrite(log_write_head_fd_, &persist_off, sizeof(uint64_t), sizeof(batch_id_t)) == -1) {
+        RDMA_LOG(FATAL) << "Fail to write persist_off into log_file";
+    }
+}
+
+// 把reader线程为每个applier构造的task放入applier的队列, 队列满时等待applier消费
+void LogReplay::submit_replay_tasks() {
+    for (auto& applier : appliers_) {
+        if (applier->pending_task_.ops_.empty()) continue;
+        std::unique_lock<std::mutex> latch(applier->latch_);
+        applier->cv_.wait(latch, [&]() { return applier->tasks_.size() < MAX_QUEUED_REPLAY_TASKS; });
+        applier->tasks_.push_back(std::move(applier->pending_task_));
+        latch.unlock();
+        applier->cv_.notify_all();
+        applier->pending_task_.ops_.clear();
+        applier->pending_task_.data_.clear();
+    }
+}
+
+void LogReplay::applierFun(ReplayApplier* applier) {
+    std::vector<int> fds;
+    while (true) {
+        std::unique_lock<std::mutex> latch(applier->latch_);
+        applier->cv_.wait(latch, [&]() { return applier->stop_ || !applier->tasks_.empty(); });
+        // 停止时先处理完队列中剩余的task, 否则其中的barrier永远等不到这个applier, 也不会被释放
+        if (applier->tasks_.empty()) break;
+        ReplayTask task = std::move(applier->tasks_.front());
+        applier->tasks_.pop_front();
+        latch.unlock();
+        applier->cv_.notify_all();
+
+        for (auto& op : task.ops_) {
+            switch (op.type_) {
+                case ReplayOp::UPDATE:
+                    applier->page_cache_.update_page(op.fd_, op.page_no_, op.offset_, &task.data_[op.data_off_], op.size_);
+                    break;
+                case ReplayOp::NEW_PAGE:
+                    applier->page_cache_.get_page(op.fd_, op.page_no_, true);
+                    break;
+                case ReplayOp::BARRIER: {
+                    ReplayBarrier* barrier = op.barrier_;
+                    fds.clear();
+                    applier->page_cache_.write_back(fds);
+                    if (!fds.empty()) {
+                        std::lock_guard<std::mutex> barrier_latch(barrier->latch_);
+                        for (int fd : fds) {
+                            if (std::find(barrier->fds_.begin(), barrier->fds_.end(), fd) == barrier->fds_.end()) barrier->fds_.push_back(fd);
+                        }
+                    }
+                    if (barrier->remaining_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                        // 所有applier都已经写回了这个batch的页面
+                        for (int fd : barrier->fds_) {
+                            disk_manager_->sync_file(fd);
+                        }
+                        advance_persist_batch(barrier->batch_id_, barrier->persist_off_);
+                        delete barrier;
+                    }
+                } break;
             }
-        } break;
-        default:
-        break;
+        }
+    }
+}
+
+/**
+ * @description: 获取重放页面缓存中的页面, 不在缓存中时从磁盘读取
+ * @return {ReplayPage*} 缓存的页面
+ * @param {int} fd 页面所在文件的句柄
+ * @param {page_id_t} page_no 页面编号
+ * @param {bool} is_new_page 新分配的页面直接初始化为0, 不读磁盘
+ */
+ReplayPage* ReplayPageCache::get_page(int fd, page_id_t page_no, bool is_new_page) {
+    auto& page = pages_[PageId(fd, page_no)];
+    if (page == nullptr) {
+        page.reset(new ReplayPage());
+        if (!is_new_page) {
+            // 崩溃前可能还没有写回过这个页面, 文件末尾之后的部分按全0处理
+            disk_manager_->read_page_or_zero(fd, page_no, page->data_, PAGE_SIZE);
+        }
+    }
+    if (is_new_page) {
+        memset(page->data_, 0, PAGE_SIZE);
+        page->dirty_ = true;
+    }
+    return page.get();
+}
+
+void ReplayPageCache::update_page(int fd, page_id_t page_no, int offset, const char* value, size_t size) {
+    assert(offset >= 0 && offset + size <= PAGE_SIZE);
+    ReplayPage* page = get_page(fd, page_no, false);
+    memcpy(page->data_ + offset, value, size);
+    page->dirty_ = true;
+}
+
+/**
+ * @description: 把缓存中的脏页写回磁盘, 每个页面只写一次, 由调用者负责fdatasync
+ * @param {vector<int>&} fds 追加被写回的文件句柄, 不重复
+ */
+void ReplayPageCache::write_back(std::vector<int>& fds) {
+    std::vector<DiskIORequest> reqs;
+    for (auto& entry : pages_) {
+        if (!entry.second->dirty_) continue;
+        int fd = entry.first.table_id;
+        reqs.push_back({fd, true, entry.second->data_, PAGE_SIZE, (off_t)entry.first.page_no * PAGE_SIZE});
+        if (std::find(fds.begin(), fds.end(), fd) == fds.end()) fds.push_back(fd);
+        entry.second->dirty_ = false;
+    }
+    disk_manager_->submit_io(reqs);
+    // 所有页面都是干净的, 超过容量时直接清空
+    if (pages_.size() > REPLAY_PAGE_CACHE_SIZE) {
+        pages_.clear();
     }
 }
 
@@ -90,99 +268,62 @@ void LogReplay::apply_sigle_log(LogRecord* log, int curr_offset) {
  * @param {int} size 读取的数据量大小
  * @param {int} offset 读取的内容在文件中的位置
  */
-int LogReplay::read_log(char *log_data, int size, int offset) {
+int LogReplay::read_log(char *log_data, int size, off_t offset) {
     // read log file from the previous end
     assert (log_replay_fd_ != -1);
-    int file_size = disk_manager_->get_file_size(LOG_FILE_NAME);
+    off_t file_size = disk_manager_->get_file_size(LOG_FILE_NAME);
     if (offset > file_size) {
         return -1;
     }
 
-    size = std::min(size, file_size - offset);
+    size = (int)std::min((off_t)size, file_size - offset);
     if(size == 0) return 0;
-    lseek(log_replay_fd_, offset, SEEK_SET);
-    ssize_t bytes_read = read(log_replay_fd_, log_data, size);
+    ssize_t bytes_read = pread(log_replay_fd_, log_data, size, offset);
     assert(bytes_read == size);
     return bytes_read;
 }
 
 void LogReplay::replayFun(){
     // offset 指向下一个要读的起始位置
-    int offset = persist_off_ + 1;
+    off_t offset = persist_off_ + 1;
     int read_bytes;
     while (!replay_stop) {
-        // RDMA_LOG(INFO) << "max_replay_off_: " << max_replay_off_ << ", offset: " << offset;
-        // 用size_t 如果出现负数就会有问题
-        int read_size = std::min((int)max_replay_off_ - (int)offset + 1, (int)LOG_REPLAY_BUFFER_SIZE);
-        // RDMA_LOG(INFO) << "Replay log size: " << read_size;
+        off_t max_replay_off;
+        {
+            std::lock_guard<std::mutex> latch(latch1_);
+            max_replay_off = max_replay_off_;
+        }
+        int read_size = (int)std::min(max_replay_off - offset + 1, (off_t)LOG_REPLAY_BUFFER_SIZE);
         if(read_size <= 0){
             // don't need to replay
             std::this_thread::sleep_for(std::chrono::milliseconds(50)); //sleep 50 ms
             continue;
         }
-        RDMA_LOG(INFO) << "Begin apply log, apply size is " << read_size << ", max_replay_off_: " << max_replay_off_ << ", offset: " << offset;
         // offset为要读取数据的起始位置，persist_off_为已经读取的字节的结尾位置，所以需要+1
-        // offset ++;
         read_bytes = read_log(buffer_.buffer_, read_size, offset);
-        RDMA_LOG(INFO) << "read bytes: " << read_bytes;
         buffer_.offset_ = read_bytes - 1;
 
         int inner_offset = 0;
-        int replay_batch_id;
         while (inner_offset <= buffer_.offset_ ) {
             
             // buffer.offset_存储了buffer中数据的最大长度，判断在buffer存储的数据内能否读到下一条日志的总长度数据
             if (inner_offset + OFFSET_LOG_TOT_LEN + sizeof(uint32_t) > buffer_.offset_) {
-                RDMA_LOG(INFO) << "the next log record's tot_len cannot be read, inner_offset: " << inner_offset << ", buffer_offset: " << buffer_.offset_;
                 break;
             }
             // 获取日志记录长度
             uint32_t size = *reinterpret_cast<const uint32_t *>(buffer_.buffer_ + inner_offset + OFFSET_LOG_TOT_LEN);
             // 如果剩余数据不是一条完整的日志记录，则不再进行读取
             if (size == 0 || size + inner_offset > buffer_.offset_ + 1) {
-                RDMA_LOG(INFO) << "The remain data does not contain a complete log record, the next log record's size is: " << size << ", inner_offset: " << inner_offset << ", buffer_offset: " << buffer_.offset_;
                 break;
             }
             
-            LogRecord *record;
-            LogType type = *reinterpret_cast<const LogType *>(buffer_.buffer_ + inner_offset + OFFSET_LOG_TYPE);
-            switch (type) {
-                case LogType::BEGIN:
-                    record = new BeginLogRecord();
-                    break;
-                case LogType::ABORT:
-                    record = new AbortLogRecord();
-                    break;
-                case LogType::COMMIT:
-                    record = new CommitLogRecord();
-                    break;
-                case LogType::INSERT:
-                    record = new InsertLogRecord();
-                    break;
-                case LogType::UPDATE:
-                    record = new UpdateLogRecord();
-                    break;
-                case LogType::DELETE:
-                    record = new DeleteLogRecord();
-                    break;
-                case LogType::NEWPAGE:
-                    record = new NewPageLogRecord();
-                    break;
-                case LogType::BATCHEND:
-                    record = new BatchEndLogRecord();
-                    break;
-                default:
-                    assert(0);
-                    break;
-            }
-            record->deserialize(buffer_.buffer_ + inner_offset);
-            // redo the log if necessary
-            apply_sigle_log(record, offset + inner_offset);
-            // replay_batch_id = record->log_batch_id_;
-            delete record;
+            // 直接在buffer上解析日志, 不需要为每条日志分配LogRecord对象
+            apply_sigle_log(LogRecordView(buffer_.buffer_ + inner_offset), offset + inner_offset);
             inner_offset += size;
         }
         offset += inner_offset;
+        // 这一段日志解析出来的操作交给applier并行重放
+        submit_replay_tasks();
 
         // persist_batch_id_ = replay_batch_id;
         // persist_off_ = offset;
@@ -2,7 +2,14 @@
 
 #include <unistd.h>
 #include <thread>
+#include <atomic>
 #include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <vector>
 #include <assert.h>
 
 #include "log_record.h"
@@ -20,9 +27,60 @@ public:
     int offset_;    // 写入log的offset
 };
 
+// 重放时缓存的页面镜像, 日志先应用到内存中的页面上, 在BATCHEND时统一写回磁盘
+struct ReplayPage {
+    char data_[PAGE_SIZE];
+    bool dirty_ = false;
+};
+
+// 重放页面缓存, key中的table_id为文件句柄, 只能被一个重放线程访问
+class ReplayPageCache {
+public:
+    // 重放页面缓存的容量, 写回之后超过这个数量就清空缓存
+    static constexpr size_t REPLAY_PAGE_CACHE_SIZE = 4096;
+
+    explicit ReplayPageCache(DiskManager* disk_manager) : disk_manager_(disk_manager) {}
+
+    ReplayPage* get_page(int fd, page_id_t page_no, bool is_new_page);
+    void update_page(int fd, page_id_t page_no, int offset, const char* value, size_t size);
+    void write_back(std::vector<int>& fds);
+
+private:
+    DiskManager* disk_manager_;
+    std::unordered_map<PageId, std::unique_ptr<ReplayPage>> pages_;
+};
+
+// 并行重放时reader线程分发给applier线程的操作
+struct ReplayBarrier;
+struct ReplayOp {
+    enum Type { UPDATE, NEW_PAGE, BARRIER };
+    Type type_;
+    int fd_;
+    page_id_t page_no_;
+    int offset_;                // 页面内的偏移
+    uint32_t size_;             // 修改的字节数
+    size_t data_off_;           // 修改的内容在ReplayTask::data_中的位置
+    ReplayBarrier* barrier_;    // 只有BARRIER使用
+};
+
+// 一个BATCHEND对应一个barrier, 所有applier都处理完这个barrier之后才能推进persist_batch_id
+struct ReplayBarrier {
+    batch_id_t batch_id_;
+    size_t persist_off_;
+    std::atomic<int> remaining_;    // 还没有到达barrier的applier个数
+    std::mutex latch_;              // 保护fds_
+    std::vector<int> fds_;          // 这个batch中被写回的文件, 最后一个到达的applier统一fdatasync
+};
+
+// reader线程每解析一段日志就给每个applier提交一个task
+struct ReplayTask {
+    std::vector<ReplayOp> ops_;
+    std::string data_;
+};
+
 class LogReplay{
 public:
-    LogReplay(DiskManager* disk_manager):disk_manager_(disk_manager){
+    LogReplay(DiskManager* disk_manager, int replay_thread_num = 1):disk_manager_(disk_manager), page_cache_(disk_manager){
         char path[1024];
         getcwd(path, sizeof(path));
         RDMA_LOG(INFO) << "LogReplay current path: " << path;
@@ -33,10 +91,11 @@ public:
             log_replay_fd_ = open(LOG_FILE_NAME, O_RDWR);
             log_write_head_fd_ = open(LOG_FILE_NAME, O_RDWR);
 
-            persist_batch_id_ = 0;
+            batch_id_t init_batch_id = 0;
+            persist_batch_id_ = init_batch_id;
             persist_off_ = sizeof(batch_id_t) + sizeof(size_t) - 1;
             
-            write(log_write_head_fd_, &persist_batch_id_, sizeof(batch_id_t));
+            write(log_write_head_fd_, &init_batch_id, sizeof(batch_id_t));
             write(log_write_head_fd_, &persist_off_, sizeof(size_t));
 
         }
@@ -49,11 +108,13 @@ public:
                 std::cerr << "Failed to seek log file." << std::endl;
                 assert(0);
             }
-            ssize_t bytes_read = read(log_replay_fd_, &persist_batch_id_, sizeof(batch_id_t));
+            batch_id_t head_batch_id;
+            ssize_t bytes_read = read(log_replay_fd_, &head_batch_id, sizeof(batch_id_t));
             if(bytes_read != sizeof(batch_id_t)){
                 std::cerr << "Failed to read persist_batch_id_." << std::endl;
                 assert(0);
             }
+            persist_batch_id_ = head_batch_id;
             bytes_read = read(log_replay_fd_, &persist_off_, sizeof(uint64_t));
             if(bytes_read != sizeof(uint64_t)){
                 std::cerr << "Failed to read persist_off_." << std::endl;
@@ -66,6 +127,16 @@ public:
         max_replay_off_ = disk_manager_->get_file_size(LOG_FILE_NAME) - 1;
         RDMA_LOG(INFO) << "init max_replay_off_: " << max_replay_off_; 
 
+        // replay_thread_num大于1时由reader线程解析日志, 按页面分发给多个applier线程并行重放
+        if (replay_thread_num > 1) {
+            for (int i = 0; i < replay_thread_num; i++) {
+                appliers_.emplace_back(new ReplayApplier(disk_manager_));
+            }
+            for (auto& applier : appliers_) {
+                applier->thread_ = std::thread(&LogReplay::applierFun, this, applier.get());
+            }
+        }
+        RDMA_LOG(INFO) << "LogReplay replay threads: " << replay_thread_num;
         replay_thread_ = std::thread(&LogReplay::replayFun, this);
 
         RDMA_LOG(INFO) << "Finish start LogReplay";
@@ -76,35 +147,91 @@ public:
         if (replay_thread_.joinable()) {
             replay_thread_.join();
         }
+        // reader线程已经退出, 把它还没有提交的task也交给applier;
+        // applier在stop_之后仍然会处理完队列中的task再退出, 每个barrier由最后到达的applier释放
+        submit_replay_tasks();
+        for (auto& applier : appliers_) {
+            {
+                std::lock_guard<std::mutex> latch(applier->latch_);
+                applier->stop_ = true;
+            }
+            applier->cv_.notify_all();
+            applier->thread_.join();
+        }
         close(log_replay_fd_);
+        close(log_write_head_fd_);
     };
 
-    int  read_log(char *log_data, int size, int offset);
-    void apply_sigle_log(LogRecord* log_record, int curr_offset);
+    int  read_log(char *log_data, int size, off_t offset);
+    void apply_sigle_log(const LogRecordView& log, size_t curr_offset);
     void add_max_replay_off_(int off) {
         std::lock_guard<std::mutex> latch(latch1_);
         max_replay_off_ += off;
     }
     void replayFun();
+
     batch_id_t get_persist_batch_id() { 
-        // std::lock_guard<std::mutex> latch(latch2_);
-        return persist_batch_id_; 
+        return persist_batch_id_.load(std::memory_order_acquire); 
+    }
+
+    /**
+     * @description: 注册一个等待batch_id被持久化的回调, 回调在对应的BATCHEND被重放后由重放线程调用
+     * @return {bool} 若batch_id已经被持久化则不注册回调并返回false, 调用者可以直接继续执行
+     * @param {batch_id_t} batch_id 需要等待的batch id
+     * @param {function<void()>} waiter 回调函数, 在重放线程中执行, 不应阻塞
+     */
+    bool add_persist_waiter(batch_id_t batch_id, std::function<void()> waiter) {
+        std::lock_guard<std::mutex> latch(latch2_);
+        if (persist_batch_id_.load(std::memory_order_relaxed) >= batch_id) return false;
+        persist_waiters_.emplace(batch_id, std::move(waiter));
+        return true;
     }
 
 private:
+    // applier的task队列中最多积压的task个数, 超过时reader线程等待
+    static constexpr size_t MAX_QUEUED_REPLAY_TASKS = 64;
+
+    struct ReplayApplier {
+        explicit ReplayApplier(DiskManager* disk_manager) : page_cache_(disk_manager) {}
+
+        std::mutex latch_;                      // 保护tasks_和stop_
+        std::condition_variable cv_;            // task入队或者出队时通知
+        std::deque<ReplayTask> tasks_;
+        bool stop_ = false;
+        ReplayTask pending_task_;               // reader线程正在构造的task, 只被reader线程访问
+        ReplayPageCache page_cache_;            // 只被applier线程访问
+        std::thread thread_;
+    };
+
+    int get_table_fd(const char* table_name, size_t size);
+    void redo_page_update(int fd, page_id_t page_no, int offset, const char* value, size_t size);
+    void redo_new_page(int fd, page_id_t page_no);
+    void redo_batch_end(batch_id_t batch_id, size_t persist_off);
+    void advance_persist_batch(batch_id_t batch_id, size_t persist_off);
+    ReplayApplier* get_applier(int fd, page_id_t page_no) {
+        return appliers_[std::hash<PageId>()(PageId(fd, page_no)) % appliers_.size()].get();
+    }
+    void submit_replay_tasks();
+    void applierFun(ReplayApplier* applier);
+
     int log_replay_fd_;             // 重放log文件fd，从头开始顺序读
     int log_write_head_fd_;         // 写文件头fd, 从文件末尾开始append写
 
     std::mutex latch1_;             // 用于保护max_replay_off_这一共享变量
     size_t max_replay_off_;         // log文件中最后一个字节的偏移量
 
-    std::mutex latch2_;              // 用于保护persist_batch_id_和persist_off_两个共享变量
-    batch_id_t persist_batch_id_;   // 已经可持久化的batch的id
+    std::mutex latch2_;              // 用于保护persist_batch_id_, persist_off_和persist_waiters_
+    std::atomic<batch_id_t> persist_batch_id_;   // 已经可持久化的batch的id
     size_t persist_off_;            // 已经可持久化的batch的最后一个字节的偏移量
+    std::multimap<batch_id_t, std::function<void()>> persist_waiters_;  // 等待某个batch持久化的请求, 按batch id排序
 
     DiskManager* disk_manager_;
     LogBuffer buffer_;
 
+    std::vector<std::pair<std::string, int>> table_fds_;   // 重放过的表名和对应的文件句柄, 只被重放线程访问
+    ReplayPageCache page_cache_;    // 串行重放时使用的页面缓存
+    std::vector<std::unique_ptr<ReplayApplier>> appliers_;  // 并行重放的applier, 为空时由重放线程串行重放
+
     bool replay_stop = false;
     std::thread replay_thread_;
     std::condition_variable cv_; // 条件变量
@@ -51,12 +51,38 @@ public:
         allocated_ = true;
     }
 
+    RmRecord(RmRecord&& other) noexcept {
+        key_ = other.key_;
+        value_size_ = other.value_size_;
+        value_ = other.value_;
+        allocated_ = other.allocated_;
+        other.value_ = nullptr;
+        other.allocated_ = false;
+    }
+
     RmRecord& operator = (const RmRecord& other) {
+        if(this == &other) return *this;
+        // 大小相同时复用已经分配的空间
+        if(!allocated_ || value_size_ != other.value_size_) {
+            if(allocated_) delete[] value_;
+            value_ = new char[other.value_size_];
+            allocated_ = true;
+        }
         key_ = other.key_;
         value_size_ = other.value_size_;
-        value_ = new char[value_size_];
         memcpy(value_, other.value_, value_size_);
-        allocated_ = true;
+        return *this;
+    }
+
+    RmRecord& operator = (RmRecord&& other) noexcept {
+        if(this == &other) return *this;
+        if(allocated_) delete[] value_;
+        key_ = other.key_;
+        value_size_ = other.value_size_;
+        value_ = other.value_;
+        allocated_ = other.allocated_;
+        other.value_ = nullptr;
+        other.allocated_ = false;
         return *this;
     }
 
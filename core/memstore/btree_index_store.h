@@ -0,0 +1,330 @@
+// Copyright (c) 2023
+
+#pragma once
+
+#include <cassert>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#include "base/common.h"
+#include "base/page.h"
+#include "memstore/mem_store.h"
+
+// 内存池中的有序索引(B-link树, 参考Sherman), 与哈希索引IndexStore并存, 用于范围扫描
+// 节点大小固定为BTREE_NODE_SIZE, 每个节点记录自己负责的key范围[lowest, highest)和右兄弟节点,
+// 计算节点只用单边RDMA READ遍历: 每层读取一个节点, key不小于highest时说明节点已经分裂, 沿sibling_id向右移动,
+// 所以读者不加latch, 读到的节点头尾version相同即可使用; 范围扫描到达叶子之后沿sibling_id读取后续叶子
+// 写者对节点CAS加排他latch(与哈希桶相同的lock_t), 修改后把头尾version加一并写回整个节点
+// 分裂时先写入新的右兄弟, 再写回左节点, 然后在持有子节点latch的情况下向上插入分隔key(自底向上的latch coupling),
+// 加latch的顺序总是从低层到高层, 不会死锁; 根节点分裂时持有旧根的latch, 所以同一时刻只有一个写者修改根指针
+// 节点不合并, 删除只移除叶子中的项
+
+#define BTREE_NODE_SIZE 1024
+#define BTREE_HEADER_SIZE 64
+#define BTREE_NULL_NODE -1
+// highest为BTREE_KEY_MAX表示正无穷, 这个key本身不能插入
+#define BTREE_KEY_MAX UINT64_MAX
+
+// 叶子中value是压缩后的Rid, 内部节点中value是子节点编号
+struct BTreeEntry {
+  itemkey_t key;
+  uint64_t value;
+} Aligned8;
+
+const int BTREE_MAX_ENTRY_NUM = (BTREE_NODE_SIZE - sizeof(lock_t) - sizeof(version_t) * 2 - sizeof(uint64_t) - sizeof(itemkey_t) * 2 -
+                                 sizeof(int64_t) * 2) / sizeof(BTreeEntry);
+
+struct BTreeNode {
+  lock_t lock;
+  version_t version;
+  uint16_t level;  // 叶子为0
+  uint16_t key_num;
+  uint32_t reserved;
+  // 节点负责的key范围[lowest, highest)
+  itemkey_t lowest;
+  itemkey_t highest;
+  int64_t sibling_id;
+  // 内部节点中小于entries[0].key的子节点
+  int64_t leftmost_child;
+  BTreeEntry entries[BTREE_MAX_ENTRY_NUM];
+  version_t rear_version;
+} Aligned8;
+
+static_assert(sizeof(BTreeNode) <= BTREE_NODE_SIZE, "BTreeNode should fit in BTREE_NODE_SIZE");
+
+// 索引区域的头部, 之后是节点数组
+struct BTreeHeader {
+  // 根节点编号, 根节点分裂的写者持有旧根的latch时修改
+  int64_t root_id;
+  // 下一个空闲节点编号, 计算节点通过FAA分配新节点
+  uint64_t next_free_id;
+  uint64_t max_node_num;
+} Aligned8;
+
+static_assert(sizeof(BTreeHeader) <= BTREE_HEADER_SIZE, "BTreeHeader should fit in BTREE_HEADER_SIZE");
+
+struct BTreeIndexMeta {
+  // To which table this index belongs
+  table_id_t table_id;
+
+  // Offset of the index header, relative to the RDMA region
+  offset_t base_off;
+
+  uint64_t max_node_num;
+
+  BTreeIndexMeta(table_id_t table_id, offset_t base_off, uint64_t max_node_num)
+      : table_id(table_id), base_off(base_off), max_node_num(max_node_num) {}
+  BTreeIndexMeta() {}
+} Aligned8;
+
+class BTreeIndexStore {
+ public:
+  BTreeIndexStore(table_id_t table_id, uint64_t max_node_num, MemStoreAllocParam* param)
+      : table_id(table_id), base_off(0), max_node_num(max_node_num) {
+
+    assert(max_node_num > 0);
+    index_size = BTREE_HEADER_SIZE + max_node_num * BTREE_NODE_SIZE;
+    region_start_ptr = param->mem_region_start;
+    assert((uint64_t)param->mem_store_start + param->mem_store_alloc_offset + index_size <= (uint64_t)param->mem_store_reserve);
+
+    index_ptr = param->mem_store_start + param->mem_store_alloc_offset;
+    param->mem_store_alloc_offset += index_size;
+
+    base_off = (uint64_t)index_ptr - (uint64_t)region_start_ptr;
+
+    memset(index_ptr, 0, index_size);
+    header = (BTreeHeader*)index_ptr;
+    header->max_node_num = max_node_num;
+    // 初始只有一个叶子作为根
+    header->root_id = AllocNode();
+    InitNode(GetNode(header->root_id), 0, 0, BTREE_KEY_MAX);
+  }
+
+  table_id_t GetTableID() const {
+    return table_id;
+  }
+
+  offset_t GetBaseOff() const {
+    return base_off;
+  }
+
+  uint64_t GetMaxNodeNum() const {
+    return max_node_num;
+  }
+
+  uint64_t IndexSize() const {
+    return index_size;
+  }
+
+  uint64_t GetNodeNum() const {
+    return header->next_free_id;
+  }
+
+  int GetHeight() const {
+    return GetNode(header->root_id)->level + 1;
+  }
+
+  // 以下静态函数同时给计算节点使用, 计算节点用它们处理RDMA READ读到的节点
+  static offset_t GetNodeOff(offset_t base_off, int64_t node_id) {
+    return base_off + BTREE_HEADER_SIZE + node_id * BTREE_NODE_SIZE;
+  }
+
+  static uint64_t PackRid(const Rid& rid) {
+    return ((uint64_t)(uint32_t)rid.page_no_ << 32) | (uint32_t)rid.slot_no_;
+  }
+
+  static Rid UnpackRid(uint64_t value) {
+    return {(page_id_t)(uint32_t)(value >> 32), (int)(uint32_t)value};
+  }
+
+  static void InitNode(BTreeNode* node, uint16_t level, itemkey_t lowest, itemkey_t highest) {
+    memset(node, 0, sizeof(BTreeNode));
+    node->level = level;
+    node->lowest = lowest;
+    node->highest = highest;
+    node->sibling_id = BTREE_NULL_NODE;
+    node->leftmost_child = BTREE_NULL_NODE;
+  }
+
+  // key不在节点负责的范围内, 节点已经分裂, 需要沿sibling_id向右移动
+  static bool NeedMoveRight(const BTreeNode* node, itemkey_t key) {
+    return key >= node->highest && node->sibling_id != BTREE_NULL_NODE;
+  }
+
+  // 第一个不小于key的项
+  static int LowerBound(const BTreeNode* node, itemkey_t key) {
+    int lo = 0, hi = node->key_num;
+    while (lo < hi) {
+      int mid = (lo + hi) / 2;
+      if (node->entries[mid].key < key) lo = mid + 1;
+      else hi = mid;
+    }
+    return lo;
+  }
+
+  // 内部节点中负责key的子节点
+  static int64_t FindChild(const BTreeNode* node, itemkey_t key) {
+    assert(node->level > 0);
+    int pos = LowerBound(node, key);
+    if (pos < node->key_num && node->entries[pos].key == key) return (int64_t)node->entries[pos].value;
+    return pos == 0 ? node->leftmost_child : (int64_t)node->entries[pos - 1].value;
+  }
+
+  // 插入或者覆盖key, 节点已满时返回false
+  static bool InsertEntry(BTreeNode* node, itemkey_t key, uint64_t value) {
+    int pos = LowerBound(node, key);
+    if (pos < node->key_num && node->entries[pos].key == key) {
+      node->entries[pos].value = value;
+      return true;
+    }
+    if (node->key_num == BTREE_MAX_ENTRY_NUM) return false;
+    memmove(&node->entries[pos + 1], &node->entries[pos], (node->key_num - pos) * sizeof(BTreeEntry));
+    node->entries[pos] = {key, value};
+    node->key_num++;
+    return true;
+  }
+
+  static bool RemoveEntry(BTreeNode* node, itemkey_t key) {
+    int pos = LowerBound(node, key);
+    if (pos == node->key_num || node->entries[pos].key != key) return false;
+    memmove(&node->entries[pos], &node->entries[pos + 1], (node->key_num - pos - 1) * sizeof(BTreeEntry));
+    node->key_num--;
+    return true;
+  }
+
+  // 把已满的left分裂到编号为right_id的空节点right中, 返回需要插入父节点的分隔key
+  // 内部节点的分隔项上移到父节点, 它的子节点成为right的leftmost_child
+  static itemkey_t SplitNode(BTreeNode* left, BTreeNode* right, int64_t right_id) {
+    int mid = left->key_num / 2;
+    itemkey_t sep = left->entries[mid].key;
+    InitNode(right, left->level, sep, left->highest);
+    right->sibling_id = left->sibling_id;
+    int from = mid;
+    if (left->level > 0) {
+      right->leftmost_child = (int64_t)left->entries[mid].value;
+      from = mid + 1;
+    }
+    right->key_num = left->key_num - from;
+    memcpy(right->entries, &left->entries[from], right->key_num * sizeof(BTreeEntry));
+    left->key_num = mid;
+    left->highest = sep;
+    left->sibling_id = right_id;
+    return sep;
+  }
+
+  // 把叶子中[lo, hi]范围内的项追加到out, 直到out中有limit项, 返回是否需要继续扫描右兄弟
+  static bool ScanLeaf(const BTreeNode* node, itemkey_t lo, itemkey_t hi, size_t limit,
+                       std::vector<std::pair<itemkey_t, Rid>>& out) {
+    assert(node->level == 0);
+    for (int i = LowerBound(node, lo); i < node->key_num; i++) {
+      if (node->entries[i].key > hi || out.size() >= limit) return false;
+      out.emplace_back(node->entries[i].key, UnpackRid(node->entries[i].value));
+    }
+    return out.size() < limit && node->highest <= hi && node->sibling_id != BTREE_NULL_NODE;
+  }
+
+  // 内存节点加载数据时使用, 单线程, 不加latch
+  bool LocalInsertKeyRid(itemkey_t key, const Rid& rid);
+
+  bool LocalDelete(itemkey_t key);
+
+  // 返回读取的节点个数, 与计算节点ScanIndex的round trip数相同
+  int LocalScan(itemkey_t lo, itemkey_t hi, size_t limit, std::vector<std::pair<itemkey_t, Rid>>& out);
+
+ private:
+  BTreeNode* GetNode(int64_t node_id) const {
+    return (BTreeNode*)(index_ptr + BTREE_HEADER_SIZE + node_id * BTREE_NODE_SIZE);
+  }
+
+  int64_t AllocNode() {
+    if (header->next_free_id >= max_node_num) return BTREE_NULL_NODE;
+    return (int64_t)header->next_free_id++;
+  }
+
+  // 从根遍历到level层负责key的节点, 记录每层经过的最后一个节点
+  int64_t LocalTraverse(itemkey_t key, uint16_t level, std::vector<int64_t>* path) {
+    int64_t node_id = header->root_id;
+    BTreeNode* node = GetNode(node_id);
+    while (true) {
+      while (NeedMoveRight(node, key)) {
+        node_id = node->sibling_id;
+        node = GetNode(node_id);
+      }
+      if (node->level == level) return node_id;
+      if (path) path->push_back(node_id);
+      node_id = FindChild(node, key);
+      node = GetNode(node_id);
+    }
+  }
+
+  // To which table this index belongs
+  table_id_t table_id;
+
+  // The offset of the header in the RDMA region
+  offset_t base_off;
+
+  uint64_t max_node_num;
+
+  // The point to the header
+  char* index_ptr;
+  BTreeHeader* header;
+
+  size_t index_size;
+
+  // Start of the index region address
+  char* region_start_ptr;
+};
+
+ALWAYS_INLINE
+bool BTreeIndexStore::LocalInsertKeyRid(itemkey_t key, const Rid& rid) {
+  assert(key != BTREE_KEY_MAX);
+  std::vector<int64_t> path;
+  int64_t node_id = LocalTraverse(key, 0, &path);
+  uint64_t value = PackRid(rid);
+  while (true) {
+    BTreeNode* node = GetNode(node_id);
+    if (InsertEntry(node, key, value)) return true;
+
+    int64_t right_id = AllocNode();
+    if (right_id == BTREE_NULL_NODE) return false;
+    BTreeNode* right = GetNode(right_id);
+    itemkey_t sep = SplitNode(node, right, right_id);
+    bool inserted = InsertEntry(key < sep ? node : right, key, value);
+    assert(inserted);
+
+    if (node_id == header->root_id) {
+      int64_t root_id = AllocNode();
+      if (root_id == BTREE_NULL_NODE) return false;
+      BTreeNode* root = GetNode(root_id);
+      InitNode(root, node->level + 1, 0, BTREE_KEY_MAX);
+      root->leftmost_child = node_id;
+      InsertEntry(root, sep, (uint64_t)right_id);
+      header->root_id = root_id;
+      return true;
+    }
+    // 分隔key插入父节点, 父节点满了继续向上分裂
+    key = sep;
+    value = (uint64_t)right_id;
+    node_id = path.back();
+    path.pop_back();
+    while (NeedMoveRight(GetNode(node_id), key)) node_id = GetNode(node_id)->sibling_id;
+  }
+}
+
+ALWAYS_INLINE
+bool BTreeIndexStore::LocalDelete(itemkey_t key) {
+  return RemoveEntry(GetNode(LocalTraverse(key, 0, nullptr)), key);
+}
+
+ALWAYS_INLINE
+int BTreeIndexStore::LocalScan(itemkey_t lo, itemkey_t hi, size_t limit, std::vector<std::pair<itemkey_t, Rid>>& out) {
+  std::vector<int64_t> path;
+  int64_t node_id = LocalTraverse(lo, 0, &path);
+  int read_nodes = path.size() + 1;
+  while (ScanLeaf(GetNode(node_id), lo, hi, limit, out)) {
+    node_id = GetNode(node_id)->sibling_id;
+    read_nodes++;
+  }
+  return read_nodes;
+}
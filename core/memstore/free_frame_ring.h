@@ -0,0 +1,104 @@
+// Copyright (c) 2023
+
+#pragma once
+
+#include <cstdint>
+
+#include "base/common.h"
+
+// 页表节点上的空闲frame环形缓冲区, 页表节点本地的淘汰线程是生产者, 计算节点通过RDMA访问, 是消费者
+// 每个槽位带一个序号, 第pos个位置对应槽位pos % capacity:
+//   seq == pos:                槽位空闲, 等待生产者写入第pos个frame
+//   seq == pos + 1:            第pos个frame已经写入, 等待消费者读取
+//   seq == pos + capacity:     消费者读取完成, 槽位交给下一圈的生产者
+// 消费者只用RDMA FAA领取dequeue_ticket, 生产者只用CPU原子操作领取enqueue_ticket, 两类原子操作不访问同一个字,
+// 因此不需要像原来那样在页表节点上也通过回环QP做RDMA原子操作
+// 领取位置之后不再撤销: 消费者一次FAA + 一次READ领取一批frame, 还没有被写入的槽位等待生产者写入后重新读取
+// 槽位为16字节并按16字节对齐, 不会跨cache line, 网卡读到的序号和frame是一致的
+
+struct RingBufferItem {
+  uint64_t seq;
+  node_id_t node_id;
+  frame_id_t frame_id;
+} __attribute__((aligned(16)));
+
+static_assert(sizeof(RingBufferItem) == 16, "ring slot must not cross a cache line");
+
+struct RingFreeFrameBuffer {
+  // 空闲页面的环形缓冲区
+  RingBufferItem free_list_buffer_[MAX_FREE_LIST_BUFFER_SIZE];
+  // 消费者的ticket, 计算节点通过RDMA FAA领取位置
+  uint64_t dequeue_ticket_ = 0;
+  // 生产者的ticket, 只被页表节点本地的线程访问
+  uint64_t enqueue_ticket_ = 0;
+};
+
+class FreeFrameRing {
+ public:
+  FreeFrameRing(RingBufferItem* slots, uint64_t capacity, uint64_t* enqueue_ticket)
+      : slots(slots), capacity(capacity), enqueue_ticket(enqueue_ticket) {}
+
+  // 计算节点上只用来检查读到本地的槽位, 不访问远端的槽位和ticket
+  explicit FreeFrameRing(uint64_t capacity) : FreeFrameRing(nullptr, capacity, nullptr) {}
+
+  explicit FreeFrameRing(RingFreeFrameBuffer* buffer)
+      : FreeFrameRing(buffer->free_list_buffer_, MAX_FREE_LIST_BUFFER_SIZE, &buffer->enqueue_ticket_) {}
+
+  void Init() {
+    for (uint64_t i = 0; i < capacity; i++) {
+      slots[i].seq = i;
+      slots[i].node_id = -1;
+      slots[i].frame_id = INVALID_FRAME_ID;
+    }
+    *enqueue_ticket = 0;
+  }
+
+  uint64_t Capacity() const {
+    return capacity;
+  }
+
+  uint64_t SlotIdx(uint64_t pos) const {
+    return pos % capacity;
+  }
+
+  // 生产者: 写入一个空闲frame, 环形缓冲区已满(下一个槽位上一圈的frame还没有被读取)时返回false
+  // 可以被页表节点上的多个线程并发调用
+  bool TryPush(node_id_t node_id, frame_id_t frame_id) {
+    uint64_t pos = __atomic_load_n(enqueue_ticket, __ATOMIC_ACQUIRE);
+    while (true) {
+      RingBufferItem& slot = slots[SlotIdx(pos)];
+      // 序号由计算节点通过RDMA WRITE更新, 需要每次从内存中读取
+      uint64_t seq = __atomic_load_n(&slot.seq, __ATOMIC_ACQUIRE);
+      int64_t diff = (int64_t)(seq - pos);
+      if (diff == 0) {
+        if (__atomic_compare_exchange_n(enqueue_ticket, &pos, pos + 1, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+          // 计算节点可能正在读取这个槽位(读到旧的序号, 会丢弃读到的frame)
+          __atomic_store_n(&slot.node_id, node_id, __ATOMIC_RELAXED);
+          __atomic_store_n(&slot.frame_id, frame_id, __ATOMIC_RELAXED);
+          __atomic_store_n(&slot.seq, pos + 1, __ATOMIC_RELEASE);
+          return true;
+        }
+        // CAS失败时pos已经更新为最新的enqueue_ticket
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = __atomic_load_n(enqueue_ticket, __ATOMIC_ACQUIRE);
+      }
+    }
+  }
+
+  // 消费者: 检查读到本地的第pos个槽位, 已经写入时取出frame, 并把本地副本的序号改为释放后的值,
+  // 调用者需要把本地副本写回远端, 槽位才能被下一圈的生产者使用
+  bool Consume(RingBufferItem& local_slot, uint64_t pos, node_id_t& node_id, frame_id_t& frame_id) const {
+    if (local_slot.seq != pos + 1) return false;
+    node_id = local_slot.node_id;
+    frame_id = local_slot.frame_id;
+    local_slot.seq = pos + capacity;
+    return true;
+  }
+
+ private:
+  RingBufferItem* slots;
+  uint64_t capacity;
+  uint64_t* enqueue_ticket;
+};
@@ -54,13 +54,16 @@ struct IndexMeta {
 
 
 // 计算每个哈希桶节点可以存放多少个rids
-const int MAX_RIDS_NUM_PER_NODE = (PAGE_SIZE - sizeof(page_id_t) - sizeof(lock_t) - sizeof(short*) * NEXT_NODE_COUNT) / (sizeof(IndexItem) );
+const int MAX_RIDS_NUM_PER_NODE = (PAGE_SIZE - sizeof(page_id_t) - sizeof(lock_t) - sizeof(version_t) * 2 - sizeof(short*) * NEXT_NODE_COUNT) / (sizeof(IndexItem) );
 
 // A IndexNode is a bucket
 // 这里注意：sizeof(IndexNode)是4080而非4096，这可能可以有效较少RNIC的哈希碰撞，ref sigmod23 guide，
 // 若后续持久化，应该持久化4K整页
+// 查找不加latch, 一次RDMA READ读取整个桶, 桶头尾的version相同并且没有被排他latch时读到的桶是一致的
+// 修改桶的一方持有排他latch, 写回时把头尾的version都加一, 写回按地址递增的顺序进行
 struct IndexNode {
   lock_t lock; 
+  version_t version;
   // node id
   page_id_t page_id;
 
@@ -68,6 +71,8 @@ struct IndexNode {
 
   short next_expand_node_id[NEXT_NODE_COUNT] = {-1};
   // IndexNode* next;
+
+  version_t rear_version;
 } Aligned4096;
 
 class IndexStore {
@@ -218,7 +223,7 @@ bool IndexStore::LocalInsertKeyRid(itemkey_t key, const Rid& rid, MemStoreReserv
       }
     }
 
-    if (node->next_expand_node_id[0] <= 0) break;
+    if (node->next_expand_node_id[0] < 0) break;
     node = (IndexNode*)(node->next_expand_node_id[0] * sizeof(IndexNode) + expand_region_base_ptr);
   }
 
@@ -1,8 +1,61 @@
 //author: huangdund
 // Copyrigth (c) 2023
 #include "page_table.h"
+#include "storage/storage_client.h"
 #include "util/json_config.h"
 
+PageTableStore::PageTableStore(uint64_t bucket_num, MemStoreAllocParam* param)
+    :base_off(0), bucket_num(bucket_num), page_table_ptr(nullptr), node_num(bucket_num),
+     free_frame_ring_(&ring_free_frame_buffer_){
+
+  assert(bucket_num > 0);
+  page_table_size = (bucket_num) * sizeof(PageTableNode);
+  region_start_ptr = param->mem_region_start;
+  assert((uint64_t)param->mem_store_start + param->mem_store_alloc_offset + page_table_size + sizeof(uint64_t) <= (uint64_t)param->mem_store_reserve);
+
+  // fill_page_count是指针，指向额外分配页面的数量，安排已分配页面数量的位置，在地址索引空间的头部
+  // 额外指开始分配了bucket_num数量的bucket_key, 如果bucket已满，则需要在保留空间中新建桶
+  fill_page_count = (uint64_t*)(param->mem_store_start + param->mem_store_alloc_offset);
+  *fill_page_count = bucket_num;
+  param->mem_store_alloc_offset += sizeof(uint64_t);
+
+  // 安排哈希表的位置
+  page_table_ptr = param->mem_store_start + param->mem_store_alloc_offset;
+  param->mem_store_alloc_offset += page_table_size;
+
+  base_off = (uint64_t)page_table_ptr - (uint64_t)region_start_ptr;
+  assert(base_off >= 0);
+
+  assert(page_table_ptr != nullptr);
+  memset(page_table_ptr, 0, page_table_size);
+  
+  for(int i=0; i<bucket_num; i++){
+    PageTableNode* node = (PageTableNode*)(i * sizeof(PageTableNode) + page_table_ptr);
+    node->next_expand_node_id[0] = -1;
+    node->next_expand_node_id[1] = -1;
+    node->next_expand_node_id[2] = -1;
+    node->next_expand_node_id[3] = -1;
+    node->next_expand_node_id[4] = -1;
+    node->page_id = i;
+  }
+
+  bucket_array = (PageTableNode*)page_table_ptr;
+
+  // 这里初始化Freelist和线程替换函数
+  free_frame_ring_.Init();
+  ReveiveMeta();
+  for(int i=0; i<manager_data_nodes.size(); i++){
+    for(int j=0; j<data_node_frame_nums[i]; j++){
+      free_list_.push_back(std::make_pair(manager_data_nodes[i], j));
+    }
+  }
+  stop_victim = true;
+  std::thread victim_thread_thread([this] {VictimPageThread();});
+  victim_thread_thread.detach();
+}
+
+PageTableStore::~PageTableStore() = default;
+
 node_id_t PageTableStore::GetDataStoreMeta(std::string& remote_ip, int remote_port) {
   // Get remote memory store metadata for remote accesses, via TCP
   /* ---------------Initialize socket---------------- */
@@ -127,9 +180,7 @@ void PageTableStore::BuildConnectWithRingBuffer(){
   rdma_buffer_allocator = new RDMABufferAllocator(global_mr, global_mr + global_mr_size - 1);
 
   // GetMRMeta
-  while (QP::get_remote_mr("127.0.0.1", local_port, SERVER_PAGETABLE_RING_FREE_FRAME_BUFFER_ID, &local_ring_free_frame_buffer_mr) != SUCC) {
-    usleep(2000);
-  }
+  // 环形缓冲区的生产者一侧只使用CPU原子操作, 回环qp只用于CLOCK淘汰对桶加latch
   while (QP::get_remote_mr("127.0.0.1", local_port, SERVER_PAGETABLE_ID, &local_page_table_mr) != SUCC) {
     usleep(2000);
   }
@@ -137,19 +188,9 @@ void PageTableStore::BuildConnectWithRingBuffer(){
   // ! 这里的local_mr 疑似被析构了? 
   MemoryAttr local_mr = global_rdma_ctrl->get_local_mr(CLIENT_MR_ID);
   //! 这里create_rc_idx(0, 0)存疑 
-  connect_local_ring_qp = global_rdma_ctrl->create_rc_qp(create_rc_idx(0, 0), opened_rnic, &local_mr);
   connect_local_page_table_qp = global_rdma_ctrl->create_rc_qp(create_rc_idx(0, 1), opened_rnic, &local_mr);
-  assert(connect_local_ring_qp != nullptr);
   assert(connect_local_page_table_qp != nullptr);
   ConnStatus rc;
-  do {
-    rc = connect_local_ring_qp->connect("127.0.0.1", local_port);
-    if (rc == SUCC) {
-      connect_local_ring_qp->bind_remote_mr(local_ring_free_frame_buffer_mr);  // Bind the hash mr as the default remote mr for convenient parameter passing
-      RDMA_LOG(INFO) << "PageTable QP connected! with local Ring page free buffer";
-    }
-    usleep(2000);
-  } while (rc != SUCC);
   do {
     rc = connect_local_page_table_qp->connect("127.0.0.1", local_port);
     if (rc == SUCC) {
@@ -158,6 +199,8 @@ void PageTableStore::BuildConnectWithRingBuffer(){
     }
     usleep(2000);
   }while (rc != SUCC);
+  // 淘汰线程通过存储层的重放进度判断脏页是否可以回收
+  storage_client.reset(new StorageClient());
   stop_victim = false;
 }
 
@@ -166,77 +209,119 @@ void PageTableStore::FillFreeListThread() {
     std::this_thread::sleep_for(std::chrono::milliseconds(100));
   }
 
-  // TODO: 20000是一个可调的参数，可以根据实际情况调整
   while (true){ // 一直循环
     while (stop_victim) {
       std::this_thread::sleep_for(std::chrono::milliseconds(100));
     }
-    std::unique_lock<std::mutex> lock(victim_mutex);
-    if(free_list_.size() > MAX_FREE_LIST_VICTIM_SIZE * 100){
-      cv.wait(lock);
+    // 空闲页面链表达到高水位之后等待VictimPageThread在低水位时唤醒, 超时之后也重新检查一次
+    size_t free_num;
+    {
+      std::unique_lock<std::mutex> lock(victim_mutex);
+      free_list_mutex_.lock();
+      free_num = free_list_.size();
+      free_list_mutex_.unlock();
+      if(free_num >= FREE_LIST_LOW_WATERMARK){
+        cv.wait_for(lock, std::chrono::milliseconds(100));
+      }
     }
+    free_list_mutex_.lock();
+    free_num = free_list_.size();
+    free_list_mutex_.unlock();
+    if(free_num >= FREE_LIST_HIGH_WATERMARK) continue;
 
-    for(int i=0; i<* fill_page_count; i++){
-      char* cas_buf = rdma_buffer_allocator->Alloc(sizeof(lock_t));
-      char* faa_buf = rdma_buffer_allocator->Alloc(sizeof(lock_t));
-
-      offset_t offset = base_off + i * sizeof(PageTableNode);
+    ClockSweep(CLOCK_SWEEP_BUCKET_NUM);
+  }
+}
 
-      // ****************************************************************************************
-      // 这里手写了一个RDMACAS + RDMARead的操作，因为这是memstore的操作，不在DTX中，因此无法使用DTX的接口
-      // 这里需要注意，这里的RDMACAS因为和本地原子操作和RDMA原子操作不兼容，因此需要使用RDMACAS来加锁
-      auto rc = connect_local_page_table_qp->post_cas(cas_buf, offset, UNLOCKED, EXCLUSIVE_LOCKED, IBV_SEND_SIGNALED);
-      if (rc != SUCC) {
-        RDMA_LOG(ERROR) << "client: post cas fail. rc=" << rc << "VictimPageThread";
-        // return;
+// CLOCK淘汰, 从clock_hand开始检查sweep_bucket_num个桶
+// 可以淘汰的页面: 没有被pin(rwcount为0), 访问位为0, 空闲超过PAGE_EVICT_IDLE_SEC(计算节点页地址缓存的租约),
+// 并且修改它的batch已经被存储层重放, 即frame中的内容已经可以从存储层重新读到
+// 清零访问位不需要获取桶的latch, 和计算节点的桶写回冲突时最多丢失一次访问记录,
+// 只有桶中存在可以淘汰的页面时才通过RDMA CAS获取桶的latch, 避免每个桶一次回环的RDMA原子操作
+void PageTableStore::ClockSweep(uint64_t sweep_bucket_num) {
+  std::vector<std::pair<node_id_t, frame_id_t>> victim_frames;
+  for(uint64_t k=0; k<sweep_bucket_num; k++){
+    if(clock_hand >= *fill_page_count){
+      // 转完一圈, 更新存储层重放的进度
+      RDMA_LOG(INFO) << "CLOCK round finished, evict: " << clock_evict_num << ", second chance: " << clock_second_chance_num
+                     << ", wait for replay: " << clock_dirty_wait_num << ", persist batch id: " << persist_batch_id;
+      clock_hand = 0;
+      clock_evict_num = 0;
+      clock_second_chance_num = 0;
+      clock_dirty_wait_num = 0;
+      if(storage_client != nullptr) persist_batch_id = storage_client->GetPersistBatchId();
+    }
+    uint64_t bucket_id = clock_hand++;
+    PageTableNode* node = (PageTableNode*)(bucket_id * sizeof(PageTableNode) + page_table_ptr);
+    offset_t offset = base_off + bucket_id * sizeof(PageTableNode);
+    timestamp_t min_timestamp = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count() - PAGE_EVICT_IDLE_SEC;
+
+    bool has_victim = false;
+    for(int j=0; j<MAX_PAGETABLE_ITEM_NUM_PER_NODE; j++){
+      PageTableItem& item = node->page_table_items[j];
+      if(item.valid == false || item.page_valid == false || item.rwcount != 0) continue;
+      if(item.referenced){
+        item.referenced = false;
+        clock_second_chance_num++;
+      }
+      else if(item.last_access_time >= min_timestamp){
+        continue;
       }
-      ibv_wc wc{};
-      rc = connect_local_page_table_qp->poll_till_completion(wc, no_timeout);
-      if (rc != SUCC) {
-        RDMA_LOG(ERROR) << "client: poll read fail. rc=" << rc << "VictimPageThread";
-        // return;
+      else if(item.dirty_batch_id > persist_batch_id){
+        clock_dirty_wait_num++;
       }
-      
-      if( *(lock_t*)cas_buf == UNLOCKED){
-        
-        std::cout << "lock page table id: " << i << std::endl;
-        // 加锁成功
-        PageTableNode* node = (PageTableNode*)(offset + page_table_ptr);
-        timestamp_t min_timestamp = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count() - 5;
-        for(int j=0; j<MAX_PAGETABLE_ITEM_NUM_PER_NODE; j++){
-          if(node->page_table_items[j].valid == true){
-            // 该页面是有效页面
-            if(node->page_table_items[j].rwcount == 0 && node->page_table_items[j].last_access_time < min_timestamp){
-              // 该页面没有被修改，可以被替换
-              // 将该页面放入空闲页面链表中
-              // free_list_mutex_[node->page_table_items[j].page_address.node_id].lock();
-              // free_list_[node->page_table_items[j].page_address.node_id].push_back(node->page_table_items[j].page_address.frame_id);
-              // free_list_mutex_[node->page_table_items[j].page_address.node_id].unlock();
-
-              free_list_mutex_.lock();
-              free_list_.push_back({node->page_table_items[j].page_address.node_id, node->page_table_items[j].page_address.frame_id});
-              free_list_mutex_.unlock();
-
-              // 将该页面从页表中删除
-              node->page_table_items[j].valid = false;
-            }
-          }
-        }
-
-        // 释放锁
-        rc = connect_local_page_table_qp->post_faa(faa_buf, offset, EXCLUSIVE_UNLOCK_TO_BE_ADDED, IBV_SEND_SIGNALED);
-        if (rc != SUCC) {
-          RDMA_LOG(ERROR) << "client: post cas fail. rc=" << rc << "VictimPageThread";
-          // return;
-        }
-        rc = connect_local_page_table_qp->poll_till_completion(wc, no_timeout);
-        if (rc != SUCC) {
-          RDMA_LOG(ERROR) << "client: poll read fail. rc=" << rc << "VictimPageThread";
-          // return;
-        }
+      else{
+        has_victim = true;
       }
     }
+    if(!has_victim) continue;
+
+    char* cas_buf = rdma_buffer_allocator->Alloc(sizeof(lock_t));
+    char* faa_buf = rdma_buffer_allocator->Alloc(sizeof(lock_t));
+
+    // ****************************************************************************************
+    // 这里手写了一个RDMACAS + RDMARead的操作，因为这是memstore的操作，不在DTX中，因此无法使用DTX的接口
+    // 这里需要注意，这里的RDMACAS因为和本地原子操作和RDMA原子操作不兼容，因此需要使用RDMACAS来加锁
+    auto rc = connect_local_page_table_qp->post_cas(cas_buf, offset, UNLOCKED, EXCLUSIVE_LOCKED, IBV_SEND_SIGNALED);
+    if (rc != SUCC) {
+      RDMA_LOG(ERROR) << "client: post cas fail. rc=" << rc << "ClockSweep";
+    }
+    ibv_wc wc{};
+    rc = connect_local_page_table_qp->poll_till_completion(wc, no_timeout);
+    if (rc != SUCC) {
+      RDMA_LOG(ERROR) << "client: poll read fail. rc=" << rc << "ClockSweep";
+    }
+    // 桶正在被计算节点使用, 下一圈再检查
+    if(*(lock_t*)cas_buf != UNLOCKED) continue;
+
+    // 持有latch之后重新检查, 计算节点在释放latch之前已经写回了整个桶
+    for(int j=0; j<MAX_PAGETABLE_ITEM_NUM_PER_NODE; j++){
+      PageTableItem& item = node->page_table_items[j];
+      if(item.valid == false || item.page_valid == false || item.rwcount != 0 || item.referenced) continue;
+      if(item.last_access_time >= min_timestamp || item.dirty_batch_id > persist_batch_id) continue;
+      victim_frames.emplace_back(item.page_address.node_id, item.page_address.frame_id);
+      // 将该页面从页表中删除
+      item.valid = false;
+      clock_evict_num++;
+    }
+
+    // 释放锁
+    rc = connect_local_page_table_qp->post_faa(faa_buf, offset, EXCLUSIVE_UNLOCK_TO_BE_ADDED, IBV_SEND_SIGNALED);
+    if (rc != SUCC) {
+      RDMA_LOG(ERROR) << "client: post faa fail. rc=" << rc << "ClockSweep";
+    }
+    rc = connect_local_page_table_qp->poll_till_completion(wc, no_timeout);
+    if (rc != SUCC) {
+      RDMA_LOG(ERROR) << "client: poll read fail. rc=" << rc << "ClockSweep";
+    }
+  }
+
+  if(victim_frames.empty()) return;
+  free_list_mutex_.lock();
+  for(auto& frame : victim_frames){
+    free_list_.push_back(frame);
   }
+  free_list_mutex_.unlock();
 }
 
 void PageTableStore::VictimPageThread(){
@@ -244,72 +329,45 @@ void PageTableStore::VictimPageThread(){
   std::thread victim_page_thread_([this]{
     FillFreeListThread();
   });
+  victim_page_thread_.detach();
 
   while (stop_victim) {
     std::this_thread::sleep_for(std::chrono::milliseconds(100));
   }
 
+  std::vector<std::pair<node_id_t, frame_id_t>> free_pages;
   while (true) {
-    // 从空闲页面链表中取出空闲页面或者从页表中将超时的页面替换掉，放入环形缓冲区从head开始
-    char* faa_cnt_buf = rdma_buffer_allocator->Alloc(sizeof(int64_t));
-    char* faa_head_buf = rdma_buffer_allocator->Alloc(sizeof(uint64_t));
-    auto rc = connect_local_ring_qp->post_faa(faa_cnt_buf, ring_buffer_item_num_off, 1, IBV_SEND_SIGNALED);
-    if (rc != SUCC) {
-      RDMA_LOG(ERROR) << "client: post faa fail. rc=" << rc << "VictimPageThread";
-    }
-    ibv_wc wc{};
-    rc = connect_local_ring_qp->poll_till_completion(wc, no_timeout);
-    if (rc != SUCC) {
-      RDMA_LOG(ERROR) << "client: poll read fail. rc=" << rc << "VictimPageThread";
+    // 空闲页面链表为空时先唤醒CLOCK淘汰, 不要先占用环形缓冲区的位置
+    free_list_mutex_.lock();
+    size_t free_num = free_list_.size();
+    while(!free_list_.empty() && free_pages.size() < MAX_FREE_LIST_BUFFER_SIZE){
+      free_pages.push_back(free_list_.front());
+      free_list_.pop_front();
     }
-    rc = connect_local_ring_qp->post_faa(faa_head_buf, ring_buffer_head_off, 1, IBV_SEND_SIGNALED);
-    if (rc != SUCC) {
-      RDMA_LOG(ERROR) << "client: post faa fail. rc=" << rc << "VictimPageThread";
+    free_list_mutex_.unlock();
+    if(free_num < FREE_LIST_LOW_WATERMARK){
+      cv.notify_one();
     }
-    rc = connect_local_ring_qp->poll_till_completion(wc, no_timeout);
-    if (rc != SUCC) {
-      RDMA_LOG(ERROR) << "client: poll read fail. rc=" << rc << "VictimPageThread";
+    if(free_pages.empty()){
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      continue;
     }
-    std::cout << "cnt_buf: " << *(int64_t*)faa_cnt_buf << "head_buf: " << *(int64_t*)faa_head_buf << std::endl;
 
-    if(*(int64_t*)faa_cnt_buf >= MAX_FREE_LIST_BUFFER_SIZE -1){
-      // buffer is full
-      auto rc = connect_local_ring_qp->post_faa(faa_head_buf, ring_buffer_head_off, -1, IBV_SEND_SIGNALED);
-      if (rc != SUCC) {
-        RDMA_LOG(ERROR) << "client: post faa fail. rc=" << rc << "VictimPageThread";
-      }
-      ibv_wc wc{};
-      rc = connect_local_ring_qp->poll_till_completion(wc, no_timeout);
-      if (rc != SUCC) {
-        RDMA_LOG(ERROR) << "client: poll read fail. rc=" << rc << "VictimPageThread";
-      }
-      rc = connect_local_ring_qp->post_faa(faa_cnt_buf, ring_buffer_item_num_off, -1, IBV_SEND_SIGNALED);
-      if (rc != SUCC) {
-        RDMA_LOG(ERROR) << "client: post faa fail. rc=" << rc << "VictimPageThread";
-      }
-      rc = connect_local_ring_qp->poll_till_completion(wc, no_timeout);
-      if (rc != SUCC) {
-        RDMA_LOG(ERROR) << "client: poll read fail. rc=" << rc << "VictimPageThread";
-      }
-      std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    // 从空闲页面链表中取出空闲页面，放入环形缓冲区, 直到环形缓冲区满
+    size_t pushed = 0;
+    while(pushed < free_pages.size() && free_frame_ring_.TryPush(free_pages[pushed].first, free_pages[pushed].second)){
+      pushed++;
     }
-    else{
-      // buffer is not full
-      // 从free list中取一个元素放入环形缓冲区
+    if(pushed < free_pages.size()){
+      // 没有放入的页面还给空闲页面链表, 等待计算节点取走
       free_list_mutex_.lock();
-      uint64_t head = (*(uint64_t*)faa_head_buf) % MAX_FREE_LIST_BUFFER_SIZE;
-      auto free_page = free_list_.front();
-      ring_free_frame_buffer_.free_list_buffer_[head] = {free_page.first, free_page.second, true};
-      free_list_.pop_front();
-
-      if(free_list_.size() < MAX_FREE_LIST_VICTIM_SIZE){
-        std::unique_lock<std::mutex> lock(victim_mutex);
-        cv.notify_one();
+      for(size_t i = free_pages.size(); i > pushed; i--){
+        free_list_.push_front(free_pages[i - 1]);
       }
-
       free_list_mutex_.unlock();
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
     }
-    // std::this_thread::sleep_for(std::chrono::microseconds(50));
+    free_pages.clear();
   }
 }
 
@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <cstddef>
 #include <cstring>
 #include <iostream>
 #include <memory>
@@ -15,6 +16,7 @@
 #include <unordered_map>
 #include <condition_variable>
 
+#include "memstore/free_frame_ring.h"
 #include "memstore/mem_store.h"
 #include "allocator/buffer_allocator.h"
 #include "rlib/rdma_ctrl.hpp"
@@ -24,6 +26,13 @@
 #include "util/debug.h"
 
 #define MAX_FREE_LIST_VICTIM_SIZE 20000
+// 空闲页面链表低于低水位时唤醒CLOCK淘汰, 补充到高水位后停止, 保证fetch路径上总有空闲页面
+#define FREE_LIST_LOW_WATERMARK MAX_FREE_LIST_VICTIM_SIZE
+#define FREE_LIST_HIGH_WATERMARK (MAX_FREE_LIST_VICTIM_SIZE * 4)
+// CLOCK指针每次检查的桶数, 检查完之后重新判断是否达到高水位
+#define CLOCK_SWEEP_BUCKET_NUM 1024
+// 页面在最后一次访问之后空闲超过这个时间才会被淘汰, 计算节点的页地址缓存的租约以此为上界
+#define PAGE_EVICT_IDLE_SEC 5
 
 // 实现页表 -- std::unordered_map<PageId, frame_id_t, PageIdHash> page_table_;
 // 页表的作用是：通过页号PageId找到对应的帧号frame_id_t
@@ -40,6 +49,11 @@ struct PageTableItem {
   uint64_t rwcount = 0; // if the page is being modified
   bool page_valid = false; // if the page is valid, if not, the page is being read from disk and flush to the memstore
   timestamp_t last_access_time = 0; 
+  // CLOCK的访问位, 计算节点unpin时随桶的写回一起置位, 淘汰线程扫描时清零
+  bool referenced = false;
+  // 最后一次修改该页面的batch, 0表示页面是干净的
+  // 存储层通过重放日志得到页面的最新内容, 重放完这个batch之后frame才可以被回收
+  batch_id_t dirty_batch_id = 0;
   // pay attention: valid is just for the slot, not for the page itself
   bool valid; // if the slot is empty, valid: exits value in the slot
 
@@ -49,6 +63,14 @@ struct PageTableItem {
     page_valid(false), valid(1) {}
 } Aligned8;
 
+// 计算节点unpin时用一个RDMA WRITE写入page_valid到referenced之间的字节, 中间只能有last_access_time,
+// 不能覆盖rwcount和dirty_batch_id, 它们由FAA/CAS修改
+static_assert(offsetof(PageTableItem, rwcount) + sizeof(uint64_t) <= offsetof(PageTableItem, page_valid) &&
+              offsetof(PageTableItem, page_valid) < offsetof(PageTableItem, last_access_time) &&
+              offsetof(PageTableItem, last_access_time) < offsetof(PageTableItem, referenced) &&
+              offsetof(PageTableItem, referenced) + sizeof(bool) <= offsetof(PageTableItem, dirty_batch_id),
+              "page_valid, last_access_time and referenced should be adjacent between rwcount and dirty_batch_id");
+
 struct PageTableMeta {
   // Virtual address of the page table, used to calculate the distance
   // between some HashNodes with the table for traversing
@@ -78,20 +100,6 @@ struct PageTableMeta {
   PageTableMeta() {}
 } Aligned8;
 
-struct RingBufferItem{
-  node_id_t node_id;
-  frame_id_t frame_id;
-  bool valid;
-} Aligned8;
-
-struct RingFreeFrameBuffer{
-  // 空闲页面的环形缓冲区
-  RingBufferItem free_list_buffer_[MAX_FREE_LIST_BUFFER_SIZE];
-  uint64_t head_ = 0;
-  uint64_t tail_ = 0;
-  int64_t buffer_item_num_ = 0;
-};
-
 // 计算每个哈希桶节点可以存放多少个rids
 const int MAX_PAGETABLE_ITEM_NUM_PER_NODE = (PAGE_SIZE - sizeof(page_id_t) - sizeof(lock_t) - sizeof(short*) * NEXT_NODE_COUNT) / (sizeof(PageTableItem) );
 
@@ -109,55 +117,14 @@ struct PageTableNode {
   // PageTableNode* next;
 } Aligned8;
 
+class StorageClient;
+
 class PageTableStore {
  public:
-  PageTableStore(uint64_t bucket_num, MemStoreAllocParam* param)
-      :base_off(0), bucket_num(bucket_num), page_table_ptr(nullptr), node_num(bucket_num), connect_local_ring_qp(nullptr){
-
-    assert(bucket_num > 0);
-    page_table_size = (bucket_num) * sizeof(PageTableNode);
-    region_start_ptr = param->mem_region_start;
-    assert((uint64_t)param->mem_store_start + param->mem_store_alloc_offset + page_table_size + sizeof(uint64_t) <= (uint64_t)param->mem_store_reserve);
-
-    // fill_page_count是指针，指向额外分配页面的数量，安排已分配页面数量的位置，在地址索引空间的头部
-    // 额外指开始分配了bucket_num数量的bucket_key, 如果bucket已满，则需要在保留空间中新建桶
-    fill_page_count = (uint64_t*)(param->mem_store_start + param->mem_store_alloc_offset);
-    *fill_page_count = bucket_num;
-    param->mem_store_alloc_offset += sizeof(uint64_t);
-
-    // 安排哈希表的位置
-    page_table_ptr = param->mem_store_start + param->mem_store_alloc_offset;
-    param->mem_store_alloc_offset += page_table_size;
-
-    base_off = (uint64_t)page_table_ptr - (uint64_t)region_start_ptr;
-    assert(base_off >= 0);
-
-    assert(page_table_ptr != nullptr);
-    memset(page_table_ptr, 0, page_table_size);
-    
-    for(int i=0; i<bucket_num; i++){
-      PageTableNode* node = (PageTableNode*)(i * sizeof(PageTableNode) + page_table_ptr);
-      node->next_expand_node_id[0] = -1;
-      node->next_expand_node_id[1] = -1;
-      node->next_expand_node_id[2] = -1;
-      node->next_expand_node_id[3] = -1;
-      node->next_expand_node_id[4] = -1;
-      node->page_id = i;
-    }
-
-    bucket_array = (PageTableNode*)page_table_ptr;
-
-    // 这里初始化Freelist和线程替换函数
-    ReveiveMeta();
-    for(int i=0; i<manager_data_nodes.size(); i++){
-      for(int j=0; j<data_node_frame_nums[i]; j++){
-        free_list_.push_back(std::make_pair(manager_data_nodes[i], j));
-      }
-    }
-    stop_victim = true;
-    std::thread victim_thread_thread([this] {VictimPageThread();});
-    victim_thread_thread.detach();
-  }
+  // StorageClient在这里是不完整类型, 构造函数和析构函数在page_table.cc中定义
+  PageTableStore(uint64_t bucket_num, MemStoreAllocParam* param);
+
+  ~PageTableStore();
 
   offset_t GetBaseOff() const {
     return base_off;
@@ -203,6 +170,7 @@ class PageTableStore {
   
   void VictimPageThread();
   void FillFreeListThread();
+  void ClockSweep(uint64_t sweep_bucket_num);
   node_id_t GetDataStoreMeta(std::string& remote_ip, int remote_port); 
   void ReveiveMeta();
   void BuildConnectWithRingBuffer();
@@ -240,32 +208,36 @@ class PageTableStore {
   std::list<std::pair<node_id_t, frame_id_t>> free_list_;
   std::mutex free_list_mutex_;
 
+  // CLOCK指针, 指向下一个要检查的桶, 范围是[0, *fill_page_count)
+  uint64_t clock_hand = 0;
+  // 存储层已经重放完成的batch, CLOCK指针每转一圈更新一次
+  batch_id_t persist_batch_id = 0;
+  std::unique_ptr<StorageClient> storage_client;
+  // 本圈CLOCK的统计
+  uint64_t clock_evict_num = 0;
+  uint64_t clock_second_chance_num = 0;
+  uint64_t clock_dirty_wait_num = 0;
+
   std::thread victim_page_thread_;
   bool stop_victim = false;
   std::mutex victim_mutex;
   std::condition_variable cv;
   RingFreeFrameBuffer ring_free_frame_buffer_;
+  // 环形缓冲区的生产者一侧, 计算节点只通过RDMA访问dequeue_ticket和槽位, 这里只用CPU原子操作
+  FreeFrameRing free_frame_ring_;
 
   // RDMA原子操作和操作系统的原子操作是不兼容的
-  // 因此PageTable对环形缓冲区加锁也需要使用RDMA原语，因此这里需要两个qp
+  // 计算节点通过RDMA原子操作对桶加latch, 因此CLOCK淘汰对桶加latch也需要通过回环qp使用RDMA原语
 
   RdmaCtrlPtr global_rdma_ctrl;
   RNicHandler* opened_rnic;
-  RCQP* connect_local_ring_qp;
   RCQP* connect_local_page_table_qp;
 
   RDMABufferAllocator* rdma_buffer_allocator;
 
-  MemoryAttr local_ring_free_frame_buffer_mr{};
   MemoryAttr local_page_table_mr{};
 
   // Nodes managed by the page table
   std::vector<node_id_t> manager_data_nodes;
   std::vector<size_t> data_node_frame_nums;
-
-  // 设置环形缓冲区元信息的offset，便于RDMA访问
-  offset_t ring_buffer_base_off = 0;
-  offset_t ring_buffer_head_off = sizeof(RingBufferItem) * MAX_FREE_LIST_BUFFER_SIZE;
-  offset_t ring_buffer_tail_off = ring_buffer_head_off + sizeof(uint64_t);
-  offset_t ring_buffer_item_num_off = ring_buffer_tail_off + sizeof(uint64_t);
 };
@@ -64,9 +64,28 @@ void CoroutineScheduler::PollLogCompletion() {
   }
 }
 
+void CoroutineScheduler::PollRPCCompletion() {
+  // Fast path: no rpc has finished, avoid taking the lock
+  if (rpc_done_num.load(std::memory_order_acquire) == 0) return;
+  std::vector<coro_id_t> done_coros;
+  {
+    std::lock_guard<std::mutex> lock(rpc_done_mutex);
+    done_coros.swap(rpc_done_coros);
+    rpc_done_num.store(0, std::memory_order_relaxed);
+  }
+  for (auto coro_id : done_coros) {
+    assert(pending_counts[coro_id] > 0);
+    pending_counts[coro_id] -= 1;
+    if (pending_counts[coro_id] == 0) {
+      AppendCoroutine(&coro_array[coro_id]);
+    }
+  }
+}
+
 void CoroutineScheduler::PollCompletion() {
   PollRegularCompletion();
   PollLogCompletion();
+  PollRPCCompletion();
 }
 
 bool CoroutineScheduler::CheckLogAck(coro_id_t c_id) {
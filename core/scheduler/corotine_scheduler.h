@@ -3,7 +3,10 @@
 
 #pragma once
 
+#include <atomic>
 #include <list>
+#include <mutex>
+#include <vector>
 
 #include "base/common.h"
 #include "rlib/rdma_ctrl.hpp"
@@ -17,6 +20,8 @@ class CoroutineScheduler {
   // The coro_num includes all the coroutines
   CoroutineScheduler(t_id_t thread_id, coro_id_t coro_num) {
     t_id = thread_id;
+    this->coro_num = coro_num;
+    posted_wrs.resize(coro_num);
     pending_counts = new int[coro_num];
     pending_log_counts = new int[coro_num];
     for (coro_id_t c = 0; c < coro_num; c++) {
@@ -32,7 +37,14 @@ class CoroutineScheduler {
   }
 
   // For RDMA requests
-  void AddPendingQP(coro_id_t coro_id, RCQP* qp);
+  // wr_num is the number of work requests posted by one ibv_post_send, only the last one is signaled
+  void AddPendingQP(coro_id_t coro_id, RCQP* qp, int wr_num = 1);
+
+  // 一个线程的所有协程共用QP的发送队列, 每个协程在一个QP上最多同时有SendQueueShare()个未完成的请求
+  int SendQueueShare() const;
+
+  // 协程上一次等到所有请求完成之后, 在qp上发出的请求数
+  int PostedWRs(coro_id_t coro_id, RCQP* qp) const;
 
   void AddPendingLogQP(coro_id_t coro_id, RCQP* qp);
 
@@ -56,6 +68,12 @@ class CoroutineScheduler {
 
   bool RDMACAS(coro_id_t coro_id, RCQP* qp, char* local_buf, uint64_t remote_offset, uint64_t compare, uint64_t swap);
 
+  // For RPC requests to the storage pool
+  // AddPendingRPC is called by the issuing coroutine, NotifyRPCDone may be called by any (brpc) thread
+  void AddPendingRPC(coro_id_t coro_id);
+
+  void NotifyRPCDone(coro_id_t coro_id);
+
   // For polling
   void PollCompletion();  // There is a coroutine polling ACKs
 
@@ -63,6 +81,8 @@ class CoroutineScheduler {
 
   void PollLogCompletion();
 
+  void PollRPCCompletion();
+
   bool CheckLogAck(coro_id_t c_id);
 
   // Link coroutines in a loop manner
@@ -97,12 +117,45 @@ class CoroutineScheduler {
 
   // number of pending log qps (i.e., the ack has not received) per coroutine
   int* pending_log_counts;
+
+  coro_id_t coro_num;
+
+  // 每个协程在各个QP上发出但还没有确认完成的请求数, Yield返回时清空, 一个协程只访问少数几个内存节点的QP
+  std::vector<std::vector<std::pair<RCQP*, int>>> posted_wrs;
+
+  // coroutines whose rpc has finished, filled by brpc threads and drained by coroutine 0
+  std::mutex rpc_done_mutex;
+
+  std::vector<coro_id_t> rpc_done_coros;
+
+  std::atomic<int> rpc_done_num{0};
 };
 
 ALWAYS_INLINE
-void CoroutineScheduler::AddPendingQP(coro_id_t coro_id, RCQP* qp) {
+void CoroutineScheduler::AddPendingQP(coro_id_t coro_id, RCQP* qp, int wr_num) {
   pending_qps.push_back(qp);
   pending_counts[coro_id] += 1;
+  for (auto& posted : posted_wrs[coro_id]) {
+    if (posted.first == qp) {
+      posted.second += wr_num;
+      return;
+    }
+  }
+  posted_wrs[coro_id].emplace_back(qp, wr_num);
+}
+
+ALWAYS_INLINE
+int CoroutineScheduler::SendQueueShare() const {
+  int share = RCQPImpl::RC_MAX_SEND_SIZE / coro_num;
+  return share > 0 ? share : 1;
+}
+
+ALWAYS_INLINE
+int CoroutineScheduler::PostedWRs(coro_id_t coro_id, RCQP* qp) const {
+  for (auto& posted : posted_wrs[coro_id]) {
+    if (posted.first == qp) return posted.second;
+  }
+  return 0;
 }
 
 ALWAYS_INLINE
@@ -119,7 +172,7 @@ bool CoroutineScheduler::RDMABatch(coro_id_t coro_id, RCQP* qp, ibv_send_wr* sen
     RDMA_LOG(ERROR) << "client: post batch fail. rc=" << rc << ", tid = " << t_id << ", coroid = " << coro_id;
     return false;
   }
-  AddPendingQP(coro_id, qp);
+  AddPendingQP(coro_id, qp, doorbell_num + 1);
   return true;
 }
 
@@ -232,6 +285,18 @@ bool CoroutineScheduler::RDMACAS(coro_id_t coro_id, RCQP* qp, char* local_buf, u
   return true;
 }
 
+ALWAYS_INLINE
+void CoroutineScheduler::AddPendingRPC(coro_id_t coro_id) {
+  pending_counts[coro_id] += 1;
+}
+
+ALWAYS_INLINE
+void CoroutineScheduler::NotifyRPCDone(coro_id_t coro_id) {
+  std::lock_guard<std::mutex> lock(rpc_done_mutex);
+  rpc_done_coros.push_back(coro_id);
+  rpc_done_num.fetch_add(1, std::memory_order_release);
+}
+
 // Link coroutines in a loop manner
 ALWAYS_INLINE
 void CoroutineScheduler::LoopLinkCoroutine(coro_id_t coro_num) {
@@ -251,6 +316,7 @@ void CoroutineScheduler::LoopLinkCoroutine(coro_id_t coro_num) {
 ALWAYS_INLINE
 void CoroutineScheduler::Yield(coro_yield_t& yield, coro_id_t cid) {
   if (unlikely(pending_counts[cid] == 0)) {
+    posted_wrs[cid].clear();
     return;
   }
   // 1. Remove this coroutine from the yield-able coroutine list
@@ -264,6 +330,8 @@ void CoroutineScheduler::Yield(coro_yield_t& yield, coro_id_t cid) {
   // 2. Yield to the next coroutine
   // RDMA_LOG(DBG) << "coro: " << cid << " yields to coro " << next->coro_id;
   RunCoroutine(yield, next);
+  // 再次被调度时本协程的所有请求都已经完成
+  posted_wrs[cid].clear();
 }
 
 // Start this coroutine. Used by coroutine 0 and Yield()
@@ -1,16 +1,36 @@
+#include <errno.h>
 #include <string.h>
 #include <unistd.h>
 #include <assert.h>
 #include <sys/stat.h>
 #include <fcntl.h>
+#include <sys/uio.h>
+#include <limits.h>
+
+#include <algorithm>
+#include <memory>
+#include <numeric>
 
 #include "util/debug.h"
 #include "util/errors.h"
 #include "disk_manager.h"
 
-DiskManager::DiskManager() { 
+DiskManager::DiskManager(bool use_io_uring) { 
     memset(fd2pageno_, 0, MAX_FD * (sizeof(std::atomic<page_id_t>) / sizeof(char))); 
 
+#ifdef FORD_IO_URING
+    if (use_io_uring) {
+        // 在构造时探测一次内核是否支持io_uring
+        IoUringEngine probe(1);
+        use_io_uring_ = probe.valid();
+    }
+#else
+    if (use_io_uring) {
+        RDMA_LOG(WARNING) << "FORD is built without io_uring, DiskManager uses blocking IO";
+    }
+#endif
+    RDMA_LOG(INFO) << "DiskManager io backend: " << (use_io_uring_ ? "io_uring" : "blocking");
+
     // 日志文件不存在, 创建日志文件, 并初始化log的batch id
     // if(! is_file(LOG_FILE_NAME)){
     //     create_file(LOG_FILE_NAME);
@@ -29,6 +49,16 @@ DiskManager::DiskManager() {
 
 }
 
+DiskManager::~DiskManager() {
+    // 关闭get_file_fd缓存的所有文件句柄
+    std::unique_lock<std::shared_timed_mutex> latch(fd_latch_);
+    for (auto& entry : path2fd_) {
+        close(entry.second);
+    }
+    path2fd_.clear();
+    fd2path_.clear();
+}
+
 /**
  * @description: 将数据写入文件的指定磁盘页面中
  * @param {int} fd 磁盘文件的文件句柄
@@ -38,14 +68,10 @@ DiskManager::DiskManager() {
  */
 void DiskManager::write_page(int fd, page_id_t page_no, const char *offset, int num_bytes) {
     // Todo:
-    // 1.lseek()定位到文件头，通过(fd,page_no)可以定位指定页面及其在磁盘文件中的偏移量
-    // 2.调用write()函数
+    // 使用pwrite按位置写入，不修改文件偏移量，多个线程可以并发写同一个fd
     // 注意write返回值与num_bytes不等时 throw InternalError("DiskManager::write_page Error");
 
-    lseek(fd, page_no * PAGE_SIZE, SEEK_SET);
-    ssize_t bytes_write = write(fd, offset, num_bytes);  // 这里的offset可以是uint_8*类型，也可以是char*类型
-    
-    RDMA_LOG(INFO) << "Write page: fd: " << fd << ", page_no: " << page_no << ", write size: " << bytes_write;
+    ssize_t bytes_write = pwrite(fd, offset, num_bytes, (off_t)page_no * PAGE_SIZE);  // 这里的offset可以是uint_8*类型，也可以是char*类型
 
     if (bytes_write != num_bytes) {
         // throw InternalError("DiskManager::write_page Error");
@@ -63,15 +89,10 @@ void DiskManager::write_page(int fd, page_id_t page_no, const char *offset, int
  */
 void DiskManager::read_page(int fd, page_id_t page_no, char *offset, int num_bytes) {
     // Todo:
-    // 1.lseek()定位到文件头，通过(fd,page_no)可以定位指定页面及其在磁盘文件中的偏移量
-    // 2.调用read()函数
+    // 使用pread按位置读取，不修改文件偏移量，多个线程可以并发读同一个fd
     // 注意read返回值与num_bytes不等时，throw InternalError("DiskManager::read_page Error");
 
-    // SEEK_SET 定位到文件头
-    lseek(fd, page_no * PAGE_SIZE, SEEK_SET);
-    ssize_t bytes_read = read(fd, offset, num_bytes);
-
-    RDMA_LOG(INFO) << "Read page: fd: " << fd << ", page_no: " << page_no << ", read size: " << bytes_read;
+    ssize_t bytes_read = pread(fd, offset, num_bytes, (off_t)page_no * PAGE_SIZE);
 
     // 没有成功从buffer偏移处读取指定数字节
     if (bytes_read != num_bytes) {
@@ -82,9 +103,140 @@ void DiskManager::read_page(int fd, page_id_t page_no, char *offset, int num_byt
     }
 }
 
+/**
+ * @description: 读取页面, 文件末尾之后的部分填0, 用于日志重放:
+ *               页面可能在NEWPAGE之后、第一次写回磁盘之前崩溃, 此时文件还没有扩展到这个页面
+ * @param {int} fd 磁盘文件的文件句柄
+ * @param {page_id_t} page_no 指定的页面编号
+ * @param {char} *offset 读取的内容写入到offset中
+ * @param {int} num_bytes 读取的数据量大小
+ */
+void DiskManager::read_page_or_zero(int fd, page_id_t page_no, char *offset, int num_bytes) {
+    int done = 0;
+    while (done < num_bytes) {
+        ssize_t bytes_read = pread(fd, offset + done, num_bytes - done, (off_t)page_no * PAGE_SIZE + done);
+        if (bytes_read < 0) {
+            if (errno == EINTR) continue;
+            RDMA_LOG(FATAL) << "DiskManager::read_page_or_zero Error: failed to read page " << page_no << ", errno " << errno;
+            throw InternalError("DiskManager::read_page_or_zero Error");
+        }
+        if (bytes_read == 0) break;  // EOF
+        done += bytes_read;
+    }
+    if (done < num_bytes) {
+        memset(offset + done, 0, num_bytes - done);
+    }
+}
+
+/**
+ * @description: 读取同一个文件中的多个完整页面, 页号连续的页面合并为一次preadv
+ * @param {int} fd 磁盘文件的文件句柄
+ * @param {vector<page_id_t>&} page_nos 要读取的页面编号, 可以无序
+ * @param {vector<char*>&} pages pages[i]用于存放page_nos[i]的内容, 每个至少PAGE_SIZE字节
+ */
+void DiskManager::read_pages(int fd, const std::vector<page_id_t>& page_nos, const std::vector<char*>& pages) {
+    assert(page_nos.size() == pages.size());
+    if (use_io_uring_) {
+        // 每个页面一个SQE, 一次提交, 由设备并发处理
+        std::vector<DiskIORequest> reqs;
+        reqs.reserve(page_nos.size());
+        for (size_t i = 0; i < page_nos.size(); i++) {
+            reqs.push_back({fd, false, pages[i], PAGE_SIZE, (off_t)page_nos[i] * PAGE_SIZE});
+        }
+        submit_io(reqs);
+        return;
+    }
+    std::vector<size_t> order(page_nos.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return page_nos[a] < page_nos[b]; });
+
+    std::vector<struct iovec> iov;
+    iov.reserve(std::min(order.size(), (size_t)IOV_MAX));
+    size_t i = 0;
+    while (i < order.size()) {
+        // 找到一段页号连续的页面
+        page_id_t start_page_no = page_nos[order[i]];
+        iov.clear();
+        while (i < order.size() && iov.size() < IOV_MAX) {
+            page_id_t page_no = page_nos[order[i]];
+            // 页号不连续(或重复)时结束这一段, 从下一个页面开始新的一段
+            if (!iov.empty() && page_no != start_page_no + (page_id_t)iov.size()) break;
+            iov.push_back({pages[order[i]], PAGE_SIZE});
+            i++;
+        }
+        ssize_t expected = (ssize_t)iov.size() * PAGE_SIZE;
+        ssize_t bytes_read = preadv(fd, iov.data(), iov.size(), (off_t)start_page_no * PAGE_SIZE);
+        if (bytes_read != expected) {
+            RDMA_LOG(FATAL) << "DiskManager::read_pages Error: failed to read " << iov.size() << " pages from page " << start_page_no
+                            << ", read bytes is " << bytes_read;
+            throw InternalError("DiskManager::read_pages Error");
+        }
+    }
+}
+
+void DiskManager::will_need_pages(int fd, const std::vector<page_id_t>& page_nos) {
+    std::vector<page_id_t> sorted_page_nos(page_nos);
+    std::sort(sorted_page_nos.begin(), sorted_page_nos.end());
+    size_t i = 0;
+    while (i < sorted_page_nos.size()) {
+        // 页号连续的一段合并成一次posix_fadvise
+        size_t j = i + 1;
+        while (j < sorted_page_nos.size() && sorted_page_nos[j] <= sorted_page_nos[j - 1] + 1) j++;
+        page_id_t page_num = sorted_page_nos[j - 1] - sorted_page_nos[i] + 1;
+        int rc = posix_fadvise(fd, (off_t)sorted_page_nos[i] * PAGE_SIZE, (off_t)page_num * PAGE_SIZE, POSIX_FADV_WILLNEED);
+        if (rc != 0) {
+            RDMA_LOG(WARNING) << "DiskManager::will_need_pages: posix_fadvise fails, " << strerror(rc);
+            return;
+        }
+        i = j;
+    }
+}
+
+IoUringEngine* DiskManager::local_io_engine() {
+    thread_local std::unique_ptr<IoUringEngine> engine;
+    thread_local bool init = false;
+    // 第一次使用时创建, 之前的引擎因为io_uring_enter失败不再可用时重新创建
+    if (!init || (engine != nullptr && !engine->valid())) {
+        init = true;
+        engine.reset(new IoUringEngine(IO_URING_ENTRIES));
+        if (!engine->valid()) engine.reset();
+    }
+    return engine.get();
+}
+
+/**
+ * @description: 批量提交IO请求并等待全部完成, 开启io_uring时一次系统调用提交所有请求, 否则逐个pread/pwrite
+ * @param {vector<DiskIORequest>&} reqs IO请求, 写请求之间不能重叠
+ */
+void DiskManager::submit_io(std::vector<DiskIORequest>& reqs) {
+    if (reqs.empty()) return;
+    std::vector<ssize_t> results(reqs.size(), 0);
+    IoUringEngine* engine = use_io_uring_ ? local_io_engine() : nullptr;
+    if (engine == nullptr || !engine->submit_and_wait(reqs.data(), reqs.size(), results.data())) {
+        for (size_t i = 0; i < reqs.size(); i++) {
+            auto& req = reqs[i];
+            results[i] = req.is_write ? pwrite(req.fd, req.buf, req.len, req.offset)
+                                      : pread(req.fd, req.buf, req.len, req.offset);
+        }
+    }
+    for (size_t i = 0; i < reqs.size(); i++) {
+        if (results[i] != (ssize_t)reqs[i].len) {
+            RDMA_LOG(FATAL) << "DiskManager::submit_io Error: fd: " << reqs[i].fd << ", offset: " << reqs[i].offset
+                            << ", expect " << reqs[i].len << " bytes, result is " << results[i];
+            throw InternalError("DiskManager::submit_io Error");
+        }
+    }
+}
+
+void DiskManager::sync_file(int fd) {
+    if (fdatasync(fd) != 0) {
+        RDMA_LOG(FATAL) << "DiskManager::sync_file Error: fdatasync fails on fd " << fd << ", errno: " << errno;
+        throw UnixError();
+    }
+}
+
 void DiskManager::update_value(int fd, page_id_t page_no, int slot_offset, char* value, int value_size) {
-    lseek(fd, page_no * PAGE_SIZE + slot_offset, SEEK_SET);
-    ssize_t bytes_write = write(fd, value, value_size);
+    ssize_t bytes_write = pwrite(fd, value, value_size, (off_t)page_no * PAGE_SIZE + slot_offset);
     if(bytes_write != value_size) {
         RDMA_LOG(FATAL) << "DiskManager::update_value Error: failed to write complete data.";
         throw InternalError("DiskManager::update_value Error");
@@ -175,8 +327,11 @@ void DiskManager::destroy_file(const std::string &path) {
         throw FileNotFoundError(path);
     }
     // If file is open, cannot destroy file
-    if (path2fd_.count(path)) {
-        throw FileNotClosedError(path);
+    {
+        std::shared_lock<std::shared_timed_mutex> latch(fd_latch_);
+        if (path2fd_.count(path)) {
+            throw FileNotClosedError(path);
+        }
     }
     // Remove file from disk
     if (unlink(path.c_str()) != 0) {
@@ -236,10 +391,10 @@ void DiskManager::close_file(int fd) {
 
 /**
  * @description: 获得文件的大小
- * @return {int} 文件的大小
+ * @return {off_t} 文件的大小
  * @param {string} &file_name 文件名
  */
-int DiskManager::get_file_size(const std::string &file_name) {
+off_t DiskManager::get_file_size(const std::string &file_name) {
     struct stat stat_buf;
     int rc = stat(file_name.c_str(), &stat_buf);
     return rc == 0 ? stat_buf.st_size : -1;
@@ -251,10 +406,12 @@ int DiskManager::get_file_size(const std::string &file_name) {
  * @param {int} fd 文件句柄
  */
 std::string DiskManager::get_file_name(int fd) {
-    if (!fd2path_.count(fd)) {
+    std::shared_lock<std::shared_timed_mutex> latch(fd_latch_);
+    auto it = fd2path_.find(fd);
+    if (it == fd2path_.end()) {
         throw FileNotOpenError(fd);
     }
-    return fd2path_[fd];
+    return it->second;
 }
 
 /**
@@ -263,8 +420,21 @@ std::string DiskManager::get_file_name(int fd) {
  * @param {string} &file_name 文件名
  */
 int DiskManager::get_file_fd(const std::string &file_name) {
-    if (!path2fd_.count(file_name)) {
-        return open_file(file_name);
+    {
+        std::shared_lock<std::shared_timed_mutex> latch(fd_latch_);
+        auto it = path2fd_.find(file_name);
+        if (it != path2fd_.end()) {
+            return it->second;
+        }
     }
-    return path2fd_[file_name];
+    std::unique_lock<std::shared_timed_mutex> latch(fd_latch_);
+    // 其他线程可能已经打开了这个文件
+    auto it = path2fd_.find(file_name);
+    if (it != path2fd_.end()) {
+        return it->second;
+    }
+    int fd = open_file(file_name);
+    path2fd_[file_name] = fd;
+    fd2path_[fd] = file_name;
+    return fd;
 }
@@ -9,8 +9,11 @@
 #include <string>
 #include <unordered_map>
 #include <mutex>
+#include <shared_mutex>
+#include <vector>
 
 #include "base/common.h"
+#include "storage/io_uring_engine.h"
 
 // template <>
 // struct std::hash<PageId> {
@@ -20,14 +23,32 @@
 
 class DiskManager {
    public:
-    explicit DiskManager();
+    // use_io_uring: 批量IO使用io_uring提交, 编译时未开启FORD_IO_URING或者内核不支持时回退到阻塞IO
+    explicit DiskManager(bool use_io_uring = false);
 
-    ~DiskManager() = default;
+    ~DiskManager();
 
     void write_page(int fd, page_id_t page_no, const char *offset, int num_bytes);
 
     void read_page(int fd, page_id_t page_no, char *offset, int num_bytes);
 
+    // like read_page, but the part past the end of file is filled with 0 instead of failing
+    void read_page_or_zero(int fd, page_id_t page_no, char *offset, int num_bytes);
+
+    // read a group of whole pages of one file, pages[i] receives page_nos[i]
+    void read_pages(int fd, const std::vector<page_id_t>& page_nos, const std::vector<char*>& pages);
+
+    // 提示内核异步读取一组页面到page cache, 不等待读取完成, 之后对这些页面的read_pages不再访问磁盘
+    void will_need_pages(int fd, const std::vector<page_id_t>& page_nos);
+
+    // 批量提交一组IO请求并等待完成, 请求之间不保证顺序, 写请求之间不能有重叠
+    void submit_io(std::vector<DiskIORequest>& reqs);
+
+    bool use_io_uring() const { return use_io_uring_; }
+
+    // 把文件已经写入的数据持久化到磁盘
+    void sync_file(int fd);
+
     // update part of page data, value_size: num_bytes
     void update_value(int fd, page_id_t page_no, int slot_offset, char* value, int value_size);
 
@@ -57,10 +78,11 @@ class DiskManager {
 
     void close_file(int fd);
 
-    int get_file_size(const std::string &file_name);
+    off_t get_file_size(const std::string &file_name);
 
     std::string get_file_name(int fd);
 
+    // 获取文件的缓存句柄, 第一次访问时打开文件, 之后一直复用直到DiskManager析构, 调用者不需要关闭
     int get_file_fd(const std::string &file_name);
 
     void SetLogFd(int log_fd) { log_fd_ = log_fd; }
@@ -84,10 +106,17 @@ class DiskManager {
     static constexpr int MAX_FD = 8192;
 
    private:
-    // 文件打开列表，用于记录文件是否被打开
+    // 文件打开列表，记录get_file_fd缓存的文件句柄，由fd_latch_保护
+    std::shared_timed_mutex fd_latch_;
     std::unordered_map<std::string, int> path2fd_;  //<Page文件磁盘路径,Page fd>哈希表
     std::unordered_map<int, std::string> fd2path_;  //<Page fd,Page文件磁盘路径>哈希表
 
+    // 当前线程的io_uring引擎, 第一次使用时创建, 创建失败返回nullptr
+    IoUringEngine* local_io_engine();
+
+    bool use_io_uring_ = false;
+    static constexpr unsigned IO_URING_ENTRIES = 128;
+
     int log_fd_ = -1;                             // WAL日志文件的文件句柄，默认为-1，代表未打开日志文件
     std::atomic<page_id_t> fd2pageno_[MAX_FD]{};  // 文件中已经分配的页面个数，初始值为0
 };
\ No newline at end of file
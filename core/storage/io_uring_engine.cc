@@ -0,0 +1,191 @@
+#include "storage/io_uring_engine.h"
+
+#include <assert.h>
+#include <errno.h>
+#include <string.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <vector>
+
+#include "util/debug.h"
+
+#ifdef FORD_IO_URING
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+static int sys_io_uring_setup(unsigned entries, struct io_uring_params* p) {
+    return (int)syscall(__NR_io_uring_setup, entries, p);
+}
+
+static int sys_io_uring_enter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags) {
+    return (int)syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, nullptr, 0);
+}
+
+IoUringEngine::IoUringEngine(unsigned entries) {
+    struct io_uring_params p;
+    memset(&p, 0, sizeof(p));
+    int fd = sys_io_uring_setup(entries, &p);
+    if (fd < 0) {
+        RDMA_LOG(WARNING) << "io_uring_setup fails, errno: " << errno << ", fall back to blocking IO";
+        return;
+    }
+
+    sq_ring_size_ = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+    cq_ring_size_ = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+    bool single_mmap = p.features & IORING_FEAT_SINGLE_MMAP;
+    if (single_mmap) {
+        if (cq_ring_size_ > sq_ring_size_) sq_ring_size_ = cq_ring_size_;
+        cq_ring_size_ = sq_ring_size_;
+    }
+
+    sq_ptr_ = mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+    if (sq_ptr_ == MAP_FAILED) {
+        RDMA_LOG(WARNING) << "mmap io_uring sq ring fails, fall back to blocking IO";
+        sq_ptr_ = nullptr;
+        close(fd);
+        return;
+    }
+    if (single_mmap) {
+        cq_ptr_ = sq_ptr_;
+    } else {
+        cq_ptr_ = mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+        if (cq_ptr_ == MAP_FAILED) {
+            RDMA_LOG(WARNING) << "mmap io_uring cq ring fails, fall back to blocking IO";
+            cq_ptr_ = nullptr;
+            munmap(sq_ptr_, sq_ring_size_);
+            sq_ptr_ = nullptr;
+            close(fd);
+            return;
+        }
+    }
+    sqes_size_ = p.sq_entries * sizeof(struct io_uring_sqe);
+    sqes_ = mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+    if (sqes_ == MAP_FAILED) {
+        RDMA_LOG(WARNING) << "mmap io_uring sqes fails, fall back to blocking IO";
+        sqes_ = nullptr;
+        if (!single_mmap) munmap(cq_ptr_, cq_ring_size_);
+        munmap(sq_ptr_, sq_ring_size_);
+        sq_ptr_ = cq_ptr_ = nullptr;
+        close(fd);
+        return;
+    }
+
+    char* sq = (char*)sq_ptr_;
+    sq_head_ = (unsigned*)(sq + p.sq_off.head);
+    sq_tail_ = (unsigned*)(sq + p.sq_off.tail);
+    sq_mask_ = (unsigned*)(sq + p.sq_off.ring_mask);
+    sq_array_ = (unsigned*)(sq + p.sq_off.array);
+
+    char* cq = (char*)cq_ptr_;
+    cq_head_ = (unsigned*)(cq + p.cq_off.head);
+    cq_tail_ = (unsigned*)(cq + p.cq_off.tail);
+    cq_mask_ = (unsigned*)(cq + p.cq_off.ring_mask);
+    cqes_ = cq + p.cq_off.cqes;
+
+    sq_entries_ = p.sq_entries;
+    ring_fd_ = fd;
+}
+
+IoUringEngine::~IoUringEngine() {
+    if (ring_fd_ < 0) return;
+    munmap(sqes_, sqes_size_);
+    if (cq_ptr_ != sq_ptr_) munmap(cq_ptr_, cq_ring_size_);
+    munmap(sq_ptr_, sq_ring_size_);
+    close(ring_fd_);
+}
+
+unsigned IoUringEngine::reap_completions(ssize_t* results) {
+    auto* cqes = (struct io_uring_cqe*)cqes_;
+    unsigned reaped = 0;
+    unsigned head = *cq_head_;
+    unsigned cq_tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+    while (head != cq_tail) {
+        struct io_uring_cqe* cqe = &cqes[head & *cq_mask_];
+        if (results != nullptr) results[cqe->user_data] = cqe->res;
+        head++;
+        reaped++;
+    }
+    __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+    return reaped;
+}
+
+void IoUringEngine::drain(unsigned in_flight) {
+    while (in_flight > 0) {
+        int ret = sys_io_uring_enter(ring_fd_, 0, in_flight, IORING_ENTER_GETEVENTS);
+        if (ret < 0 && errno != EINTR) {
+            // 无法再等待, 关闭ring时内核会取消剩余的请求
+            RDMA_LOG(ERROR) << "io_uring_enter fails while draining " << in_flight << " requests, errno: " << errno;
+            return;
+        }
+        unsigned reaped = reap_completions(nullptr);
+        in_flight -= reaped < in_flight ? reaped : in_flight;
+    }
+}
+
+bool IoUringEngine::submit_and_wait(const DiskIORequest* reqs, size_t num, ssize_t* results) {
+    assert(valid());
+    std::vector<struct iovec> iovs(num < sq_entries_ ? num : sq_entries_);
+    auto* sqes = (struct io_uring_sqe*)sqes_;
+
+    size_t start = 0;
+    while (start < num) {
+        unsigned batch = (unsigned)((num - start) < sq_entries_ ? (num - start) : sq_entries_);
+
+        // 1. 填写SQE, 只有本线程修改sq tail
+        unsigned tail = *sq_tail_;
+        unsigned mask = *sq_mask_;
+        for (unsigned i = 0; i < batch; i++) {
+            const DiskIORequest& req = reqs[start + i];
+            iovs[i].iov_base = req.buf;
+            iovs[i].iov_len = req.len;
+
+            unsigned idx = tail & mask;
+            struct io_uring_sqe* sqe = &sqes[idx];
+            memset(sqe, 0, sizeof(*sqe));
+            sqe->opcode = req.is_write ? IORING_OP_WRITEV : IORING_OP_READV;
+            sqe->fd = req.fd;
+            sqe->addr = (uint64_t)&iovs[i];
+            sqe->len = 1;
+            sqe->off = (uint64_t)req.offset;
+            sqe->user_data = start + i;
+            sq_array_[idx] = idx;
+            tail++;
+        }
+        __atomic_store_n(sq_tail_, tail, __ATOMIC_RELEASE);
+
+        // 2. 提交并等待这一批请求全部完成
+        unsigned to_submit = batch;
+        unsigned completed = 0;
+        while (completed < batch) {
+            int ret = sys_io_uring_enter(ring_fd_, to_submit, batch - completed, IORING_ENTER_GETEVENTS);
+            if (ret < 0) {
+                if (errno == EINTR) continue;
+                RDMA_LOG(ERROR) << "io_uring_enter fails, errno: " << errno;
+                // 已经提交的请求仍然在读写调用者的buf, 必须等它们完成之后才能返回让调用者回退到阻塞IO,
+                // 未提交的SQE和之后到达的CQE会被下一次调用误认为是自己的请求, 所以这个ring不再使用
+                drain(batch - to_submit - completed);
+                broken_ = true;
+                return false;
+            }
+            to_submit -= (unsigned)ret < to_submit ? (unsigned)ret : to_submit;
+
+            // 3. 收割CQE
+            completed += reap_completions(results);
+        }
+        start += batch;
+    }
+    return true;
+}
+
+#else
+
+IoUringEngine::IoUringEngine(unsigned entries) {}
+
+IoUringEngine::~IoUringEngine() {}
+
+bool IoUringEngine::submit_and_wait(const DiskIORequest* reqs, size_t num, ssize_t* results) { return false; }
+
+#endif
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <sys/types.h>
+
+#include <cstddef>
+#include <cstdint>
+
+// 一次磁盘IO请求, buf的生命周期由调用者保证直到IO完成
+struct DiskIORequest {
+    int fd;
+    bool is_write;
+    char* buf;
+    size_t len;
+    off_t offset;
+};
+
+/**
+ * 基于io_uring的批量IO引擎, 直接使用io_uring_setup/io_uring_enter系统调用, 不依赖liburing
+ * 一个引擎只能被一个线程使用, DiskManager为每个线程创建一个
+ * 只有定义了FORD_IO_URING时才会真正创建ring, 否则valid()始终返回false, 调用者需要回退到阻塞IO
+ */
+class IoUringEngine {
+   public:
+    explicit IoUringEngine(unsigned entries);
+
+    ~IoUringEngine();
+
+    // io_uring_enter失败之后ring中可能残留请求, 引擎不再可用, 由调用者重新创建
+    bool valid() const { return ring_fd_ >= 0 && !broken_; }
+
+    /**
+     * @description: 提交一批IO请求并等待全部完成, 一次io_uring_enter提交最多entries个请求
+     * @return {bool} 若io_uring_enter本身失败则返回false, 此时results中的内容无效, 已提交的请求都已完成, 引擎不再valid
+     * @param {DiskIORequest*} reqs IO请求数组, 请求之间的执行顺序不保证, 调用者需要保证写请求之间没有重叠
+     * @param {size_t} num 请求个数
+     * @param {ssize_t*} results results[i]为reqs[i]的返回值, 即传输的字节数或者-errno
+     */
+    bool submit_and_wait(const DiskIORequest* reqs, size_t num, ssize_t* results);
+
+   private:
+    // 收割CQ中所有已完成的请求, results为nullptr时丢弃结果, 返回收割的个数
+    unsigned reap_completions(ssize_t* results);
+
+    // 等待in_flight个已提交的请求完成
+    void drain(unsigned in_flight);
+
+    int ring_fd_ = -1;
+    bool broken_ = false;
+    unsigned sq_entries_ = 0;
+
+    // submission queue
+    void* sq_ptr_ = nullptr;
+    size_t sq_ring_size_ = 0;
+    unsigned* sq_head_ = nullptr;
+    unsigned* sq_tail_ = nullptr;
+    unsigned* sq_mask_ = nullptr;
+    unsigned* sq_array_ = nullptr;
+    void* sqes_ = nullptr;
+    size_t sqes_size_ = 0;
+
+    // completion queue
+    void* cq_ptr_ = nullptr;
+    size_t cq_ring_size_ = 0;
+    unsigned* cq_head_ = nullptr;
+    unsigned* cq_tail_ = nullptr;
+    unsigned* cq_mask_ = nullptr;
+    void* cqes_ = nullptr;
+};
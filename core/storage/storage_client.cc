@@ -0,0 +1,136 @@
+#include "storage/storage_client.h"
+
+#include <cassert>
+#include <cstring>
+
+#include "util/debug.h"
+
+DEFINE_string(protocol, "baidu_std", "Protocol type");
+DEFINE_string(connection_type, "", "Connection type. Available values: single, pooled, short");
+DEFINE_string(server, "127.0.0.1:12348", "IP address of server");
+DEFINE_int32(timeout_ms, 0x7fffffff, "RPC timeout in milliseconds");
+DEFINE_int32(max_retry, 3, "Max retries(not including the first RPC)");
+DEFINE_int32(interval_ms, 10, "Milliseconds between consecutive requests");
+
+StorageClient::StorageClient() : stub_(&channel_) {
+  brpc::ChannelOptions options;
+  options.use_rdma = true;
+  options.protocol = FLAGS_protocol;
+  // baidu_std默认使用single连接, 同一个连接上可以同时有多个未完成的请求
+  options.connection_type = FLAGS_connection_type;
+  options.timeout_ms = FLAGS_timeout_ms;
+  options.max_retry = FLAGS_max_retry;
+  if (channel_.Init(FLAGS_server.c_str(), &options) != 0) {
+    RDMA_LOG(FATAL) << "Fail to initialize channel to storage server " << FLAGS_server;
+  }
+}
+
+bool StorageClient::AsyncGetPage(CoroutineScheduler* coro_sched,
+                                 coro_id_t coro_id,
+                                 const std::string& table_name,
+                                 page_id_t page_no,
+                                 batch_id_t require_batch_id,
+                                 char* page,
+                                 bool* failed) {
+  *failed = false;
+  auto* call = new AsyncGetPageCall(coro_sched, coro_id, page, failed);
+  call->request.mutable_page_id()->set_table_name(table_name);
+  call->request.mutable_page_id()->set_page_no(page_no);
+  call->request.set_require_batch_id(require_batch_id);
+
+  // 必须在发出请求之前增加pending计数, 否则回调可能先于计数执行
+  coro_sched->AddPendingRPC(coro_id);
+  stub_.GetPage(&call->cntl, &call->request, &call->response, call);
+  return true;
+}
+
+bool StorageClient::AsyncGetPages(CoroutineScheduler* coro_sched,
+                                  coro_id_t coro_id,
+                                  const std::vector<std::pair<std::string, page_id_t>>& page_ids,
+                                  batch_id_t require_batch_id,
+                                  const std::vector<char*>& pages,
+                                  bool* failed) {
+  assert(page_ids.size() == pages.size());
+  *failed = false;
+  if (page_ids.empty()) return true;
+  auto* call = new AsyncGetPagesCall(coro_sched, coro_id, pages, failed);
+  for (auto& page_id : page_ids) {
+    auto* req_page_id = call->request.add_page_ids();
+    req_page_id->set_table_name(page_id.first);
+    req_page_id->set_page_no(page_id.second);
+  }
+  call->request.set_require_batch_id(require_batch_id);
+
+  coro_sched->AddPendingRPC(coro_id);
+  stub_.GetPages(&call->cntl, &call->request, &call->response, call);
+  return true;
+}
+
+bool StorageClient::AsyncReadAheadPages(const std::vector<std::pair<std::string, page_id_t>>& page_ids,
+                                        const std::shared_ptr<ReadAheadProbe>& probe) {
+  probe->page_exists.assign(page_ids.size(), 0);
+  if (page_ids.empty()) {
+    probe->done.store(true, std::memory_order_release);
+    return true;
+  }
+  auto* call = new AsyncGetPagesCall(probe);
+  for (auto& page_id : page_ids) {
+    auto* req_page_id = call->request.add_page_ids();
+    req_page_id->set_table_name(page_id.first);
+    req_page_id->set_page_no(page_id.second);
+  }
+  call->request.set_read_ahead(true);
+
+  stub_.GetPages(&call->cntl, &call->request, &call->response, call);
+  return true;
+}
+
+batch_id_t StorageClient::GetPersistBatchId() {
+  brpc::Controller cntl;
+  storage_service::GetPersistBatchIdRequest request;
+  storage_service::GetPersistBatchIdResponse response;
+  stub_.GetPersistBatchId(&cntl, &request, &response, nullptr);
+  if (cntl.Failed()) {
+    RDMA_LOG(ERROR) << "GetPersistBatchId fails: " << cntl.ErrorText();
+    return 0;
+  }
+  return response.persist_batch_id();
+}
+
+void AsyncGetPageCall::Run() {
+  if (cntl.Failed()) {
+    RDMA_LOG(ERROR) << "GetPage " << request.page_id().table_name() << ":" << request.page_id().page_no()
+                    << " fails: " << cntl.ErrorText();
+    *failed_ = true;
+  } else {
+    size_t size = response.data().size() < PAGE_SIZE ? response.data().size() : PAGE_SIZE;
+    memcpy(page_, response.data().data(), size);
+  }
+  coro_sched_->NotifyRPCDone(coro_id_);
+  delete this;
+}
+
+void AsyncGetPagesCall::Run() {
+  if (cntl.Failed() || response.data().size() != pages_.size() * PAGE_SIZE) {
+    RDMA_LOG(ERROR) << "GetPages of " << pages_.size() << " pages fails: " << cntl.ErrorText();
+    // 预读请求的page_exists保持全0, 不会装入任何页面
+    if (failed_ != nullptr) *failed_ = true;
+  } else {
+    const char* data = response.data().data();
+    for (size_t i = 0; i < pages_.size(); i++) {
+      memcpy(pages_[i], data + i * PAGE_SIZE, PAGE_SIZE);
+    }
+    if (probe_ != nullptr && (size_t)response.page_exists_size() == probe_->page_exists.size()) {
+      for (size_t i = 0; i < probe_->page_exists.size(); i++) {
+        probe_->page_exists[i] = response.page_exists(i);
+      }
+    }
+  }
+  if (probe_ != nullptr) {
+    probe_->done.store(true, std::memory_order_release);
+    delete this;
+    return;
+  }
+  coro_sched_->NotifyRPCDone(coro_id_);
+  delete this;
+}
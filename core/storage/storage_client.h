@@ -0,0 +1,123 @@
+#pragma once
+
+#include <brpc/channel.h>
+#include <gflags/gflags.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/common.h"
+#include "scheduler/corotine_scheduler.h"
+#include "storage/storage_service.pb.h"
+
+// 一次预读探测的结果, 由发起者和请求的回调共同持有, 发起者可以在回调之前释放自己的引用
+struct ReadAheadProbe {
+  // 存储层返回的页面是否存在, 超出表末尾的页面不装入
+  std::vector<char> page_exists;
+  std::atomic<bool> done{false};
+};
+
+// 计算节点访问存储层的客户端, 每个计算节点只创建一个, 所有线程共享
+// brpc::Channel是线程安全的, 在构造时完成Init, 之后所有的页面请求都复用这个Channel上的连接,
+// 避免在事务的关键路径上建立连接
+class StorageClient {
+ public:
+  StorageClient();
+
+  ~StorageClient() = default;
+
+  // 异步从存储层读取一个页面, 页面数据会被拷贝到page中
+  // 请求发出后会增加coro_id的pending计数, 调用者需要通过CoroutineScheduler::Yield等待结果,
+  // 期间本线程的其他协程可以继续执行
+  // 请求失败(超时, 存储层重启等)时*failed被置为true, page的内容不可用, 调用者需要重新发起请求,
+  // 不能把它写入共享内存池
+  bool AsyncGetPage(CoroutineScheduler* coro_sched,
+                    coro_id_t coro_id,
+                    const std::string& table_name,
+                    page_id_t page_no,
+                    batch_id_t require_batch_id,
+                    char* page,
+                    bool* failed);
+
+  // 异步批量读取页面, 所有页面在一个请求中发出, pages[i]接收page_ids[i]的内容
+  // 与AsyncGetPage一样只增加一次pending计数, 失败时*failed被置为true
+  bool AsyncGetPages(CoroutineScheduler* coro_sched,
+                     coro_id_t coro_id,
+                     const std::vector<std::pair<std::string, page_id_t>>& page_ids,
+                     batch_id_t require_batch_id,
+                     const std::vector<char*>& pages,
+                     bool* failed);
+
+  // 异步预读页面: 存储层把存在的页面提前读入page cache, 不返回页面数据, 超出文件末尾的页面不是错误
+  // 不增加协程的pending计数, Yield不会等待预读, 请求完成后probe->page_exists[i]表示page_ids[i]是否存在,
+  // 并把probe->done置为true, 调用者之后检查, 不需要等待请求完成
+  bool AsyncReadAheadPages(const std::vector<std::pair<std::string, page_id_t>>& page_ids,
+                           const std::shared_ptr<ReadAheadProbe>& probe);
+
+  // 同步查询存储层已经重放完成的batch, 给内存层的淘汰线程使用, 失败时返回0
+  batch_id_t GetPersistBatchId();
+
+ private:
+  brpc::Channel channel_;
+
+  // stub只保存channel_的指针, 需要在channel_之后声明
+  storage_service::StorageService_Stub stub_;
+};
+
+// brpc的done回调, 在bthread worker中执行, 负责拷贝页面并通知协程调度器
+// 失败状态在NotifyRPCDone之前写入, 协程Yield返回之后就能看到
+class AsyncGetPageCall : public google::protobuf::Closure {
+ public:
+  AsyncGetPageCall(CoroutineScheduler* coro_sched, coro_id_t coro_id, char* page, bool* failed)
+      : coro_sched_(coro_sched), coro_id_(coro_id), page_(page), failed_(failed) {}
+
+  void Run() override;
+
+  brpc::Controller cntl;
+
+  storage_service::GetPageRequest request;
+
+  storage_service::GetPageResponse response;
+
+ private:
+  CoroutineScheduler* coro_sched_;
+
+  coro_id_t coro_id_;
+
+  char* page_;
+
+  bool* failed_;
+};
+
+class AsyncGetPagesCall : public google::protobuf::Closure {
+ public:
+  AsyncGetPagesCall(CoroutineScheduler* coro_sched, coro_id_t coro_id, const std::vector<char*>& pages, bool* failed)
+      : coro_sched_(coro_sched), coro_id_(coro_id), pages_(pages), failed_(failed) {}
+
+  // 预读请求, 没有页面数据, 完成时不通知协程调度器
+  explicit AsyncGetPagesCall(const std::shared_ptr<ReadAheadProbe>& probe)
+      : coro_sched_(nullptr), coro_id_(0), failed_(nullptr), probe_(probe) {}
+
+  void Run() override;
+
+  brpc::Controller cntl;
+
+  storage_service::GetPagesRequest request;
+
+  storage_service::GetPagesResponse response;
+
+ private:
+  CoroutineScheduler* coro_sched_;
+
+  coro_id_t coro_id_;
+
+  std::vector<char*> pages_;
+
+  bool* failed_;
+
+  // 预读请求的结果, 普通请求为nullptr
+  std::shared_ptr<ReadAheadProbe> probe_;
+};
@@ -1,6 +1,13 @@
 #include "storage_rpc.h"
 #include "util/debug.h"
 
+#include <brpc/controller.h>
+#include <bthread/bthread.h>
+
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
 namespace storage_service{
 
     StoragePoolImpl::StoragePoolImpl(LogManager* log_manager, DiskManager* disk_manager)
@@ -14,47 +21,144 @@ namespace storage_service{
                        ::storage_service::LogWriteResponse* response,
                        ::google::protobuf::Closure* done){
             
-        brpc::ClosureGuard done_guard(done);
-        RDMA_LOG(INFO) << "handle write log request, log is " << request->log();
-        log_manager_->write_batch_log_to_disk(request->log());
+        // 计算层用LogBuilder构造的日志放在attachment中, 兼容直接放在request->log()中的日志
+        brpc::Controller* cntl = static_cast<brpc::Controller*>(controller);
+        std::string log;
+        if (!cntl->request_attachment().empty()) {
+            cntl->request_attachment().cutn(&log, cntl->request_attachment().size());
+        } else {
+            log = request->log();
+        }
+
+        // 日志交给log writer做group commit, 落盘之后才回复, 等待期间不占用worker线程
+        log_manager_->append_batch_log(std::move(log), [done]() { done->Run(); });
         
         return;
     };
 
+    // 在后台bthread中执行fn, 不占用调用者所在的线程(重放线程)
+    static void* RunDeferredRead(void* arg) {
+        auto* fn = static_cast<std::function<void()>*>(arg);
+        (*fn)();
+        delete fn;
+        return nullptr;
+    }
+
+    static void StartDeferredRead(std::function<void()> fn) {
+        auto* arg = new std::function<void()>(std::move(fn));
+        bthread_t tid;
+        if (bthread_start_background(&tid, nullptr, RunDeferredRead, arg) != 0) {
+            RDMA_LOG(ERROR) << "Fail to start bthread for deferred read, run it inline";
+            RunDeferredRead(arg);
+        }
+    }
+
+    // 如果request_batch_id还没有持久化, 则挂起read并返回true, read会在对应的BATCHEND重放后在新的bthread中执行
+    // 挂起的请求不占用brpc的worker线程
+    bool StoragePoolImpl::DeferUntilPersisted(batch_id_t request_batch_id, const std::function<void()>& read) {
+        LogReplay* log_replay = log_manager_->log_replay_;
+        return log_replay->add_persist_waiter(request_batch_id, [read]() { StartDeferredRead(read); });
+    }
+
     void StoragePoolImpl::GetPage(::google::protobuf::RpcController* controller,
                        const ::storage_service::GetPageRequest* request,
                        ::storage_service::GetPageResponse* response,
                        ::google::protobuf::Closure* done){
 
-        brpc::ClosureGuard done_guard(done);
-
-        std::string table_name = request->page_id().table_name();
-        page_id_t page_no = request->page_id().page_no();
         batch_id_t request_batch_id = request->require_batch_id();
-        LogReplay* log_replay = log_manager_->log_replay_;
 
-        RDMA_LOG(INFO) << "handle GetPage request";
-        RDMA_LOG(INFO) << "request_batch_id: " << request_batch_id << ", persist_batch_id: " << log_replay->get_persist_batch_id();
+        // done由read负责调用, request和response在done被调用之前一直有效
+        auto read = [this, request, response, done]() {
+            brpc::ClosureGuard done_guard(done);
 
-        char data[PAGE_SIZE + 1];
+            std::string table_name = request->page_id().table_name();
+            page_id_t page_no = request->page_id().page_no();
+            char data[PAGE_SIZE + 1];
 
-        // TODO
-        while(log_replay->get_persist_batch_id() < request_batch_id) {
-            // wait
-            usleep(10);
+            int fd = disk_manager_->get_file_fd(table_name);
+            disk_manager_->read_page(fd, page_no, data, PAGE_SIZE);
+
+            response->set_data(std::string(data, PAGE_SIZE));
+        };
+
+        if (DeferUntilPersisted(request_batch_id, read)) return;
+
+        read();
+        return;
+    };
+
+    void StoragePoolImpl::GetPages(::google::protobuf::RpcController* controller,
+                       const ::storage_service::GetPagesRequest* request,
+                       ::storage_service::GetPagesResponse* response,
+                       ::google::protobuf::Closure* done){
+
+        batch_id_t request_batch_id = request->require_batch_id();
+
+        if(request->read_ahead()) {
+            brpc::ClosureGuard done_guard(done);
+            ReadAheadPages(request, response);
+            return;
         }
 
-        RDMA_LOG(INFO) << "the batch_id requirement is satisfied";
+        auto read = [this, request, response, done]() {
+            brpc::ClosureGuard done_guard(done);
 
-        int fd = disk_manager_->open_file(table_name);
-        disk_manager_->read_page(fd, page_no, data, PAGE_SIZE);
+            // 所有页面按请求顺序放在同一个buffer中, 避免每个页面单独分配内存
+            int page_num = request->page_ids_size();
+            std::string* data = response->mutable_data();
+            data->resize((size_t)page_num * PAGE_SIZE);
 
-        response->set_data(std::string(data, PAGE_SIZE));
+            // 按表分组, 同一个表的页面交给DiskManager合并成preadv
+            std::unordered_map<std::string, std::pair<std::vector<page_id_t>, std::vector<char*>>> table_pages;
+            for(int i = 0; i < page_num; i++) {
+                auto& page_id = request->page_ids(i);
+                auto& group = table_pages[page_id.table_name()];
+                group.first.push_back(page_id.page_no());
+                group.second.push_back(&(*data)[(size_t)i * PAGE_SIZE]);
+            }
 
-        disk_manager_->close_file(fd);
+            for(auto& table : table_pages) {
+                int fd = disk_manager_->get_file_fd(table.first);
+                disk_manager_->read_pages(fd, table.second.first, table.second.second);
+            }
+        };
 
-        RDMA_LOG(INFO) << "success to GetPage";
+        if (DeferUntilPersisted(request_batch_id, read)) return;
 
+        read();
+        return;
+    };
+
+    // 预读只需要知道页面是否存在并把页面读入page cache, 不依赖日志重放的进度, 不需要等待batch持久化
+    // 计算节点之后在页表中pin住页面, 再通过普通的GetPages读取页面的内容
+    void StoragePoolImpl::ReadAheadPages(const ::storage_service::GetPagesRequest* request,
+                       ::storage_service::GetPagesResponse* response){
+
+        std::unordered_map<std::string, page_id_t> table_page_num;
+        std::unordered_map<std::string, std::vector<page_id_t>> table_pages;
+        for(int i = 0; i < request->page_ids_size(); i++) {
+            auto& page_id = request->page_ids(i);
+            auto it = table_page_num.find(page_id.table_name());
+            if(it == table_page_num.end()) {
+                off_t file_size = disk_manager_->get_file_size(page_id.table_name());
+                it = table_page_num.emplace(page_id.table_name(), file_size < 0 ? 0 : (page_id_t)(file_size / PAGE_SIZE)).first;
+            }
+            bool exists = page_id.page_no() >= 0 && page_id.page_no() < it->second;
+            response->add_page_exists(exists);
+            if(exists) table_pages[page_id.table_name()].push_back(page_id.page_no());
+        }
+        for(auto& table : table_pages) {
+            disk_manager_->will_need_pages(disk_manager_->get_file_fd(table.first), table.second);
+        }
+    }
+
+    void StoragePoolImpl::GetPersistBatchId(::google::protobuf::RpcController* controller,
+                       const ::storage_service::GetPersistBatchIdRequest* request,
+                       ::storage_service::GetPersistBatchIdResponse* response,
+                       ::google::protobuf::Closure* done){
+
+        brpc::ClosureGuard done_guard(done);
+        response->set_persist_batch_id(log_manager_->log_replay_->get_persist_batch_id());
         return;
     };
-}
\ No newline at end of file
+}
@@ -2,6 +2,8 @@
 #include <brpc/server.h>
 #include <gflags/gflags.h>
 
+#include <functional>
+
 #include "storage_service.pb.h"
 #include "log/log_manager.h"
 #include "disk_manager.h"
@@ -25,7 +27,25 @@ class StoragePoolImpl : public StorageService{
                        ::storage_service::GetPageResponse* response,
                        ::google::protobuf::Closure* done);
 
+    // 计算层向存储层批量读数据页, 同一个表中的页面使用向量化IO读取
+    virtual void GetPages(::google::protobuf::RpcController* controller,
+                       const ::storage_service::GetPagesRequest* request,
+                       ::storage_service::GetPagesResponse* response,
+                       ::google::protobuf::Closure* done);
+
+    // 内存层查询已经重放完成的batch
+    virtual void GetPersistBatchId(::google::protobuf::RpcController* controller,
+                       const ::storage_service::GetPersistBatchIdRequest* request,
+                       ::storage_service::GetPersistBatchIdResponse* response,
+                       ::google::protobuf::Closure* done);
+
   private:
+    bool DeferUntilPersisted(batch_id_t request_batch_id, const std::function<void()>& read);
+
+    // 处理预读请求, 返回页面是否存在, 存在的页面提示内核提前读入page cache
+    void ReadAheadPages(const ::storage_service::GetPagesRequest* request,
+                       ::storage_service::GetPagesResponse* response);
+
     LogManager* log_manager_;
     DiskManager* disk_manager_;
 
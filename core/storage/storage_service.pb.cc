@@ -22,8 +22,9 @@ namespace _pbi = _pb::internal;
 
 namespace storage_service {
 PROTOBUF_CONSTEXPR LogWriteRequest::LogWriteRequest(
-    ::_pbi::ConstantInitialized)
-  : log_(&::_pbi::fixed_address_empty_string, ::_pbi::ConstantInitialized{}){}
+    ::_pbi::ConstantInitialized): _impl_{
+    /*decltype(_impl_.log_)*/{&::_pbi::fixed_address_empty_string, ::_pbi::ConstantInitialized{}}
+  , /*decltype(_impl_._cached_size_)*/{}} {}
 struct LogWriteRequestDefaultTypeInternal {
   PROTOBUF_CONSTEXPR LogWriteRequestDefaultTypeInternal()
       : _instance(::_pbi::ConstantInitialized{}) {}
@@ -34,7 +35,7 @@ struct LogWriteRequestDefaultTypeInternal {
 };
 PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORITY1 LogWriteRequestDefaultTypeInternal _LogWriteRequest_default_instance_;
 PROTOBUF_CONSTEXPR LogWriteResponse::LogWriteResponse(
-    ::_pbi::ConstantInitialized){}
+    ::_pbi::ConstantInitialized) {}
 struct LogWriteResponseDefaultTypeInternal {
   PROTOBUF_CONSTEXPR LogWriteResponseDefaultTypeInternal()
       : _instance(::_pbi::ConstantInitialized{}) {}
@@ -45,9 +46,10 @@ struct LogWriteResponseDefaultTypeInternal {
 };
 PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORITY1 LogWriteResponseDefaultTypeInternal _LogWriteResponse_default_instance_;
 PROTOBUF_CONSTEXPR GetPageRequest_PageID::GetPageRequest_PageID(
-    ::_pbi::ConstantInitialized)
-  : table_name_(&::_pbi::fixed_address_empty_string, ::_pbi::ConstantInitialized{})
-  , page_no_(0){}
+    ::_pbi::ConstantInitialized): _impl_{
+    /*decltype(_impl_.table_name_)*/{&::_pbi::fixed_address_empty_string, ::_pbi::ConstantInitialized{}}
+  , /*decltype(_impl_.page_no_)*/0
+  , /*decltype(_impl_._cached_size_)*/{}} {}
 struct GetPageRequest_PageIDDefaultTypeInternal {
   PROTOBUF_CONSTEXPR GetPageRequest_PageIDDefaultTypeInternal()
       : _instance(::_pbi::ConstantInitialized{}) {}
@@ -58,9 +60,10 @@ struct GetPageRequest_PageIDDefaultTypeInternal {
 };
 PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORITY1 GetPageRequest_PageIDDefaultTypeInternal _GetPageRequest_PageID_default_instance_;
 PROTOBUF_CONSTEXPR GetPageRequest::GetPageRequest(
-    ::_pbi::ConstantInitialized)
-  : page_id_(nullptr)
-  , require_batch_id_(uint64_t{0u}){}
+    ::_pbi::ConstantInitialized): _impl_{
+    /*decltype(_impl_.page_id_)*/nullptr
+  , /*decltype(_impl_.require_batch_id_)*/uint64_t{0u}
+  , /*decltype(_impl_._cached_size_)*/{}} {}
 struct GetPageRequestDefaultTypeInternal {
   PROTOBUF_CONSTEXPR GetPageRequestDefaultTypeInternal()
       : _instance(::_pbi::ConstantInitialized{}) {}
@@ -71,8 +74,9 @@ struct GetPageRequestDefaultTypeInternal {
 };
 PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORITY1 GetPageRequestDefaultTypeInternal _GetPageRequest_default_instance_;
 PROTOBUF_CONSTEXPR GetPageResponse::GetPageResponse(
-    ::_pbi::ConstantInitialized)
-  : data_(&::_pbi::fixed_address_empty_string, ::_pbi::ConstantInitialized{}){}
+    ::_pbi::ConstantInitialized): _impl_{
+    /*decltype(_impl_.data_)*/{&::_pbi::fixed_address_empty_string, ::_pbi::ConstantInitialized{}}
+  , /*decltype(_impl_._cached_size_)*/{}} {}
 struct GetPageResponseDefaultTypeInternal {
   PROTOBUF_CONSTEXPR GetPageResponseDefaultTypeInternal()
       : _instance(::_pbi::ConstantInitialized{}) {}
@@ -82,8 +86,61 @@ struct GetPageResponseDefaultTypeInternal {
   };
 };
 PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORITY1 GetPageResponseDefaultTypeInternal _GetPageResponse_default_instance_;
+PROTOBUF_CONSTEXPR GetPagesRequest::GetPagesRequest(
+    ::_pbi::ConstantInitialized): _impl_{
+    /*decltype(_impl_.page_ids_)*/{}
+  , /*decltype(_impl_.require_batch_id_)*/uint64_t{0u}
+  , /*decltype(_impl_.read_ahead_)*/false
+  , /*decltype(_impl_._cached_size_)*/{}} {}
+struct GetPagesRequestDefaultTypeInternal {
+  PROTOBUF_CONSTEXPR GetPagesRequestDefaultTypeInternal()
+      : _instance(::_pbi::ConstantInitialized{}) {}
+  ~GetPagesRequestDefaultTypeInternal() {}
+  union {
+    GetPagesRequest _instance;
+  };
+};
+PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORITY1 GetPagesRequestDefaultTypeInternal _GetPagesRequest_default_instance_;
+PROTOBUF_CONSTEXPR GetPagesResponse::GetPagesResponse(
+    ::_pbi::ConstantInitialized): _impl_{
+    /*decltype(_impl_.page_exists_)*/{}
+  , /*decltype(_impl_.data_)*/{&::_pbi::fixed_address_empty_string, ::_pbi::ConstantInitialized{}}
+  , /*decltype(_impl_._cached_size_)*/{}} {}
+struct GetPagesResponseDefaultTypeInternal {
+  PROTOBUF_CONSTEXPR GetPagesResponseDefaultTypeInternal()
+      : _instance(::_pbi::ConstantInitialized{}) {}
+  ~GetPagesResponseDefaultTypeInternal() {}
+  union {
+    GetPagesResponse _instance;
+  };
+};
+PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORITY1 GetPagesResponseDefaultTypeInternal _GetPagesResponse_default_instance_;
+PROTOBUF_CONSTEXPR GetPersistBatchIdRequest::GetPersistBatchIdRequest(
+    ::_pbi::ConstantInitialized) {}
+struct GetPersistBatchIdRequestDefaultTypeInternal {
+  PROTOBUF_CONSTEXPR GetPersistBatchIdRequestDefaultTypeInternal()
+      : _instance(::_pbi::ConstantInitialized{}) {}
+  ~GetPersistBatchIdRequestDefaultTypeInternal() {}
+  union {
+    GetPersistBatchIdRequest _instance;
+  };
+};
+PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORITY1 GetPersistBatchIdRequestDefaultTypeInternal _GetPersistBatchIdRequest_default_instance_;
+PROTOBUF_CONSTEXPR GetPersistBatchIdResponse::GetPersistBatchIdResponse(
+    ::_pbi::ConstantInitialized): _impl_{
+    /*decltype(_impl_.persist_batch_id_)*/uint64_t{0u}
+  , /*decltype(_impl_._cached_size_)*/{}} {}
+struct GetPersistBatchIdResponseDefaultTypeInternal {
+  PROTOBUF_CONSTEXPR GetPersistBatchIdResponseDefaultTypeInternal()
+      : _instance(::_pbi::ConstantInitialized{}) {}
+  ~GetPersistBatchIdResponseDefaultTypeInternal() {}
+  union {
+    GetPersistBatchIdResponse _instance;
+  };
+};
+PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORITY1 GetPersistBatchIdResponseDefaultTypeInternal _GetPersistBatchIdResponse_default_instance_;
 }  // namespace storage_service
-static ::_pb::Metadata file_level_metadata_storage_5fservice_2eproto[5];
+static ::_pb::Metadata file_level_metadata_storage_5fservice_2eproto[9];
 static constexpr ::_pb::EnumDescriptor const** file_level_enum_descriptors_storage_5fservice_2eproto = nullptr;
 static const ::_pb::ServiceDescriptor* file_level_service_descriptors_storage_5fservice_2eproto[1];
 
@@ -94,7 +151,7 @@ const uint32_t TableStruct_storage_5fservice_2eproto::offsets[] PROTOBUF_SECTION
   ~0u,  // no _oneof_case_
   ~0u,  // no _weak_field_map_
   ~0u,  // no _inlined_string_donated_
-  PROTOBUF_FIELD_OFFSET(::storage_service::LogWriteRequest, log_),
+  PROTOBUF_FIELD_OFFSET(::storage_service::LogWriteRequest, _impl_.log_),
   ~0u,  // no _has_bits_
   PROTOBUF_FIELD_OFFSET(::storage_service::LogWriteResponse, _internal_metadata_),
   ~0u,  // no _extensions_
@@ -107,23 +164,53 @@ const uint32_t TableStruct_storage_5fservice_2eproto::offsets[] PROTOBUF_SECTION
   ~0u,  // no _oneof_case_
   ~0u,  // no _weak_field_map_
   ~0u,  // no _inlined_string_donated_
-  PROTOBUF_FIELD_OFFSET(::storage_service::GetPageRequest_PageID, table_name_),
-  PROTOBUF_FIELD_OFFSET(::storage_service::GetPageRequest_PageID, page_no_),
+  PROTOBUF_FIELD_OFFSET(::storage_service::GetPageRequest_PageID, _impl_.table_name_),
+  PROTOBUF_FIELD_OFFSET(::storage_service::GetPageRequest_PageID, _impl_.page_no_),
   ~0u,  // no _has_bits_
   PROTOBUF_FIELD_OFFSET(::storage_service::GetPageRequest, _internal_metadata_),
   ~0u,  // no _extensions_
   ~0u,  // no _oneof_case_
   ~0u,  // no _weak_field_map_
   ~0u,  // no _inlined_string_donated_
-  PROTOBUF_FIELD_OFFSET(::storage_service::GetPageRequest, page_id_),
-  PROTOBUF_FIELD_OFFSET(::storage_service::GetPageRequest, require_batch_id_),
+  PROTOBUF_FIELD_OFFSET(::storage_service::GetPageRequest, _impl_.page_id_),
+  PROTOBUF_FIELD_OFFSET(::storage_service::GetPageRequest, _impl_.require_batch_id_),
   ~0u,  // no _has_bits_
   PROTOBUF_FIELD_OFFSET(::storage_service::GetPageResponse, _internal_metadata_),
   ~0u,  // no _extensions_
   ~0u,  // no _oneof_case_
   ~0u,  // no _weak_field_map_
   ~0u,  // no _inlined_string_donated_
-  PROTOBUF_FIELD_OFFSET(::storage_service::GetPageResponse, data_),
+  PROTOBUF_FIELD_OFFSET(::storage_service::GetPageResponse, _impl_.data_),
+  ~0u,  // no _has_bits_
+  PROTOBUF_FIELD_OFFSET(::storage_service::GetPagesRequest, _internal_metadata_),
+  ~0u,  // no _extensions_
+  ~0u,  // no _oneof_case_
+  ~0u,  // no _weak_field_map_
+  ~0u,  // no _inlined_string_donated_
+  PROTOBUF_FIELD_OFFSET(::storage_service::GetPagesRequest, _impl_.page_ids_),
+  PROTOBUF_FIELD_OFFSET(::storage_service::GetPagesRequest, _impl_.require_batch_id_),
+  PROTOBUF_FIELD_OFFSET(::storage_service::GetPagesRequest, _impl_.read_ahead_),
+  ~0u,  // no _has_bits_
+  PROTOBUF_FIELD_OFFSET(::storage_service::GetPagesResponse, _internal_metadata_),
+  ~0u,  // no _extensions_
+  ~0u,  // no _oneof_case_
+  ~0u,  // no _weak_field_map_
+  ~0u,  // no _inlined_string_donated_
+  PROTOBUF_FIELD_OFFSET(::storage_service::GetPagesResponse, _impl_.data_),
+  PROTOBUF_FIELD_OFFSET(::storage_service::GetPagesResponse, _impl_.page_exists_),
+  ~0u,  // no _has_bits_
+  PROTOBUF_FIELD_OFFSET(::storage_service::GetPersistBatchIdRequest, _internal_metadata_),
+  ~0u,  // no _extensions_
+  ~0u,  // no _oneof_case_
+  ~0u,  // no _weak_field_map_
+  ~0u,  // no _inlined_string_donated_
+  ~0u,  // no _has_bits_
+  PROTOBUF_FIELD_OFFSET(::storage_service::GetPersistBatchIdResponse, _internal_metadata_),
+  ~0u,  // no _extensions_
+  ~0u,  // no _oneof_case_
+  ~0u,  // no _weak_field_map_
+  ~0u,  // no _inlined_string_donated_
+  PROTOBUF_FIELD_OFFSET(::storage_service::GetPersistBatchIdResponse, _impl_.persist_batch_id_),
 };
 static const ::_pbi::MigrationSchema schemas[] PROTOBUF_SECTION_VARIABLE(protodesc_cold) = {
   { 0, -1, -1, sizeof(::storage_service::LogWriteRequest)},
@@ -131,6 +218,10 @@ static const ::_pbi::MigrationSchema schemas[] PROTOBUF_SECTION_VARIABLE(protode
   { 13, -1, -1, sizeof(::storage_service::GetPageRequest_PageID)},
   { 21, -1, -1, sizeof(::storage_service::GetPageRequest)},
   { 29, -1, -1, sizeof(::storage_service::GetPageResponse)},
+  { 36, -1, -1, sizeof(::storage_service::GetPagesRequest)},
+  { 45, -1, -1, sizeof(::storage_service::GetPagesResponse)},
+  { 53, -1, -1, sizeof(::storage_service::GetPersistBatchIdRequest)},
+  { 59, -1, -1, sizeof(::storage_service::GetPersistBatchIdResponse)},
 };
 
 static const ::_pb::Message* const file_default_instances[] = {
@@ -139,6 +230,10 @@ static const ::_pb::Message* const file_default_instances[] = {
   &::storage_service::_GetPageRequest_PageID_default_instance_._instance,
   &::storage_service::_GetPageRequest_default_instance_._instance,
   &::storage_service::_GetPageResponse_default_instance_._instance,
+  &::storage_service::_GetPagesRequest_default_instance_._instance,
+  &::storage_service::_GetPagesResponse_default_instance_._instance,
+  &::storage_service::_GetPersistBatchIdRequest_default_instance_._instance,
+  &::storage_service::_GetPersistBatchIdResponse_default_instance_._instance,
 };
 
 const char descriptor_table_protodef_storage_5fservice_2eproto[] PROTOBUF_SECTION_VARIABLE(protodesc_cold) =
@@ -148,18 +243,29 @@ const char descriptor_table_protodef_storage_5fservice_2eproto[] PROTOBUF_SECTIO
   "id\030\001 \001(\0132&.storage_service.GetPageReques"
   "t.PageID\022\030\n\020require_batch_id\030\002 \001(\004\032-\n\006Pa"
   "geID\022\022\n\ntable_name\030\001 \001(\t\022\017\n\007page_no\030\002 \001("
-  "\021\"\037\n\017GetPageResponse\022\014\n\004data\030\001 \001(\0142\257\001\n\016S"
-  "torageService\022O\n\010LogWrite\022 .storage_serv"
-  "ice.LogWriteRequest\032!.storage_service.Lo"
-  "gWriteResponse\022L\n\007GetPage\022\037.storage_serv"
-  "ice.GetPageRequest\032 .storage_service.Get"
-  "PageResponseB\003\200\001\001b\006proto3"
+  "\021\"\037\n\017GetPageResponse\022\014\n\004data\030\001 \001(\014\"y\n\017Ge"
+  "tPagesRequest\0228\n\010page_ids\030\001 \003(\0132&.storag"
+  "e_service.GetPageRequest.PageID\022\030\n\020requi"
+  "re_batch_id\030\002 \001(\004\022\022\n\nread_ahead\030\003 \001(\010\"5\n"
+  "\020GetPagesResponse\022\014\n\004data\030\001 \001(\014\022\023\n\013page_"
+  "exists\030\002 \003(\010\"\032\n\030GetPersistBatchIdRequest"
+  "\"5\n\031GetPersistBatchIdResponse\022\030\n\020persist"
+  "_batch_id\030\001 \001(\0042\354\002\n\016StorageService\022O\n\010Lo"
+  "gWrite\022 .storage_service.LogWriteRequest"
+  "\032!.storage_service.LogWriteResponse\022L\n\007G"
+  "etPage\022\037.storage_service.GetPageRequest\032"
+  " .storage_service.GetPageResponse\022O\n\010Get"
+  "Pages\022 .storage_service.GetPagesRequest\032"
+  "!.storage_service.GetPagesResponse\022j\n\021Ge"
+  "tPersistBatchId\022).storage_service.GetPer"
+  "sistBatchIdRequest\032*.storage_service.Get"
+  "PersistBatchIdResponseB\003\200\001\001b\006proto3"
   ;
 static ::_pbi::once_flag descriptor_table_storage_5fservice_2eproto_once;
 const ::_pbi::DescriptorTable descriptor_table_storage_5fservice_2eproto = {
-    false, false, 465, descriptor_table_protodef_storage_5fservice_2eproto,
+    false, false, 915, descriptor_table_protodef_storage_5fservice_2eproto,
     "storage_service.proto",
-    &descriptor_table_storage_5fservice_2eproto_once, nullptr, 0, 5,
+    &descriptor_table_storage_5fservice_2eproto_once, nullptr, 0, 9,
     schemas, file_default_instances, TableStruct_storage_5fservice_2eproto::offsets,
     file_level_metadata_storage_5fservice_2eproto, file_level_enum_descriptors_storage_5fservice_2eproto,
     file_level_service_descriptors_storage_5fservice_2eproto,
@@ -181,28 +287,40 @@ class LogWriteRequest::_Internal {
 LogWriteRequest::LogWriteRequest(::PROTOBUF_NAMESPACE_ID::Arena* arena,
                          bool is_message_owned)
   : ::PROTOBUF_NAMESPACE_ID::Message(arena, is_message_owned) {
-  SharedCtor();
+  SharedCtor(arena, is_message_owned);
   // @@protoc_insertion_point(arena_constructor:storage_service.LogWriteRequest)
 }
 LogWriteRequest::LogWriteRequest(const LogWriteRequest& from)
   : ::PROTOBUF_NAMESPACE_ID::Message() {
+  LogWriteRequest* const _this = this; (void)_this;
+  new (&_impl_) Impl_{
+      decltype(_impl_.log_){}
+    , /*decltype(_impl_._cached_size_)*/{}};
+
   _internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
-  log_.InitDefault();
+  _impl_.log_.InitDefault();
   #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
-    log_.Set("", GetArenaForAllocation());
+    _impl_.log_.Set("", GetArenaForAllocation());
   #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
   if (!from._internal_log().empty()) {
-    log_.Set(from._internal_log(), 
-      GetArenaForAllocation());
+    _this->_impl_.log_.Set(from._internal_log(), 
+      _this->GetArenaForAllocation());
   }
   // @@protoc_insertion_point(copy_constructor:storage_service.LogWriteRequest)
 }
 
-inline void LogWriteRequest::SharedCtor() {
-log_.InitDefault();
-#ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
-  log_.Set("", GetArenaForAllocation());
-#endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+inline void LogWriteRequest::SharedCtor(
+    ::_pb::Arena* arena, bool is_message_owned) {
+  (void)arena;
+  (void)is_message_owned;
+  new (&_impl_) Impl_{
+      decltype(_impl_.log_){}
+    , /*decltype(_impl_._cached_size_)*/{}
+  };
+  _impl_.log_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.log_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
 }
 
 LogWriteRequest::~LogWriteRequest() {
@@ -216,11 +334,11 @@ LogWriteRequest::~LogWriteRequest() {
 
 inline void LogWriteRequest::SharedDtor() {
   GOOGLE_DCHECK(GetArenaForAllocation() == nullptr);
-  log_.Destroy();
+  _impl_.log_.Destroy();
 }
 
 void LogWriteRequest::SetCachedSize(int size) const {
-  _cached_size_.Set(size);
+  _impl_._cached_size_.Set(size);
 }
 
 void LogWriteRequest::Clear() {
@@ -229,7 +347,7 @@ void LogWriteRequest::Clear() {
   // Prevent compiler warnings about cached_has_bits being unused
   (void) cached_has_bits;
 
-  log_.ClearToEmpty();
+  _impl_.log_.ClearToEmpty();
   _internal_metadata_.Clear<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>();
 }
 
@@ -306,32 +424,28 @@ size_t LogWriteRequest::ByteSizeLong() const {
         this->_internal_log());
   }
 
-  return MaybeComputeUnknownFieldsSize(total_size, &_cached_size_);
+  return MaybeComputeUnknownFieldsSize(total_size, &_impl_._cached_size_);
 }
 
 const ::PROTOBUF_NAMESPACE_ID::Message::ClassData LogWriteRequest::_class_data_ = {
-    ::PROTOBUF_NAMESPACE_ID::Message::CopyWithSizeCheck,
+    ::PROTOBUF_NAMESPACE_ID::Message::CopyWithSourceCheck,
     LogWriteRequest::MergeImpl
 };
 const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*LogWriteRequest::GetClassData() const { return &_class_data_; }
 
-void LogWriteRequest::MergeImpl(::PROTOBUF_NAMESPACE_ID::Message* to,
-                      const ::PROTOBUF_NAMESPACE_ID::Message& from) {
-  static_cast<LogWriteRequest *>(to)->MergeFrom(
-      static_cast<const LogWriteRequest &>(from));
-}
-
 
-void LogWriteRequest::MergeFrom(const LogWriteRequest& from) {
-// @@protoc_insertion_point(class_specific_merge_from_start:storage_service.LogWriteRequest)
-  GOOGLE_DCHECK_NE(&from, this);
+void LogWriteRequest::MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg) {
+  auto* const _this = static_cast<LogWriteRequest*>(&to_msg);
+  auto& from = static_cast<const LogWriteRequest&>(from_msg);
+  // @@protoc_insertion_point(class_specific_merge_from_start:storage_service.LogWriteRequest)
+  GOOGLE_DCHECK_NE(&from, _this);
   uint32_t cached_has_bits = 0;
   (void) cached_has_bits;
 
   if (!from._internal_log().empty()) {
-    _internal_set_log(from._internal_log());
+    _this->_internal_set_log(from._internal_log());
   }
-  _internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+  _this->_internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
 }
 
 void LogWriteRequest::CopyFrom(const LogWriteRequest& from) {
@@ -351,8 +465,8 @@ void LogWriteRequest::InternalSwap(LogWriteRequest* other) {
   auto* rhs_arena = other->GetArenaForAllocation();
   _internal_metadata_.InternalSwap(&other->_internal_metadata_);
   ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::InternalSwap(
-      &log_, lhs_arena,
-      &other->log_, rhs_arena
+      &_impl_.log_, lhs_arena,
+      &other->_impl_.log_, rhs_arena
   );
 }
 
@@ -375,6 +489,7 @@ LogWriteResponse::LogWriteResponse(::PROTOBUF_NAMESPACE_ID::Arena* arena,
 }
 LogWriteResponse::LogWriteResponse(const LogWriteResponse& from)
   : ::PROTOBUF_NAMESPACE_ID::internal::ZeroFieldsBase() {
+  LogWriteResponse* const _this = this; (void)_this;
   _internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
   // @@protoc_insertion_point(copy_constructor:storage_service.LogWriteResponse)
 }
@@ -410,30 +525,43 @@ class GetPageRequest_PageID::_Internal {
 GetPageRequest_PageID::GetPageRequest_PageID(::PROTOBUF_NAMESPACE_ID::Arena* arena,
                          bool is_message_owned)
   : ::PROTOBUF_NAMESPACE_ID::Message(arena, is_message_owned) {
-  SharedCtor();
+  SharedCtor(arena, is_message_owned);
   // @@protoc_insertion_point(arena_constructor:storage_service.GetPageRequest.PageID)
 }
 GetPageRequest_PageID::GetPageRequest_PageID(const GetPageRequest_PageID& from)
   : ::PROTOBUF_NAMESPACE_ID::Message() {
+  GetPageRequest_PageID* const _this = this; (void)_this;
+  new (&_impl_) Impl_{
+      decltype(_impl_.table_name_){}
+    , decltype(_impl_.page_no_){}
+    , /*decltype(_impl_._cached_size_)*/{}};
+
   _internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
-  table_name_.InitDefault();
+  _impl_.table_name_.InitDefault();
   #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
-    table_name_.Set("", GetArenaForAllocation());
+    _impl_.table_name_.Set("", GetArenaForAllocation());
   #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
   if (!from._internal_table_name().empty()) {
-    table_name_.Set(from._internal_table_name(), 
-      GetArenaForAllocation());
+    _this->_impl_.table_name_.Set(from._internal_table_name(), 
+      _this->GetArenaForAllocation());
   }
-  page_no_ = from.page_no_;
+  _this->_impl_.page_no_ = from._impl_.page_no_;
   // @@protoc_insertion_point(copy_constructor:storage_service.GetPageRequest.PageID)
 }
 
-inline void GetPageRequest_PageID::SharedCtor() {
-table_name_.InitDefault();
-#ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
-  table_name_.Set("", GetArenaForAllocation());
-#endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
-page_no_ = 0;
+inline void GetPageRequest_PageID::SharedCtor(
+    ::_pb::Arena* arena, bool is_message_owned) {
+  (void)arena;
+  (void)is_message_owned;
+  new (&_impl_) Impl_{
+      decltype(_impl_.table_name_){}
+    , decltype(_impl_.page_no_){0}
+    , /*decltype(_impl_._cached_size_)*/{}
+  };
+  _impl_.table_name_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.table_name_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
 }
 
 GetPageRequest_PageID::~GetPageRequest_PageID() {
@@ -447,11 +575,11 @@ GetPageRequest_PageID::~GetPageRequest_PageID() {
 
 inline void GetPageRequest_PageID::SharedDtor() {
   GOOGLE_DCHECK(GetArenaForAllocation() == nullptr);
-  table_name_.Destroy();
+  _impl_.table_name_.Destroy();
 }
 
 void GetPageRequest_PageID::SetCachedSize(int size) const {
-  _cached_size_.Set(size);
+  _impl_._cached_size_.Set(size);
 }
 
 void GetPageRequest_PageID::Clear() {
@@ -460,8 +588,8 @@ void GetPageRequest_PageID::Clear() {
   // Prevent compiler warnings about cached_has_bits being unused
   (void) cached_has_bits;
 
-  table_name_.ClearToEmpty();
-  page_no_ = 0;
+  _impl_.table_name_.ClearToEmpty();
+  _impl_.page_no_ = 0;
   _internal_metadata_.Clear<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>();
 }
 
@@ -484,7 +612,7 @@ const char* GetPageRequest_PageID::_InternalParse(const char* ptr, ::_pbi::Parse
       // sint32 page_no = 2;
       case 2:
         if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 16)) {
-          page_no_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarintZigZag32(&ptr);
+          _impl_.page_no_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarintZigZag32(&ptr);
           CHK_(ptr);
         } else
           goto handle_unusual;
@@ -562,35 +690,31 @@ size_t GetPageRequest_PageID::ByteSizeLong() const {
     total_size += ::_pbi::WireFormatLite::SInt32SizePlusOne(this->_internal_page_no());
   }
 
-  return MaybeComputeUnknownFieldsSize(total_size, &_cached_size_);
+  return MaybeComputeUnknownFieldsSize(total_size, &_impl_._cached_size_);
 }
 
 const ::PROTOBUF_NAMESPACE_ID::Message::ClassData GetPageRequest_PageID::_class_data_ = {
-    ::PROTOBUF_NAMESPACE_ID::Message::CopyWithSizeCheck,
+    ::PROTOBUF_NAMESPACE_ID::Message::CopyWithSourceCheck,
     GetPageRequest_PageID::MergeImpl
 };
 const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*GetPageRequest_PageID::GetClassData() const { return &_class_data_; }
 
-void GetPageRequest_PageID::MergeImpl(::PROTOBUF_NAMESPACE_ID::Message* to,
-                      const ::PROTOBUF_NAMESPACE_ID::Message& from) {
-  static_cast<GetPageRequest_PageID *>(to)->MergeFrom(
-      static_cast<const GetPageRequest_PageID &>(from));
-}
-
 
-void GetPageRequest_PageID::MergeFrom(const GetPageRequest_PageID& from) {
-// @@protoc_insertion_point(class_specific_merge_from_start:storage_service.GetPageRequest.PageID)
-  GOOGLE_DCHECK_NE(&from, this);
+void GetPageRequest_PageID::MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg) {
+  auto* const _this = static_cast<GetPageRequest_PageID*>(&to_msg);
+  auto& from = static_cast<const GetPageRequest_PageID&>(from_msg);
+  // @@protoc_insertion_point(class_specific_merge_from_start:storage_service.GetPageRequest.PageID)
+  GOOGLE_DCHECK_NE(&from, _this);
   uint32_t cached_has_bits = 0;
   (void) cached_has_bits;
 
   if (!from._internal_table_name().empty()) {
-    _internal_set_table_name(from._internal_table_name());
+    _this->_internal_set_table_name(from._internal_table_name());
   }
   if (from._internal_page_no() != 0) {
-    _internal_set_page_no(from._internal_page_no());
+    _this->_internal_set_page_no(from._internal_page_no());
   }
-  _internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+  _this->_internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
 }
 
 void GetPageRequest_PageID::CopyFrom(const GetPageRequest_PageID& from) {
@@ -610,10 +734,10 @@ void GetPageRequest_PageID::InternalSwap(GetPageRequest_PageID* other) {
   auto* rhs_arena = other->GetArenaForAllocation();
   _internal_metadata_.InternalSwap(&other->_internal_metadata_);
   ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::InternalSwap(
-      &table_name_, lhs_arena,
-      &other->table_name_, rhs_arena
+      &_impl_.table_name_, lhs_arena,
+      &other->_impl_.table_name_, rhs_arena
   );
-  swap(page_no_, other->page_no_);
+  swap(_impl_.page_no_, other->_impl_.page_no_);
 }
 
 ::PROTOBUF_NAMESPACE_ID::Metadata GetPageRequest_PageID::GetMetadata() const {
@@ -631,31 +755,39 @@ class GetPageRequest::_Internal {
 
 const ::storage_service::GetPageRequest_PageID&
 GetPageRequest::_Internal::page_id(const GetPageRequest* msg) {
-  return *msg->page_id_;
+  return *msg->_impl_.page_id_;
 }
 GetPageRequest::GetPageRequest(::PROTOBUF_NAMESPACE_ID::Arena* arena,
                          bool is_message_owned)
   : ::PROTOBUF_NAMESPACE_ID::Message(arena, is_message_owned) {
-  SharedCtor();
+  SharedCtor(arena, is_message_owned);
   // @@protoc_insertion_point(arena_constructor:storage_service.GetPageRequest)
 }
 GetPageRequest::GetPageRequest(const GetPageRequest& from)
   : ::PROTOBUF_NAMESPACE_ID::Message() {
+  GetPageRequest* const _this = this; (void)_this;
+  new (&_impl_) Impl_{
+      decltype(_impl_.page_id_){nullptr}
+    , decltype(_impl_.require_batch_id_){}
+    , /*decltype(_impl_._cached_size_)*/{}};
+
   _internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
   if (from._internal_has_page_id()) {
-    page_id_ = new ::storage_service::GetPageRequest_PageID(*from.page_id_);
-  } else {
-    page_id_ = nullptr;
+    _this->_impl_.page_id_ = new ::storage_service::GetPageRequest_PageID(*from._impl_.page_id_);
   }
-  require_batch_id_ = from.require_batch_id_;
+  _this->_impl_.require_batch_id_ = from._impl_.require_batch_id_;
   // @@protoc_insertion_point(copy_constructor:storage_service.GetPageRequest)
 }
 
-inline void GetPageRequest::SharedCtor() {
-::memset(reinterpret_cast<char*>(this) + static_cast<size_t>(
-    reinterpret_cast<char*>(&page_id_) - reinterpret_cast<char*>(this)),
-    0, static_cast<size_t>(reinterpret_cast<char*>(&require_batch_id_) -
-    reinterpret_cast<char*>(&page_id_)) + sizeof(require_batch_id_));
+inline void GetPageRequest::SharedCtor(
+    ::_pb::Arena* arena, bool is_message_owned) {
+  (void)arena;
+  (void)is_message_owned;
+  new (&_impl_) Impl_{
+      decltype(_impl_.page_id_){nullptr}
+    , decltype(_impl_.require_batch_id_){uint64_t{0u}}
+    , /*decltype(_impl_._cached_size_)*/{}
+  };
 }
 
 GetPageRequest::~GetPageRequest() {
@@ -669,11 +801,11 @@ GetPageRequest::~GetPageRequest() {
 
 inline void GetPageRequest::SharedDtor() {
   GOOGLE_DCHECK(GetArenaForAllocation() == nullptr);
-  if (this != internal_default_instance()) delete page_id_;
+  if (this != internal_default_instance()) delete _impl_.page_id_;
 }
 
 void GetPageRequest::SetCachedSize(int size) const {
-  _cached_size_.Set(size);
+  _impl_._cached_size_.Set(size);
 }
 
 void GetPageRequest::Clear() {
@@ -682,11 +814,11 @@ void GetPageRequest::Clear() {
   // Prevent compiler warnings about cached_has_bits being unused
   (void) cached_has_bits;
 
-  if (GetArenaForAllocation() == nullptr && page_id_ != nullptr) {
-    delete page_id_;
+  if (GetArenaForAllocation() == nullptr && _impl_.page_id_ != nullptr) {
+    delete _impl_.page_id_;
   }
-  page_id_ = nullptr;
-  require_batch_id_ = uint64_t{0u};
+  _impl_.page_id_ = nullptr;
+  _impl_.require_batch_id_ = uint64_t{0u};
   _internal_metadata_.Clear<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>();
 }
 
@@ -707,7 +839,7 @@ const char* GetPageRequest::_InternalParse(const char* ptr, ::_pbi::ParseContext
       // uint64 require_batch_id = 2;
       case 2:
         if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 16)) {
-          require_batch_id_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          _impl_.require_batch_id_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
           CHK_(ptr);
         } else
           goto handle_unusual;
@@ -774,7 +906,7 @@ size_t GetPageRequest::ByteSizeLong() const {
   if (this->_internal_has_page_id()) {
     total_size += 1 +
       ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::MessageSize(
-        *page_id_);
+        *_impl_.page_id_);
   }
 
   // uint64 require_batch_id = 2;
@@ -782,35 +914,32 @@ size_t GetPageRequest::ByteSizeLong() const {
     total_size += ::_pbi::WireFormatLite::UInt64SizePlusOne(this->_internal_require_batch_id());
   }
 
-  return MaybeComputeUnknownFieldsSize(total_size, &_cached_size_);
+  return MaybeComputeUnknownFieldsSize(total_size, &_impl_._cached_size_);
 }
 
 const ::PROTOBUF_NAMESPACE_ID::Message::ClassData GetPageRequest::_class_data_ = {
-    ::PROTOBUF_NAMESPACE_ID::Message::CopyWithSizeCheck,
+    ::PROTOBUF_NAMESPACE_ID::Message::CopyWithSourceCheck,
     GetPageRequest::MergeImpl
 };
 const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*GetPageRequest::GetClassData() const { return &_class_data_; }
 
-void GetPageRequest::MergeImpl(::PROTOBUF_NAMESPACE_ID::Message* to,
-                      const ::PROTOBUF_NAMESPACE_ID::Message& from) {
-  static_cast<GetPageRequest *>(to)->MergeFrom(
-      static_cast<const GetPageRequest &>(from));
-}
-
 
-void GetPageRequest::MergeFrom(const GetPageRequest& from) {
-// @@protoc_insertion_point(class_specific_merge_from_start:storage_service.GetPageRequest)
-  GOOGLE_DCHECK_NE(&from, this);
+void GetPageRequest::MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg) {
+  auto* const _this = static_cast<GetPageRequest*>(&to_msg);
+  auto& from = static_cast<const GetPageRequest&>(from_msg);
+  // @@protoc_insertion_point(class_specific_merge_from_start:storage_service.GetPageRequest)
+  GOOGLE_DCHECK_NE(&from, _this);
   uint32_t cached_has_bits = 0;
   (void) cached_has_bits;
 
   if (from._internal_has_page_id()) {
-    _internal_mutable_page_id()->::storage_service::GetPageRequest_PageID::MergeFrom(from._internal_page_id());
+    _this->_internal_mutable_page_id()->::storage_service::GetPageRequest_PageID::MergeFrom(
+        from._internal_page_id());
   }
   if (from._internal_require_batch_id() != 0) {
-    _internal_set_require_batch_id(from._internal_require_batch_id());
+    _this->_internal_set_require_batch_id(from._internal_require_batch_id());
   }
-  _internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+  _this->_internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
 }
 
 void GetPageRequest::CopyFrom(const GetPageRequest& from) {
@@ -828,11 +957,11 @@ void GetPageRequest::InternalSwap(GetPageRequest* other) {
   using std::swap;
   _internal_metadata_.InternalSwap(&other->_internal_metadata_);
   ::PROTOBUF_NAMESPACE_ID::internal::memswap<
-      PROTOBUF_FIELD_OFFSET(GetPageRequest, require_batch_id_)
-      + sizeof(GetPageRequest::require_batch_id_)
-      - PROTOBUF_FIELD_OFFSET(GetPageRequest, page_id_)>(
-          reinterpret_cast<char*>(&page_id_),
-          reinterpret_cast<char*>(&other->page_id_));
+      PROTOBUF_FIELD_OFFSET(GetPageRequest, _impl_.require_batch_id_)
+      + sizeof(GetPageRequest::_impl_.require_batch_id_)
+      - PROTOBUF_FIELD_OFFSET(GetPageRequest, _impl_.page_id_)>(
+          reinterpret_cast<char*>(&_impl_.page_id_),
+          reinterpret_cast<char*>(&other->_impl_.page_id_));
 }
 
 ::PROTOBUF_NAMESPACE_ID::Metadata GetPageRequest::GetMetadata() const {
@@ -850,28 +979,40 @@ class GetPageResponse::_Internal {
 GetPageResponse::GetPageResponse(::PROTOBUF_NAMESPACE_ID::Arena* arena,
                          bool is_message_owned)
   : ::PROTOBUF_NAMESPACE_ID::Message(arena, is_message_owned) {
-  SharedCtor();
+  SharedCtor(arena, is_message_owned);
   // @@protoc_insertion_point(arena_constructor:storage_service.GetPageResponse)
 }
 GetPageResponse::GetPageResponse(const GetPageResponse& from)
   : ::PROTOBUF_NAMESPACE_ID::Message() {
+  GetPageResponse* const _this = this; (void)_this;
+  new (&_impl_) Impl_{
+      decltype(_impl_.data_){}
+    , /*decltype(_impl_._cached_size_)*/{}};
+
   _internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
-  data_.InitDefault();
+  _impl_.data_.InitDefault();
   #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
-    data_.Set("", GetArenaForAllocation());
+    _impl_.data_.Set("", GetArenaForAllocation());
   #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
   if (!from._internal_data().empty()) {
-    data_.Set(from._internal_data(), 
-      GetArenaForAllocation());
+    _this->_impl_.data_.Set(from._internal_data(), 
+      _this->GetArenaForAllocation());
   }
   // @@protoc_insertion_point(copy_constructor:storage_service.GetPageResponse)
 }
 
-inline void GetPageResponse::SharedCtor() {
-data_.InitDefault();
-#ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
-  data_.Set("", GetArenaForAllocation());
-#endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+inline void GetPageResponse::SharedCtor(
+    ::_pb::Arena* arena, bool is_message_owned) {
+  (void)arena;
+  (void)is_message_owned;
+  new (&_impl_) Impl_{
+      decltype(_impl_.data_){}
+    , /*decltype(_impl_._cached_size_)*/{}
+  };
+  _impl_.data_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.data_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
 }
 
 GetPageResponse::~GetPageResponse() {
@@ -885,11 +1026,11 @@ GetPageResponse::~GetPageResponse() {
 
 inline void GetPageResponse::SharedDtor() {
   GOOGLE_DCHECK(GetArenaForAllocation() == nullptr);
-  data_.Destroy();
+  _impl_.data_.Destroy();
 }
 
 void GetPageResponse::SetCachedSize(int size) const {
-  _cached_size_.Set(size);
+  _impl_._cached_size_.Set(size);
 }
 
 void GetPageResponse::Clear() {
@@ -898,7 +1039,7 @@ void GetPageResponse::Clear() {
   // Prevent compiler warnings about cached_has_bits being unused
   (void) cached_has_bits;
 
-  data_.ClearToEmpty();
+  _impl_.data_.ClearToEmpty();
   _internal_metadata_.Clear<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>();
 }
 
@@ -975,32 +1116,28 @@ size_t GetPageResponse::ByteSizeLong() const {
         this->_internal_data());
   }
 
-  return MaybeComputeUnknownFieldsSize(total_size, &_cached_size_);
+  return MaybeComputeUnknownFieldsSize(total_size, &_impl_._cached_size_);
 }
 
 const ::PROTOBUF_NAMESPACE_ID::Message::ClassData GetPageResponse::_class_data_ = {
-    ::PROTOBUF_NAMESPACE_ID::Message::CopyWithSizeCheck,
+    ::PROTOBUF_NAMESPACE_ID::Message::CopyWithSourceCheck,
     GetPageResponse::MergeImpl
 };
 const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*GetPageResponse::GetClassData() const { return &_class_data_; }
 
-void GetPageResponse::MergeImpl(::PROTOBUF_NAMESPACE_ID::Message* to,
-                      const ::PROTOBUF_NAMESPACE_ID::Message& from) {
-  static_cast<GetPageResponse *>(to)->MergeFrom(
-      static_cast<const GetPageResponse &>(from));
-}
-
 
-void GetPageResponse::MergeFrom(const GetPageResponse& from) {
-// @@protoc_insertion_point(class_specific_merge_from_start:storage_service.GetPageResponse)
-  GOOGLE_DCHECK_NE(&from, this);
+void GetPageResponse::MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg) {
+  auto* const _this = static_cast<GetPageResponse*>(&to_msg);
+  auto& from = static_cast<const GetPageResponse&>(from_msg);
+  // @@protoc_insertion_point(class_specific_merge_from_start:storage_service.GetPageResponse)
+  GOOGLE_DCHECK_NE(&from, _this);
   uint32_t cached_has_bits = 0;
   (void) cached_has_bits;
 
   if (!from._internal_data().empty()) {
-    _internal_set_data(from._internal_data());
+    _this->_internal_set_data(from._internal_data());
   }
-  _internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+  _this->_internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
 }
 
 void GetPageResponse::CopyFrom(const GetPageResponse& from) {
@@ -1020,8 +1157,8 @@ void GetPageResponse::InternalSwap(GetPageResponse* other) {
   auto* rhs_arena = other->GetArenaForAllocation();
   _internal_metadata_.InternalSwap(&other->_internal_metadata_);
   ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::InternalSwap(
-      &data_, lhs_arena,
-      &other->data_, rhs_arena
+      &_impl_.data_, lhs_arena,
+      &other->_impl_.data_, rhs_arena
   );
 }
 
@@ -1033,116 +1170,864 @@ void GetPageResponse::InternalSwap(GetPageResponse* other) {
 
 // ===================================================================
 
-StorageService::~StorageService() {}
+class GetPagesRequest::_Internal {
+ public:
+};
 
-const ::PROTOBUF_NAMESPACE_ID::ServiceDescriptor* StorageService::descriptor() {
-  ::PROTOBUF_NAMESPACE_ID::internal::AssignDescriptors(&descriptor_table_storage_5fservice_2eproto);
-  return file_level_service_descriptors_storage_5fservice_2eproto[0];
+GetPagesRequest::GetPagesRequest(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                         bool is_message_owned)
+  : ::PROTOBUF_NAMESPACE_ID::Message(arena, is_message_owned) {
+  SharedCtor(arena, is_message_owned);
+  // @@protoc_insertion_point(arena_constructor:storage_service.GetPagesRequest)
 }
+GetPagesRequest::GetPagesRequest(const GetPagesRequest& from)
+  : ::PROTOBUF_NAMESPACE_ID::Message() {
+  GetPagesRequest* const _this = this; (void)_this;
+  new (&_impl_) Impl_{
+      decltype(_impl_.page_ids_){from._impl_.page_ids_}
+    , decltype(_impl_.require_batch_id_){}
+    , decltype(_impl_.read_ahead_){}
+    , /*decltype(_impl_._cached_size_)*/{}};
 
-const ::PROTOBUF_NAMESPACE_ID::ServiceDescriptor* StorageService::GetDescriptor() {
-  return descriptor();
+  _internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+  ::memcpy(&_impl_.require_batch_id_, &from._impl_.require_batch_id_,
+    static_cast<size_t>(reinterpret_cast<char*>(&_impl_.read_ahead_) -
+    reinterpret_cast<char*>(&_impl_.require_batch_id_)) + sizeof(_impl_.read_ahead_));
+  // @@protoc_insertion_point(copy_constructor:storage_service.GetPagesRequest)
 }
 
-void StorageService::LogWrite(::PROTOBUF_NAMESPACE_ID::RpcController* controller,
-                         const ::storage_service::LogWriteRequest*,
-                         ::storage_service::LogWriteResponse*,
-                         ::google::protobuf::Closure* done) {
-  controller->SetFailed("Method LogWrite() not implemented.");
-  done->Run();
+inline void GetPagesRequest::SharedCtor(
+    ::_pb::Arena* arena, bool is_message_owned) {
+  (void)arena;
+  (void)is_message_owned;
+  new (&_impl_) Impl_{
+      decltype(_impl_.page_ids_){arena}
+    , decltype(_impl_.require_batch_id_){uint64_t{0u}}
+    , decltype(_impl_.read_ahead_){false}
+    , /*decltype(_impl_._cached_size_)*/{}
+  };
 }
 
-void StorageService::GetPage(::PROTOBUF_NAMESPACE_ID::RpcController* controller,
-                         const ::storage_service::GetPageRequest*,
-                         ::storage_service::GetPageResponse*,
-                         ::google::protobuf::Closure* done) {
-  controller->SetFailed("Method GetPage() not implemented.");
-  done->Run();
+GetPagesRequest::~GetPagesRequest() {
+  // @@protoc_insertion_point(destructor:storage_service.GetPagesRequest)
+  if (auto *arena = _internal_metadata_.DeleteReturnArena<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>()) {
+  (void)arena;
+    return;
+  }
+  SharedDtor();
 }
 
-void StorageService::CallMethod(const ::PROTOBUF_NAMESPACE_ID::MethodDescriptor* method,
-                             ::PROTOBUF_NAMESPACE_ID::RpcController* controller,
-                             const ::PROTOBUF_NAMESPACE_ID::Message* request,
-                             ::PROTOBUF_NAMESPACE_ID::Message* response,
-                             ::google::protobuf::Closure* done) {
-  GOOGLE_DCHECK_EQ(method->service(), file_level_service_descriptors_storage_5fservice_2eproto[0]);
-  switch(method->index()) {
-    case 0:
-      LogWrite(controller,
-             ::PROTOBUF_NAMESPACE_ID::internal::DownCast<const ::storage_service::LogWriteRequest*>(
-                 request),
-             ::PROTOBUF_NAMESPACE_ID::internal::DownCast<::storage_service::LogWriteResponse*>(
-                 response),
-             done);
-      break;
-    case 1:
-      GetPage(controller,
-             ::PROTOBUF_NAMESPACE_ID::internal::DownCast<const ::storage_service::GetPageRequest*>(
-                 request),
-             ::PROTOBUF_NAMESPACE_ID::internal::DownCast<::storage_service::GetPageResponse*>(
-                 response),
-             done);
-      break;
-    default:
-      GOOGLE_LOG(FATAL) << "Bad method index; this should never happen.";
-      break;
-  }
+inline void GetPagesRequest::SharedDtor() {
+  GOOGLE_DCHECK(GetArenaForAllocation() == nullptr);
+  _impl_.page_ids_.~RepeatedPtrField();
 }
 
-const ::PROTOBUF_NAMESPACE_ID::Message& StorageService::GetRequestPrototype(
-    const ::PROTOBUF_NAMESPACE_ID::MethodDescriptor* method) const {
-  GOOGLE_DCHECK_EQ(method->service(), descriptor());
-  switch(method->index()) {
-    case 0:
-      return ::storage_service::LogWriteRequest::default_instance();
-    case 1:
-      return ::storage_service::GetPageRequest::default_instance();
-    default:
-      GOOGLE_LOG(FATAL) << "Bad method index; this should never happen.";
-      return *::PROTOBUF_NAMESPACE_ID::MessageFactory::generated_factory()
-          ->GetPrototype(method->input_type());
-  }
+void GetPagesRequest::SetCachedSize(int size) const {
+  _impl_._cached_size_.Set(size);
 }
 
-const ::PROTOBUF_NAMESPACE_ID::Message& StorageService::GetResponsePrototype(
-    const ::PROTOBUF_NAMESPACE_ID::MethodDescriptor* method) const {
-  GOOGLE_DCHECK_EQ(method->service(), descriptor());
-  switch(method->index()) {
-    case 0:
-      return ::storage_service::LogWriteResponse::default_instance();
-    case 1:
-      return ::storage_service::GetPageResponse::default_instance();
-    default:
-      GOOGLE_LOG(FATAL) << "Bad method index; this should never happen.";
-      return *::PROTOBUF_NAMESPACE_ID::MessageFactory::generated_factory()
-          ->GetPrototype(method->output_type());
-  }
+void GetPagesRequest::Clear() {
+// @@protoc_insertion_point(message_clear_start:storage_service.GetPagesRequest)
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  _impl_.page_ids_.Clear();
+  ::memset(&_impl_.require_batch_id_, 0, static_cast<size_t>(
+      reinterpret_cast<char*>(&_impl_.read_ahead_) -
+      reinterpret_cast<char*>(&_impl_.require_batch_id_)) + sizeof(_impl_.read_ahead_));
+  _internal_metadata_.Clear<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>();
 }
 
-StorageService_Stub::StorageService_Stub(::PROTOBUF_NAMESPACE_ID::RpcChannel* channel)
-  : channel_(channel), owns_channel_(false) {}
-StorageService_Stub::StorageService_Stub(
-    ::PROTOBUF_NAMESPACE_ID::RpcChannel* channel,
-    ::PROTOBUF_NAMESPACE_ID::Service::ChannelOwnership ownership)
-  : channel_(channel),
-    owns_channel_(ownership == ::PROTOBUF_NAMESPACE_ID::Service::STUB_OWNS_CHANNEL) {}
-StorageService_Stub::~StorageService_Stub() {
-  if (owns_channel_) delete channel_;
+const char* GetPagesRequest::_InternalParse(const char* ptr, ::_pbi::ParseContext* ctx) {
+#define CHK_(x) if (PROTOBUF_PREDICT_FALSE(!(x))) goto failure
+  while (!ctx->Done(&ptr)) {
+    uint32_t tag;
+    ptr = ::_pbi::ReadTag(ptr, &tag);
+    switch (tag >> 3) {
+      // repeated .storage_service.GetPageRequest.PageID page_ids = 1;
+      case 1:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 10)) {
+          ptr -= 1;
+          do {
+            ptr += 1;
+            ptr = ctx->ParseMessage(_internal_add_page_ids(), ptr);
+            CHK_(ptr);
+            if (!ctx->DataAvailable(ptr)) break;
+          } while (::PROTOBUF_NAMESPACE_ID::internal::ExpectTag<10>(ptr));
+        } else
+          goto handle_unusual;
+        continue;
+      // uint64 require_batch_id = 2;
+      case 2:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 16)) {
+          _impl_.require_batch_id_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // bool read_ahead = 3;
+      case 3:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 24)) {
+          _impl_.read_ahead_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      default:
+        goto handle_unusual;
+    }  // switch
+  handle_unusual:
+    if ((tag == 0) || ((tag & 7) == 4)) {
+      CHK_(ptr);
+      ctx->SetLastTag(tag);
+      goto message_done;
+    }
+    ptr = UnknownFieldParse(
+        tag,
+        _internal_metadata_.mutable_unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(),
+        ptr, ctx);
+    CHK_(ptr != nullptr);
+  }  // while
+message_done:
+  return ptr;
+failure:
+  ptr = nullptr;
+  goto message_done;
+#undef CHK_
 }
 
-void StorageService_Stub::LogWrite(::PROTOBUF_NAMESPACE_ID::RpcController* controller,
-                              const ::storage_service::LogWriteRequest* request,
-                              ::storage_service::LogWriteResponse* response,
-                              ::google::protobuf::Closure* done) {
-  channel_->CallMethod(descriptor()->method(0),
-                       controller, request, response, done);
+uint8_t* GetPagesRequest::_InternalSerialize(
+    uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const {
+  // @@protoc_insertion_point(serialize_to_array_start:storage_service.GetPagesRequest)
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  // repeated .storage_service.GetPageRequest.PageID page_ids = 1;
+  for (unsigned i = 0,
+      n = static_cast<unsigned>(this->_internal_page_ids_size()); i < n; i++) {
+    const auto& repfield = this->_internal_page_ids(i);
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::
+        InternalWriteMessage(1, repfield, repfield.GetCachedSize(), target, stream);
+  }
+
+  // uint64 require_batch_id = 2;
+  if (this->_internal_require_batch_id() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteUInt64ToArray(2, this->_internal_require_batch_id(), target);
+  }
+
+  // bool read_ahead = 3;
+  if (this->_internal_read_ahead() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteBoolToArray(3, this->_internal_read_ahead(), target);
+  }
+
+  if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
+    target = ::_pbi::WireFormat::InternalSerializeUnknownFieldsToArray(
+        _internal_metadata_.unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(::PROTOBUF_NAMESPACE_ID::UnknownFieldSet::default_instance), target, stream);
+  }
+  // @@protoc_insertion_point(serialize_to_array_end:storage_service.GetPagesRequest)
+  return target;
 }
-void StorageService_Stub::GetPage(::PROTOBUF_NAMESPACE_ID::RpcController* controller,
-                              const ::storage_service::GetPageRequest* request,
-                              ::storage_service::GetPageResponse* response,
-                              ::google::protobuf::Closure* done) {
-  channel_->CallMethod(descriptor()->method(1),
-                       controller, request, response, done);
+
+size_t GetPagesRequest::ByteSizeLong() const {
+// @@protoc_insertion_point(message_byte_size_start:storage_service.GetPagesRequest)
+  size_t total_size = 0;
+
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  // repeated .storage_service.GetPageRequest.PageID page_ids = 1;
+  total_size += 1UL * this->_internal_page_ids_size();
+  for (const auto& msg : this->_impl_.page_ids_) {
+    total_size +=
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::MessageSize(msg);
+  }
+
+  // uint64 require_batch_id = 2;
+  if (this->_internal_require_batch_id() != 0) {
+    total_size += ::_pbi::WireFormatLite::UInt64SizePlusOne(this->_internal_require_batch_id());
+  }
+
+  // bool read_ahead = 3;
+  if (this->_internal_read_ahead() != 0) {
+    total_size += 1 + 1;
+  }
+
+  return MaybeComputeUnknownFieldsSize(total_size, &_impl_._cached_size_);
+}
+
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData GetPagesRequest::_class_data_ = {
+    ::PROTOBUF_NAMESPACE_ID::Message::CopyWithSourceCheck,
+    GetPagesRequest::MergeImpl
+};
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*GetPagesRequest::GetClassData() const { return &_class_data_; }
+
+
+void GetPagesRequest::MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg) {
+  auto* const _this = static_cast<GetPagesRequest*>(&to_msg);
+  auto& from = static_cast<const GetPagesRequest&>(from_msg);
+  // @@protoc_insertion_point(class_specific_merge_from_start:storage_service.GetPagesRequest)
+  GOOGLE_DCHECK_NE(&from, _this);
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  _this->_impl_.page_ids_.MergeFrom(from._impl_.page_ids_);
+  if (from._internal_require_batch_id() != 0) {
+    _this->_internal_set_require_batch_id(from._internal_require_batch_id());
+  }
+  if (from._internal_read_ahead() != 0) {
+    _this->_internal_set_read_ahead(from._internal_read_ahead());
+  }
+  _this->_internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+}
+
+void GetPagesRequest::CopyFrom(const GetPagesRequest& from) {
+// @@protoc_insertion_point(class_specific_copy_from_start:storage_service.GetPagesRequest)
+  if (&from == this) return;
+  Clear();
+  MergeFrom(from);
+}
+
+bool GetPagesRequest::IsInitialized() const {
+  return true;
+}
+
+void GetPagesRequest::InternalSwap(GetPagesRequest* other) {
+  using std::swap;
+  _internal_metadata_.InternalSwap(&other->_internal_metadata_);
+  _impl_.page_ids_.InternalSwap(&other->_impl_.page_ids_);
+  ::PROTOBUF_NAMESPACE_ID::internal::memswap<
+      PROTOBUF_FIELD_OFFSET(GetPagesRequest, _impl_.read_ahead_)
+      + sizeof(GetPagesRequest::_impl_.read_ahead_)
+      - PROTOBUF_FIELD_OFFSET(GetPagesRequest, _impl_.require_batch_id_)>(
+          reinterpret_cast<char*>(&_impl_.require_batch_id_),
+          reinterpret_cast<char*>(&other->_impl_.require_batch_id_));
+}
+
+::PROTOBUF_NAMESPACE_ID::Metadata GetPagesRequest::GetMetadata() const {
+  return ::_pbi::AssignDescriptors(
+      &descriptor_table_storage_5fservice_2eproto_getter, &descriptor_table_storage_5fservice_2eproto_once,
+      file_level_metadata_storage_5fservice_2eproto[5]);
+}
+
+// ===================================================================
+
+class GetPagesResponse::_Internal {
+ public:
+};
+
+GetPagesResponse::GetPagesResponse(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                         bool is_message_owned)
+  : ::PROTOBUF_NAMESPACE_ID::Message(arena, is_message_owned) {
+  SharedCtor(arena, is_message_owned);
+  // @@protoc_insertion_point(arena_constructor:storage_service.GetPagesResponse)
+}
+GetPagesResponse::GetPagesResponse(const GetPagesResponse& from)
+  : ::PROTOBUF_NAMESPACE_ID::Message() {
+  GetPagesResponse* const _this = this; (void)_this;
+  new (&_impl_) Impl_{
+      decltype(_impl_.page_exists_){from._impl_.page_exists_}
+    , decltype(_impl_.data_){}
+    , /*decltype(_impl_._cached_size_)*/{}};
+
+  _internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+  _impl_.data_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.data_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (!from._internal_data().empty()) {
+    _this->_impl_.data_.Set(from._internal_data(), 
+      _this->GetArenaForAllocation());
+  }
+  // @@protoc_insertion_point(copy_constructor:storage_service.GetPagesResponse)
+}
+
+inline void GetPagesResponse::SharedCtor(
+    ::_pb::Arena* arena, bool is_message_owned) {
+  (void)arena;
+  (void)is_message_owned;
+  new (&_impl_) Impl_{
+      decltype(_impl_.page_exists_){arena}
+    , decltype(_impl_.data_){}
+    , /*decltype(_impl_._cached_size_)*/{}
+  };
+  _impl_.data_.InitDefault();
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    _impl_.data_.Set("", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+}
+
+GetPagesResponse::~GetPagesResponse() {
+  // @@protoc_insertion_point(destructor:storage_service.GetPagesResponse)
+  if (auto *arena = _internal_metadata_.DeleteReturnArena<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>()) {
+  (void)arena;
+    return;
+  }
+  SharedDtor();
+}
+
+inline void GetPagesResponse::SharedDtor() {
+  GOOGLE_DCHECK(GetArenaForAllocation() == nullptr);
+  _impl_.page_exists_.~RepeatedField();
+  _impl_.data_.Destroy();
+}
+
+void GetPagesResponse::SetCachedSize(int size) const {
+  _impl_._cached_size_.Set(size);
+}
+
+void GetPagesResponse::Clear() {
+// @@protoc_insertion_point(message_clear_start:storage_service.GetPagesResponse)
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  _impl_.page_exists_.Clear();
+  _impl_.data_.ClearToEmpty();
+  _internal_metadata_.Clear<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>();
+}
+
+const char* GetPagesResponse::_InternalParse(const char* ptr, ::_pbi::ParseContext* ctx) {
+#define CHK_(x) if (PROTOBUF_PREDICT_FALSE(!(x))) goto failure
+  while (!ctx->Done(&ptr)) {
+    uint32_t tag;
+    ptr = ::_pbi::ReadTag(ptr, &tag);
+    switch (tag >> 3) {
+      // bytes data = 1;
+      case 1:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 10)) {
+          auto str = _internal_mutable_data();
+          ptr = ::_pbi::InlineGreedyStringParser(str, ptr, ctx);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // repeated bool page_exists = 2;
+      case 2:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 18)) {
+          ptr = ::PROTOBUF_NAMESPACE_ID::internal::PackedBoolParser(_internal_mutable_page_exists(), ptr, ctx);
+          CHK_(ptr);
+        } else if (static_cast<uint8_t>(tag) == 16) {
+          _internal_add_page_exists(::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr));
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      default:
+        goto handle_unusual;
+    }  // switch
+  handle_unusual:
+    if ((tag == 0) || ((tag & 7) == 4)) {
+      CHK_(ptr);
+      ctx->SetLastTag(tag);
+      goto message_done;
+    }
+    ptr = UnknownFieldParse(
+        tag,
+        _internal_metadata_.mutable_unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(),
+        ptr, ctx);
+    CHK_(ptr != nullptr);
+  }  // while
+message_done:
+  return ptr;
+failure:
+  ptr = nullptr;
+  goto message_done;
+#undef CHK_
+}
+
+uint8_t* GetPagesResponse::_InternalSerialize(
+    uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const {
+  // @@protoc_insertion_point(serialize_to_array_start:storage_service.GetPagesResponse)
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  // bytes data = 1;
+  if (!this->_internal_data().empty()) {
+    target = stream->WriteBytesMaybeAliased(
+        1, this->_internal_data(), target);
+  }
+
+  // repeated bool page_exists = 2;
+  if (this->_internal_page_exists_size() > 0) {
+    target = stream->WriteFixedPacked(2, _internal_page_exists(), target);
+  }
+
+  if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
+    target = ::_pbi::WireFormat::InternalSerializeUnknownFieldsToArray(
+        _internal_metadata_.unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(::PROTOBUF_NAMESPACE_ID::UnknownFieldSet::default_instance), target, stream);
+  }
+  // @@protoc_insertion_point(serialize_to_array_end:storage_service.GetPagesResponse)
+  return target;
+}
+
+size_t GetPagesResponse::ByteSizeLong() const {
+// @@protoc_insertion_point(message_byte_size_start:storage_service.GetPagesResponse)
+  size_t total_size = 0;
+
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  // repeated bool page_exists = 2;
+  {
+    unsigned int count = static_cast<unsigned int>(this->_internal_page_exists_size());
+    size_t data_size = 1UL * count;
+    if (data_size > 0) {
+      total_size += 1 +
+        ::_pbi::WireFormatLite::Int32Size(static_cast<int32_t>(data_size));
+    }
+    total_size += data_size;
+  }
+
+  // bytes data = 1;
+  if (!this->_internal_data().empty()) {
+    total_size += 1 +
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::BytesSize(
+        this->_internal_data());
+  }
+
+  return MaybeComputeUnknownFieldsSize(total_size, &_impl_._cached_size_);
+}
+
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData GetPagesResponse::_class_data_ = {
+    ::PROTOBUF_NAMESPACE_ID::Message::CopyWithSourceCheck,
+    GetPagesResponse::MergeImpl
+};
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*GetPagesResponse::GetClassData() const { return &_class_data_; }
+
+
+void GetPagesResponse::MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg) {
+  auto* const _this = static_cast<GetPagesResponse*>(&to_msg);
+  auto& from = static_cast<const GetPagesResponse&>(from_msg);
+  // @@protoc_insertion_point(class_specific_merge_from_start:storage_service.GetPagesResponse)
+  GOOGLE_DCHECK_NE(&from, _this);
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  _this->_impl_.page_exists_.MergeFrom(from._impl_.page_exists_);
+  if (!from._internal_data().empty()) {
+    _this->_internal_set_data(from._internal_data());
+  }
+  _this->_internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+}
+
+void GetPagesResponse::CopyFrom(const GetPagesResponse& from) {
+// @@protoc_insertion_point(class_specific_copy_from_start:storage_service.GetPagesResponse)
+  if (&from == this) return;
+  Clear();
+  MergeFrom(from);
+}
+
+bool GetPagesResponse::IsInitialized() const {
+  return true;
+}
+
+void GetPagesResponse::InternalSwap(GetPagesResponse* other) {
+  using std::swap;
+  auto* lhs_arena = GetArenaForAllocation();
+  auto* rhs_arena = other->GetArenaForAllocation();
+  _internal_metadata_.InternalSwap(&other->_internal_metadata_);
+  _impl_.page_exists_.InternalSwap(&other->_impl_.page_exists_);
+  ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::InternalSwap(
+      &_impl_.data_, lhs_arena,
+      &other->_impl_.data_, rhs_arena
+  );
+}
+
+::PROTOBUF_NAMESPACE_ID::Metadata GetPagesResponse::GetMetadata() const {
+  return ::_pbi::AssignDescriptors(
+      &descriptor_table_storage_5fservice_2eproto_getter, &descriptor_table_storage_5fservice_2eproto_once,
+      file_level_metadata_storage_5fservice_2eproto[6]);
+}
+
+// ===================================================================
+
+class GetPersistBatchIdRequest::_Internal {
+ public:
+};
+
+GetPersistBatchIdRequest::GetPersistBatchIdRequest(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                         bool is_message_owned)
+  : ::PROTOBUF_NAMESPACE_ID::internal::ZeroFieldsBase(arena, is_message_owned) {
+  // @@protoc_insertion_point(arena_constructor:storage_service.GetPersistBatchIdRequest)
+}
+GetPersistBatchIdRequest::GetPersistBatchIdRequest(const GetPersistBatchIdRequest& from)
+  : ::PROTOBUF_NAMESPACE_ID::internal::ZeroFieldsBase() {
+  GetPersistBatchIdRequest* const _this = this; (void)_this;
+  _internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+  // @@protoc_insertion_point(copy_constructor:storage_service.GetPersistBatchIdRequest)
+}
+
+
+
+
+
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData GetPersistBatchIdRequest::_class_data_ = {
+    ::PROTOBUF_NAMESPACE_ID::internal::ZeroFieldsBase::CopyImpl,
+    ::PROTOBUF_NAMESPACE_ID::internal::ZeroFieldsBase::MergeImpl,
+};
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*GetPersistBatchIdRequest::GetClassData() const { return &_class_data_; }
+
+
+
+
+
+
+
+::PROTOBUF_NAMESPACE_ID::Metadata GetPersistBatchIdRequest::GetMetadata() const {
+  return ::_pbi::AssignDescriptors(
+      &descriptor_table_storage_5fservice_2eproto_getter, &descriptor_table_storage_5fservice_2eproto_once,
+      file_level_metadata_storage_5fservice_2eproto[7]);
+}
+
+// ===================================================================
+
+class GetPersistBatchIdResponse::_Internal {
+ public:
+};
+
+GetPersistBatchIdResponse::GetPersistBatchIdResponse(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                         bool is_message_owned)
+  : ::PROTOBUF_NAMESPACE_ID::Message(arena, is_message_owned) {
+  SharedCtor(arena, is_message_owned);
+  // @@protoc_insertion_point(arena_constructor:storage_service.GetPersistBatchIdResponse)
+}
+GetPersistBatchIdResponse::GetPersistBatchIdResponse(const GetPersistBatchIdResponse& from)
+  : ::PROTOBUF_NAMESPACE_ID::Message() {
+  GetPersistBatchIdResponse* const _this = this; (void)_this;
+  new (&_impl_) Impl_{
+      decltype(_impl_.persist_batch_id_){}
+    , /*decltype(_impl_._cached_size_)*/{}};
+
+  _internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+  _this->_impl_.persist_batch_id_ = from._impl_.persist_batch_id_;
+  // @@protoc_insertion_point(copy_constructor:storage_service.GetPersistBatchIdResponse)
+}
+
+inline void GetPersistBatchIdResponse::SharedCtor(
+    ::_pb::Arena* arena, bool is_message_owned) {
+  (void)arena;
+  (void)is_message_owned;
+  new (&_impl_) Impl_{
+      decltype(_impl_.persist_batch_id_){uint64_t{0u}}
+    , /*decltype(_impl_._cached_size_)*/{}
+  };
+}
+
+GetPersistBatchIdResponse::~GetPersistBatchIdResponse() {
+  // @@protoc_insertion_point(destructor:storage_service.GetPersistBatchIdResponse)
+  if (auto *arena = _internal_metadata_.DeleteReturnArena<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>()) {
+  (void)arena;
+    return;
+  }
+  SharedDtor();
+}
+
+inline void GetPersistBatchIdResponse::SharedDtor() {
+  GOOGLE_DCHECK(GetArenaForAllocation() == nullptr);
+}
+
+void GetPersistBatchIdResponse::SetCachedSize(int size) const {
+  _impl_._cached_size_.Set(size);
+}
+
+void GetPersistBatchIdResponse::Clear() {
+// @@protoc_insertion_point(message_clear_start:storage_service.GetPersistBatchIdResponse)
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  _impl_.persist_batch_id_ = uint64_t{0u};
+  _internal_metadata_.Clear<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>();
+}
+
+const char* GetPersistBatchIdResponse::_InternalParse(const char* ptr, ::_pbi::ParseContext* ctx) {
+#define CHK_(x) if (PROTOBUF_PREDICT_FALSE(!(x))) goto failure
+  while (!ctx->Done(&ptr)) {
+    uint32_t tag;
+    ptr = ::_pbi::ReadTag(ptr, &tag);
+    switch (tag >> 3) {
+      // uint64 persist_batch_id = 1;
+      case 1:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 8)) {
+          _impl_.persist_batch_id_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      default:
+        goto handle_unusual;
+    }  // switch
+  handle_unusual:
+    if ((tag == 0) || ((tag & 7) == 4)) {
+      CHK_(ptr);
+      ctx->SetLastTag(tag);
+      goto message_done;
+    }
+    ptr = UnknownFieldParse(
+        tag,
+        _internal_metadata_.mutable_unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(),
+        ptr, ctx);
+    CHK_(ptr != nullptr);
+  }  // while
+message_done:
+  return ptr;
+failure:
+  ptr = nullptr;
+  goto message_done;
+#undef CHK_
+}
+
+uint8_t* GetPersistBatchIdResponse::_InternalSerialize(
+    uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const {
+  // @@protoc_insertion_point(serialize_to_array_start:storage_service.GetPersistBatchIdResponse)
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  // uint64 persist_batch_id = 1;
+  if (this->_internal_persist_batch_id() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteUInt64ToArray(1, this->_internal_persist_batch_id(), target);
+  }
+
+  if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
+    target = ::_pbi::WireFormat::InternalSerializeUnknownFieldsToArray(
+        _internal_metadata_.unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(::PROTOBUF_NAMESPACE_ID::UnknownFieldSet::default_instance), target, stream);
+  }
+  // @@protoc_insertion_point(serialize_to_array_end:storage_service.GetPersistBatchIdResponse)
+  return target;
+}
+
+size_t GetPersistBatchIdResponse::ByteSizeLong() const {
+// @@protoc_insertion_point(message_byte_size_start:storage_service.GetPersistBatchIdResponse)
+  size_t total_size = 0;
+
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  // uint64 persist_batch_id = 1;
+  if (this->_internal_persist_batch_id() != 0) {
+    total_size += ::_pbi::WireFormatLite::UInt64SizePlusOne(this->_internal_persist_batch_id());
+  }
+
+  return MaybeComputeUnknownFieldsSize(total_size, &_impl_._cached_size_);
+}
+
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData GetPersistBatchIdResponse::_class_data_ = {
+    ::PROTOBUF_NAMESPACE_ID::Message::CopyWithSourceCheck,
+    GetPersistBatchIdResponse::MergeImpl
+};
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*GetPersistBatchIdResponse::GetClassData() const { return &_class_data_; }
+
+
+void GetPersistBatchIdResponse::MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg) {
+  auto* const _this = static_cast<GetPersistBatchIdResponse*>(&to_msg);
+  auto& from = static_cast<const GetPersistBatchIdResponse&>(from_msg);
+  // @@protoc_insertion_point(class_specific_merge_from_start:storage_service.GetPersistBatchIdResponse)
+  GOOGLE_DCHECK_NE(&from, _this);
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  if (from._internal_persist_batch_id() != 0) {
+    _this->_internal_set_persist_batch_id(from._internal_persist_batch_id());
+  }
+  _this->_internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+}
+
+void GetPersistBatchIdResponse::CopyFrom(const GetPersistBatchIdResponse& from) {
+// @@protoc_insertion_point(class_specific_copy_from_start:storage_service.GetPersistBatchIdResponse)
+  if (&from == this) return;
+  Clear();
+  MergeFrom(from);
+}
+
+bool GetPersistBatchIdResponse::IsInitialized() const {
+  return true;
+}
+
+void GetPersistBatchIdResponse::InternalSwap(GetPersistBatchIdResponse* other) {
+  using std::swap;
+  _internal_metadata_.InternalSwap(&other->_internal_metadata_);
+  swap(_impl_.persist_batch_id_, other->_impl_.persist_batch_id_);
+}
+
+::PROTOBUF_NAMESPACE_ID::Metadata GetPersistBatchIdResponse::GetMetadata() const {
+  return ::_pbi::AssignDescriptors(
+      &descriptor_table_storage_5fservice_2eproto_getter, &descriptor_table_storage_5fservice_2eproto_once,
+      file_level_metadata_storage_5fservice_2eproto[8]);
+}
+
+// ===================================================================
+
+StorageService::~StorageService() {}
+
+const ::PROTOBUF_NAMESPACE_ID::ServiceDescriptor* StorageService::descriptor() {
+  ::PROTOBUF_NAMESPACE_ID::internal::AssignDescriptors(&descriptor_table_storage_5fservice_2eproto);
+  return file_level_service_descriptors_storage_5fservice_2eproto[0];
+}
+
+const ::PROTOBUF_NAMESPACE_ID::ServiceDescriptor* StorageService::GetDescriptor() {
+  return descriptor();
+}
+
+void StorageService::LogWrite(::PROTOBUF_NAMESPACE_ID::RpcController* controller,
+                         const ::storage_service::LogWriteRequest*,
+                         ::storage_service::LogWriteResponse*,
+                         ::google::protobuf::Closure* done) {
+  controller->SetFailed("Method LogWrite() not implemented.");
+  done->Run();
+}
+
+void StorageService::GetPage(::PROTOBUF_NAMESPACE_ID::RpcController* controller,
+                         const ::storage_service::GetPageRequest*,
+                         ::storage_service::GetPageResponse*,
+                         ::google::protobuf::Closure* done) {
+  controller->SetFailed("Method GetPage() not implemented.");
+  done->Run();
+}
+
+void StorageService::GetPages(::PROTOBUF_NAMESPACE_ID::RpcController* controller,
+                         const ::storage_service::GetPagesRequest*,
+                         ::storage_service::GetPagesResponse*,
+                         ::google::protobuf::Closure* done) {
+  controller->SetFailed("Method GetPages() not implemented.");
+  done->Run();
+}
+
+void StorageService::GetPersistBatchId(::PROTOBUF_NAMESPACE_ID::RpcController* controller,
+                         const ::storage_service::GetPersistBatchIdRequest*,
+                         ::storage_service::GetPersistBatchIdResponse*,
+                         ::google::protobuf::Closure* done) {
+  controller->SetFailed("Method GetPersistBatchId() not implemented.");
+  done->Run();
+}
+
+void StorageService::CallMethod(const ::PROTOBUF_NAMESPACE_ID::MethodDescriptor* method,
+                             ::PROTOBUF_NAMESPACE_ID::RpcController* controller,
+                             const ::PROTOBUF_NAMESPACE_ID::Message* request,
+                             ::PROTOBUF_NAMESPACE_ID::Message* response,
+                             ::google::protobuf::Closure* done) {
+  GOOGLE_DCHECK_EQ(method->service(), file_level_service_descriptors_storage_5fservice_2eproto[0]);
+  switch(method->index()) {
+    case 0:
+      LogWrite(controller,
+             ::PROTOBUF_NAMESPACE_ID::internal::DownCast<const ::storage_service::LogWriteRequest*>(
+                 request),
+             ::PROTOBUF_NAMESPACE_ID::internal::DownCast<::storage_service::LogWriteResponse*>(
+                 response),
+             done);
+      break;
+    case 1:
+      GetPage(controller,
+             ::PROTOBUF_NAMESPACE_ID::internal::DownCast<const ::storage_service::GetPageRequest*>(
+                 request),
+             ::PROTOBUF_NAMESPACE_ID::internal::DownCast<::storage_service::GetPageResponse*>(
+                 response),
+             done);
+      break;
+    case 2:
+      GetPages(controller,
+             ::PROTOBUF_NAMESPACE_ID::internal::DownCast<const ::storage_service::GetPagesRequest*>(
+                 request),
+             ::PROTOBUF_NAMESPACE_ID::internal::DownCast<::storage_service::GetPagesResponse*>(
+                 response),
+             done);
+      break;
+    case 3:
+      GetPersistBatchId(controller,
+             ::PROTOBUF_NAMESPACE_ID::internal::DownCast<const ::storage_service::GetPersistBatchIdRequest*>(
+                 request),
+             ::PROTOBUF_NAMESPACE_ID::internal::DownCast<::storage_service::GetPersistBatchIdResponse*>(
+                 response),
+             done);
+      break;
+    default:
+      GOOGLE_LOG(FATAL) << "Bad method index; this should never happen.";
+      break;
+  }
+}
+
+const ::PROTOBUF_NAMESPACE_ID::Message& StorageService::GetRequestPrototype(
+    const ::PROTOBUF_NAMESPACE_ID::MethodDescriptor* method) const {
+  GOOGLE_DCHECK_EQ(method->service(), descriptor());
+  switch(method->index()) {
+    case 0:
+      return ::storage_service::LogWriteRequest::default_instance();
+    case 1:
+      return ::storage_service::GetPageRequest::default_instance();
+    case 2:
+      return ::storage_service::GetPagesRequest::default_instance();
+    case 3:
+      return ::storage_service::GetPersistBatchIdRequest::default_instance();
+    default:
+      GOOGLE_LOG(FATAL) << "Bad method index; this should never happen.";
+      return *::PROTOBUF_NAMESPACE_ID::MessageFactory::generated_factory()
+          ->GetPrototype(method->input_type());
+  }
+}
+
+const ::PROTOBUF_NAMESPACE_ID::Message& StorageService::GetResponsePrototype(
+    const ::PROTOBUF_NAMESPACE_ID::MethodDescriptor* method) const {
+  GOOGLE_DCHECK_EQ(method->service(), descriptor());
+  switch(method->index()) {
+    case 0:
+      return ::storage_service::LogWriteResponse::default_instance();
+    case 1:
+      return ::storage_service::GetPageResponse::default_instance();
+    case 2:
+      return ::storage_service::GetPagesResponse::default_instance();
+    case 3:
+      return ::storage_service::GetPersistBatchIdResponse::default_instance();
+    default:
+      GOOGLE_LOG(FATAL) << "Bad method index; this should never happen.";
+      return *::PROTOBUF_NAMESPACE_ID::MessageFactory::generated_factory()
+          ->GetPrototype(method->output_type());
+  }
+}
+
+StorageService_Stub::StorageService_Stub(::PROTOBUF_NAMESPACE_ID::RpcChannel* channel)
+  : channel_(channel), owns_channel_(false) {}
+StorageService_Stub::StorageService_Stub(
+    ::PROTOBUF_NAMESPACE_ID::RpcChannel* channel,
+    ::PROTOBUF_NAMESPACE_ID::Service::ChannelOwnership ownership)
+  : channel_(channel),
+    owns_channel_(ownership == ::PROTOBUF_NAMESPACE_ID::Service::STUB_OWNS_CHANNEL) {}
+StorageService_Stub::~StorageService_Stub() {
+  if (owns_channel_) delete channel_;
+}
+
+void StorageService_Stub::LogWrite(::PROTOBUF_NAMESPACE_ID::RpcController* controller,
+                              const ::storage_service::LogWriteRequest* request,
+                              ::storage_service::LogWriteResponse* response,
+                              ::google::protobuf::Closure* done) {
+  channel_->CallMethod(descriptor()->method(0),
+                       controller, request, response, done);
+}
+void StorageService_Stub::GetPage(::PROTOBUF_NAMESPACE_ID::RpcController* controller,
+                              const ::storage_service::GetPageRequest* request,
+                              ::storage_service::GetPageResponse* response,
+                              ::google::protobuf::Closure* done) {
+  channel_->CallMethod(descriptor()->method(1),
+                       controller, request, response, done);
+}
+void StorageService_Stub::GetPages(::PROTOBUF_NAMESPACE_ID::RpcController* controller,
+                              const ::storage_service::GetPagesRequest* request,
+                              ::storage_service::GetPagesResponse* response,
+                              ::google::protobuf::Closure* done) {
+  channel_->CallMethod(descriptor()->method(2),
+                       controller, request, response, done);
+}
+void StorageService_Stub::GetPersistBatchId(::PROTOBUF_NAMESPACE_ID::RpcController* controller,
+                              const ::storage_service::GetPersistBatchIdRequest* request,
+                              ::storage_service::GetPersistBatchIdResponse* response,
+                              ::google::protobuf::Closure* done) {
+  channel_->CallMethod(descriptor()->method(3),
+                       controller, request, response, done);
 }
 
 // @@protoc_insertion_point(namespace_scope)
@@ -1168,6 +2053,22 @@ template<> PROTOBUF_NOINLINE ::storage_service::GetPageResponse*
 Arena::CreateMaybeMessage< ::storage_service::GetPageResponse >(Arena* arena) {
   return Arena::CreateMessageInternal< ::storage_service::GetPageResponse >(arena);
 }
+template<> PROTOBUF_NOINLINE ::storage_service::GetPagesRequest*
+Arena::CreateMaybeMessage< ::storage_service::GetPagesRequest >(Arena* arena) {
+  return Arena::CreateMessageInternal< ::storage_service::GetPagesRequest >(arena);
+}
+template<> PROTOBUF_NOINLINE ::storage_service::GetPagesResponse*
+Arena::CreateMaybeMessage< ::storage_service::GetPagesResponse >(Arena* arena) {
+  return Arena::CreateMessageInternal< ::storage_service::GetPagesResponse >(arena);
+}
+template<> PROTOBUF_NOINLINE ::storage_service::GetPersistBatchIdRequest*
+Arena::CreateMaybeMessage< ::storage_service::GetPersistBatchIdRequest >(Arena* arena) {
+  return Arena::CreateMessageInternal< ::storage_service::GetPersistBatchIdRequest >(arena);
+}
+template<> PROTOBUF_NOINLINE ::storage_service::GetPersistBatchIdResponse*
+Arena::CreateMaybeMessage< ::storage_service::GetPersistBatchIdResponse >(Arena* arena) {
+  return Arena::CreateMessageInternal< ::storage_service::GetPersistBatchIdResponse >(arena);
+}
 PROTOBUF_NAMESPACE_CLOSE
 
 // @@protoc_insertion_point(global_scope)
@@ -8,12 +8,12 @@
 #include <string>
 
 #include <google/protobuf/port_def.inc>
-#if PROTOBUF_VERSION < 3020000
+#if PROTOBUF_VERSION < 3021000
 #error This file was generated by a newer version of protoc which is
 #error incompatible with your Protocol Buffer headers. Please update
 #error your headers.
 #endif
-#if 3020001 < PROTOBUF_MIN_PROTOC_VERSION
+#if 3021012 < PROTOBUF_MIN_PROTOC_VERSION
 #error This file was generated by an older version of protoc which is
 #error incompatible with your Protocol Buffer headers. Please
 #error regenerate this file with a newer version of protoc.
@@ -56,6 +56,18 @@ extern GetPageRequest_PageIDDefaultTypeInternal _GetPageRequest_PageID_default_i
 class GetPageResponse;
 struct GetPageResponseDefaultTypeInternal;
 extern GetPageResponseDefaultTypeInternal _GetPageResponse_default_instance_;
+class GetPagesRequest;
+struct GetPagesRequestDefaultTypeInternal;
+extern GetPagesRequestDefaultTypeInternal _GetPagesRequest_default_instance_;
+class GetPagesResponse;
+struct GetPagesResponseDefaultTypeInternal;
+extern GetPagesResponseDefaultTypeInternal _GetPagesResponse_default_instance_;
+class GetPersistBatchIdRequest;
+struct GetPersistBatchIdRequestDefaultTypeInternal;
+extern GetPersistBatchIdRequestDefaultTypeInternal _GetPersistBatchIdRequest_default_instance_;
+class GetPersistBatchIdResponse;
+struct GetPersistBatchIdResponseDefaultTypeInternal;
+extern GetPersistBatchIdResponseDefaultTypeInternal _GetPersistBatchIdResponse_default_instance_;
 class LogWriteRequest;
 struct LogWriteRequestDefaultTypeInternal;
 extern LogWriteRequestDefaultTypeInternal _LogWriteRequest_default_instance_;
@@ -67,6 +79,10 @@ PROTOBUF_NAMESPACE_OPEN
 template<> ::storage_service::GetPageRequest* Arena::CreateMaybeMessage<::storage_service::GetPageRequest>(Arena*);
 template<> ::storage_service::GetPageRequest_PageID* Arena::CreateMaybeMessage<::storage_service::GetPageRequest_PageID>(Arena*);
 template<> ::storage_service::GetPageResponse* Arena::CreateMaybeMessage<::storage_service::GetPageResponse>(Arena*);
+template<> ::storage_service::GetPagesRequest* Arena::CreateMaybeMessage<::storage_service::GetPagesRequest>(Arena*);
+template<> ::storage_service::GetPagesResponse* Arena::CreateMaybeMessage<::storage_service::GetPagesResponse>(Arena*);
+template<> ::storage_service::GetPersistBatchIdRequest* Arena::CreateMaybeMessage<::storage_service::GetPersistBatchIdRequest>(Arena*);
+template<> ::storage_service::GetPersistBatchIdResponse* Arena::CreateMaybeMessage<::storage_service::GetPersistBatchIdResponse>(Arena*);
 template<> ::storage_service::LogWriteRequest* Arena::CreateMaybeMessage<::storage_service::LogWriteRequest>(Arena*);
 template<> ::storage_service::LogWriteResponse* Arena::CreateMaybeMessage<::storage_service::LogWriteResponse>(Arena*);
 PROTOBUF_NAMESPACE_CLOSE
@@ -154,9 +170,11 @@ class LogWriteRequest final :
   using ::PROTOBUF_NAMESPACE_ID::Message::CopyFrom;
   void CopyFrom(const LogWriteRequest& from);
   using ::PROTOBUF_NAMESPACE_ID::Message::MergeFrom;
-  void MergeFrom(const LogWriteRequest& from);
+  void MergeFrom( const LogWriteRequest& from) {
+    LogWriteRequest::MergeImpl(*this, from);
+  }
   private:
-  static void MergeImpl(::PROTOBUF_NAMESPACE_ID::Message* to, const ::PROTOBUF_NAMESPACE_ID::Message& from);
+  static void MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg);
   public:
   PROTOBUF_ATTRIBUTE_REINITIALIZES void Clear() final;
   bool IsInitialized() const final;
@@ -165,10 +183,10 @@ class LogWriteRequest final :
   const char* _InternalParse(const char* ptr, ::PROTOBUF_NAMESPACE_ID::internal::ParseContext* ctx) final;
   uint8_t* _InternalSerialize(
       uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const final;
-  int GetCachedSize() const final { return _cached_size_.Get(); }
+  int GetCachedSize() const final { return _impl_._cached_size_.Get(); }
 
   private:
-  void SharedCtor();
+  void SharedCtor(::PROTOBUF_NAMESPACE_ID::Arena* arena, bool is_message_owned);
   void SharedDtor();
   void SetCachedSize(int size) const final;
   void InternalSwap(LogWriteRequest* other);
@@ -216,8 +234,11 @@ class LogWriteRequest final :
   template <typename T> friend class ::PROTOBUF_NAMESPACE_ID::Arena::InternalHelper;
   typedef void InternalArenaConstructable_;
   typedef void DestructorSkippable_;
-  ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr log_;
-  mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
+  struct Impl_ {
+    ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr log_;
+    mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
+  };
+  union { Impl_ _impl_; };
   friend struct ::TableStruct_storage_5fservice_2eproto;
 };
 // -------------------------------------------------------------------
@@ -300,11 +321,11 @@ class LogWriteResponse final :
   }
   using ::PROTOBUF_NAMESPACE_ID::internal::ZeroFieldsBase::CopyFrom;
   inline void CopyFrom(const LogWriteResponse& from) {
-    ::PROTOBUF_NAMESPACE_ID::internal::ZeroFieldsBase::CopyImpl(this, from);
+    ::PROTOBUF_NAMESPACE_ID::internal::ZeroFieldsBase::CopyImpl(*this, from);
   }
   using ::PROTOBUF_NAMESPACE_ID::internal::ZeroFieldsBase::MergeFrom;
   void MergeFrom(const LogWriteResponse& from) {
-    ::PROTOBUF_NAMESPACE_ID::internal::ZeroFieldsBase::MergeImpl(this, from);
+    ::PROTOBUF_NAMESPACE_ID::internal::ZeroFieldsBase::MergeImpl(*this, from);
   }
   public:
 
@@ -334,6 +355,8 @@ class LogWriteResponse final :
   template <typename T> friend class ::PROTOBUF_NAMESPACE_ID::Arena::InternalHelper;
   typedef void InternalArenaConstructable_;
   typedef void DestructorSkippable_;
+  struct Impl_ {
+  };
   friend struct ::TableStruct_storage_5fservice_2eproto;
 };
 // -------------------------------------------------------------------
@@ -418,9 +441,11 @@ class GetPageRequest_PageID final :
   using ::PROTOBUF_NAMESPACE_ID::Message::CopyFrom;
   void CopyFrom(const GetPageRequest_PageID& from);
   using ::PROTOBUF_NAMESPACE_ID::Message::MergeFrom;
-  void MergeFrom(const GetPageRequest_PageID& from);
+  void MergeFrom( const GetPageRequest_PageID& from) {
+    GetPageRequest_PageID::MergeImpl(*this, from);
+  }
   private:
-  static void MergeImpl(::PROTOBUF_NAMESPACE_ID::Message* to, const ::PROTOBUF_NAMESPACE_ID::Message& from);
+  static void MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg);
   public:
   PROTOBUF_ATTRIBUTE_REINITIALIZES void Clear() final;
   bool IsInitialized() const final;
@@ -429,10 +454,10 @@ class GetPageRequest_PageID final :
   const char* _InternalParse(const char* ptr, ::PROTOBUF_NAMESPACE_ID::internal::ParseContext* ctx) final;
   uint8_t* _InternalSerialize(
       uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const final;
-  int GetCachedSize() const final { return _cached_size_.Get(); }
+  int GetCachedSize() const final { return _impl_._cached_size_.Get(); }
 
   private:
-  void SharedCtor();
+  void SharedCtor(::PROTOBUF_NAMESPACE_ID::Arena* arena, bool is_message_owned);
   void SharedDtor();
   void SetCachedSize(int size) const final;
   void InternalSwap(GetPageRequest_PageID* other);
@@ -490,9 +515,12 @@ class GetPageRequest_PageID final :
   template <typename T> friend class ::PROTOBUF_NAMESPACE_ID::Arena::InternalHelper;
   typedef void InternalArenaConstructable_;
   typedef void DestructorSkippable_;
-  ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr table_name_;
-  int32_t page_no_;
-  mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
+  struct Impl_ {
+    ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr table_name_;
+    int32_t page_no_;
+    mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
+  };
+  union { Impl_ _impl_; };
   friend struct ::TableStruct_storage_5fservice_2eproto;
 };
 // -------------------------------------------------------------------
@@ -577,9 +605,11 @@ class GetPageRequest final :
   using ::PROTOBUF_NAMESPACE_ID::Message::CopyFrom;
   void CopyFrom(const GetPageRequest& from);
   using ::PROTOBUF_NAMESPACE_ID::Message::MergeFrom;
-  void MergeFrom(const GetPageRequest& from);
+  void MergeFrom( const GetPageRequest& from) {
+    GetPageRequest::MergeImpl(*this, from);
+  }
   private:
-  static void MergeImpl(::PROTOBUF_NAMESPACE_ID::Message* to, const ::PROTOBUF_NAMESPACE_ID::Message& from);
+  static void MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg);
   public:
   PROTOBUF_ATTRIBUTE_REINITIALIZES void Clear() final;
   bool IsInitialized() const final;
@@ -588,10 +618,10 @@ class GetPageRequest final :
   const char* _InternalParse(const char* ptr, ::PROTOBUF_NAMESPACE_ID::internal::ParseContext* ctx) final;
   uint8_t* _InternalSerialize(
       uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const final;
-  int GetCachedSize() const final { return _cached_size_.Get(); }
+  int GetCachedSize() const final { return _impl_._cached_size_.Get(); }
 
   private:
-  void SharedCtor();
+  void SharedCtor(::PROTOBUF_NAMESPACE_ID::Arena* arena, bool is_message_owned);
   void SharedDtor();
   void SetCachedSize(int size) const final;
   void InternalSwap(GetPageRequest* other);
@@ -655,9 +685,12 @@ class GetPageRequest final :
   template <typename T> friend class ::PROTOBUF_NAMESPACE_ID::Arena::InternalHelper;
   typedef void InternalArenaConstructable_;
   typedef void DestructorSkippable_;
-  ::storage_service::GetPageRequest_PageID* page_id_;
-  uint64_t require_batch_id_;
-  mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
+  struct Impl_ {
+    ::storage_service::GetPageRequest_PageID* page_id_;
+    uint64_t require_batch_id_;
+    mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
+  };
+  union { Impl_ _impl_; };
   friend struct ::TableStruct_storage_5fservice_2eproto;
 };
 // -------------------------------------------------------------------
@@ -742,9 +775,11 @@ class GetPageResponse final :
   using ::PROTOBUF_NAMESPACE_ID::Message::CopyFrom;
   void CopyFrom(const GetPageResponse& from);
   using ::PROTOBUF_NAMESPACE_ID::Message::MergeFrom;
-  void MergeFrom(const GetPageResponse& from);
+  void MergeFrom( const GetPageResponse& from) {
+    GetPageResponse::MergeImpl(*this, from);
+  }
   private:
-  static void MergeImpl(::PROTOBUF_NAMESPACE_ID::Message* to, const ::PROTOBUF_NAMESPACE_ID::Message& from);
+  static void MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg);
   public:
   PROTOBUF_ATTRIBUTE_REINITIALIZES void Clear() final;
   bool IsInitialized() const final;
@@ -753,10 +788,10 @@ class GetPageResponse final :
   const char* _InternalParse(const char* ptr, ::PROTOBUF_NAMESPACE_ID::internal::ParseContext* ctx) final;
   uint8_t* _InternalSerialize(
       uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const final;
-  int GetCachedSize() const final { return _cached_size_.Get(); }
+  int GetCachedSize() const final { return _impl_._cached_size_.Get(); }
 
   private:
-  void SharedCtor();
+  void SharedCtor(::PROTOBUF_NAMESPACE_ID::Arena* arena, bool is_message_owned);
   void SharedDtor();
   void SetCachedSize(int size) const final;
   void InternalSwap(GetPageResponse* other);
@@ -804,202 +839,843 @@ class GetPageResponse final :
   template <typename T> friend class ::PROTOBUF_NAMESPACE_ID::Arena::InternalHelper;
   typedef void InternalArenaConstructable_;
   typedef void DestructorSkippable_;
-  ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr data_;
-  mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
+  struct Impl_ {
+    ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr data_;
+    mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
+  };
+  union { Impl_ _impl_; };
   friend struct ::TableStruct_storage_5fservice_2eproto;
 };
-// ===================================================================
-
-class StorageService_Stub;
+// -------------------------------------------------------------------
 
-class StorageService : public ::PROTOBUF_NAMESPACE_ID::Service {
- protected:
-  // This class should be treated as an abstract interface.
-  inline StorageService() {};
+class GetPagesRequest final :
+    public ::PROTOBUF_NAMESPACE_ID::Message /* @@protoc_insertion_point(class_definition:storage_service.GetPagesRequest) */ {
  public:
-  virtual ~StorageService();
-
-  typedef StorageService_Stub Stub;
+  inline GetPagesRequest() : GetPagesRequest(nullptr) {}
+  ~GetPagesRequest() override;
+  explicit PROTOBUF_CONSTEXPR GetPagesRequest(::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized);
 
-  static const ::PROTOBUF_NAMESPACE_ID::ServiceDescriptor* descriptor();
+  GetPagesRequest(const GetPagesRequest& from);
+  GetPagesRequest(GetPagesRequest&& from) noexcept
+    : GetPagesRequest() {
+    *this = ::std::move(from);
+  }
 
-  virtual void LogWrite(::PROTOBUF_NAMESPACE_ID::RpcController* controller,
-                       const ::storage_service::LogWriteRequest* request,
-                       ::storage_service::LogWriteResponse* response,
-                       ::google::protobuf::Closure* done);
-  virtual void GetPage(::PROTOBUF_NAMESPACE_ID::RpcController* controller,
-                       const ::storage_service::GetPageRequest* request,
-                       ::storage_service::GetPageResponse* response,
-                       ::google::protobuf::Closure* done);
+  inline GetPagesRequest& operator=(const GetPagesRequest& from) {
+    CopyFrom(from);
+    return *this;
+  }
+  inline GetPagesRequest& operator=(GetPagesRequest&& from) noexcept {
+    if (this == &from) return *this;
+    if (GetOwningArena() == from.GetOwningArena()
+  #ifdef PROTOBUF_FORCE_COPY_IN_MOVE
+        && GetOwningArena() != nullptr
+  #endif  // !PROTOBUF_FORCE_COPY_IN_MOVE
+    ) {
+      InternalSwap(&from);
+    } else {
+      CopyFrom(from);
+    }
+    return *this;
+  }
 
-  // implements Service ----------------------------------------------
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* descriptor() {
+    return GetDescriptor();
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* GetDescriptor() {
+    return default_instance().GetMetadata().descriptor;
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Reflection* GetReflection() {
+    return default_instance().GetMetadata().reflection;
+  }
+  static const GetPagesRequest& default_instance() {
+    return *internal_default_instance();
+  }
+  static inline const GetPagesRequest* internal_default_instance() {
+    return reinterpret_cast<const GetPagesRequest*>(
+               &_GetPagesRequest_default_instance_);
+  }
+  static constexpr int kIndexInFileMessages =
+    5;
 
-  const ::PROTOBUF_NAMESPACE_ID::ServiceDescriptor* GetDescriptor();
-  void CallMethod(const ::PROTOBUF_NAMESPACE_ID::MethodDescriptor* method,
-                  ::PROTOBUF_NAMESPACE_ID::RpcController* controller,
-                  const ::PROTOBUF_NAMESPACE_ID::Message* request,
-                  ::PROTOBUF_NAMESPACE_ID::Message* response,
-                  ::google::protobuf::Closure* done);
-  const ::PROTOBUF_NAMESPACE_ID::Message& GetRequestPrototype(
-    const ::PROTOBUF_NAMESPACE_ID::MethodDescriptor* method) const;
-  const ::PROTOBUF_NAMESPACE_ID::Message& GetResponsePrototype(
-    const ::PROTOBUF_NAMESPACE_ID::MethodDescriptor* method) const;
+  friend void swap(GetPagesRequest& a, GetPagesRequest& b) {
+    a.Swap(&b);
+  }
+  inline void Swap(GetPagesRequest* other) {
+    if (other == this) return;
+  #ifdef PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() != nullptr &&
+        GetOwningArena() == other->GetOwningArena()) {
+   #else  // PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() == other->GetOwningArena()) {
+  #endif  // !PROTOBUF_FORCE_COPY_IN_SWAP
+      InternalSwap(other);
+    } else {
+      ::PROTOBUF_NAMESPACE_ID::internal::GenericSwap(this, other);
+    }
+  }
+  void UnsafeArenaSwap(GetPagesRequest* other) {
+    if (other == this) return;
+    GOOGLE_DCHECK(GetOwningArena() == other->GetOwningArena());
+    InternalSwap(other);
+  }
 
- private:
-  GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(StorageService);
-};
+  // implements Message ----------------------------------------------
 
-class StorageService_Stub : public StorageService {
- public:
-  StorageService_Stub(::PROTOBUF_NAMESPACE_ID::RpcChannel* channel);
-  StorageService_Stub(::PROTOBUF_NAMESPACE_ID::RpcChannel* channel,
-                   ::PROTOBUF_NAMESPACE_ID::Service::ChannelOwnership ownership);
-  ~StorageService_Stub();
+  GetPagesRequest* New(::PROTOBUF_NAMESPACE_ID::Arena* arena = nullptr) const final {
+    return CreateMaybeMessage<GetPagesRequest>(arena);
+  }
+  using ::PROTOBUF_NAMESPACE_ID::Message::CopyFrom;
+  void CopyFrom(const GetPagesRequest& from);
+  using ::PROTOBUF_NAMESPACE_ID::Message::MergeFrom;
+  void MergeFrom( const GetPagesRequest& from) {
+    GetPagesRequest::MergeImpl(*this, from);
+  }
+  private:
+  static void MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg);
+  public:
+  PROTOBUF_ATTRIBUTE_REINITIALIZES void Clear() final;
+  bool IsInitialized() const final;
 
-  inline ::PROTOBUF_NAMESPACE_ID::RpcChannel* channel() { return channel_; }
+  size_t ByteSizeLong() const final;
+  const char* _InternalParse(const char* ptr, ::PROTOBUF_NAMESPACE_ID::internal::ParseContext* ctx) final;
+  uint8_t* _InternalSerialize(
+      uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const final;
+  int GetCachedSize() const final { return _impl_._cached_size_.Get(); }
 
-  // implements StorageService ------------------------------------------
+  private:
+  void SharedCtor(::PROTOBUF_NAMESPACE_ID::Arena* arena, bool is_message_owned);
+  void SharedDtor();
+  void SetCachedSize(int size) const final;
+  void InternalSwap(GetPagesRequest* other);
 
-  void LogWrite(::PROTOBUF_NAMESPACE_ID::RpcController* controller,
-                       const ::storage_service::LogWriteRequest* request,
-                       ::storage_service::LogWriteResponse* response,
-                       ::google::protobuf::Closure* done);
-  void GetPage(::PROTOBUF_NAMESPACE_ID::RpcController* controller,
-                       const ::storage_service::GetPageRequest* request,
-                       ::storage_service::GetPageResponse* response,
-                       ::google::protobuf::Closure* done);
- private:
-  ::PROTOBUF_NAMESPACE_ID::RpcChannel* channel_;
-  bool owns_channel_;
-  GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(StorageService_Stub);
-};
+  private:
+  friend class ::PROTOBUF_NAMESPACE_ID::internal::AnyMetadata;
+  static ::PROTOBUF_NAMESPACE_ID::StringPiece FullMessageName() {
+    return "storage_service.GetPagesRequest";
+  }
+  protected:
+  explicit GetPagesRequest(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                       bool is_message_owned = false);
+  public:
 
+  static const ClassData _class_data_;
+  const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*GetClassData() const final;
 
-// ===================================================================
+  ::PROTOBUF_NAMESPACE_ID::Metadata GetMetadata() const final;
 
+  // nested types ----------------------------------------------------
 
-// ===================================================================
+  // accessors -------------------------------------------------------
 
-#ifdef __GNUC__
-  #pragma GCC diagnostic push
-  #pragma GCC diagnostic ignored "-Wstrict-aliasing"
-#endif  // __GNUC__
-// LogWriteRequest
+  enum : int {
+    kPageIdsFieldNumber = 1,
+    kRequireBatchIdFieldNumber = 2,
+    kReadAheadFieldNumber = 3,
+  };
+  // repeated .storage_service.GetPageRequest.PageID page_ids = 1;
+  int page_ids_size() const;
+  private:
+  int _internal_page_ids_size() const;
+  public:
+  void clear_page_ids();
+  ::storage_service::GetPageRequest_PageID* mutable_page_ids(int index);
+  ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::storage_service::GetPageRequest_PageID >*
+      mutable_page_ids();
+  private:
+  const ::storage_service::GetPageRequest_PageID& _internal_page_ids(int index) const;
+  ::storage_service::GetPageRequest_PageID* _internal_add_page_ids();
+  public:
+  const ::storage_service::GetPageRequest_PageID& page_ids(int index) const;
+  ::storage_service::GetPageRequest_PageID* add_page_ids();
+  const ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::storage_service::GetPageRequest_PageID >&
+      page_ids() const;
 
-// bytes log = 1;
-inline void LogWriteRequest::clear_log() {
-  log_.ClearToEmpty();
-}
-inline const std::string& LogWriteRequest::log() const {
-  // @@protoc_insertion_point(field_get:storage_service.LogWriteRequest.log)
-  return _internal_log();
-}
-template <typename ArgT0, typename... ArgT>
-inline PROTOBUF_ALWAYS_INLINE
-void LogWriteRequest::set_log(ArgT0&& arg0, ArgT... args) {
- 
- log_.SetBytes(static_cast<ArgT0 &&>(arg0), args..., GetArenaForAllocation());
-  // @@protoc_insertion_point(field_set:storage_service.LogWriteRequest.log)
-}
-inline std::string* LogWriteRequest::mutable_log() {
-  std::string* _s = _internal_mutable_log();
-  // @@protoc_insertion_point(field_mutable:storage_service.LogWriteRequest.log)
-  return _s;
-}
-inline const std::string& LogWriteRequest::_internal_log() const {
-  return log_.Get();
-}
-inline void LogWriteRequest::_internal_set_log(const std::string& value) {
-  
-  log_.Set(value, GetArenaForAllocation());
-}
-inline std::string* LogWriteRequest::_internal_mutable_log() {
-  
-  return log_.Mutable(GetArenaForAllocation());
-}
-inline std::string* LogWriteRequest::release_log() {
-  // @@protoc_insertion_point(field_release:storage_service.LogWriteRequest.log)
-  return log_.Release();
-}
-inline void LogWriteRequest::set_allocated_log(std::string* log) {
-  if (log != nullptr) {
-    
-  } else {
-    
-  }
-  log_.SetAllocated(log, GetArenaForAllocation());
-#ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
-  if (log_.IsDefault()) {
-    log_.Set("", GetArenaForAllocation());
-  }
-#endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
-  // @@protoc_insertion_point(field_set_allocated:storage_service.LogWriteRequest.log)
-}
+  // uint64 require_batch_id = 2;
+  void clear_require_batch_id();
+  uint64_t require_batch_id() const;
+  void set_require_batch_id(uint64_t value);
+  private:
+  uint64_t _internal_require_batch_id() const;
+  void _internal_set_require_batch_id(uint64_t value);
+  public:
 
-// -------------------------------------------------------------------
+  // bool read_ahead = 3;
+  void clear_read_ahead();
+  bool read_ahead() const;
+  void set_read_ahead(bool value);
+  private:
+  bool _internal_read_ahead() const;
+  void _internal_set_read_ahead(bool value);
+  public:
 
-// LogWriteResponse
+  // @@protoc_insertion_point(class_scope:storage_service.GetPagesRequest)
+ private:
+  class _Internal;
 
+  template <typename T> friend class ::PROTOBUF_NAMESPACE_ID::Arena::InternalHelper;
+  typedef void InternalArenaConstructable_;
+  typedef void DestructorSkippable_;
+  struct Impl_ {
+    ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::storage_service::GetPageRequest_PageID > page_ids_;
+    uint64_t require_batch_id_;
+    bool read_ahead_;
+    mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
+  };
+  union { Impl_ _impl_; };
+  friend struct ::TableStruct_storage_5fservice_2eproto;
+};
 // -------------------------------------------------------------------
 
-// GetPageRequest_PageID
+class GetPagesResponse final :
+    public ::PROTOBUF_NAMESPACE_ID::Message /* @@protoc_insertion_point(class_definition:storage_service.GetPagesResponse) */ {
+ public:
+  inline GetPagesResponse() : GetPagesResponse(nullptr) {}
+  ~GetPagesResponse() override;
+  explicit PROTOBUF_CONSTEXPR GetPagesResponse(::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized);
 
-// string table_name = 1;
-inline void GetPageRequest_PageID::clear_table_name() {
-  table_name_.ClearToEmpty();
-}
-inline const std::string& GetPageRequest_PageID::table_name() const {
-  // @@protoc_insertion_point(field_get:storage_service.GetPageRequest.PageID.table_name)
-  return _internal_table_name();
-}
-template <typename ArgT0, typename... ArgT>
-inline PROTOBUF_ALWAYS_INLINE
-void GetPageRequest_PageID::set_table_name(ArgT0&& arg0, ArgT... args) {
- 
- table_name_.Set(static_cast<ArgT0 &&>(arg0), args..., GetArenaForAllocation());
-  // @@protoc_insertion_point(field_set:storage_service.GetPageRequest.PageID.table_name)
-}
-inline std::string* GetPageRequest_PageID::mutable_table_name() {
-  std::string* _s = _internal_mutable_table_name();
-  // @@protoc_insertion_point(field_mutable:storage_service.GetPageRequest.PageID.table_name)
-  return _s;
-}
-inline const std::string& GetPageRequest_PageID::_internal_table_name() const {
-  return table_name_.Get();
-}
-inline void GetPageRequest_PageID::_internal_set_table_name(const std::string& value) {
-  
-  table_name_.Set(value, GetArenaForAllocation());
-}
-inline std::string* GetPageRequest_PageID::_internal_mutable_table_name() {
-  
-  return table_name_.Mutable(GetArenaForAllocation());
-}
-inline std::string* GetPageRequest_PageID::release_table_name() {
-  // @@protoc_insertion_point(field_release:storage_service.GetPageRequest.PageID.table_name)
-  return table_name_.Release();
-}
-inline void GetPageRequest_PageID::set_allocated_table_name(std::string* table_name) {
-  if (table_name != nullptr) {
-    
-  } else {
-    
-  }
-  table_name_.SetAllocated(table_name, GetArenaForAllocation());
-#ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
-  if (table_name_.IsDefault()) {
-    table_name_.Set("", GetArenaForAllocation());
+  GetPagesResponse(const GetPagesResponse& from);
+  GetPagesResponse(GetPagesResponse&& from) noexcept
+    : GetPagesResponse() {
+    *this = ::std::move(from);
   }
-#endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
-  // @@protoc_insertion_point(field_set_allocated:storage_service.GetPageRequest.PageID.table_name)
-}
+
+  inline GetPagesResponse& operator=(const GetPagesResponse& from) {
+    CopyFrom(from);
+    return *this;
+  }
+  inline GetPagesResponse& operator=(GetPagesResponse&& from) noexcept {
+    if (this == &from) return *this;
+    if (GetOwningArena() == from.GetOwningArena()
+  #ifdef PROTOBUF_FORCE_COPY_IN_MOVE
+        && GetOwningArena() != nullptr
+  #endif  // !PROTOBUF_FORCE_COPY_IN_MOVE
+    ) {
+      InternalSwap(&from);
+    } else {
+      CopyFrom(from);
+    }
+    return *this;
+  }
+
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* descriptor() {
+    return GetDescriptor();
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* GetDescriptor() {
+    return default_instance().GetMetadata().descriptor;
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Reflection* GetReflection() {
+    return default_instance().GetMetadata().reflection;
+  }
+  static const GetPagesResponse& default_instance() {
+    return *internal_default_instance();
+  }
+  static inline const GetPagesResponse* internal_default_instance() {
+    return reinterpret_cast<const GetPagesResponse*>(
+               &_GetPagesResponse_default_instance_);
+  }
+  static constexpr int kIndexInFileMessages =
+    6;
+
+  friend void swap(GetPagesResponse& a, GetPagesResponse& b) {
+    a.Swap(&b);
+  }
+  inline void Swap(GetPagesResponse* other) {
+    if (other == this) return;
+  #ifdef PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() != nullptr &&
+        GetOwningArena() == other->GetOwningArena()) {
+   #else  // PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() == other->GetOwningArena()) {
+  #endif  // !PROTOBUF_FORCE_COPY_IN_SWAP
+      InternalSwap(other);
+    } else {
+      ::PROTOBUF_NAMESPACE_ID::internal::GenericSwap(this, other);
+    }
+  }
+  void UnsafeArenaSwap(GetPagesResponse* other) {
+    if (other == this) return;
+    GOOGLE_DCHECK(GetOwningArena() == other->GetOwningArena());
+    InternalSwap(other);
+  }
+
+  // implements Message ----------------------------------------------
+
+  GetPagesResponse* New(::PROTOBUF_NAMESPACE_ID::Arena* arena = nullptr) const final {
+    return CreateMaybeMessage<GetPagesResponse>(arena);
+  }
+  using ::PROTOBUF_NAMESPACE_ID::Message::CopyFrom;
+  void CopyFrom(const GetPagesResponse& from);
+  using ::PROTOBUF_NAMESPACE_ID::Message::MergeFrom;
+  void MergeFrom( const GetPagesResponse& from) {
+    GetPagesResponse::MergeImpl(*this, from);
+  }
+  private:
+  static void MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg);
+  public:
+  PROTOBUF_ATTRIBUTE_REINITIALIZES void Clear() final;
+  bool IsInitialized() const final;
+
+  size_t ByteSizeLong() const final;
+  const char* _InternalParse(const char* ptr, ::PROTOBUF_NAMESPACE_ID::internal::ParseContext* ctx) final;
+  uint8_t* _InternalSerialize(
+      uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const final;
+  int GetCachedSize() const final { return _impl_._cached_size_.Get(); }
+
+  private:
+  void SharedCtor(::PROTOBUF_NAMESPACE_ID::Arena* arena, bool is_message_owned);
+  void SharedDtor();
+  void SetCachedSize(int size) const final;
+  void InternalSwap(GetPagesResponse* other);
+
+  private:
+  friend class ::PROTOBUF_NAMESPACE_ID::internal::AnyMetadata;
+  static ::PROTOBUF_NAMESPACE_ID::StringPiece FullMessageName() {
+    return "storage_service.GetPagesResponse";
+  }
+  protected:
+  explicit GetPagesResponse(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                       bool is_message_owned = false);
+  public:
+
+  static const ClassData _class_data_;
+  const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*GetClassData() const final;
+
+  ::PROTOBUF_NAMESPACE_ID::Metadata GetMetadata() const final;
+
+  // nested types ----------------------------------------------------
+
+  // accessors -------------------------------------------------------
+
+  enum : int {
+    kPageExistsFieldNumber = 2,
+    kDataFieldNumber = 1,
+  };
+  // repeated bool page_exists = 2;
+  int page_exists_size() const;
+  private:
+  int _internal_page_exists_size() const;
+  public:
+  void clear_page_exists();
+  private:
+  bool _internal_page_exists(int index) const;
+  const ::PROTOBUF_NAMESPACE_ID::RepeatedField< bool >&
+      _internal_page_exists() const;
+  void _internal_add_page_exists(bool value);
+  ::PROTOBUF_NAMESPACE_ID::RepeatedField< bool >*
+      _internal_mutable_page_exists();
+  public:
+  bool page_exists(int index) const;
+  void set_page_exists(int index, bool value);
+  void add_page_exists(bool value);
+  const ::PROTOBUF_NAMESPACE_ID::RepeatedField< bool >&
+      page_exists() const;
+  ::PROTOBUF_NAMESPACE_ID::RepeatedField< bool >*
+      mutable_page_exists();
+
+  // bytes data = 1;
+  void clear_data();
+  const std::string& data() const;
+  template <typename ArgT0 = const std::string&, typename... ArgT>
+  void set_data(ArgT0&& arg0, ArgT... args);
+  std::string* mutable_data();
+  PROTOBUF_NODISCARD std::string* release_data();
+  void set_allocated_data(std::string* data);
+  private:
+  const std::string& _internal_data() const;
+  inline PROTOBUF_ALWAYS_INLINE void _internal_set_data(const std::string& value);
+  std::string* _internal_mutable_data();
+  public:
+
+  // @@protoc_insertion_point(class_scope:storage_service.GetPagesResponse)
+ private:
+  class _Internal;
+
+  template <typename T> friend class ::PROTOBUF_NAMESPACE_ID::Arena::InternalHelper;
+  typedef void InternalArenaConstructable_;
+  typedef void DestructorSkippable_;
+  struct Impl_ {
+    ::PROTOBUF_NAMESPACE_ID::RepeatedField< bool > page_exists_;
+    ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr data_;
+    mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
+  };
+  union { Impl_ _impl_; };
+  friend struct ::TableStruct_storage_5fservice_2eproto;
+};
+// -------------------------------------------------------------------
+
+class GetPersistBatchIdRequest final :
+    public ::PROTOBUF_NAMESPACE_ID::internal::ZeroFieldsBase /* @@protoc_insertion_point(class_definition:storage_service.GetPersistBatchIdRequest) */ {
+ public:
+  inline GetPersistBatchIdRequest() : GetPersistBatchIdRequest(nullptr) {}
+  explicit PROTOBUF_CONSTEXPR GetPersistBatchIdRequest(::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized);
+
+  GetPersistBatchIdRequest(const GetPersistBatchIdRequest& from);
+  GetPersistBatchIdRequest(GetPersistBatchIdRequest&& from) noexcept
+    : GetPersistBatchIdRequest() {
+    *this = ::std::move(from);
+  }
+
+  inline GetPersistBatchIdRequest& operator=(const GetPersistBatchIdRequest& from) {
+    CopyFrom(from);
+    return *this;
+  }
+  inline GetPersistBatchIdRequest& operator=(GetPersistBatchIdRequest&& from) noexcept {
+    if (this == &from) return *this;
+    if (GetOwningArena() == from.GetOwningArena()
+  #ifdef PROTOBUF_FORCE_COPY_IN_MOVE
+        && GetOwningArena() != nullptr
+  #endif  // !PROTOBUF_FORCE_COPY_IN_MOVE
+    ) {
+      InternalSwap(&from);
+    } else {
+      CopyFrom(from);
+    }
+    return *this;
+  }
+
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* descriptor() {
+    return GetDescriptor();
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* GetDescriptor() {
+    return default_instance().GetMetadata().descriptor;
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Reflection* GetReflection() {
+    return default_instance().GetMetadata().reflection;
+  }
+  static const GetPersistBatchIdRequest& default_instance() {
+    return *internal_default_instance();
+  }
+  static inline const GetPersistBatchIdRequest* internal_default_instance() {
+    return reinterpret_cast<const GetPersistBatchIdRequest*>(
+               &_GetPersistBatchIdRequest_default_instance_);
+  }
+  static constexpr int kIndexInFileMessages =
+    7;
+
+  friend void swap(GetPersistBatchIdRequest& a, GetPersistBatchIdRequest& b) {
+    a.Swap(&b);
+  }
+  inline void Swap(GetPersistBatchIdRequest* other) {
+    if (other == this) return;
+  #ifdef PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() != nullptr &&
+        GetOwningArena() == other->GetOwningArena()) {
+   #else  // PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() == other->GetOwningArena()) {
+  #endif  // !PROTOBUF_FORCE_COPY_IN_SWAP
+      InternalSwap(other);
+    } else {
+      ::PROTOBUF_NAMESPACE_ID::internal::GenericSwap(this, other);
+    }
+  }
+  void UnsafeArenaSwap(GetPersistBatchIdRequest* other) {
+    if (other == this) return;
+    GOOGLE_DCHECK(GetOwningArena() == other->GetOwningArena());
+    InternalSwap(other);
+  }
+
+  // implements Message ----------------------------------------------
+
+  GetPersistBatchIdRequest* New(::PROTOBUF_NAMESPACE_ID::Arena* arena = nullptr) const final {
+    return CreateMaybeMessage<GetPersistBatchIdRequest>(arena);
+  }
+  using ::PROTOBUF_NAMESPACE_ID::internal::ZeroFieldsBase::CopyFrom;
+  inline void CopyFrom(const GetPersistBatchIdRequest& from) {
+    ::PROTOBUF_NAMESPACE_ID::internal::ZeroFieldsBase::CopyImpl(*this, from);
+  }
+  using ::PROTOBUF_NAMESPACE_ID::internal::ZeroFieldsBase::MergeFrom;
+  void MergeFrom(const GetPersistBatchIdRequest& from) {
+    ::PROTOBUF_NAMESPACE_ID::internal::ZeroFieldsBase::MergeImpl(*this, from);
+  }
+  public:
+
+  private:
+  friend class ::PROTOBUF_NAMESPACE_ID::internal::AnyMetadata;
+  static ::PROTOBUF_NAMESPACE_ID::StringPiece FullMessageName() {
+    return "storage_service.GetPersistBatchIdRequest";
+  }
+  protected:
+  explicit GetPersistBatchIdRequest(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                       bool is_message_owned = false);
+  public:
+
+  static const ClassData _class_data_;
+  const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*GetClassData() const final;
+
+  ::PROTOBUF_NAMESPACE_ID::Metadata GetMetadata() const final;
+
+  // nested types ----------------------------------------------------
+
+  // accessors -------------------------------------------------------
+
+  // @@protoc_insertion_point(class_scope:storage_service.GetPersistBatchIdRequest)
+ private:
+  class _Internal;
+
+  template <typename T> friend class ::PROTOBUF_NAMESPACE_ID::Arena::InternalHelper;
+  typedef void InternalArenaConstructable_;
+  typedef void DestructorSkippable_;
+  struct Impl_ {
+  };
+  friend struct ::TableStruct_storage_5fservice_2eproto;
+};
+// -------------------------------------------------------------------
+
+class GetPersistBatchIdResponse final :
+    public ::PROTOBUF_NAMESPACE_ID::Message /* @@protoc_insertion_point(class_definition:storage_service.GetPersistBatchIdResponse) */ {
+ public:
+  inline GetPersistBatchIdResponse() : GetPersistBatchIdResponse(nullptr) {}
+  ~GetPersistBatchIdResponse() override;
+  explicit PROTOBUF_CONSTEXPR GetPersistBatchIdResponse(::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized);
+
+  GetPersistBatchIdResponse(const GetPersistBatchIdResponse& from);
+  GetPersistBatchIdResponse(GetPersistBatchIdResponse&& from) noexcept
+    : GetPersistBatchIdResponse() {
+    *this = ::std::move(from);
+  }
+
+  inline GetPersistBatchIdResponse& operator=(const GetPersistBatchIdResponse& from) {
+    CopyFrom(from);
+    return *this;
+  }
+  inline GetPersistBatchIdResponse& operator=(GetPersistBatchIdResponse&& from) noexcept {
+    if (this == &from) return *this;
+    if (GetOwningArena() == from.GetOwningArena()
+  #ifdef PROTOBUF_FORCE_COPY_IN_MOVE
+        && GetOwningArena() != nullptr
+  #endif  // !PROTOBUF_FORCE_COPY_IN_MOVE
+    ) {
+      InternalSwap(&from);
+    } else {
+      CopyFrom(from);
+    }
+    return *this;
+  }
+
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* descriptor() {
+    return GetDescriptor();
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* GetDescriptor() {
+    return default_instance().GetMetadata().descriptor;
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Reflection* GetReflection() {
+    return default_instance().GetMetadata().reflection;
+  }
+  static const GetPersistBatchIdResponse& default_instance() {
+    return *internal_default_instance();
+  }
+  static inline const GetPersistBatchIdResponse* internal_default_instance() {
+    return reinterpret_cast<const GetPersistBatchIdResponse*>(
+               &_GetPersistBatchIdResponse_default_instance_);
+  }
+  static constexpr int kIndexInFileMessages =
+    8;
+
+  friend void swap(GetPersistBatchIdResponse& a, GetPersistBatchIdResponse& b) {
+    a.Swap(&b);
+  }
+  inline void Swap(GetPersistBatchIdResponse* other) {
+    if (other == this) return;
+  #ifdef PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() != nullptr &&
+        GetOwningArena() == other->GetOwningArena()) {
+   #else  // PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() == other->GetOwningArena()) {
+  #endif  // !PROTOBUF_FORCE_COPY_IN_SWAP
+      InternalSwap(other);
+    } else {
+      ::PROTOBUF_NAMESPACE_ID::internal::GenericSwap(this, other);
+    }
+  }
+  void UnsafeArenaSwap(GetPersistBatchIdResponse* other) {
+    if (other == this) return;
+    GOOGLE_DCHECK(GetOwningArena() == other->GetOwningArena());
+    InternalSwap(other);
+  }
+
+  // implements Message ----------------------------------------------
+
+  GetPersistBatchIdResponse* New(::PROTOBUF_NAMESPACE_ID::Arena* arena = nullptr) const final {
+    return CreateMaybeMessage<GetPersistBatchIdResponse>(arena);
+  }
+  using ::PROTOBUF_NAMESPACE_ID::Message::CopyFrom;
+  void CopyFrom(const GetPersistBatchIdResponse& from);
+  using ::PROTOBUF_NAMESPACE_ID::Message::MergeFrom;
+  void MergeFrom( const GetPersistBatchIdResponse& from) {
+    GetPersistBatchIdResponse::MergeImpl(*this, from);
+  }
+  private:
+  static void MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg);
+  public:
+  PROTOBUF_ATTRIBUTE_REINITIALIZES void Clear() final;
+  bool IsInitialized() const final;
+
+  size_t ByteSizeLong() const final;
+  const char* _InternalParse(const char* ptr, ::PROTOBUF_NAMESPACE_ID::internal::ParseContext* ctx) final;
+  uint8_t* _InternalSerialize(
+      uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const final;
+  int GetCachedSize() const final { return _impl_._cached_size_.Get(); }
+
+  private:
+  void SharedCtor(::PROTOBUF_NAMESPACE_ID::Arena* arena, bool is_message_owned);
+  void SharedDtor();
+  void SetCachedSize(int size) const final;
+  void InternalSwap(GetPersistBatchIdResponse* other);
+
+  private:
+  friend class ::PROTOBUF_NAMESPACE_ID::internal::AnyMetadata;
+  static ::PROTOBUF_NAMESPACE_ID::StringPiece FullMessageName() {
+    return "storage_service.GetPersistBatchIdResponse";
+  }
+  protected:
+  explicit GetPersistBatchIdResponse(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                       bool is_message_owned = false);
+  public:
+
+  static const ClassData _class_data_;
+  const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*GetClassData() const final;
+
+  ::PROTOBUF_NAMESPACE_ID::Metadata GetMetadata() const final;
+
+  // nested types ----------------------------------------------------
+
+  // accessors -------------------------------------------------------
+
+  enum : int {
+    kPersistBatchIdFieldNumber = 1,
+  };
+  // uint64 persist_batch_id = 1;
+  void clear_persist_batch_id();
+  uint64_t persist_batch_id() const;
+  void set_persist_batch_id(uint64_t value);
+  private:
+  uint64_t _internal_persist_batch_id() const;
+  void _internal_set_persist_batch_id(uint64_t value);
+  public:
+
+  // @@protoc_insertion_point(class_scope:storage_service.GetPersistBatchIdResponse)
+ private:
+  class _Internal;
+
+  template <typename T> friend class ::PROTOBUF_NAMESPACE_ID::Arena::InternalHelper;
+  typedef void InternalArenaConstructable_;
+  typedef void DestructorSkippable_;
+  struct Impl_ {
+    uint64_t persist_batch_id_;
+    mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
+  };
+  union { Impl_ _impl_; };
+  friend struct ::TableStruct_storage_5fservice_2eproto;
+};
+// ===================================================================
+
+class StorageService_Stub;
+
+class StorageService : public ::PROTOBUF_NAMESPACE_ID::Service {
+ protected:
+  // This class should be treated as an abstract interface.
+  inline StorageService() {};
+ public:
+  virtual ~StorageService();
+
+  typedef StorageService_Stub Stub;
+
+  static const ::PROTOBUF_NAMESPACE_ID::ServiceDescriptor* descriptor();
+
+  virtual void LogWrite(::PROTOBUF_NAMESPACE_ID::RpcController* controller,
+                       const ::storage_service::LogWriteRequest* request,
+                       ::storage_service::LogWriteResponse* response,
+                       ::google::protobuf::Closure* done);
+  virtual void GetPage(::PROTOBUF_NAMESPACE_ID::RpcController* controller,
+                       const ::storage_service::GetPageRequest* request,
+                       ::storage_service::GetPageResponse* response,
+                       ::google::protobuf::Closure* done);
+  virtual void GetPages(::PROTOBUF_NAMESPACE_ID::RpcController* controller,
+                       const ::storage_service::GetPagesRequest* request,
+                       ::storage_service::GetPagesResponse* response,
+                       ::google::protobuf::Closure* done);
+  virtual void GetPersistBatchId(::PROTOBUF_NAMESPACE_ID::RpcController* controller,
+                       const ::storage_service::GetPersistBatchIdRequest* request,
+                       ::storage_service::GetPersistBatchIdResponse* response,
+                       ::google::protobuf::Closure* done);
+
+  // implements Service ----------------------------------------------
+
+  const ::PROTOBUF_NAMESPACE_ID::ServiceDescriptor* GetDescriptor();
+  void CallMethod(const ::PROTOBUF_NAMESPACE_ID::MethodDescriptor* method,
+                  ::PROTOBUF_NAMESPACE_ID::RpcController* controller,
+                  const ::PROTOBUF_NAMESPACE_ID::Message* request,
+                  ::PROTOBUF_NAMESPACE_ID::Message* response,
+                  ::google::protobuf::Closure* done);
+  const ::PROTOBUF_NAMESPACE_ID::Message& GetRequestPrototype(
+    const ::PROTOBUF_NAMESPACE_ID::MethodDescriptor* method) const;
+  const ::PROTOBUF_NAMESPACE_ID::Message& GetResponsePrototype(
+    const ::PROTOBUF_NAMESPACE_ID::MethodDescriptor* method) const;
+
+ private:
+  GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(StorageService);
+};
+
+class StorageService_Stub : public StorageService {
+ public:
+  StorageService_Stub(::PROTOBUF_NAMESPACE_ID::RpcChannel* channel);
+  StorageService_Stub(::PROTOBUF_NAMESPACE_ID::RpcChannel* channel,
+                   ::PROTOBUF_NAMESPACE_ID::Service::ChannelOwnership ownership);
+  ~StorageService_Stub();
+
+  inline ::PROTOBUF_NAMESPACE_ID::RpcChannel* channel() { return channel_; }
+
+  // implements StorageService ------------------------------------------
+
+  void LogWrite(::PROTOBUF_NAMESPACE_ID::RpcController* controller,
+                       const ::storage_service::LogWriteRequest* request,
+                       ::storage_service::LogWriteResponse* response,
+                       ::google::protobuf::Closure* done);
+  void GetPage(::PROTOBUF_NAMESPACE_ID::RpcController* controller,
+                       const ::storage_service::GetPageRequest* request,
+                       ::storage_service::GetPageResponse* response,
+                       ::google::protobuf::Closure* done);
+  void GetPages(::PROTOBUF_NAMESPACE_ID::RpcController* controller,
+                       const ::storage_service::GetPagesRequest* request,
+                       ::storage_service::GetPagesResponse* response,
+                       ::google::protobuf::Closure* done);
+  void GetPersistBatchId(::PROTOBUF_NAMESPACE_ID::RpcController* controller,
+                       const ::storage_service::GetPersistBatchIdRequest* request,
+                       ::storage_service::GetPersistBatchIdResponse* response,
+                       ::google::protobuf::Closure* done);
+ private:
+  ::PROTOBUF_NAMESPACE_ID::RpcChannel* channel_;
+  bool owns_channel_;
+  GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(StorageService_Stub);
+};
+
+
+// ===================================================================
+
+
+// ===================================================================
+
+#ifdef __GNUC__
+  #pragma GCC diagnostic push
+  #pragma GCC diagnostic ignored "-Wstrict-aliasing"
+#endif  // __GNUC__
+// LogWriteRequest
+
+// bytes log = 1;
+inline void LogWriteRequest::clear_log() {
+  _impl_.log_.ClearToEmpty();
+}
+inline const std::string& LogWriteRequest::log() const {
+  // @@protoc_insertion_point(field_get:storage_service.LogWriteRequest.log)
+  return _internal_log();
+}
+template <typename ArgT0, typename... ArgT>
+inline PROTOBUF_ALWAYS_INLINE
+void LogWriteRequest::set_log(ArgT0&& arg0, ArgT... args) {
+ 
+ _impl_.log_.SetBytes(static_cast<ArgT0 &&>(arg0), args..., GetArenaForAllocation());
+  // @@protoc_insertion_point(field_set:storage_service.LogWriteRequest.log)
+}
+inline std::string* LogWriteRequest::mutable_log() {
+  std::string* _s = _internal_mutable_log();
+  // @@protoc_insertion_point(field_mutable:storage_service.LogWriteRequest.log)
+  return _s;
+}
+inline const std::string& LogWriteRequest::_internal_log() const {
+  return _impl_.log_.Get();
+}
+inline void LogWriteRequest::_internal_set_log(const std::string& value) {
+  
+  _impl_.log_.Set(value, GetArenaForAllocation());
+}
+inline std::string* LogWriteRequest::_internal_mutable_log() {
+  
+  return _impl_.log_.Mutable(GetArenaForAllocation());
+}
+inline std::string* LogWriteRequest::release_log() {
+  // @@protoc_insertion_point(field_release:storage_service.LogWriteRequest.log)
+  return _impl_.log_.Release();
+}
+inline void LogWriteRequest::set_allocated_log(std::string* log) {
+  if (log != nullptr) {
+    
+  } else {
+    
+  }
+  _impl_.log_.SetAllocated(log, GetArenaForAllocation());
+#ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (_impl_.log_.IsDefault()) {
+    _impl_.log_.Set("", GetArenaForAllocation());
+  }
+#endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  // @@protoc_insertion_point(field_set_allocated:storage_service.LogWriteRequest.log)
+}
+
+// -------------------------------------------------------------------
+
+// LogWriteResponse
+
+// -------------------------------------------------------------------
+
+// GetPageRequest_PageID
+
+// string table_name = 1;
+inline void GetPageRequest_PageID::clear_table_name() {
+  _impl_.table_name_.ClearToEmpty();
+}
+inline const std::string& GetPageRequest_PageID::table_name() const {
+  // @@protoc_insertion_point(field_get:storage_service.GetPageRequest.PageID.table_name)
+  return _internal_table_name();
+}
+template <typename ArgT0, typename... ArgT>
+inline PROTOBUF_ALWAYS_INLINE
+void GetPageRequest_PageID::set_table_name(ArgT0&& arg0, ArgT... args) {
+ 
+ _impl_.table_name_.Set(static_cast<ArgT0 &&>(arg0), args..., GetArenaForAllocation());
+  // @@protoc_insertion_point(field_set:storage_service.GetPageRequest.PageID.table_name)
+}
+inline std::string* GetPageRequest_PageID::mutable_table_name() {
+  std::string* _s = _internal_mutable_table_name();
+  // @@protoc_insertion_point(field_mutable:storage_service.GetPageRequest.PageID.table_name)
+  return _s;
+}
+inline const std::string& GetPageRequest_PageID::_internal_table_name() const {
+  return _impl_.table_name_.Get();
+}
+inline void GetPageRequest_PageID::_internal_set_table_name(const std::string& value) {
+  
+  _impl_.table_name_.Set(value, GetArenaForAllocation());
+}
+inline std::string* GetPageRequest_PageID::_internal_mutable_table_name() {
+  
+  return _impl_.table_name_.Mutable(GetArenaForAllocation());
+}
+inline std::string* GetPageRequest_PageID::release_table_name() {
+  // @@protoc_insertion_point(field_release:storage_service.GetPageRequest.PageID.table_name)
+  return _impl_.table_name_.Release();
+}
+inline void GetPageRequest_PageID::set_allocated_table_name(std::string* table_name) {
+  if (table_name != nullptr) {
+    
+  } else {
+    
+  }
+  _impl_.table_name_.SetAllocated(table_name, GetArenaForAllocation());
+#ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (_impl_.table_name_.IsDefault()) {
+    _impl_.table_name_.Set("", GetArenaForAllocation());
+  }
+#endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  // @@protoc_insertion_point(field_set_allocated:storage_service.GetPageRequest.PageID.table_name)
+}
 
 // sint32 page_no = 2;
 inline void GetPageRequest_PageID::clear_page_no() {
-  page_no_ = 0;
+  _impl_.page_no_ = 0;
 }
 inline int32_t GetPageRequest_PageID::_internal_page_no() const {
-  return page_no_;
+  return _impl_.page_no_;
 }
 inline int32_t GetPageRequest_PageID::page_no() const {
   // @@protoc_insertion_point(field_get:storage_service.GetPageRequest.PageID.page_no)
@@ -1007,7 +1683,7 @@ inline int32_t GetPageRequest_PageID::page_no() const {
 }
 inline void GetPageRequest_PageID::_internal_set_page_no(int32_t value) {
   
-  page_no_ = value;
+  _impl_.page_no_ = value;
 }
 inline void GetPageRequest_PageID::set_page_no(int32_t value) {
   _internal_set_page_no(value);
@@ -1020,19 +1696,19 @@ inline void GetPageRequest_PageID::set_page_no(int32_t value) {
 
 // .storage_service.GetPageRequest.PageID page_id = 1;
 inline bool GetPageRequest::_internal_has_page_id() const {
-  return this != internal_default_instance() && page_id_ != nullptr;
+  return this != internal_default_instance() && _impl_.page_id_ != nullptr;
 }
 inline bool GetPageRequest::has_page_id() const {
   return _internal_has_page_id();
 }
 inline void GetPageRequest::clear_page_id() {
-  if (GetArenaForAllocation() == nullptr && page_id_ != nullptr) {
-    delete page_id_;
+  if (GetArenaForAllocation() == nullptr && _impl_.page_id_ != nullptr) {
+    delete _impl_.page_id_;
   }
-  page_id_ = nullptr;
+  _impl_.page_id_ = nullptr;
 }
 inline const ::storage_service::GetPageRequest_PageID& GetPageRequest::_internal_page_id() const {
-  const ::storage_service::GetPageRequest_PageID* p = page_id_;
+  const ::storage_service::GetPageRequest_PageID* p = _impl_.page_id_;
   return p != nullptr ? *p : reinterpret_cast<const ::storage_service::GetPageRequest_PageID&>(
       ::storage_service::_GetPageRequest_PageID_default_instance_);
 }
@@ -1043,9 +1719,9 @@ inline const ::storage_service::GetPageRequest_PageID& GetPageRequest::page_id()
 inline void GetPageRequest::unsafe_arena_set_allocated_page_id(
     ::storage_service::GetPageRequest_PageID* page_id) {
   if (GetArenaForAllocation() == nullptr) {
-    delete reinterpret_cast<::PROTOBUF_NAMESPACE_ID::MessageLite*>(page_id_);
+    delete reinterpret_cast<::PROTOBUF_NAMESPACE_ID::MessageLite*>(_impl_.page_id_);
   }
-  page_id_ = page_id;
+  _impl_.page_id_ = page_id;
   if (page_id) {
     
   } else {
@@ -1055,8 +1731,8 @@ inline void GetPageRequest::unsafe_arena_set_allocated_page_id(
 }
 inline ::storage_service::GetPageRequest_PageID* GetPageRequest::release_page_id() {
   
-  ::storage_service::GetPageRequest_PageID* temp = page_id_;
-  page_id_ = nullptr;
+  ::storage_service::GetPageRequest_PageID* temp = _impl_.page_id_;
+  _impl_.page_id_ = nullptr;
 #ifdef PROTOBUF_FORCE_COPY_IN_RELEASE
   auto* old =  reinterpret_cast<::PROTOBUF_NAMESPACE_ID::MessageLite*>(temp);
   temp = ::PROTOBUF_NAMESPACE_ID::internal::DuplicateIfNonNull(temp);
@@ -1071,17 +1747,17 @@ inline ::storage_service::GetPageRequest_PageID* GetPageRequest::release_page_id
 inline ::storage_service::GetPageRequest_PageID* GetPageRequest::unsafe_arena_release_page_id() {
   // @@protoc_insertion_point(field_release:storage_service.GetPageRequest.page_id)
   
-  ::storage_service::GetPageRequest_PageID* temp = page_id_;
-  page_id_ = nullptr;
+  ::storage_service::GetPageRequest_PageID* temp = _impl_.page_id_;
+  _impl_.page_id_ = nullptr;
   return temp;
 }
 inline ::storage_service::GetPageRequest_PageID* GetPageRequest::_internal_mutable_page_id() {
   
-  if (page_id_ == nullptr) {
+  if (_impl_.page_id_ == nullptr) {
     auto* p = CreateMaybeMessage<::storage_service::GetPageRequest_PageID>(GetArenaForAllocation());
-    page_id_ = p;
+    _impl_.page_id_ = p;
   }
-  return page_id_;
+  return _impl_.page_id_;
 }
 inline ::storage_service::GetPageRequest_PageID* GetPageRequest::mutable_page_id() {
   ::storage_service::GetPageRequest_PageID* _msg = _internal_mutable_page_id();
@@ -1091,7 +1767,7 @@ inline ::storage_service::GetPageRequest_PageID* GetPageRequest::mutable_page_id
 inline void GetPageRequest::set_allocated_page_id(::storage_service::GetPageRequest_PageID* page_id) {
   ::PROTOBUF_NAMESPACE_ID::Arena* message_arena = GetArenaForAllocation();
   if (message_arena == nullptr) {
-    delete page_id_;
+    delete _impl_.page_id_;
   }
   if (page_id) {
     ::PROTOBUF_NAMESPACE_ID::Arena* submessage_arena =
@@ -1104,16 +1780,16 @@ inline void GetPageRequest::set_allocated_page_id(::storage_service::GetPageRequ
   } else {
     
   }
-  page_id_ = page_id;
+  _impl_.page_id_ = page_id;
   // @@protoc_insertion_point(field_set_allocated:storage_service.GetPageRequest.page_id)
 }
 
 // uint64 require_batch_id = 2;
 inline void GetPageRequest::clear_require_batch_id() {
-  require_batch_id_ = uint64_t{0u};
+  _impl_.require_batch_id_ = uint64_t{0u};
 }
 inline uint64_t GetPageRequest::_internal_require_batch_id() const {
-  return require_batch_id_;
+  return _impl_.require_batch_id_;
 }
 inline uint64_t GetPageRequest::require_batch_id() const {
   // @@protoc_insertion_point(field_get:storage_service.GetPageRequest.require_batch_id)
@@ -1121,7 +1797,7 @@ inline uint64_t GetPageRequest::require_batch_id() const {
 }
 inline void GetPageRequest::_internal_set_require_batch_id(uint64_t value) {
   
-  require_batch_id_ = value;
+  _impl_.require_batch_id_ = value;
 }
 inline void GetPageRequest::set_require_batch_id(uint64_t value) {
   _internal_set_require_batch_id(value);
@@ -1134,7 +1810,7 @@ inline void GetPageRequest::set_require_batch_id(uint64_t value) {
 
 // bytes data = 1;
 inline void GetPageResponse::clear_data() {
-  data_.ClearToEmpty();
+  _impl_.data_.ClearToEmpty();
 }
 inline const std::string& GetPageResponse::data() const {
   // @@protoc_insertion_point(field_get:storage_service.GetPageResponse.data)
@@ -1144,7 +1820,7 @@ template <typename ArgT0, typename... ArgT>
 inline PROTOBUF_ALWAYS_INLINE
 void GetPageResponse::set_data(ArgT0&& arg0, ArgT... args) {
  
- data_.SetBytes(static_cast<ArgT0 &&>(arg0), args..., GetArenaForAllocation());
+ _impl_.data_.SetBytes(static_cast<ArgT0 &&>(arg0), args..., GetArenaForAllocation());
   // @@protoc_insertion_point(field_set:storage_service.GetPageResponse.data)
 }
 inline std::string* GetPageResponse::mutable_data() {
@@ -1153,19 +1829,19 @@ inline std::string* GetPageResponse::mutable_data() {
   return _s;
 }
 inline const std::string& GetPageResponse::_internal_data() const {
-  return data_.Get();
+  return _impl_.data_.Get();
 }
 inline void GetPageResponse::_internal_set_data(const std::string& value) {
   
-  data_.Set(value, GetArenaForAllocation());
+  _impl_.data_.Set(value, GetArenaForAllocation());
 }
 inline std::string* GetPageResponse::_internal_mutable_data() {
   
-  return data_.Mutable(GetArenaForAllocation());
+  return _impl_.data_.Mutable(GetArenaForAllocation());
 }
 inline std::string* GetPageResponse::release_data() {
   // @@protoc_insertion_point(field_release:storage_service.GetPageResponse.data)
-  return data_.Release();
+  return _impl_.data_.Release();
 }
 inline void GetPageResponse::set_allocated_data(std::string* data) {
   if (data != nullptr) {
@@ -1173,15 +1849,228 @@ inline void GetPageResponse::set_allocated_data(std::string* data) {
   } else {
     
   }
-  data_.SetAllocated(data, GetArenaForAllocation());
+  _impl_.data_.SetAllocated(data, GetArenaForAllocation());
 #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
-  if (data_.IsDefault()) {
-    data_.Set("", GetArenaForAllocation());
+  if (_impl_.data_.IsDefault()) {
+    _impl_.data_.Set("", GetArenaForAllocation());
   }
 #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
   // @@protoc_insertion_point(field_set_allocated:storage_service.GetPageResponse.data)
 }
 
+// -------------------------------------------------------------------
+
+// GetPagesRequest
+
+// repeated .storage_service.GetPageRequest.PageID page_ids = 1;
+inline int GetPagesRequest::_internal_page_ids_size() const {
+  return _impl_.page_ids_.size();
+}
+inline int GetPagesRequest::page_ids_size() const {
+  return _internal_page_ids_size();
+}
+inline void GetPagesRequest::clear_page_ids() {
+  _impl_.page_ids_.Clear();
+}
+inline ::storage_service::GetPageRequest_PageID* GetPagesRequest::mutable_page_ids(int index) {
+  // @@protoc_insertion_point(field_mutable:storage_service.GetPagesRequest.page_ids)
+  return _impl_.page_ids_.Mutable(index);
+}
+inline ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::storage_service::GetPageRequest_PageID >*
+GetPagesRequest::mutable_page_ids() {
+  // @@protoc_insertion_point(field_mutable_list:storage_service.GetPagesRequest.page_ids)
+  return &_impl_.page_ids_;
+}
+inline const ::storage_service::GetPageRequest_PageID& GetPagesRequest::_internal_page_ids(int index) const {
+  return _impl_.page_ids_.Get(index);
+}
+inline const ::storage_service::GetPageRequest_PageID& GetPagesRequest::page_ids(int index) const {
+  // @@protoc_insertion_point(field_get:storage_service.GetPagesRequest.page_ids)
+  return _internal_page_ids(index);
+}
+inline ::storage_service::GetPageRequest_PageID* GetPagesRequest::_internal_add_page_ids() {
+  return _impl_.page_ids_.Add();
+}
+inline ::storage_service::GetPageRequest_PageID* GetPagesRequest::add_page_ids() {
+  ::storage_service::GetPageRequest_PageID* _add = _internal_add_page_ids();
+  // @@protoc_insertion_point(field_add:storage_service.GetPagesRequest.page_ids)
+  return _add;
+}
+inline const ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::storage_service::GetPageRequest_PageID >&
+GetPagesRequest::page_ids() const {
+  // @@protoc_insertion_point(field_list:storage_service.GetPagesRequest.page_ids)
+  return _impl_.page_ids_;
+}
+
+// uint64 require_batch_id = 2;
+inline void GetPagesRequest::clear_require_batch_id() {
+  _impl_.require_batch_id_ = uint64_t{0u};
+}
+inline uint64_t GetPagesRequest::_internal_require_batch_id() const {
+  return _impl_.require_batch_id_;
+}
+inline uint64_t GetPagesRequest::require_batch_id() const {
+  // @@protoc_insertion_point(field_get:storage_service.GetPagesRequest.require_batch_id)
+  return _internal_require_batch_id();
+}
+inline void GetPagesRequest::_internal_set_require_batch_id(uint64_t value) {
+  
+  _impl_.require_batch_id_ = value;
+}
+inline void GetPagesRequest::set_require_batch_id(uint64_t value) {
+  _internal_set_require_batch_id(value);
+  // @@protoc_insertion_point(field_set:storage_service.GetPagesRequest.require_batch_id)
+}
+
+// bool read_ahead = 3;
+inline void GetPagesRequest::clear_read_ahead() {
+  _impl_.read_ahead_ = false;
+}
+inline bool GetPagesRequest::_internal_read_ahead() const {
+  return _impl_.read_ahead_;
+}
+inline bool GetPagesRequest::read_ahead() const {
+  // @@protoc_insertion_point(field_get:storage_service.GetPagesRequest.read_ahead)
+  return _internal_read_ahead();
+}
+inline void GetPagesRequest::_internal_set_read_ahead(bool value) {
+  
+  _impl_.read_ahead_ = value;
+}
+inline void GetPagesRequest::set_read_ahead(bool value) {
+  _internal_set_read_ahead(value);
+  // @@protoc_insertion_point(field_set:storage_service.GetPagesRequest.read_ahead)
+}
+
+// -------------------------------------------------------------------
+
+// GetPagesResponse
+
+// bytes data = 1;
+inline void GetPagesResponse::clear_data() {
+  _impl_.data_.ClearToEmpty();
+}
+inline const std::string& GetPagesResponse::data() const {
+  // @@protoc_insertion_point(field_get:storage_service.GetPagesResponse.data)
+  return _internal_data();
+}
+template <typename ArgT0, typename... ArgT>
+inline PROTOBUF_ALWAYS_INLINE
+void GetPagesResponse::set_data(ArgT0&& arg0, ArgT... args) {
+ 
+ _impl_.data_.SetBytes(static_cast<ArgT0 &&>(arg0), args..., GetArenaForAllocation());
+  // @@protoc_insertion_point(field_set:storage_service.GetPagesResponse.data)
+}
+inline std::string* GetPagesResponse::mutable_data() {
+  std::string* _s = _internal_mutable_data();
+  // @@protoc_insertion_point(field_mutable:storage_service.GetPagesResponse.data)
+  return _s;
+}
+inline const std::string& GetPagesResponse::_internal_data() const {
+  return _impl_.data_.Get();
+}
+inline void GetPagesResponse::_internal_set_data(const std::string& value) {
+  
+  _impl_.data_.Set(value, GetArenaForAllocation());
+}
+inline std::string* GetPagesResponse::_internal_mutable_data() {
+  
+  return _impl_.data_.Mutable(GetArenaForAllocation());
+}
+inline std::string* GetPagesResponse::release_data() {
+  // @@protoc_insertion_point(field_release:storage_service.GetPagesResponse.data)
+  return _impl_.data_.Release();
+}
+inline void GetPagesResponse::set_allocated_data(std::string* data) {
+  if (data != nullptr) {
+    
+  } else {
+    
+  }
+  _impl_.data_.SetAllocated(data, GetArenaForAllocation());
+#ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (_impl_.data_.IsDefault()) {
+    _impl_.data_.Set("", GetArenaForAllocation());
+  }
+#endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  // @@protoc_insertion_point(field_set_allocated:storage_service.GetPagesResponse.data)
+}
+
+// repeated bool page_exists = 2;
+inline int GetPagesResponse::_internal_page_exists_size() const {
+  return _impl_.page_exists_.size();
+}
+inline int GetPagesResponse::page_exists_size() const {
+  return _internal_page_exists_size();
+}
+inline void GetPagesResponse::clear_page_exists() {
+  _impl_.page_exists_.Clear();
+}
+inline bool GetPagesResponse::_internal_page_exists(int index) const {
+  return _impl_.page_exists_.Get(index);
+}
+inline bool GetPagesResponse::page_exists(int index) const {
+  // @@protoc_insertion_point(field_get:storage_service.GetPagesResponse.page_exists)
+  return _internal_page_exists(index);
+}
+inline void GetPagesResponse::set_page_exists(int index, bool value) {
+  _impl_.page_exists_.Set(index, value);
+  // @@protoc_insertion_point(field_set:storage_service.GetPagesResponse.page_exists)
+}
+inline void GetPagesResponse::_internal_add_page_exists(bool value) {
+  _impl_.page_exists_.Add(value);
+}
+inline void GetPagesResponse::add_page_exists(bool value) {
+  _internal_add_page_exists(value);
+  // @@protoc_insertion_point(field_add:storage_service.GetPagesResponse.page_exists)
+}
+inline const ::PROTOBUF_NAMESPACE_ID::RepeatedField< bool >&
+GetPagesResponse::_internal_page_exists() const {
+  return _impl_.page_exists_;
+}
+inline const ::PROTOBUF_NAMESPACE_ID::RepeatedField< bool >&
+GetPagesResponse::page_exists() const {
+  // @@protoc_insertion_point(field_list:storage_service.GetPagesResponse.page_exists)
+  return _internal_page_exists();
+}
+inline ::PROTOBUF_NAMESPACE_ID::RepeatedField< bool >*
+GetPagesResponse::_internal_mutable_page_exists() {
+  return &_impl_.page_exists_;
+}
+inline ::PROTOBUF_NAMESPACE_ID::RepeatedField< bool >*
+GetPagesResponse::mutable_page_exists() {
+  // @@protoc_insertion_point(field_mutable_list:storage_service.GetPagesResponse.page_exists)
+  return _internal_mutable_page_exists();
+}
+
+// -------------------------------------------------------------------
+
+// GetPersistBatchIdRequest
+
+// -------------------------------------------------------------------
+
+// GetPersistBatchIdResponse
+
+// uint64 persist_batch_id = 1;
+inline void GetPersistBatchIdResponse::clear_persist_batch_id() {
+  _impl_.persist_batch_id_ = uint64_t{0u};
+}
+inline uint64_t GetPersistBatchIdResponse::_internal_persist_batch_id() const {
+  return _impl_.persist_batch_id_;
+}
+inline uint64_t GetPersistBatchIdResponse::persist_batch_id() const {
+  // @@protoc_insertion_point(field_get:storage_service.GetPersistBatchIdResponse.persist_batch_id)
+  return _internal_persist_batch_id();
+}
+inline void GetPersistBatchIdResponse::_internal_set_persist_batch_id(uint64_t value) {
+  
+  _impl_.persist_batch_id_ = value;
+}
+inline void GetPersistBatchIdResponse::set_persist_batch_id(uint64_t value) {
+  _internal_set_persist_batch_id(value);
+  // @@protoc_insertion_point(field_set:storage_service.GetPersistBatchIdResponse.persist_batch_id)
+}
+
 #ifdef __GNUC__
   #pragma GCC diagnostic pop
 #endif  // __GNUC__
@@ -1193,6 +2082,14 @@ inline void GetPageResponse::set_allocated_data(std::string* data) {
 
 // -------------------------------------------------------------------
 
+// -------------------------------------------------------------------
+
+// -------------------------------------------------------------------
+
+// -------------------------------------------------------------------
+
+// -------------------------------------------------------------------
+
 
 // @@protoc_insertion_point(namespace_scope)
 
@@ -3,6 +3,7 @@
 #include <deque>
 
 #include "base/common.h"
+#include "log/log_builder.h"
 #include "log/log_record.h"
 #include "util/debug.h"
 
@@ -16,17 +17,26 @@ public:
 
     std::deque<LogRecord*> logs;
 
+    // 把batch的日志序列化到builder中, 之后可以用builder.move_to(&cntl.request_attachment())发送LogWrite请求
+    void build_log(LogBuilder* builder) {
+        for(auto log: logs) {
+            builder->append(*log);
+        }
+    }
+
     std::string get_log_string(){
-        std::string str = "";
+        size_t log_size = 0;
+        for(auto log: logs) {
+            log_size += log->log_tot_len_;
+        }
+        // 一次分配好空间, 日志直接序列化到string中
+        std::string str(log_size, '\0');
+        size_t offset = 0;
         for(auto log: logs) {
-            char* log_str = new char[log->log_tot_len_];
-            log->serialize(log_str);
-            // log->format_print();
-            str += std::string(log_str, log->log_tot_len_);
-            delete[] log_str;
+            log->serialize(&str[offset]);
+            offset += log->log_tot_len_;
         }
-        RDMA_LOG(INFO) << "transaction " << batch_id_ << "'s log: " << str;
         return str;
     }
 
-};
\ No newline at end of file
+};
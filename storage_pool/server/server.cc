@@ -50,6 +50,12 @@ int main(int argc, char* argv[]) {
     int local_meta_port = (int)local_node.get("local_meta_port").get_int64();
     auto log_buf_size_GB = local_node.get("log_buf_size_GB").get_uint64();
     bool use_rdma = (bool)local_node.get("use_rdma").get_bool();
+    bool use_io_uring = (bool)local_node.get("use_io_uring").get_bool();
+    GroupCommitConfig group_commit_config;
+    group_commit_config.flush_interval_us = (int)local_node.get("log_flush_interval_us").get_int64();
+    group_commit_config.max_group_bytes = (size_t)local_node.get("log_max_group_bytes").get_uint64();
+    group_commit_config.max_group_size = (size_t)local_node.get("log_max_group_size").get_uint64();
+    int replay_thread_num = (int)local_node.get("replay_thread_num").get_int64();
     std::string workload = local_node.get("workload").get_str();
 
     auto compute_nodes = json_config.get("remote_compute_nodes");
@@ -57,9 +63,9 @@ int main(int argc, char* argv[]) {
     size_t compute_node_num = compute_node_ips.size();
 
     // 在这里开始构造disk_manager, log_manager, server
-    auto disk_manager = std::make_shared<DiskManager>();
-    auto log_replay = std::make_shared<LogReplay>(disk_manager.get()); 
-    auto log_manager = std::make_shared<LogManager>(disk_manager.get(), log_replay.get());
+    auto disk_manager = std::make_shared<DiskManager>(use_io_uring);
+    auto log_replay = std::make_shared<LogReplay>(disk_manager.get(), replay_thread_num); 
+    auto log_manager = std::make_shared<LogManager>(disk_manager.get(), log_replay.get(), group_commit_config);
     
     // Init table in disk
     auto buffer_mgr = std::make_shared<BufferPoolManager>(BUFFER_POOL_SIZE, disk_manager.get());
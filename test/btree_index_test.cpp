@@ -0,0 +1,113 @@
+#include <gflags/gflags.h>
+
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <random>
+#include <vector>
+
+#include "memstore/btree_index_store.h"
+#include "util/debug.h"
+
+DEFINE_int32(key_num, 200000, "Number of keys inserted into the ordered index");
+DEFINE_int32(scan_num, 20000, "Number of random range scans");
+DEFINE_int32(max_scan_len, 200, "Max number of items returned by one scan");
+
+/**
+ * 有序索引BTreeIndexStore的正确性测试
+ * 1. 随机顺序插入key之后, 随机范围扫描的结果与std::map相同, 扫描读取的节点数不超过 树高+叶子数
+ * 2. 从最初的根节点(已经不是根了)出发, 用计算节点使用的NeedMoveRight/FindChild遍历, 仍然能找到每个key,
+ *    对应DTX中缓存的根节点过期的情况
+ * 3. 删除一部分key之后扫描结果仍然与std::map相同
+ */
+
+static void Check(bool cond, const char* what) {
+  if (!cond) RDMA_LOG(FATAL) << "check fails: " << what;
+}
+
+static Rid MakeRid(itemkey_t key) { return {(page_id_t)(key >> 8), (int)(key & 0xff)}; }
+
+// 与DTX::TraverseBTree相同, 从start_id出发找到负责key的叶子
+static const BTreeNode* TraverseFrom(char* index_ptr, int64_t start_id, itemkey_t key) {
+  auto get_node = [&](int64_t id) { return (const BTreeNode*)(index_ptr + BTreeIndexStore::GetNodeOff(0, id)); };
+  const BTreeNode* node = get_node(start_id);
+  while (true) {
+    if (BTreeIndexStore::NeedMoveRight(node, key)) node = get_node(node->sibling_id);
+    else if (node->level == 0) return node;
+    else node = get_node(BTreeIndexStore::FindChild(node, key));
+  }
+}
+
+static void CheckScans(BTreeIndexStore& index, const std::map<itemkey_t, Rid>& expected, std::mt19937_64& rand,
+                       bool check_read_nodes) {
+  for (int i = 0; i < FLAGS_scan_num; i++) {
+    itemkey_t lo = rand() % ((uint64_t)FLAGS_key_num * 16);
+    itemkey_t hi = lo + rand() % ((uint64_t)FLAGS_max_scan_len * 16);
+    size_t limit = 1 + rand() % FLAGS_max_scan_len;
+    std::vector<std::pair<itemkey_t, Rid>> res;
+    int read_nodes = index.LocalScan(lo, hi, limit, res);
+
+    auto it = expected.lower_bound(lo);
+    for (auto& item : res) {
+      Check(it != expected.end() && it->first == item.first && it->second == item.second, "scan returns keys in order");
+      it++;
+    }
+    Check(res.size() == limit || it == expected.end() || it->first > hi, "scan stops at the limit or hi");
+    if (!check_read_nodes) continue;
+    // 只有插入时每个叶子至少半满, 除了第一个和最后一个叶子
+    int max_leaves = res.size() / (BTREE_MAX_ENTRY_NUM / 2) + 2;
+    Check(read_nodes <= index.GetHeight() - 1 + max_leaves, "scan reads O(log n + pages) nodes");
+  }
+}
+
+int main(int argc, char* argv[]) {
+  google::ParseCommandLineFlags(&argc, &argv, true);
+
+  uint64_t max_node_num = (uint64_t)FLAGS_key_num / (BTREE_MAX_ENTRY_NUM / 2) * 2 + 16;
+  size_t mem_size = BTREE_HEADER_SIZE + max_node_num * BTREE_NODE_SIZE;
+  char* region = (char*)aligned_alloc(4096, (mem_size + 4095) / 4096 * 4096);
+  MemStoreAllocParam param(region, region, 0, region + mem_size);
+  BTreeIndexStore index(1, max_node_num, &param);
+  RDMA_LOG(INFO) << "sizeof(BTreeNode): " << sizeof(BTreeNode) << ", entries per node: " << BTREE_MAX_ENTRY_NUM;
+
+  // 1. 随机顺序插入
+  std::mt19937_64 rand(2024);
+  std::map<itemkey_t, Rid> expected;
+  for (int i = 0; i < FLAGS_key_num; i++) {
+    itemkey_t key = rand() % ((uint64_t)FLAGS_key_num * 16);
+    Check(index.LocalInsertKeyRid(key, MakeRid(key)), "insert succeeds");
+    expected[key] = MakeRid(key);
+  }
+  std::cout << "keys: " << expected.size() << ", nodes: " << index.GetNodeNum() << ", height: " << index.GetHeight()
+            << std::endl;
+  Check(index.GetHeight() > 2, "the tree has internal levels");
+  CheckScans(index, expected, rand, true);
+
+  // 2. 从过期的根出发, 最初的根是最左侧的叶子, 需要沿叶子链表移动, 只抽查一部分key
+  int checked = 0;
+  for (auto& item : expected) {
+    if (checked++ % 97 != 0) continue;
+    const BTreeNode* leaf = TraverseFrom(region + index.GetBaseOff(), 0, item.first);
+    int pos = BTreeIndexStore::LowerBound(leaf, item.first);
+    Check(pos < leaf->key_num && leaf->entries[pos].key == item.first, "stale root finds the key by moving right");
+  }
+
+  // 3. 删除一半的key
+  int deleted = 0;
+  for (auto it = expected.begin(); it != expected.end();) {
+    if (rand() % 2 == 0) {
+      Check(index.LocalDelete(it->first), "delete an existing key");
+      it = expected.erase(it);
+      deleted++;
+    } else {
+      it++;
+    }
+  }
+  Check(!index.LocalDelete((uint64_t)FLAGS_key_num * 16), "delete a missing key");
+  CheckScans(index, expected, rand, false);
+  std::cout << "deleted: " << deleted << std::endl;
+
+  free(region);
+  std::cout << "PASS" << std::endl;
+  return 0;
+}
@@ -0,0 +1,369 @@
+#include <gflags/gflags.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "memstore/btree_index_store.h"
+#include "util/debug.h"
+
+DEFINE_int32(thread_num, 8, "Number of concurrent writers");
+DEFINE_int32(key_num_per_thread, 20000, "Number of keys inserted by each writer");
+
+/**
+ * 有序索引在计算节点上的插入协议(dtx/dtx_btree_index.cc)的测试, 内存池用本地的一块区域模拟
+ * SimDTX中的函数与DTX中的同名函数步骤相同, RDMA操作换成对模拟区域的原子访问, 每次Yield调用钩子模拟协程切换
+ * 1. 根节点分裂的竞争: 写者A分裂根节点之后暂停, 还没有写入新的根; 写者B分裂A的右兄弟,
+ *    向上插入分隔key时旧根仍然是叶子, B需要等待A写入新的根, 之后两个分隔key都在新的根中
+ * 2. 多个线程并发随机插入, 每次RDMA操作之间随机让出, 之后每一层的节点链表有序并且覆盖全部key,
+ *    从根遍历能找到每个key
+ */
+
+static void Check(bool cond, const char* what) {
+  if (!cond) RDMA_LOG(FATAL) << "check fails: " << what;
+}
+
+static Rid MakeRid(itemkey_t key) { return {(page_id_t)(key >> 8), (int)(key & 0xff)}; }
+
+// 模拟的内存节点, 每个RDMA操作持有互斥锁执行, 相当于单个操作是原子的
+class SimRemote {
+ public:
+  explicit SimRemote(char* region) : region_(region) {}
+
+  void Read(char* buf, offset_t off, size_t size) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    memcpy(buf, region_ + off, size);
+  }
+
+  void Write(const char* buf, offset_t off, size_t size) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    memcpy(region_ + off, buf, size);
+  }
+
+  uint64_t CAS(offset_t off, uint64_t compare, uint64_t swap) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    uint64_t old = *(uint64_t*)(region_ + off);
+    if (old == compare) *(uint64_t*)(region_ + off) = swap;
+    return old;
+  }
+
+  uint64_t FAA(offset_t off, uint64_t add) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    uint64_t old = *(uint64_t*)(region_ + off);
+    *(uint64_t*)(region_ + off) = old + add;
+    return old;
+  }
+
+ private:
+  char* region_;
+  std::mutex mutex_;
+};
+
+// 一个计算节点上的事务, 对应DTX中的有序索引操作
+class SimDTX {
+ public:
+  SimDTX(SimRemote* remote, const BTreeIndexStore& index, std::function<void(const std::string&)> on_yield)
+      : remote_(remote), base_off_(index.GetBaseOff()), max_node_num_(index.GetMaxNodeNum()), on_yield_(on_yield) {}
+
+  bool InsertBTreeIndex(itemkey_t key, Rid rid) {
+    BTreeNode* leaf;
+    int64_t leaf_id = TraverseBTree(key, 0, leaf);
+    bool ret = InsertBTreeLevel(key, BTreeIndexStore::PackRid(rid), 0, leaf_id);
+    bufs_.clear();
+    return ret;
+  }
+
+  // TraverseBTree中等待新的根的次数
+  int root_waits = 0;
+
+ private:
+  char* Alloc(size_t size) {
+    bufs_.emplace_back(new char[size]);
+    return bufs_.back().get();
+  }
+
+  void Yield(const std::string& step) { on_yield_(step); }
+
+  BTreeHeader* ReadBTreeHeader() {
+    char* header_buf = Alloc(sizeof(BTreeHeader));
+    remote_->Read(header_buf, base_off_, sizeof(BTreeHeader));
+    Yield("read header");
+    BTreeHeader* header = (BTreeHeader*)header_buf;
+    root_cache_ = header->root_id;
+    return header;
+  }
+
+  int64_t GetBTreeRoot(bool refresh) {
+    if (!refresh && root_cache_ != BTREE_NULL_NODE) return root_cache_;
+    return ReadBTreeHeader()->root_id;
+  }
+
+  BTreeNode* ReadBTreeNode(int64_t btree_node_id) {
+    char* node_buf = Alloc(sizeof(BTreeNode));
+    while (true) {
+      remote_->Read(node_buf, BTreeIndexStore::GetNodeOff(base_off_, btree_node_id), sizeof(BTreeNode));
+      Yield("read node");
+      BTreeNode* node = (BTreeNode*)node_buf;
+      if (node->version == node->rear_version) return node;
+    }
+  }
+
+  BTreeNode* LockBTreeNode(itemkey_t key, int64_t& btree_node_id) {
+    char* node_buf = Alloc(sizeof(BTreeNode));
+    while (true) {
+      offset_t node_off = BTreeIndexStore::GetNodeOff(base_off_, btree_node_id);
+      // 同一个doorbell中的CAS和READ
+      uint64_t old = remote_->CAS(node_off, UNLOCKED, EXCLUSIVE_LOCKED);
+      remote_->Read(node_buf, node_off, sizeof(BTreeNode));
+      Yield("lock node");
+      if (old != UNLOCKED) continue;
+
+      BTreeNode* node = (BTreeNode*)node_buf;
+      if (!BTreeIndexStore::NeedMoveRight(node, key)) return node;
+      Unlock(node_off);
+      btree_node_id = node->sibling_id;
+    }
+  }
+
+  void Unlock(offset_t node_off) { remote_->FAA(node_off, EXCLUSIVE_UNLOCK_TO_BE_ADDED); }
+
+  void UnlockWithWrite(offset_t node_off, BTreeNode* node) {
+    remote_->Write((char*)node + sizeof(lock_t), node_off + sizeof(lock_t), sizeof(BTreeNode) - sizeof(lock_t));
+    Unlock(node_off);
+  }
+
+  int64_t AllocBTreeNode() {
+    uint64_t btree_node_id = remote_->FAA(base_off_ + offsetof(BTreeHeader, next_free_id), 1);
+    Yield("alloc node");
+    return btree_node_id >= max_node_num_ ? BTREE_NULL_NODE : (int64_t)btree_node_id;
+  }
+
+  int64_t TraverseBTree(itemkey_t key, uint16_t level, BTreeNode*& node) {
+    int64_t btree_node_id = GetBTreeRoot(false);
+    node = ReadBTreeNode(btree_node_id);
+    while (node->level < level) {
+      BTreeHeader* header = ReadBTreeHeader();
+      if (header->next_free_id >= header->max_node_num) return BTREE_NULL_NODE;
+      btree_node_id = header->root_id;
+      node = ReadBTreeNode(btree_node_id);
+      if (node->level < level) root_waits++;
+    }
+    while (true) {
+      if (BTreeIndexStore::NeedMoveRight(node, key)) {
+        btree_node_id = node->sibling_id;
+      } else if (node->level == level) {
+        return btree_node_id;
+      } else {
+        btree_node_id = BTreeIndexStore::FindChild(node, key);
+      }
+      node = ReadBTreeNode(btree_node_id);
+    }
+  }
+
+  bool InsertBTreeLevel(itemkey_t key, uint64_t value, uint16_t level, int64_t btree_node_id) {
+    BTreeNode* node = LockBTreeNode(key, btree_node_id);
+    offset_t node_off = BTreeIndexStore::GetNodeOff(base_off_, btree_node_id);
+    if (BTreeIndexStore::InsertEntry(node, key, value)) {
+      node->version++;
+      node->rear_version = node->version;
+      UnlockWithWrite(node_off, node);
+      return true;
+    }
+
+    int64_t right_id = AllocBTreeNode();
+    if (right_id == BTREE_NULL_NODE) {
+      Unlock(node_off);
+      return false;
+    }
+    BTreeNode* right = (BTreeNode*)Alloc(sizeof(BTreeNode));
+    itemkey_t sep = BTreeIndexStore::SplitNode(node, right, right_id);
+    bool inserted = BTreeIndexStore::InsertEntry(key < sep ? node : right, key, value);
+    Check(inserted, "the split node has room for the key");
+
+    remote_->Write((char*)right, BTreeIndexStore::GetNodeOff(base_off_, right_id), sizeof(BTreeNode));
+    Yield("write right");
+    node->version++;
+    node->rear_version = node->version;
+    remote_->Write((char*)node + sizeof(lock_t), node_off + sizeof(lock_t), sizeof(BTreeNode) - sizeof(lock_t));
+
+    bool ret = true;
+    if (GetBTreeRoot(true) == btree_node_id) {
+      int64_t root_id = AllocBTreeNode();
+      if (root_id == BTREE_NULL_NODE) {
+        ret = false;
+      } else {
+        BTreeNode* root = (BTreeNode*)Alloc(sizeof(BTreeNode));
+        BTreeIndexStore::InitNode(root, level + 1, 0, BTREE_KEY_MAX);
+        root->leftmost_child = btree_node_id;
+        BTreeIndexStore::InsertEntry(root, sep, (uint64_t)right_id);
+        remote_->Write((char*)root, BTreeIndexStore::GetNodeOff(base_off_, root_id), sizeof(BTreeNode));
+        Yield("write root");
+        remote_->Write((char*)&root_id, base_off_ + offsetof(BTreeHeader, root_id), sizeof(int64_t));
+        Yield("write header");
+        root_cache_ = root_id;
+      }
+    } else {
+      BTreeNode* parent;
+      int64_t parent_id = TraverseBTree(sep, level + 1, parent);
+      ret = parent_id != BTREE_NULL_NODE && InsertBTreeLevel(sep, (uint64_t)right_id, level + 1, parent_id);
+    }
+    Unlock(node_off);
+    return ret;
+  }
+
+  SimRemote* remote_;
+  offset_t base_off_;
+  uint64_t max_node_num_;
+  std::function<void(const std::string&)> on_yield_;
+  int64_t root_cache_ = BTREE_NULL_NODE;
+  std::vector<std::unique_ptr<char[]>> bufs_;
+};
+
+struct SimIndex {
+  explicit SimIndex(uint64_t max_node_num) {
+    size_t mem_size = BTREE_HEADER_SIZE + max_node_num * BTREE_NODE_SIZE;
+    region = (char*)aligned_alloc(4096, (mem_size + 4095) / 4096 * 4096);
+    MemStoreAllocParam param(region, region, 0, region + mem_size);
+    index.reset(new BTreeIndexStore(1, max_node_num, &param));
+    remote.reset(new SimRemote(region));
+  }
+
+  ~SimIndex() { free(region); }
+
+  const BTreeNode* GetNode(int64_t node_id) const {
+    return (const BTreeNode*)(region + BTreeIndexStore::GetNodeOff(index->GetBaseOff(), node_id));
+  }
+
+  char* region;
+  std::unique_ptr<BTreeIndexStore> index;
+  std::unique_ptr<SimRemote> remote;
+};
+
+// 每一层从最左侧的节点沿sibling_id遍历, 范围首尾相接, 节点内key有序, 没有latch残留, 返回叶子中的全部key
+static std::vector<itemkey_t> CheckLevels(const SimIndex& sim) {
+  const BTreeHeader* header = (const BTreeHeader*)(sim.region + sim.index->GetBaseOff());
+  int64_t leftmost = header->root_id;
+  std::vector<itemkey_t> keys;
+  while (true) {
+    const BTreeNode* first = sim.GetNode(leftmost);
+    Check(first->lowest == 0, "the leftmost node starts from 0");
+    itemkey_t expect_lowest = 0;
+    for (int64_t id = leftmost; id != BTREE_NULL_NODE; id = sim.GetNode(id)->sibling_id) {
+      const BTreeNode* node = sim.GetNode(id);
+      Check(node->lock == UNLOCKED, "no latch is left");
+      Check(node->version == node->rear_version, "node is completely written");
+      Check(node->level == first->level, "siblings are at the same level");
+      Check(node->lowest == expect_lowest, "sibling ranges are contiguous");
+      for (int i = 0; i < node->key_num; i++) {
+        Check(node->entries[i].key >= node->lowest && node->entries[i].key < node->highest, "key in node range");
+        Check(i == 0 || node->entries[i - 1].key < node->entries[i].key, "keys are sorted");
+        if (node->level == 0) keys.push_back(node->entries[i].key);
+      }
+      expect_lowest = node->highest;
+    }
+    Check(expect_lowest == BTREE_KEY_MAX, "the rightmost node ends at infinity");
+    if (first->level == 0) return keys;
+    leftmost = first->leftmost_child;
+  }
+}
+
+static void CheckLookup(SimIndex& sim, const std::set<itemkey_t>& expected) {
+  std::vector<itemkey_t> keys = CheckLevels(sim);
+  Check(keys.size() == expected.size() && std::equal(keys.begin(), keys.end(), expected.begin()),
+        "leaves contain exactly the inserted keys");
+  for (itemkey_t key : expected) {
+    std::vector<std::pair<itemkey_t, Rid>> res;
+    sim.index->LocalScan(key, key, 1, res);
+    Check(res.size() == 1 && res[0].first == key && res[0].second == MakeRid(key), "lookup from the root finds the key");
+  }
+}
+
+// 1. 写者A分裂根节点之后在写入新的根之前暂停, 写者B分裂A的右兄弟
+static void TestConcurrentRootSplit() {
+  SimIndex sim(16);
+  std::set<itemkey_t> expected;
+  SimDTX loader(sim.remote.get(), *sim.index, [](const std::string&) {});
+  for (int i = 1; i <= BTREE_MAX_ENTRY_NUM; i++) {
+    Check(loader.InsertBTreeIndex(i * 10, MakeRid(i * 10)), "fill the root leaf");
+    expected.insert(i * 10);
+  }
+
+  std::atomic<bool> a_paused(false), b_waiting(false);
+  SimDTX* writer_b = nullptr;
+  SimDTX writer_a(sim.remote.get(), *sim.index, [&](const std::string& step) {
+    if (step != "write root") return;
+    a_paused = true;
+    while (!b_waiting) std::this_thread::yield();
+  });
+  std::thread thread_a([&]() { Check(writer_a.InsertBTreeIndex(5, MakeRid(5)), "A inserts"); });
+  while (!a_paused) std::this_thread::yield();
+
+  // 旧根分裂之后右兄弟有一半的项, 再插入这么多key使右兄弟分裂
+  writer_b = new SimDTX(sim.remote.get(), *sim.index, [&](const std::string&) {
+    if (writer_b->root_waits > 0) b_waiting = true;
+  });
+  std::thread thread_b([&]() {
+    for (int i = 0; i <= BTREE_MAX_ENTRY_NUM / 2; i++) {
+      itemkey_t key = BTREE_MAX_ENTRY_NUM * 10 + 1 + i;
+      Check(writer_b->InsertBTreeIndex(key, MakeRid(key)), "B inserts");
+    }
+  });
+  thread_a.join();
+  thread_b.join();
+  Check(writer_b->root_waits > 0, "B waits for the new root");
+  delete writer_b;
+
+  expected.insert(5);
+  for (int i = 0; i <= BTREE_MAX_ENTRY_NUM / 2; i++) expected.insert(BTREE_MAX_ENTRY_NUM * 10 + 1 + i);
+  Check(sim.index->GetHeight() == 2, "one new root above the leaves");
+  CheckLookup(sim, expected);
+  std::cout << "concurrent root split: PASS" << std::endl;
+}
+
+// 2. 多个线程并发插入
+static void TestConcurrentInsert() {
+  uint64_t total = (uint64_t)FLAGS_thread_num * FLAGS_key_num_per_thread;
+  SimIndex sim(total / (BTREE_MAX_ENTRY_NUM / 2) * 2 + 16);
+  std::vector<std::vector<itemkey_t>> thread_keys(FLAGS_thread_num);
+  std::set<itemkey_t> expected;
+  std::mt19937_64 rand(2024);
+  for (auto& keys : thread_keys) {
+    for (int i = 0; i < FLAGS_key_num_per_thread; i++) {
+      keys.push_back(rand() % (total * 16));
+      expected.insert(keys.back());
+    }
+  }
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < FLAGS_thread_num; t++) {
+    threads.emplace_back([&, t]() {
+      std::mt19937 yield_rand(t);
+      SimDTX dtx(sim.remote.get(), *sim.index, [&](const std::string&) {
+        if (yield_rand() % 4 == 0) std::this_thread::yield();
+      });
+      for (itemkey_t key : thread_keys[t]) Check(dtx.InsertBTreeIndex(key, MakeRid(key)), "concurrent insert");
+    });
+  }
+  for (auto& thread : threads) thread.join();
+
+  CheckLookup(sim, expected);
+  std::cout << "concurrent insert: keys: " << expected.size() << ", nodes: " << sim.index->GetNodeNum()
+            << ", height: " << sim.index->GetHeight() << ", PASS" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+  google::ParseCommandLineFlags(&argc, &argv, true);
+  TestConcurrentRootSplit();
+  TestConcurrentInsert();
+  std::cout << "PASS" << std::endl;
+  return 0;
+}
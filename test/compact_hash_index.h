@@ -0,0 +1,261 @@
+// Copyright (c) 2023
+
+#pragma once
+
+#include <cassert>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#include "base/common.h"
+#include "base/page.h"
+#include "memstore/mem_store.h"
+#include "util/hash.h"
+
+// 紧凑哈希索引布局, 只用于index_layout_bench中与IndexNode布局对比, 计算节点和内存节点都不使用
+// IndexNode接近4K, 查找一个key也要读取整个桶, 每个索引项24字节
+// 紧凑布局的每个桶64字节: 8字节的桶头和7个8字节的槽, 槽中是16位的key指纹和压缩后的Rid
+// 每个key有两个候选桶(two-choice hashing), 插入到较空的那个, 查找在一个doorbell中读取这两个桶共128字节
+// 两个候选桶都满的时候从保留区分配溢出桶, 挂到较短的溢出链上, 只有溢出时查找才需要读取更多的桶
+// 槽只有8字节, 插入和删除可以直接对槽CAS, 读者不需要latch也不需要version
+// 槽中只有指纹没有完整的key, 指纹相同的不同key(约每次查找 槽数/65535 的概率)需要读取记录之后比较DataItem中的key
+
+#define COMPACT_INDEX_SLOT_NUM 7
+#define COMPACT_INDEX_NO_OVERFLOW -1
+
+// 槽的格式: 高16位是指纹, 中间32位是page_no, 低16位是slot_no; 0表示空槽, 指纹不会是0
+using index_slot_t = uint64_t;
+
+struct CompactIndexBucket {
+  // 溢出桶在保留区中的编号, COMPACT_INDEX_NO_OVERFLOW表示没有溢出桶, 远程链接新的溢出桶时对它CAS
+  int64_t next_overflow_id;
+  index_slot_t slots[COMPACT_INDEX_SLOT_NUM];
+} Aligned8;
+
+static_assert(sizeof(CompactIndexBucket) == 64, "CompactIndexBucket should fill one cache line");
+
+class CompactIndexStore {
+ public:
+  CompactIndexStore(table_id_t table_id, uint64_t bucket_num, MemStoreAllocParam* param, MemStoreReserveParam* param_reserve)
+      : table_id(table_id), base_off(0), bucket_num(bucket_num), index_ptr(nullptr), item_num(0), overflow_num(0) {
+
+    assert(bucket_num > 1);
+    index_size = bucket_num * sizeof(CompactIndexBucket);
+    region_start_ptr = param->mem_region_start;
+    assert((uint64_t)param->mem_store_start + param->mem_store_alloc_offset + index_size <= (uint64_t)param->mem_store_reserve);
+
+    // 安排哈希表的位置
+    index_ptr = param->mem_store_start + param->mem_store_alloc_offset;
+    param->mem_store_alloc_offset += index_size;
+
+    base_off = (uint64_t)index_ptr - (uint64_t)region_start_ptr;
+
+    memset(index_ptr, 0, index_size);
+    bucket_array = (CompactIndexBucket*)index_ptr;
+    for (uint64_t i = 0; i < bucket_num; i++) bucket_array[i].next_overflow_id = COMPACT_INDEX_NO_OVERFLOW;
+
+    // 溢出桶从保留空间中分配, 编号相对于保留空间的起始地址
+    expand_region_base_ptr = param_reserve->mem_store_reserve;
+  }
+
+  table_id_t GetTableID() const {
+    return table_id;
+  }
+
+  offset_t GetBaseOff() const {
+    return base_off;
+  }
+
+  uint64_t GetIndexNodeSize() const {
+    return sizeof(CompactIndexBucket);
+  }
+
+  uint64_t GetBucketNum() const {
+    return bucket_num;
+  }
+
+  uint64_t IndexSize() const {
+    return index_size;
+  }
+
+  uint64_t GetItemNum() const {
+    return item_num;
+  }
+
+  uint64_t GetOverflowNum() const {
+    return overflow_num;
+  }
+
+  // 以下静态函数同时给计算节点使用, 计算节点根据IndexMeta中的base_off和bucket_num算出两个候选桶的偏移,
+  // 在一个doorbell中读取这两个桶, 然后用FindCandidates在读到的桶中查找
+  static uint16_t GetFingerprint(itemkey_t key) {
+    uint16_t fp = (uint16_t)(MurmurHash64A(key, 0xdeadbeef) >> 48);
+    return fp == 0 ? 1 : fp;
+  }
+
+  static std::pair<uint64_t, uint64_t> GetCandidateBuckets(itemkey_t key, uint64_t bucket_num) {
+    uint64_t bucket1 = MurmurHash64A(key, 0xdeadbeef) % bucket_num;
+    uint64_t bucket2 = MurmurHash64A(key, 0xbeefdead) % bucket_num;
+    if (bucket2 == bucket1) bucket2 = (bucket1 + 1) % bucket_num;
+    return std::make_pair(bucket1, bucket2);
+  }
+
+  static index_slot_t PackSlot(uint16_t fp, const Rid& rid) {
+    assert(rid.slot_no_ >= 0 && rid.slot_no_ <= 0xffff);
+    return ((index_slot_t)fp << 48) | ((index_slot_t)(uint32_t)rid.page_no_ << 16) | (index_slot_t)(uint16_t)rid.slot_no_;
+  }
+
+  static uint16_t SlotFingerprint(index_slot_t slot) {
+    return (uint16_t)(slot >> 48);
+  }
+
+  static Rid SlotRid(index_slot_t slot) {
+    return {(page_id_t)(uint32_t)(slot >> 16), (int)(slot & 0xffff)};
+  }
+
+  // 把桶中指纹匹配的Rid追加到rids, 返回追加的个数
+  static int FindCandidates(const CompactIndexBucket* bucket, uint16_t fp, std::vector<Rid>& rids) {
+    int found = 0;
+    for (int i = 0; i < COMPACT_INDEX_SLOT_NUM; i++) {
+      if (bucket->slots[i] != 0 && SlotFingerprint(bucket->slots[i]) == fp) {
+        rids.push_back(SlotRid(bucket->slots[i]));
+        found++;
+      }
+    }
+    return found;
+  }
+
+  // 返回key所有指纹匹配的Rid, 由调用者读取记录后比较key
+  void LocalGetCandidateRids(itemkey_t key, std::vector<Rid>& rids);
+
+  // 这里不检查是否已经存在, 由上层保证
+  bool LocalInsertKeyRid(itemkey_t key, const Rid& rid, MemStoreReserveParam* param);
+
+  // 指纹可能冲突, 删除时需要给出key对应的Rid
+  bool LocalDelete(itemkey_t key, const Rid& rid);
+
+ private:
+  CompactIndexBucket* GetOverflowBucket(int64_t overflow_id) {
+    return (CompactIndexBucket*)(expand_region_base_ptr + overflow_id * sizeof(CompactIndexBucket));
+  }
+
+  static int CountUsedSlots(const CompactIndexBucket* bucket) {
+    int used = 0;
+    for (int i = 0; i < COMPACT_INDEX_SLOT_NUM; i++) {
+      if (bucket->slots[i] != 0) used++;
+    }
+    return used;
+  }
+
+  // 在bucket及其溢出链上找空槽, 没有找到返回nullptr, chain_len返回链上的桶数, tail返回链尾的桶
+  index_slot_t* FindEmptySlot(CompactIndexBucket* bucket, int& chain_len, CompactIndexBucket*& tail) {
+    chain_len = 0;
+    while (true) {
+      chain_len++;
+      for (int i = 0; i < COMPACT_INDEX_SLOT_NUM; i++) {
+        if (bucket->slots[i] == 0) return &bucket->slots[i];
+      }
+      tail = bucket;
+      if (bucket->next_overflow_id == COMPACT_INDEX_NO_OVERFLOW) return nullptr;
+      bucket = GetOverflowBucket(bucket->next_overflow_id);
+    }
+  }
+
+  // To which table this hash store belongs
+  table_id_t table_id;
+
+  // The offset in the RDMA region
+  // Attention: the base_off is offset of fisrt index bucket
+  offset_t base_off;
+
+  // Total hash buckets
+  uint64_t bucket_num;
+
+  // The point to value in the table
+  char* index_ptr;
+  CompactIndexBucket* bucket_array;
+
+  // The size of the entire hash table
+  size_t index_size;
+
+  // Start of the index region address
+  char* region_start_ptr;
+
+  char* expand_region_base_ptr;
+
+  // 已经插入的索引项个数和分配的溢出桶个数
+  uint64_t item_num;
+  uint64_t overflow_num;
+};
+
+ALWAYS_INLINE
+void CompactIndexStore::LocalGetCandidateRids(itemkey_t key, std::vector<Rid>& rids) {
+  uint16_t fp = GetFingerprint(key);
+  auto buckets = GetCandidateBuckets(key, bucket_num);
+  for (uint64_t bucket_id : {buckets.first, buckets.second}) {
+    CompactIndexBucket* bucket = &bucket_array[bucket_id];
+    while (true) {
+      FindCandidates(bucket, fp, rids);
+      if (bucket->next_overflow_id == COMPACT_INDEX_NO_OVERFLOW) break;
+      bucket = GetOverflowBucket(bucket->next_overflow_id);
+    }
+  }
+}
+
+ALWAYS_INLINE
+bool CompactIndexStore::LocalInsertKeyRid(itemkey_t key, const Rid& rid, MemStoreReserveParam* param) {
+  index_slot_t slot = PackSlot(GetFingerprint(key), rid);
+  auto buckets = GetCandidateBuckets(key, bucket_num);
+  CompactIndexBucket* bucket1 = &bucket_array[buckets.first];
+  CompactIndexBucket* bucket2 = &bucket_array[buckets.second];
+  // 插入到较空的候选桶, 两个候选桶都满了再找溢出链
+  if (CountUsedSlots(bucket2) < CountUsedSlots(bucket1)) std::swap(bucket1, bucket2);
+
+  int chain_len1, chain_len2;
+  CompactIndexBucket* tail1 = nullptr;
+  CompactIndexBucket* tail2 = nullptr;
+  index_slot_t* empty = FindEmptySlot(bucket1, chain_len1, tail1);
+  if (empty == nullptr) empty = FindEmptySlot(bucket2, chain_len2, tail2);
+  if (empty != nullptr) {
+    *empty = slot;
+    item_num++;
+    return true;
+  }
+
+  // Allocate, 挂到较短的溢出链上
+  CompactIndexBucket* tail = chain_len2 < chain_len1 ? tail2 : tail1;
+  if ((uint64_t)param->mem_store_reserve + param->mem_store_reserve_offset + sizeof(CompactIndexBucket) > (uint64_t)param->mem_store_end) {
+    return false;
+  }
+  auto* new_bucket = (CompactIndexBucket*)(param->mem_store_reserve + param->mem_store_reserve_offset);
+  param->mem_store_reserve_offset += sizeof(CompactIndexBucket);
+  memset(new_bucket, 0, sizeof(CompactIndexBucket));
+  new_bucket->next_overflow_id = COMPACT_INDEX_NO_OVERFLOW;
+  new_bucket->slots[0] = slot;
+  tail->next_overflow_id = ((char*)new_bucket - expand_region_base_ptr) / sizeof(CompactIndexBucket);
+
+  overflow_num++;
+  item_num++;
+  return true;
+}
+
+ALWAYS_INLINE
+bool CompactIndexStore::LocalDelete(itemkey_t key, const Rid& rid) {
+  index_slot_t slot = PackSlot(GetFingerprint(key), rid);
+  auto buckets = GetCandidateBuckets(key, bucket_num);
+  for (uint64_t bucket_id : {buckets.first, buckets.second}) {
+    CompactIndexBucket* bucket = &bucket_array[bucket_id];
+    while (true) {
+      for (int i = 0; i < COMPACT_INDEX_SLOT_NUM; i++) {
+        if (bucket->slots[i] == slot) {
+          bucket->slots[i] = 0;
+          item_num--;
+          return true;
+        }
+      }
+      if (bucket->next_overflow_id == COMPACT_INDEX_NO_OVERFLOW) break;
+      bucket = GetOverflowBucket(bucket->next_overflow_id);
+    }
+  }
+  return false;
+}
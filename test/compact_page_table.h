@@ -0,0 +1,235 @@
+// Copyright (c) 2023
+
+#pragma once
+
+#include <cassert>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#include "base/common.h"
+#include "base/page.h"
+#include "memstore/mem_store.h"
+#include "memstore/page_table.h"
+#include "util/hash.h"
+
+// 紧凑页表布局, 只用于page_table_layout_bench中与PageTableNode布局对比, 计算节点和内存节点都不使用
+// PageTableNode接近4K, 查找一个页面也要读取整个桶, 其中绝大部分字节是无关的页表项
+// 紧凑布局的每个桶只有256字节以内, 每个页面有两个候选桶(cuckoo hashing), 查找只需要读取这两个桶,
+// 桶内用1字节的指纹过滤页表项, 两个候选桶都满的时候通过cuckoo踢出把已有的页表项移动到它的另一个候选桶
+
+#define COMPACT_PAGE_TABLE_SLOT_NUM 6
+#define MAX_CUCKOO_KICK_NUM 128
+
+struct CompactPageTableItem {
+  PageId page_id;
+  PageAddress page_address;
+  uint64_t rwcount = 0;
+  timestamp_t last_access_time = 0;
+  bool page_valid = false;
+} Aligned8;
+
+// 一个桶, 指纹为0表示空槽, 槽是否有效只看指纹, 不需要单独的valid字段
+struct CompactPageTableBucket {
+  lock_t lock;
+  uint8_t fingerprints[COMPACT_PAGE_TABLE_SLOT_NUM];
+  uint8_t reserved[8 - COMPACT_PAGE_TABLE_SLOT_NUM];
+  CompactPageTableItem items[COMPACT_PAGE_TABLE_SLOT_NUM];
+} Aligned8;
+
+static_assert(sizeof(CompactPageTableBucket) <= 256, "CompactPageTableBucket should fit in 256 bytes");
+
+class CompactPageTableStore {
+ public:
+  CompactPageTableStore(uint64_t bucket_num, MemStoreAllocParam* param)
+      : base_off(0), bucket_num(bucket_num), page_table_ptr(nullptr), item_num(0), kick_seed(0x9e3779b97f4a7c15) {
+
+    assert(bucket_num > 1);
+    page_table_size = bucket_num * sizeof(CompactPageTableBucket);
+    region_start_ptr = param->mem_region_start;
+    assert((uint64_t)param->mem_store_start + param->mem_store_alloc_offset + page_table_size <= (uint64_t)param->mem_store_reserve);
+
+    // 安排哈希表的位置, 紧凑布局不需要额外的扩展桶
+    page_table_ptr = param->mem_store_start + param->mem_store_alloc_offset;
+    param->mem_store_alloc_offset += page_table_size;
+
+    base_off = (uint64_t)page_table_ptr - (uint64_t)region_start_ptr;
+
+    memset(page_table_ptr, 0, page_table_size);
+    bucket_array = (CompactPageTableBucket*)page_table_ptr;
+  }
+
+  offset_t GetBaseOff() const {
+    return base_off;
+  }
+
+  uint64_t GetBucketNum() const {
+    return bucket_num;
+  }
+
+  char* GetAddrPtr() const {
+    return page_table_ptr;
+  }
+
+  uint64_t PageTableNodeSize() const {
+    return sizeof(CompactPageTableBucket);
+  }
+
+  uint64_t PageTableSize() const {
+    return page_table_size;
+  }
+
+  uint64_t GetItemNum() const {
+    return item_num;
+  }
+
+  // 以下静态函数同时给计算节点使用, 计算节点根据PageTableMeta中的base_off和bucket_num算出两个候选桶的偏移,
+  // 在一个doorbell中读取这两个桶, 然后用FindSlot在读到的桶中查找
+  static uint8_t GetFingerprint(PageId page_id) {
+    uint8_t fp = (uint8_t)(MurmurHash64A(page_id.Get(), 0xdeadbeef) >> 56);
+    return fp == 0 ? 1 : fp;
+  }
+
+  static std::pair<uint64_t, uint64_t> GetCandidateBuckets(PageId page_id, uint64_t bucket_num) {
+    uint64_t bucket1 = MurmurHash64A(page_id.Get(), 0xdeadbeef) % bucket_num;
+    uint64_t bucket2 = MurmurHash64A(page_id.Get(), 0xbeefdead) % bucket_num;
+    if (bucket2 == bucket1) bucket2 = (bucket1 + 1) % bucket_num;
+    return std::make_pair(bucket1, bucket2);
+  }
+
+  // 返回page_id在桶中的槽号, 没有找到返回-1
+  static int FindSlot(const CompactPageTableBucket* bucket, PageId page_id, uint8_t fp) {
+    for (int i = 0; i < COMPACT_PAGE_TABLE_SLOT_NUM; i++) {
+      if (bucket->fingerprints[i] == fp && bucket->items[i].page_id == page_id) return i;
+    }
+    return -1;
+  }
+
+  PageAddress LocalGetPageFrame(PageId page_id);
+
+  bool LocalInsertPageTableItem(PageId page_id, PageAddress page_address);
+
+  bool LocalDeletePageTableItem(PageId page_id);
+
+ private:
+  CompactPageTableBucket* GetBucket(uint64_t bucket_id) {
+    return &bucket_array[bucket_id];
+  }
+
+  static int FindEmptySlot(const CompactPageTableBucket* bucket) {
+    for (int i = 0; i < COMPACT_PAGE_TABLE_SLOT_NUM; i++) {
+      if (bucket->fingerprints[i] == 0) return i;
+    }
+    return -1;
+  }
+
+  // The offset in the RDMA region
+  // Attention: the base_off is offset of fisrt bucket
+  offset_t base_off;
+
+  // Total hash buckets
+  uint64_t bucket_num;
+
+  // The point to value in the table
+  char* page_table_ptr;
+  CompactPageTableBucket* bucket_array;
+
+  // The size of the entire hash table
+  size_t page_table_size;
+
+  // Start of the index region address
+  char* region_start_ptr;
+
+  // 已经插入的页表项个数
+  uint64_t item_num;
+
+  // cuckoo踢出时选择槽位的随机数种子
+  uint64_t kick_seed;
+};
+
+ALWAYS_INLINE
+PageAddress CompactPageTableStore::LocalGetPageFrame(PageId page_id) {
+  uint8_t fp = GetFingerprint(page_id);
+  auto buckets = GetCandidateBuckets(page_id, bucket_num);
+  for (uint64_t bucket_id : {buckets.first, buckets.second}) {
+    CompactPageTableBucket* bucket = GetBucket(bucket_id);
+    int slot = FindSlot(bucket, page_id, fp);
+    if (slot >= 0) return bucket->items[slot].page_address;
+  }
+  return {-1, INVALID_FRAME_ID};  // failed to found one
+}
+
+// 两个候选桶都满的时候随机选择一个槽踢出, 被踢出的页表项放到它的另一个候选桶中, 直到找到空槽
+// 踢出次数超过MAX_CUCKOO_KICK_NUM时按原路径撤销所有的踢出, 返回false
+ALWAYS_INLINE
+bool CompactPageTableStore::LocalInsertPageTableItem(PageId page_id, PageAddress page_address) {
+  // exits same key
+  if (LocalGetPageFrame(page_id).frame_id != INVALID_FRAME_ID) return false;
+
+  CompactPageTableItem item;
+  item.page_id = page_id;
+  item.page_address = page_address;
+  uint8_t fp = GetFingerprint(page_id);
+
+  auto buckets = GetCandidateBuckets(page_id, bucket_num);
+  for (uint64_t bucket_id : {buckets.first, buckets.second}) {
+    CompactPageTableBucket* bucket = GetBucket(bucket_id);
+    int slot = FindEmptySlot(bucket);
+    if (slot >= 0) {
+      bucket->items[slot] = item;
+      bucket->fingerprints[slot] = fp;
+      item_num++;
+      return true;
+    }
+  }
+
+  std::vector<std::pair<uint64_t, int>> kick_path;
+  uint64_t bucket_id = buckets.first;
+  for (int kick = 0; kick < MAX_CUCKOO_KICK_NUM; kick++) {
+    kick_seed ^= kick_seed << 13;
+    kick_seed ^= kick_seed >> 7;
+    kick_seed ^= kick_seed << 17;
+    int victim = kick_seed % COMPACT_PAGE_TABLE_SLOT_NUM;
+    CompactPageTableBucket* bucket = GetBucket(bucket_id);
+    std::swap(item, bucket->items[victim]);
+    std::swap(fp, bucket->fingerprints[victim]);
+    kick_path.emplace_back(bucket_id, victim);
+
+    // 被踢出的页表项移动到另一个候选桶
+    auto victim_buckets = GetCandidateBuckets(item.page_id, bucket_num);
+    bucket_id = victim_buckets.first == bucket_id ? victim_buckets.second : victim_buckets.first;
+    CompactPageTableBucket* alt_bucket = GetBucket(bucket_id);
+    int slot = FindEmptySlot(alt_bucket);
+    if (slot >= 0) {
+      alt_bucket->items[slot] = item;
+      alt_bucket->fingerprints[slot] = fp;
+      item_num++;
+      return true;
+    }
+  }
+
+  // 撤销踢出, 交换是自逆的, 逆序再交换一次即可恢复
+  for (auto it = kick_path.rbegin(); it != kick_path.rend(); ++it) {
+    CompactPageTableBucket* bucket = GetBucket(it->first);
+    std::swap(item, bucket->items[it->second]);
+    std::swap(fp, bucket->fingerprints[it->second]);
+  }
+  assert(item.page_id == page_id);
+  return false;
+}
+
+ALWAYS_INLINE
+bool CompactPageTableStore::LocalDeletePageTableItem(PageId page_id) {
+  uint8_t fp = GetFingerprint(page_id);
+  auto buckets = GetCandidateBuckets(page_id, bucket_num);
+  for (uint64_t bucket_id : {buckets.first, buckets.second}) {
+    CompactPageTableBucket* bucket = GetBucket(bucket_id);
+    int slot = FindSlot(bucket, page_id, fp);
+    if (slot >= 0) {
+      bucket->fingerprints[slot] = 0;
+      item_num--;
+      return true;
+    }
+  }
+  return false;
+}
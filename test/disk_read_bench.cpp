@@ -0,0 +1,100 @@
+#include <fcntl.h>
+#include <gflags/gflags.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "storage/disk_manager.h"
+#include "util/debug.h"
+
+DEFINE_string(bench_file, "disk_read_bench_table", "File used by the benchmark");
+DEFINE_int32(bench_pages, 65536, "Number of 4 KB pages in the benchmark file");
+DEFINE_int32(max_threads, 16, "Benchmark 1..max_threads reader threads");
+DEFINE_int32(seconds, 3, "Seconds to run for each thread count");
+DEFINE_string(mode, "pread", "pread: cached fd + pread (current GetPage path); "
+                             "lseek: open + lseek + read + close per page (old GetPage path)");
+
+/**
+ * 随机4KB页面读的吞吐测试, 线程数从1增加到max_threads
+ * 对比GetPage原来每次open/lseek/read/close的读取方式和DiskManager缓存fd+pread的读取方式
+ */
+
+static void PrepareFile(DiskManager* disk_manager) {
+    if (disk_manager->is_file(FLAGS_bench_file) &&
+        disk_manager->get_file_size(FLAGS_bench_file) >= (int64_t)FLAGS_bench_pages * PAGE_SIZE) {
+        return;
+    }
+    if (!disk_manager->is_file(FLAGS_bench_file)) disk_manager->create_file(FLAGS_bench_file);
+    int fd = disk_manager->open_file(FLAGS_bench_file);
+    char page[PAGE_SIZE];
+    for (page_id_t page_no = 0; page_no < FLAGS_bench_pages; page_no++) {
+        memset(page, page_no & 0xFF, PAGE_SIZE);
+        disk_manager->write_page(fd, page_no, page, PAGE_SIZE);
+    }
+    fsync(fd);
+    disk_manager->close_file(fd);
+}
+
+static void ReadOldPath(const std::string& file, page_id_t page_no, char* page) {
+    int fd = open(file.c_str(), O_RDWR);
+    lseek(fd, (off_t)page_no * PAGE_SIZE, SEEK_SET);
+    ssize_t bytes_read = read(fd, page, PAGE_SIZE);
+    if (bytes_read != PAGE_SIZE) {
+        RDMA_LOG(FATAL) << "read page " << page_no << " fails";
+    }
+    close(fd);
+}
+
+static void Reader(DiskManager* disk_manager, int thread_id, std::atomic<bool>* stop, uint64_t* read_num) {
+    std::mt19937_64 rand(thread_id * 7919 + 1);
+    std::uniform_int_distribution<page_id_t> page_dist(0, FLAGS_bench_pages - 1);
+    char page[PAGE_SIZE];
+    uint64_t cnt = 0;
+    bool use_pread = FLAGS_mode == "pread";
+    while (!stop->load(std::memory_order_relaxed)) {
+        page_id_t page_no = page_dist(rand);
+        if (use_pread) {
+            int fd = disk_manager->get_file_fd(FLAGS_bench_file);
+            disk_manager->read_page(fd, page_no, page, PAGE_SIZE);
+        } else {
+            ReadOldPath(FLAGS_bench_file, page_no, page);
+        }
+        cnt++;
+    }
+    *read_num = cnt;
+}
+
+int main(int argc, char* argv[]) {
+    google::ParseCommandLineFlags(&argc, &argv, true);
+
+    DiskManager* disk_manager = new DiskManager();
+    PrepareFile(disk_manager);
+
+    RDMA_LOG(INFO) << "mode: " << FLAGS_mode << ", pages: " << FLAGS_bench_pages << ", seconds per run: " << FLAGS_seconds;
+    for (int thread_num = 1; thread_num <= FLAGS_max_threads; thread_num++) {
+        std::atomic<bool> stop(false);
+        std::vector<uint64_t> read_nums(thread_num, 0);
+        std::vector<std::thread> threads;
+        for (int i = 0; i < thread_num; i++) {
+            threads.emplace_back(Reader, disk_manager, i, &stop, &read_nums[i]);
+        }
+        std::this_thread::sleep_for(std::chrono::seconds(FLAGS_seconds));
+        stop = true;
+        for (auto& t : threads) t.join();
+
+        uint64_t total = 0;
+        for (auto n : read_nums) total += n;
+        double pages_per_sec = (double)total / FLAGS_seconds;
+        std::cout << "threads: " << thread_num << ", pages/sec: " << (uint64_t)pages_per_sec
+                  << ", pages/sec/thread: " << (uint64_t)(pages_per_sec / thread_num) << std::endl;
+    }
+
+    delete disk_manager;
+    return 0;
+}
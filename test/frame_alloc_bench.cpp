@@ -0,0 +1,130 @@
+#include <gflags/gflags.h>
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <list>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "allocator/frame_magazine.h"
+#include "memstore/page_table.h"
+#include "util/debug.h"
+
+DEFINE_string(allocator, "global,magazine", "Comma separated frame allocators to benchmark: global, magazine");
+DEFINE_string(threads, "1,2,4,8,16", "Comma separated thread numbers");
+DEFINE_int64(insert_per_thread, 1000000, "Number of page table inserts (frame allocations) per thread");
+DEFINE_int32(rtt_ns, 2000, "Simulated latency of one RDMA round trip to the page table node");
+
+/**
+ * 计算节点空闲frame分配器的扩展性测试, 每次页表插入分配一个frame, 统计不同线程数下每秒的插入数
+ * global: 原来的实现, 计算节点上所有线程共享一个加锁的空闲链表, 链表为空时在持锁期间对环形缓冲区做FAA和READ,
+ *         两次round trip期间其他线程都被阻塞在锁上
+ * magazine: 每个线程一个FrameMagazine, 低于FRAME_MAGAZINE_LOW_WATERMARK时从环形缓冲区批量补充, 补充不持有任何锁
+ * 环形缓冲区用一个原子变量模拟, 远程访问用忙等rtt_ns模拟. 实际运行时补充的round trip还会被同一线程的其他协程掩盖,
+ * 这里把延迟全部算在分配线程上, 结果是magazine的下界
+ */
+
+// 模拟页表节点上的环形缓冲区, 空闲frame足够多, 只模拟FAA取出一批frame
+class SimRingBuffer {
+ public:
+  SimRingBuffer() : tail(0) {}
+
+  // FAA dequeue ticket, 然后READ这一批槽位, 共两次round trip
+  uint64_t FetchBatch() {
+    uint64_t start = tail.fetch_add(FRAME_MAGAZINE_REFILL_BATCH);
+    SimRoundTrip();
+    SimRoundTrip();
+    return start;
+  }
+
+ private:
+  static void SimRoundTrip() {
+    auto end = std::chrono::steady_clock::now() + std::chrono::nanoseconds(FLAGS_rtt_ns);
+    while (std::chrono::steady_clock::now() < end) {
+    }
+  }
+
+  std::atomic<uint64_t> tail;
+};
+
+static PageAddress MakePageAddress(uint64_t frame) { return PageAddress{0, (frame_id_t)frame}; }
+
+static void GlobalListThread(SimRingBuffer* ring, std::list<PageAddress>* free_list, std::mutex* free_list_mutex,
+                             uint64_t* checksum) {
+  uint64_t sum = 0;
+  for (int64_t i = 0; i < FLAGS_insert_per_thread; i++) {
+    free_list_mutex->lock();
+    if (free_list->empty()) {
+      uint64_t start = ring->FetchBatch();
+      for (int j = 0; j < FRAME_MAGAZINE_REFILL_BATCH; j++) free_list->push_back(MakePageAddress(start + j));
+    }
+    sum += free_list->front().frame_id;
+    free_list->pop_front();
+    free_list_mutex->unlock();
+  }
+  *checksum = sum;
+}
+
+static void MagazineThread(SimRingBuffer* ring, uint64_t* checksum) {
+  FrameMagazine magazine;
+  uint64_t sum = 0;
+  for (int64_t i = 0; i < FLAGS_insert_per_thread; i++) {
+    // 与DTX::ReserveFreePageSlots相同, 插入之前保证弹匣中的余量
+    while (magazine.Size() < 1 + FRAME_MAGAZINE_LOW_WATERMARK) {
+      uint64_t start = ring->FetchBatch();
+      for (int j = 0; j < FRAME_MAGAZINE_REFILL_BATCH; j++) magazine.Push(MakePageAddress(start + j));
+      magazine.GetStat().refill_num++;
+    }
+    PageAddress page_address;
+    magazine.Pop(page_address);
+    sum += page_address.frame_id;
+  }
+  *checksum = sum;
+}
+
+int main(int argc, char* argv[]) {
+  google::ParseCommandLineFlags(&argc, &argv, true);
+
+  std::vector<int> thread_nums;
+  std::stringstream thread_list(FLAGS_threads);
+  std::string thread_num;
+  while (std::getline(thread_list, thread_num, ',')) thread_nums.push_back(std::stoi(thread_num));
+
+  std::stringstream allocator_list(FLAGS_allocator);
+  std::string allocator;
+  while (std::getline(allocator_list, allocator, ',')) {
+    if (allocator != "global" && allocator != "magazine") {
+      RDMA_LOG(FATAL) << "unknown frame allocator: " << allocator;
+    }
+    for (int n : thread_nums) {
+      SimRingBuffer ring;
+      std::list<PageAddress> free_list;
+      std::mutex free_list_mutex;
+      std::vector<uint64_t> checksums(n, 0);
+      std::vector<std::thread> workers;
+
+      auto start = std::chrono::steady_clock::now();
+      for (int t = 0; t < n; t++) {
+        if (allocator == "global") {
+          workers.emplace_back(GlobalListThread, &ring, &free_list, &free_list_mutex, &checksums[t]);
+        } else {
+          workers.emplace_back(MagazineThread, &ring, &checksums[t]);
+        }
+      }
+      for (auto& worker : workers) worker.join();
+      double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+      uint64_t checksum = 0;
+      for (auto sum : checksums) checksum += sum;
+      uint64_t insert_num = (uint64_t)FLAGS_insert_per_thread * n;
+      std::cout << "allocator: " << allocator << ", threads: " << n << ", inserts: " << insert_num
+                << ", time(s): " << sec << ", inserts/sec: " << insert_num / sec << ", checksum: " << checksum
+                << std::endl;
+    }
+  }
+  return 0;
+}
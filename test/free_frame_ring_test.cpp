@@ -0,0 +1,247 @@
+#include <gflags/gflags.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "allocator/frame_magazine.h"
+#include "memstore/free_frame_ring.h"
+#include "util/debug.h"
+
+DEFINE_int32(capacity, 64, "Number of slots in the ring, small to exercise wrap-around and full rings");
+DEFINE_int32(frame_num, 1024, "Number of frames recycled between producers and consumers");
+DEFINE_int32(producer_num, 2, "Number of producer threads, as the victim threads on the page table node");
+DEFINE_int32(consumer_num, 4, "Number of consumer threads, as the compute node coroutines");
+DEFINE_int32(claim_per_consumer, 100000, "Number of refills per consumer");
+DEFINE_int32(max_batch, 16, "Max number of frames needed by one refill");
+
+/**
+ * FreeFrameRing和FrameMagazine::Refill的正确性测试
+ * 没有RDMA网卡时用SoftNic代替DTX::FrameRingAccessor: FAA是对dequeue_ticket的原子加, READ/WRITE按槽位拷贝,
+ * 先读序号再读frame, 与生产者先写frame再写序号的顺序配合, 与网卡读取不跨cache line的槽位得到一致结果的效果相同
+ * 1. 多个生产者和消费者并发, 消费者与DTX一样调用FrameMagazine::Refill补充需要的frame, 检查同一个frame不会
+ *    同时被分配给两个消费者, 结束时没有frame丢失. 消费者持有frame一段时间后还给生产者, 模拟淘汰之后的回收
+ * 2. 生产者暂停时领取的位置还没有全部写入, Refill取得需要的frame之后立即返回, 没有取完的位置留作pending claim,
+ *    之后的补充先取这些位置, 不再FAA, 也不会跳过或者重复任何位置
+ */
+
+struct SoftNic {
+  RingBufferItem* remote_slots;
+  uint64_t* remote_dequeue_ticket;
+  uint64_t capacity;
+  std::vector<RingBufferItem> local_slots;
+  uint64_t backoff_num = 0;
+
+  SoftNic(RingBufferItem* remote_slots, uint64_t* remote_dequeue_ticket, uint64_t capacity)
+      : remote_slots(remote_slots), remote_dequeue_ticket(remote_dequeue_ticket), capacity(capacity),
+        local_slots(FRAME_MAGAZINE_REFILL_BATCH) {}
+
+  uint64_t Capacity() const { return capacity; }
+
+  uint64_t Claim(size_t num) { return __atomic_fetch_add(remote_dequeue_ticket, num, __ATOMIC_ACQ_REL); }
+
+  RingBufferItem* Read(uint64_t pos, size_t num) {
+    for (size_t i = 0; i < num; i++) {
+      RingBufferItem& slot = remote_slots[(pos + i) % capacity];
+      local_slots[i].seq = __atomic_load_n(&slot.seq, __ATOMIC_ACQUIRE);
+      local_slots[i].node_id = __atomic_load_n(&slot.node_id, __ATOMIC_RELAXED);
+      local_slots[i].frame_id = __atomic_load_n(&slot.frame_id, __ATOMIC_RELAXED);
+    }
+    return local_slots.data();
+  }
+
+  void Write(uint64_t pos, size_t num, RingBufferItem* local) {
+    for (size_t i = 0; i < num; i++) {
+      RingBufferItem& slot = remote_slots[(pos + i) % capacity];
+      __atomic_store_n(&slot.seq, local[i].seq, __ATOMIC_RELEASE);
+    }
+  }
+
+  void Backoff(int wait_num) {
+    backoff_num++;
+    std::this_thread::yield();
+  }
+};
+
+// 淘汰之后等待放入环形缓冲区的frame, 对应PageTableStore::free_list_
+struct FreeList {
+  std::mutex mutex;
+  std::deque<frame_id_t> frames;
+};
+
+static void Check(bool cond, const char* what) {
+  if (!cond) RDMA_LOG(FATAL) << "check fails: " << what;
+}
+
+static void TestConcurrentRefill() {
+  std::vector<RingBufferItem> slots(FLAGS_capacity);
+  uint64_t enqueue_ticket = 0;
+  uint64_t dequeue_ticket = 0;
+  FreeFrameRing ring(slots.data(), FLAGS_capacity, &enqueue_ticket);
+  ring.Init();
+
+  FreeList free_list;
+  for (int i = 0; i < FLAGS_frame_num; i++) free_list.frames.push_back(i);
+
+  // 每个frame当前的持有者个数, 大于1说明同一个frame被分配了两次
+  std::vector<std::atomic<int>> owners(FLAGS_frame_num);
+  for (auto& owner : owners) owner = 0;
+  std::atomic<uint64_t> handed_out(0);
+  std::atomic<uint64_t> wait_num(0);
+  std::atomic<uint64_t> claim_num(0);
+  std::atomic<bool> consumers_done(false);
+
+  std::vector<std::thread> producers;
+  for (int p = 0; p < FLAGS_producer_num; p++) {
+    producers.emplace_back([&] {
+      while (!consumers_done.load()) {
+        free_list.mutex.lock();
+        if (free_list.frames.empty()) {
+          free_list.mutex.unlock();
+          std::this_thread::yield();
+          continue;
+        }
+        frame_id_t frame_id = free_list.frames.front();
+        free_list.frames.pop_front();
+        free_list.mutex.unlock();
+        if (!ring.TryPush(0, frame_id)) {
+          free_list.mutex.lock();
+          free_list.frames.push_front(frame_id);
+          free_list.mutex.unlock();
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+
+  std::vector<std::thread> consumers;
+  for (int c = 0; c < FLAGS_consumer_num; c++) {
+    consumers.emplace_back([&, c] {
+      SoftNic nic(slots.data(), &dequeue_ticket, FLAGS_capacity);
+      FrameMagazine magazine;
+      std::mt19937 rand(c);
+      std::vector<frame_id_t> held;
+      auto take_frames = [&]() {
+        PageAddress page_address;
+        while (magazine.Pop(page_address)) {
+          frame_id_t frame_id = page_address.frame_id;
+          if (frame_id < 0 || frame_id >= FLAGS_frame_num || owners[frame_id].fetch_add(1) != 0) {
+            RDMA_LOG(FATAL) << "frame " << frame_id << " is handed out twice";
+          }
+          held.push_back(frame_id);
+          handed_out++;
+        }
+      };
+      auto return_frames = [&]() {
+        std::lock_guard<std::mutex> lock(free_list.mutex);
+        for (auto frame_id : held) {
+          owners[frame_id].fetch_sub(1);
+          free_list.frames.push_back(frame_id);
+        }
+        held.clear();
+      };
+      for (int k = 0; k < FLAGS_claim_per_consumer; k++) {
+        magazine.Refill(nic, 0, rand() % FLAGS_max_batch + 1);
+        take_frames();
+        // 持有一部分frame之后归还, 让frame在生产者和消费者之间循环
+        if (held.size() > (size_t)FLAGS_max_batch) return_frames();
+      }
+      // 退出之前取完领取的位置, 否则生产者下一圈会一直等待这些槽位
+      return_frames();
+      magazine.Refill(nic, 0, magazine.PendingClaim(0).num);
+      Check(magazine.PendingClaim(0).num == 0, "the pending claim is drained");
+      take_frames();
+      return_frames();
+      wait_num += nic.backoff_num;
+      claim_num += magazine.GetStat().refill_num;
+    });
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  for (auto& consumer : consumers) consumer.join();
+  consumers_done = true;
+  for (auto& producer : producers) producer.join();
+  double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  // 所有frame要么在空闲链表中, 要么在环形缓冲区中等待被领取
+  Check(dequeue_ticket == claim_num.load() * FRAME_MAGAZINE_REFILL_BATCH, "every claim takes one batch");
+  uint64_t in_ring = enqueue_ticket - dequeue_ticket;
+  if (free_list.frames.size() + in_ring != (size_t)FLAGS_frame_num) {
+    RDMA_LOG(FATAL) << "frames lost, in free list: " << free_list.frames.size() << ", in ring: " << in_ring;
+  }
+  std::cout << "concurrent refill, handed out: " << handed_out.load() << ", claims: " << claim_num.load()
+            << ", wait for producer: " << wait_num.load() << ", time(s): " << sec << std::endl;
+}
+
+static void TestStalledProducer() {
+  uint64_t capacity = FRAME_MAGAZINE_REFILL_BATCH * 2;
+  std::vector<RingBufferItem> slots(capacity);
+  uint64_t enqueue_ticket = 0;
+  uint64_t dequeue_ticket = 0;
+  FreeFrameRing ring(slots.data(), capacity, &enqueue_ticket);
+  ring.Init();
+  SoftNic nic(slots.data(), &dequeue_ticket, capacity);
+  FrameMagazine magazine;
+
+  frame_id_t next_frame = 0;
+  auto produce = [&](int num) {
+    for (int i = 0; i < num; i++) Check(ring.TryPush(0, next_frame++), "the ring has free slots");
+  };
+  std::vector<frame_id_t> taken;
+  auto take_frames = [&]() {
+    PageAddress page_address;
+    while (magazine.Pop(page_address)) taken.push_back(page_address.frame_id);
+  };
+
+  // 生产者只写入了领取的一批位置中的前10个, 需要4个frame时不等待剩下的位置
+  produce(10);
+  Check(magazine.Refill(nic, 0, 4) == 10, "refill takes the written slots");
+  Check(dequeue_ticket == FRAME_MAGAZINE_REFILL_BATCH, "one batch is claimed");
+  FrameClaim claim = magazine.PendingClaim(0);
+  Check(claim.pos == 10 && claim.num == FRAME_MAGAZINE_REFILL_BATCH - 10, "the rest of the batch stays pending");
+  Check(nic.backoff_num == 0, "no wait when enough slots are written");
+  take_frames();
+
+  // 生产者暂停一段时间后继续, Refill在等待期间退避, 取得的frame来自pending claim, 不再FAA
+  std::thread late_producer([&] {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    produce(5);
+  });
+  Check(magazine.Refill(nic, 0, 3) == 5, "refill waits for the stalled producer");
+  late_producer.join();
+  Check(nic.backoff_num > 0, "refill backs off while the slots are empty");
+  Check(dequeue_ticket == FRAME_MAGAZINE_REFILL_BATCH, "the pending claim is used before a new FAA");
+  claim = magazine.PendingClaim(0);
+  Check(claim.pos == 15 && claim.num == FRAME_MAGAZINE_REFILL_BATCH - 15, "the pending claim advances");
+  take_frames();
+
+  // pending claim取完之后才领取下一批
+  produce(FRAME_MAGAZINE_REFILL_BATCH);
+  size_t need = FRAME_MAGAZINE_REFILL_BATCH - 15 + 5;
+  Check(magazine.Refill(nic, 0, need) == FRAME_MAGAZINE_REFILL_BATCH, "refill drains the pending claim first");
+  Check(dequeue_ticket == 2 * FRAME_MAGAZINE_REFILL_BATCH, "a new batch is claimed after the pending one");
+  claim = magazine.PendingClaim(0);
+  Check(claim.pos == FRAME_MAGAZINE_REFILL_BATCH + 15 && claim.num == FRAME_MAGAZINE_REFILL_BATCH - 15,
+        "the new batch is pending");
+  take_frames();
+
+  // 每个写入的位置恰好被取出一次
+  std::sort(taken.begin(), taken.end());
+  Check(taken.size() == (size_t)next_frame, "every written slot is taken");
+  for (size_t i = 0; i < taken.size(); i++) Check(taken[i] == (frame_id_t)i, "no slot is skipped or taken twice");
+  std::cout << "stalled producer, taken: " << taken.size() << ", backoff: " << nic.backoff_num << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+  google::ParseCommandLineFlags(&argc, &argv, true);
+  TestStalledProducer();
+  TestConcurrentRefill();
+  std::cout << "PASS" << std::endl;
+  return 0;
+}
@@ -0,0 +1,189 @@
+#include <gflags/gflags.h>
+
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include "cache/index_cache.h"
+#include "memstore/data_item.h"
+#include "util/debug.h"
+
+DEFINE_int32(key_num, 100000, "Number of keys in the simulated table");
+DEFINE_int32(hot_key_num, 1000, "Number of hot keys accessed by most lookups");
+DEFINE_int32(lookup_num, 1000000, "Number of simulated lookups");
+DEFINE_int32(bucket_num, 4096, "Number of simulated index buckets");
+DEFINE_int32(batch_size, 16, "Number of keys read together, as one LocalBatch");
+
+/**
+ * IndexCache的正确性测试, 读取记录走LocalBatch::ReadData使用的IndexCache::ReadRecords
+ * 远程索引用一个key->Rid的表和每个桶的version模拟, 读取记录用Rid->key的表模拟,
+ * 分别作为ReadRecords的lookup(GetHashIndex)和fetch(FetchTuple)
+ * 1. 热点访问: 热点key之后的查找都命中
+ * 2. 本节点修改了桶: 桶上的缓存项通过version发现过期, 不会返回旧的Rid
+ * 3. 其他节点修改了桶: 缓存项返回旧的Rid, 读到的记录的key不匹配, 计为false hit,
+ *    ReadRecords重新获取索引并只重新读取这些记录, 新的Rid写回index供FlushWrite使用
+ * 4. 扫描: 填入缓存容量三倍的冷key, 期间热点key一直被访问, 分片满了之后只淘汰冷key
+ */
+
+static void Check(bool cond, const char* what) {
+  if (!cond) RDMA_LOG(FATAL) << "check fails: " << what;
+}
+
+struct SimIndex {
+  IndexCache* cache;
+  std::unordered_map<itemkey_t, Rid> rids;
+  std::unordered_map<uint64_t, itemkey_t> records;
+  std::vector<version_t> bucket_versions;
+  uint64_t remote_lookup_num = 0;
+  uint64_t fetch_num = 0;
+
+  static uint64_t RecordId(const Rid& rid) { return ((uint64_t)rid.page_no_ << 32) | (uint32_t)rid.slot_no_; }
+
+  offset_t BucketOff(itemkey_t key) { return (key % bucket_versions.size()) * 4096; }
+
+  void Put(itemkey_t key, Rid rid) {
+    auto it = rids.find(key);
+    if (it != rids.end()) records.erase(RecordId(it->second));
+    rids[key] = rid;
+    records[RecordId(rid)] = key;
+  }
+
+  // 其他节点修改桶: 只改变远程的version
+  void RemoteUpdate(itemkey_t key, Rid rid) {
+    Put(key, rid);
+    bucket_versions[key % bucket_versions.size()]++;
+  }
+
+  // 本节点修改桶: 同时记录桶的新version
+  void LocalUpdate(itemkey_t key, Rid rid) {
+    RemoteUpdate(key, rid);
+    cache->UpdateBucketVersion(0, BucketOff(key), bucket_versions[key % bucket_versions.size()]);
+  }
+
+  Rid RemoteLookup(itemkey_t key) {
+    remote_lookup_num++;
+    version_t version = bucket_versions[key % bucket_versions.size()];
+    cache->UpdateBucketVersion(0, BucketOff(key), version);
+    Rid rid = rids.at(key);
+    cache->Insert(1, key, rid, 0, BucketOff(key), version);
+    return rid;
+  }
+
+  // FetchTuple: 按Rid读取记录, Rid上已经是其他记录时读到其他key
+  std::vector<DataItemPtr> Fetch(std::vector<table_id_t>& tid_list, std::vector<Rid>& id_list) {
+    std::vector<DataItemPtr> data_list;
+    for (size_t i = 0; i < id_list.size(); i++) {
+      fetch_num++;
+      auto it = records.find(RecordId(id_list[i]));
+      auto item = std::make_shared<DataItem>(tid_list[i], it == records.end() ? -1 : it->second);
+      if (it == records.end()) item->valid = 0;
+      data_list.push_back(item);
+    }
+    return data_list;
+  }
+
+  // GetHashIndex: 先查找缓存, 未命中的key读取远程索引
+  std::unordered_map<table_id_t, std::unordered_map<itemkey_t, Rid>> GetHashIndex(std::vector<table_id_t>& tid_list,
+                                                                                  std::vector<itemkey_t>& key_list) {
+    std::unordered_map<table_id_t, std::unordered_map<itemkey_t, Rid>> index;
+    for (size_t i = 0; i < key_list.size(); i++) {
+      Rid rid;
+      if (!cache->Search(tid_list[i], key_list[i], rid)) rid = RemoteLookup(key_list[i]);
+      index[tid_list[i]][key_list[i]] = rid;
+    }
+    return index;
+  }
+
+  // 与LocalBatch::ExeBatchRW相同: 获取索引之后读取记录, 检查读到的记录和写回index中的Rid
+  void ReadBatch(std::vector<itemkey_t> keys) {
+    std::vector<table_id_t> tids(keys.size(), 1);
+    auto index = GetHashIndex(tids, keys);
+    auto fetch = [&](std::vector<table_id_t>& tid_list, std::vector<Rid>& id_list) { return Fetch(tid_list, id_list); };
+    auto lookup = [&](std::vector<table_id_t>& tid_list, std::vector<itemkey_t>& key_list) {
+      return GetHashIndex(tid_list, key_list);
+    };
+    auto data_list = cache->ReadRecords(index, fetch, lookup);
+    Check(data_list.size() == keys.size(), "one record per key");
+    for (auto& item : data_list) {
+      Check(item->valid && item->table_id == 1, "the record exists");
+      Check(std::find(keys.begin(), keys.end(), item->key) != keys.end(), "the record is one of the keys");
+      Check(index[1][item->key] == rids.at(item->key), "index holds the current rid for FlushWrite");
+    }
+  }
+};
+
+int main(int argc, char* argv[]) {
+  google::ParseCommandLineFlags(&argc, &argv, true);
+
+  IndexCache cache;
+  SimIndex index{&cache};
+  index.bucket_versions.resize(FLAGS_bucket_num, 0);
+  for (int key = 0; key < FLAGS_key_num; key++) index.Put(key, {key / 64, key % 64});
+
+  // 1. 热点访问, 每批是不重复的热点key
+  std::mt19937_64 rand(2024);
+  for (int i = 0; i < FLAGS_lookup_num / FLAGS_batch_size; i++) {
+    std::vector<itemkey_t> keys;
+    while (keys.size() < (size_t)FLAGS_batch_size) {
+      itemkey_t key = rand() % FLAGS_hot_key_num;
+      if (std::find(keys.begin(), keys.end(), key) == keys.end()) keys.push_back(key);
+    }
+    index.ReadBatch(keys);
+  }
+  auto stat = cache.GetStat();
+  Check(stat.miss_num == (uint64_t)FLAGS_hot_key_num, "only the first lookup of each hot key misses");
+  Check(stat.false_hit_num == 0 && stat.stale_num == 0, "no stale entry without updates");
+  std::cout << "hot keys: hit " << stat.hit_num << ", miss " << stat.miss_num << std::endl;
+
+  auto read_hot_keys = [&]() {
+    for (int key = 0; key < FLAGS_hot_key_num; key += FLAGS_batch_size) {
+      std::vector<itemkey_t> keys;
+      for (int k = key; k < std::min(key + FLAGS_batch_size, FLAGS_hot_key_num); k++) keys.push_back(k);
+      index.ReadBatch(keys);
+    }
+  };
+
+  // 2. 本节点修改桶, 使用新的Rid
+  int next_page = FLAGS_key_num;
+  for (int key = 0; key < FLAGS_hot_key_num; key += 10) index.LocalUpdate(key, {next_page++, 0});
+  read_hot_keys();
+  auto local_stat = cache.GetStat();
+  Check(local_stat.stale_num > 0, "local updates are detected by the bucket version");
+  Check(local_stat.false_hit_num == 0, "local updates never cause false hits");
+  std::cout << "local update: stale " << local_stat.stale_num << std::endl;
+
+  // 3. 其他节点修改桶, 记录的key不匹配, 只有这些记录重新获取索引并重新读取
+  for (int key = 1; key < FLAGS_hot_key_num; key += 10) index.RemoteUpdate(key, {next_page++, 0});
+  uint64_t fetch_num = index.fetch_num;
+  uint64_t remote_lookup_num = index.remote_lookup_num;
+  read_hot_keys();
+  auto remote_stat = cache.GetStat();
+  uint64_t remote_update_num = (FLAGS_hot_key_num + 8) / 10;
+  Check(remote_stat.false_hit_num == remote_update_num, "every remote update causes one false hit");
+  Check(index.fetch_num - fetch_num == FLAGS_hot_key_num + remote_update_num, "only false hits are fetched again");
+  Check(index.remote_lookup_num - remote_lookup_num == remote_update_num, "only false hits read the remote index");
+  std::cout << "remote update: false hit " << remote_stat.false_hit_num << ", stale " << remote_stat.stale_num
+            << std::endl;
+
+  // 4. 另一张表的扫描先填满所有分片, 之后继续扫描, 热点key在扫描期间一直被访问, 不会被淘汰
+  uint64_t capacity = (uint64_t)INDEX_CACHE_SHARD_NUM * MAX_INDEX_CACHE_ITEM_PER_SHARD;
+  auto scan = [&](uint64_t num) {
+    for (uint64_t i = 0; i < num; i++) {
+      cache.Insert(2, rand(), {(page_id_t)(i / 64), (int)(i % 64)}, 0, 0, 0);
+      if (i % 65536 == 0) read_hot_keys();
+    }
+  };
+  scan(capacity);
+  read_hot_keys();
+  uint64_t scan_miss_num = cache.GetStat().miss_num;
+  scan(capacity * 2);
+  read_hot_keys();
+  Check(cache.GetStat().miss_num == scan_miss_num, "a scan does not evict hot keys");
+  std::cout << "scan: " << capacity * 3 << " cold keys, hot keys all hit" << std::endl;
+
+  std::cout << "PASS" << std::endl;
+  return 0;
+}
@@ -0,0 +1,163 @@
+#include <gflags/gflags.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "compact_hash_index.h"
+#include "memstore/hash_index_store.h"
+#include "util/debug.h"
+
+DEFINE_string(layout, "node,compact", "Comma separated hash index layouts to benchmark: node, compact");
+DEFINE_int32(index_mb, 256, "Memory of one hash index in MB, shared by both layouts");
+DEFINE_double(fill_ratio, 0.9, "Number of inserted keys relative to the slots of the compact layout");
+DEFINE_int64(lookup_num, 10000000, "Number of random lookups of existing keys");
+DEFINE_double(nic_gbps, 100, "NIC bandwidth used to estimate the bandwidth bound lookups/sec");
+
+/**
+ * 哈希索引布局的对比测试, 在同样大小的内存中分别用IndexNode布局和紧凑布局建立索引, 插入相同的key后随机查找,
+ * 统计每次远程查找需要读取的字节数, 本地查找的CPU开销, 以及在给定网卡带宽下单个索引节点能支撑的查找次数
+ * 两种布局的主桶都占内存的3/4, 剩下的1/4作为扩展桶/溢出桶的保留区
+ * node: 每次查找读取key所在的整个IndexNode桶链
+ * compact: 每一轮在一个doorbell中读取两条候选链上的下一个桶, 指纹冲突时需要多读取一条记录来比较key
+ */
+
+// key i的Rid, 根据Rid可以找回i, 模拟读取记录之后比较DataItem中的key
+static Rid MakeRid(uint64_t i) { return {(page_id_t)(i / 64), (int)(i % 64)}; }
+
+static uint64_t RidToIndex(const Rid& rid) { return (uint64_t)rid.page_no_ * 64 + rid.slot_no_; }
+
+// 记录的大小, 用于估计指纹冲突时多读取的字节数
+static constexpr size_t RECORD_READ_SIZE = 128;
+
+static void PrintResult(const std::string& layout, uint64_t key_num, uint64_t inserted, uint64_t node_num,
+                        double bytes_per_lookup, double ns_per_lookup, double false_hit_per_lookup, uint64_t checksum) {
+  double nic_lookups = FLAGS_nic_gbps * 1e9 / 8 / bytes_per_lookup;
+  std::cout << "layout: " << layout << ", keys: " << key_num << ", inserted: " << inserted << ", nodes: " << node_num
+            << ", bytes/lookup: " << bytes_per_lookup << ", ns/lookup: " << ns_per_lookup
+            << ", false hits/lookup: " << false_hit_per_lookup << ", NIC bound lookups/sec: " << nic_lookups
+            << ", checksum: " << checksum << std::endl;
+}
+
+// 与DTX::GetHashIndex相同, 从主桶开始沿着next_expand_node_id读取, 返回远程读取的桶个数
+static int NodeLookup(IndexNode* buckets, char* expand_base, uint64_t bucket_num, itemkey_t key, Rid& rid) {
+  IndexNode* node = &buckets[MurmurHash64A(key, 0xdeadbeef) % bucket_num];
+  int read_nodes = 1;
+  while (true) {
+    for (int i = 0; i < MAX_RIDS_NUM_PER_NODE; i++) {
+      if (node->index_items[i].valid == true && node->index_items[i].key == key) {
+        rid = node->index_items[i].rid;
+        return read_nodes;
+      }
+    }
+    if (node->next_expand_node_id[0] < 0) return read_nodes;
+    node = (IndexNode*)(expand_base + node->next_expand_node_id[0] * sizeof(IndexNode));
+    read_nodes++;
+  }
+}
+
+// 两条候选链并行读取, 每一轮读取每条链上的下一个桶, 返回远程读取的字节数
+static size_t CompactLookup(CompactIndexBucket* buckets, char* expand_base, uint64_t bucket_num, itemkey_t key,
+                            const std::vector<itemkey_t>& keys, Rid& rid, uint64_t& false_hits) {
+  uint16_t fp = CompactIndexStore::GetFingerprint(key);
+  auto candidates = CompactIndexStore::GetCandidateBuckets(key, bucket_num);
+  CompactIndexBucket* chains[2] = {&buckets[candidates.first], &buckets[candidates.second]};
+  size_t read_bytes = 0;
+  std::vector<Rid> rids;
+  while (chains[0] != nullptr || chains[1] != nullptr) {
+    rids.clear();
+    for (auto& bucket : chains) {
+      if (bucket == nullptr) continue;
+      read_bytes += sizeof(CompactIndexBucket);
+      CompactIndexStore::FindCandidates(bucket, fp, rids);
+      bucket = bucket->next_overflow_id == COMPACT_INDEX_NO_OVERFLOW
+                   ? nullptr
+                   : (CompactIndexBucket*)(expand_base + bucket->next_overflow_id * sizeof(CompactIndexBucket));
+    }
+    for (auto& candidate : rids) {
+      if (keys[RidToIndex(candidate)] == key) {
+        rid = candidate;
+        return read_bytes;
+      }
+      false_hits++;
+      read_bytes += RECORD_READ_SIZE;
+    }
+  }
+  return read_bytes;
+}
+
+int main(int argc, char* argv[]) {
+  google::ParseCommandLineFlags(&argc, &argv, true);
+
+  size_t mem_size = (size_t)FLAGS_index_mb * 1024 * 1024;
+  size_t main_size = mem_size / 4 * 3;
+  uint64_t compact_bucket_num = main_size / sizeof(CompactIndexBucket);
+  uint64_t key_num = compact_bucket_num * COMPACT_INDEX_SLOT_NUM * FLAGS_fill_ratio;
+  RDMA_LOG(INFO) << "sizeof(IndexNode): " << sizeof(IndexNode)
+                 << ", sizeof(CompactIndexBucket): " << sizeof(CompactIndexBucket) << ", keys: " << key_num;
+
+  std::mt19937_64 rand(2024);
+  std::vector<itemkey_t> keys(key_num);
+  for (auto& key : keys) key = rand();
+  std::vector<uint64_t> lookups(FLAGS_lookup_num);
+  for (auto& lookup : lookups) lookup = rand() % key_num;
+
+  // 主桶和保留区放在同一块内存中
+  char* region = (char*)aligned_alloc(4096, mem_size);
+
+  std::stringstream layout_list(FLAGS_layout);
+  std::string layout;
+  while (std::getline(layout_list, layout, ',')) {
+    uint64_t inserted = 0;
+    uint64_t checksum = 0;
+    uint64_t read_bytes = 0;
+    uint64_t false_hits = 0;
+    MemStoreAllocParam param(region, region, 0, region + main_size);
+    MemStoreReserveParam param_reserve(region + main_size, 0, region + mem_size);
+    if (layout == "node") {
+      uint64_t bucket_num = main_size / sizeof(IndexNode);
+      IndexStore index(1, bucket_num, &param, &param_reserve);
+      for (uint64_t i = 0; i < key_num; i++) {
+        if (param_reserve.mem_store_reserve_offset + sizeof(IndexNode) > mem_size - main_size) break;
+        if (index.LocalInsertKeyRid(keys[i], MakeRid(i), &param_reserve)) inserted++;
+      }
+      uint64_t node_num = bucket_num + param_reserve.mem_store_reserve_offset / sizeof(IndexNode);
+      auto start = std::chrono::steady_clock::now();
+      for (auto i : lookups) {
+        // 同样大小的内存放不下所有的key, 只查找已经插入的key
+        if (i >= inserted) i %= inserted;
+        Rid rid{INVALID_PAGE_ID, -1};
+        read_bytes += NodeLookup((IndexNode*)index.GetIndexPtr(), region + main_size, bucket_num, keys[i], rid) * sizeof(IndexNode);
+        checksum += rid.page_no_;
+      }
+      double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+      PrintResult(layout, key_num, inserted, node_num, (double)read_bytes / lookups.size(), ns / lookups.size(), 0,
+                  checksum);
+    } else if (layout == "compact") {
+      CompactIndexStore index(1, compact_bucket_num, &param, &param_reserve);
+      for (uint64_t i = 0; i < key_num; i++) {
+        if (index.LocalInsertKeyRid(keys[i], MakeRid(i), &param_reserve)) inserted++;
+      }
+      auto* buckets = (CompactIndexBucket*)(region + index.GetBaseOff());
+      auto start = std::chrono::steady_clock::now();
+      for (auto i : lookups) {
+        Rid rid{INVALID_PAGE_ID, -1};
+        read_bytes += CompactLookup(buckets, region + main_size, compact_bucket_num, keys[i], keys, rid, false_hits);
+        checksum += rid.page_no_;
+      }
+      double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+      PrintResult(layout, key_num, inserted, compact_bucket_num + index.GetOverflowNum(),
+                  (double)read_bytes / lookups.size(), ns / lookups.size(), (double)false_hits / lookups.size(),
+                  checksum);
+    } else {
+      RDMA_LOG(FATAL) << "unknown hash index layout: " << layout;
+    }
+  }
+  free(region);
+  return 0;
+}
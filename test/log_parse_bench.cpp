@@ -0,0 +1,209 @@
+#include <gflags/gflags.h>
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "log/log_record.h"
+#include "util/debug.h"
+
+DEFINE_int32(record_num, 1000000, "Number of log records in the generated log buffer");
+DEFINE_int32(table_num, 9, "Number of distinct table names in the log");
+DEFINE_int32(value_size, 64, "Size of each inserted/updated value in bytes");
+DEFINE_int32(records_per_batch, 1000, "Number of records between two BATCHEND records");
+DEFINE_int32(rounds, 5, "Number of passes over the log buffer for each mode");
+
+/**
+ * 日志重放解析部分的CPU开销测试, 不包含页面修改和IO
+ * object: 原来的重放方式, 每条日志new一个LogRecord子类, 虚函数deserialize, dynamic_cast, 构造string表名
+ * view: LogRecordView在buffer上直接读取字段, 按LogType switch分发, 表名查找已经转换过的表
+ */
+
+static std::string TableName(int table) { return "bench_table_" + std::to_string(table); }
+
+static std::string GenerateLog(std::vector<size_t>& record_offs) {
+    std::mt19937_64 rand(2024);
+    std::uniform_int_distribution<int> table_dist(0, FLAGS_table_num - 1);
+    std::uniform_int_distribution<int> type_dist(0, 99);
+    std::uniform_int_distribution<int> page_dist(1, 1 << 16);
+    std::vector<char> value(FLAGS_value_size, 'v');
+
+    std::string log;
+    batch_id_t batch_id = 1;
+    for (int i = 0; i < FLAGS_record_num; i++) {
+        std::string record;
+        std::string table_name = TableName(table_dist(rand));
+        RmRecord rm_record(i, FLAGS_value_size, value.data());
+        Rid rid{page_dist(rand), 64};
+        int type = type_dist(rand);
+        if ((i + 1) % FLAGS_records_per_batch == 0) {
+            BatchEndLogRecord batch_end(batch_id++, 0, 0);
+            record.resize(batch_end.log_tot_len_);
+            batch_end.serialize(&record[0]);
+        } else if (type < 70) {
+            UpdateLogRecord update(batch_id, 0, i, rm_record, rid, table_name);
+            record.resize(update.log_tot_len_);
+            update.serialize(&record[0]);
+        } else if (type < 85) {
+            InsertLogRecord insert(batch_id, 0, i, rm_record, rid, table_name);
+            insert.set_meta(16, 1, 10, 3);
+            record.resize(insert.log_tot_len_);
+            insert.serialize(&record[0]);
+        } else if (type < 95) {
+            DeleteLogRecord del(batch_id, 0, i, table_name, rid.page_no_);
+            del.set_meta(16, 0, RmPageHdr{-1, 9}, 3);
+            record.resize(del.log_tot_len_);
+            del.serialize(&record[0]);
+        } else {
+            NewPageLogRecord new_page(batch_id, 0, i, table_name, rid.page_no_);
+            new_page.set_meta(rid.page_no_ + 1, rid.page_no_);
+            record.resize(new_page.log_tot_len_);
+            new_page.serialize(&record[0]);
+        }
+        record_offs.push_back(log.size());
+        log.append(record);
+    }
+    return log;
+}
+
+static int GetTableId(std::unordered_map<std::string, int>& table_ids, const std::string& table_name) {
+    auto iter = table_ids.find(table_name);
+    if (iter != table_ids.end()) return iter->second;
+    int table_id = (int)table_ids.size();
+    table_ids.emplace(table_name, table_id);
+    return table_id;
+}
+
+// 原来的解析方式, 表名转换为string之后查哈希表(对应DiskManager::get_file_fd), 返回各字段之和防止被编译器优化掉
+static uint64_t ParseObject(const std::string& log, std::unordered_map<std::string, int>& table_ids) {
+    uint64_t sum = 0;
+    size_t offset = 0;
+    while (offset < log.size()) {
+        const char* src = log.data() + offset;
+        uint32_t size = *reinterpret_cast<const uint32_t*>(src + OFFSET_LOG_TOT_LEN);
+        LogRecord* record;
+        switch (*reinterpret_cast<const LogType*>(src + OFFSET_LOG_TYPE)) {
+            case LogType::INSERT: record = new InsertLogRecord(); break;
+            case LogType::UPDATE: record = new UpdateLogRecord(); break;
+            case LogType::DELETE: record = new DeleteLogRecord(); break;
+            case LogType::NEWPAGE: record = new NewPageLogRecord(); break;
+            default: record = new BatchEndLogRecord(); break;
+        }
+        record->deserialize(src);
+        switch (record->log_type_) {
+            case LogType::INSERT: {
+                InsertLogRecord* insert_log = dynamic_cast<InsertLogRecord*>(record);
+                std::string table_name(insert_log->table_name_, insert_log->table_name_ + insert_log->table_name_size_);
+                sum += GetTableId(table_ids, table_name) + insert_log->rid_.page_no_ + insert_log->insert_value_.value_[0] +
+                       insert_log->first_free_page_no_;
+            } break;
+            case LogType::UPDATE: {
+                UpdateLogRecord* update_log = dynamic_cast<UpdateLogRecord*>(record);
+                std::string table_name(update_log->table_name_, update_log->table_name_ + update_log->table_name_size_);
+                sum += GetTableId(table_ids, table_name) + update_log->rid_.page_no_ + update_log->new_value_.value_[0];
+            } break;
+            case LogType::DELETE: {
+                DeleteLogRecord* delete_log = dynamic_cast<DeleteLogRecord*>(record);
+                std::string table_name(delete_log->table_name_, delete_log->table_name_ + delete_log->table_name_size_);
+                sum += GetTableId(table_ids, table_name) + delete_log->page_no_ + delete_log->first_free_page_no_;
+            } break;
+            case LogType::NEWPAGE: {
+                NewPageLogRecord* new_page_log = dynamic_cast<NewPageLogRecord*>(record);
+                std::string table_name(new_page_log->table_name_, new_page_log->table_name_ + new_page_log->table_name_size_);
+                sum += GetTableId(table_ids, table_name) + new_page_log->page_no_ + new_page_log->num_pages_;
+            } break;
+            default:
+                sum += record->log_batch_id_;
+                break;
+        }
+        delete record;
+        offset += size;
+    }
+    return sum;
+}
+
+// 与LogReplay::get_table_fd相同的表名查找方式
+static int GetTableId(std::vector<std::pair<std::string, int>>& tables, const char* name, size_t size) {
+    for (auto& table : tables) {
+        if (table.first.size() == size && memcmp(table.first.data(), name, size) == 0) return table.second;
+    }
+    tables.emplace_back(std::string(name, size), (int)tables.size());
+    return tables.back().second;
+}
+
+static uint64_t ParseView(const std::string& log, std::vector<std::pair<std::string, int>>& tables) {
+    uint64_t sum = 0;
+    size_t offset = 0;
+    while (offset < log.size()) {
+        LogRecordView view(log.data() + offset);
+        switch (view.type()) {
+            case LogType::INSERT:
+                sum += GetTableId(tables, view.table_name(), view.table_name_size()) + view.rid().page_no_ +
+                       view.value()[0] + view.first_free_page_no();
+                break;
+            case LogType::UPDATE:
+                sum += GetTableId(tables, view.table_name(), view.table_name_size()) + view.rid().page_no_ + view.value()[0];
+                break;
+            case LogType::DELETE:
+                sum += GetTableId(tables, view.table_name(), view.table_name_size()) + view.page_no() +
+                       view.first_free_page_no();
+                break;
+            case LogType::NEWPAGE:
+                sum += GetTableId(tables, view.table_name(), view.table_name_size()) + view.page_no() + view.num_pages();
+                break;
+            default:
+                sum += view.batch_id();
+                break;
+        }
+        offset += view.tot_len();
+    }
+    return sum;
+}
+
+int main(int argc, char* argv[]) {
+    google::ParseCommandLineFlags(&argc, &argv, true);
+
+    std::vector<size_t> record_offs;
+    std::string log = GenerateLog(record_offs);
+    RDMA_LOG(INFO) << "log records: " << record_offs.size() << ", log bytes: " << log.size();
+
+    // 校验两种解析方式读到的字段一致
+    for (size_t off : record_offs) {
+        const char* src = log.data() + off;
+        LogRecordView view(src);
+        if (view.type() == LogType::DELETE) {
+            DeleteLogRecord record;
+            record.deserialize(src);
+            if (record.page_no_ != view.page_no() || record.bucket_offset_ != view.bucket_offset() ||
+                record.first_free_page_no_ != view.first_free_page_no()) {
+                RDMA_LOG(FATAL) << "DeleteLogRecord and LogRecordView mismatch at offset " << off;
+            }
+        } else if (view.type() == LogType::INSERT) {
+            InsertLogRecord record;
+            record.deserialize(src);
+            if (!(record.rid_ == view.rid()) || record.num_records_ != view.num_records() ||
+                record.first_free_page_no_ != view.first_free_page_no()) {
+                RDMA_LOG(FATAL) << "InsertLogRecord and LogRecordView mismatch at offset " << off;
+            }
+        }
+    }
+
+    std::unordered_map<std::string, int> table_ids;
+    std::vector<std::pair<std::string, int>> tables;
+    for (const char* mode : {"object", "view"}) {
+        uint64_t sum = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int round = 0; round < FLAGS_rounds; round++) {
+            sum += strcmp(mode, "object") == 0 ? ParseObject(log, table_ids) : ParseView(log, tables);
+        }
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "mode: " << mode << ", ns/record: " << ns / ((double)record_offs.size() * FLAGS_rounds)
+                  << ", checksum: " << sum << std::endl;
+    }
+    return 0;
+}
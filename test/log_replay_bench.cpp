@@ -0,0 +1,164 @@
+#include <fcntl.h>
+#include <gflags/gflags.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "log/logreplay.h"
+#include "storage/disk_manager.h"
+#include "util/debug.h"
+
+DEFINE_string(bench_dir, "log_replay_bench", "Directory holding the generated log file and tables");
+DEFINE_double(log_gb, 2, "Size of the generated log in GB");
+DEFINE_int32(table_num, 4, "Number of tables touched by the log");
+DEFINE_int32(table_pages, 16384, "Number of 4 KB pages in each table");
+DEFINE_int32(value_size, 64, "Size of each updated value in bytes");
+DEFINE_int32(records_per_batch, 20000, "Number of UPDATE records between two BATCHEND records");
+DEFINE_string(replay_threads, "1,2,4,8", "Comma separated applier thread counts to benchmark");
+DEFINE_bool(regenerate, false, "Regenerate the log even if it already exists");
+
+/**
+ * 日志重放的吞吐测试: 生成一个几GB的UPDATE日志, 分别用不同的applier线程数从头重放,
+ * 统计persist_batch_id推进到最后一个batch所需的时间
+ */
+
+static const char* BENCH_META_FILE = "log_replay_bench_meta";
+
+static std::string TableName(int table) { return "bench_table_" + std::to_string(table); }
+
+static void PrepareTables(DiskManager* disk_manager) {
+    std::vector<char> page(PAGE_SIZE, 0);
+    for (int table = 0; table < FLAGS_table_num; table++) {
+        std::string name = TableName(table);
+        if (disk_manager->is_file(name) && disk_manager->get_file_size(name) >= (off_t)FLAGS_table_pages * PAGE_SIZE) {
+            continue;
+        }
+        if (!disk_manager->is_file(name)) disk_manager->create_file(name);
+        int fd = disk_manager->get_file_fd(name);
+        for (page_id_t page_no = 0; page_no < FLAGS_table_pages; page_no++) {
+            disk_manager->write_page(fd, page_no, page.data(), PAGE_SIZE);
+        }
+        disk_manager->sync_file(fd);
+    }
+}
+
+// 生成日志文件, 返回最后一个batch的id
+static batch_id_t GenerateLog() {
+    int fd = open(LOG_FILE_NAME, O_CREAT | O_TRUNC | O_WRONLY, 0600);
+    if (fd < 0) RDMA_LOG(FATAL) << "create " << LOG_FILE_NAME << " fails";
+
+    batch_id_t init_batch_id = 0;
+    size_t init_persist_off = sizeof(batch_id_t) + sizeof(size_t) - 1;
+    std::string buf;
+    buf.append((char*)&init_batch_id, sizeof(batch_id_t));
+    buf.append((char*)&init_persist_off, sizeof(size_t));
+
+    std::mt19937_64 rand(2024);
+    std::uniform_int_distribution<int> table_dist(0, FLAGS_table_num - 1);
+    std::uniform_int_distribution<page_id_t> page_dist(1, FLAGS_table_pages - 1);
+    int slot_num = (PAGE_SIZE - OFFSET_PAGE_HDR - 64) / (FLAGS_value_size + sizeof(itemkey_t));
+    std::uniform_int_distribution<int> slot_dist(0, slot_num - 1);
+    std::vector<char> value(FLAGS_value_size);
+
+    size_t target = (size_t)(FLAGS_log_gb * 1024 * 1024 * 1024);
+    size_t written = 0;
+    batch_id_t batch_id = 1;
+    int batch_records = 0;
+    while (written + buf.size() < target || batch_records != 0) {
+        std::string record;
+        if (batch_records == FLAGS_records_per_batch || written + buf.size() >= target) {
+            BatchEndLogRecord batch_end(batch_id, 0, 0);
+            record.resize(batch_end.log_tot_len_);
+            batch_end.serialize(&record[0]);
+            batch_id++;
+            batch_records = 0;
+        } else {
+            int table = table_dist(rand);
+            memset(value.data(), (char)(batch_id + batch_records), FLAGS_value_size);
+            RmRecord new_value(batch_records, FLAGS_value_size, value.data());
+            Rid rid{page_dist(rand), OFFSET_PAGE_HDR + 64 + slot_dist(rand) * (int)(FLAGS_value_size + sizeof(itemkey_t))};
+            UpdateLogRecord update(batch_id, 0, batch_records, new_value, rid, TableName(table));
+            record.resize(update.log_tot_len_);
+            update.serialize(&record[0]);
+            batch_records++;
+        }
+        buf.append(record);
+        if (buf.size() >= (1 << 20)) {
+            if (write(fd, buf.data(), buf.size()) != (ssize_t)buf.size()) RDMA_LOG(FATAL) << "write log fails";
+            written += buf.size();
+            buf.clear();
+        }
+    }
+    if (write(fd, buf.data(), buf.size()) != (ssize_t)buf.size()) RDMA_LOG(FATAL) << "write log fails";
+    written += buf.size();
+    fsync(fd);
+    close(fd);
+
+    batch_id_t last_batch_id = batch_id - 1;
+    std::ofstream meta(BENCH_META_FILE);
+    meta << last_batch_id;
+    RDMA_LOG(INFO) << "generate log: " << written << " bytes, " << last_batch_id << " batches";
+    return last_batch_id;
+}
+
+// 把日志文件头恢复为初始状态, 让LogReplay从头开始重放
+static void ResetLogHead() {
+    int fd = open(LOG_FILE_NAME, O_WRONLY);
+    batch_id_t init_batch_id = 0;
+    size_t init_persist_off = sizeof(batch_id_t) + sizeof(size_t) - 1;
+    pwrite(fd, &init_batch_id, sizeof(batch_id_t), 0);
+    pwrite(fd, &init_persist_off, sizeof(size_t), sizeof(batch_id_t));
+    fsync(fd);
+    close(fd);
+}
+
+int main(int argc, char* argv[]) {
+    google::ParseCommandLineFlags(&argc, &argv, true);
+
+    // LogReplay固定读取当前目录下的LOG_FILE
+    mkdir(FLAGS_bench_dir.c_str(), 0755);
+    if (chdir(FLAGS_bench_dir.c_str()) != 0) {
+        RDMA_LOG(FATAL) << "chdir " << FLAGS_bench_dir << " fails";
+    }
+
+    DiskManager* disk_manager = new DiskManager();
+    PrepareTables(disk_manager);
+
+    batch_id_t last_batch_id = 0;
+    std::ifstream meta(BENCH_META_FILE);
+    if (FLAGS_regenerate || !disk_manager->is_file(LOG_FILE_NAME) || !(meta >> last_batch_id)) {
+        last_batch_id = GenerateLog();
+    }
+    off_t log_size = disk_manager->get_file_size(LOG_FILE_NAME);
+
+    std::stringstream thread_list(FLAGS_replay_threads);
+    std::string item;
+    while (std::getline(thread_list, item, ',')) {
+        int thread_num = std::stoi(item);
+        ResetLogHead();
+
+        auto start = std::chrono::steady_clock::now();
+        LogReplay* log_replay = new LogReplay(disk_manager, thread_num);
+        while (log_replay->get_persist_batch_id() < last_batch_id) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        delete log_replay;
+
+        std::cout << "replay threads: " << thread_num << ", log bytes: " << log_size << ", seconds: " << seconds
+                  << ", MB/sec: " << log_size / seconds / 1024 / 1024 << ", batches/sec: " << last_batch_id / seconds
+                  << std::endl;
+    }
+
+    delete disk_manager;
+    return 0;
+}
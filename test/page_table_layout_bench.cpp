@@ -0,0 +1,157 @@
+#include <gflags/gflags.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "compact_page_table.h"
+#include "memstore/page_table.h"
+#include "util/debug.h"
+
+DEFINE_string(layout, "node,compact", "Comma separated page table layouts to benchmark: node, compact");
+DEFINE_int32(table_mb, 256, "Memory of one page table node in MB, shared by both layouts");
+DEFINE_double(fill_ratio, 0.9, "Number of inserted pages relative to the slots of the compact layout");
+DEFINE_int64(lookup_num, 10000000, "Number of random lookups of resident pages");
+DEFINE_double(nic_gbps, 100, "NIC bandwidth used to estimate the bandwidth bound lookups/sec");
+
+/**
+ * 页表布局的对比测试, 在同样大小的内存中分别用PageTableNode布局和紧凑布局建立页表, 插入相同的页面后随机查找,
+ * 统计每次远程查找需要读取的字节数, 本地查找的CPU开销, 以及在给定网卡带宽下单个页表节点能支撑的查找次数
+ * node: 每次查找读取页面所在的整个PageTableNode桶链
+ * compact: 每次查找在一个doorbell中读取两个候选桶
+ */
+
+// PageTableNode布局, 与PageTableStore::LocalInsertPageTableItem相同, 桶满时从保留区分配扩展桶挂到桶链上
+class NodeLayoutTable {
+ public:
+  explicit NodeLayoutTable(size_t mem_size) {
+    bucket_num = mem_size * 0.75 / sizeof(PageTableNode);
+    node_capacity = mem_size / sizeof(PageTableNode);
+    nodes = (PageTableNode*)calloc(node_capacity, sizeof(PageTableNode));
+    for (uint64_t i = 0; i < node_capacity; i++) {
+      for (int j = 0; j < NEXT_NODE_COUNT; j++) nodes[i].next_expand_node_id[j] = -1;
+    }
+    node_num = bucket_num;
+  }
+
+  ~NodeLayoutTable() { free(nodes); }
+
+  bool Insert(PageId page_id, PageAddress page_address) {
+    PageTableNode* node = &nodes[MurmurHash64A(page_id.Get(), 0xdeadbeef) % bucket_num];
+    while (true) {
+      for (int i = 0; i < MAX_PAGETABLE_ITEM_NUM_PER_NODE; i++) {
+        if (node->page_table_items[i].valid == false) {
+          node->page_table_items[i] = PageTableItem(page_id, page_address);
+          return true;
+        }
+      }
+      if (node->next_expand_node_id[0] < 0) break;
+      node = &nodes[bucket_num + node->next_expand_node_id[0]];
+    }
+    if (node_num == node_capacity) return false;
+    PageTableNode* new_node = &nodes[node_num];
+    new_node->page_table_items[0] = PageTableItem(page_id, page_address);
+    node->next_expand_node_id[0] = node_num - bucket_num;
+    node_num++;
+    return true;
+  }
+
+  // 返回查找过程中需要远程读取的桶个数
+  int Lookup(PageId page_id, PageAddress& page_address) {
+    PageTableNode* node = &nodes[MurmurHash64A(page_id.Get(), 0xdeadbeef) % bucket_num];
+    int read_nodes = 1;
+    while (true) {
+      for (int i = 0; i < MAX_PAGETABLE_ITEM_NUM_PER_NODE; i++) {
+        if (node->page_table_items[i].valid == true && node->page_table_items[i].page_id == page_id) {
+          page_address = node->page_table_items[i].page_address;
+          return read_nodes;
+        }
+      }
+      if (node->next_expand_node_id[0] < 0) return read_nodes;
+      node = &nodes[bucket_num + node->next_expand_node_id[0]];
+      read_nodes++;
+    }
+  }
+
+  uint64_t GetSlotNum() const { return node_num * MAX_PAGETABLE_ITEM_NUM_PER_NODE; }
+
+ private:
+  PageTableNode* nodes;
+  uint64_t bucket_num;
+  uint64_t node_num;
+  uint64_t node_capacity;
+};
+
+// PageId::Get()只用page_no的低16位区分页面
+static PageId MakePageId(uint64_t i) { return PageId((int)(i >> 16), (page_id_t)(i & 0xffff)); }
+
+static void PrintResult(const std::string& layout, uint64_t page_num, uint64_t inserted, double load_factor,
+                        double bytes_per_lookup, double ns_per_lookup, uint64_t checksum) {
+  double nic_lookups = FLAGS_nic_gbps * 1e9 / 8 / bytes_per_lookup;
+  std::cout << "layout: " << layout << ", pages: " << page_num << ", inserted: " << inserted
+            << ", load factor: " << load_factor << ", bytes/lookup: " << bytes_per_lookup
+            << ", ns/lookup: " << ns_per_lookup << ", NIC bound lookups/sec: " << nic_lookups
+            << ", checksum: " << checksum << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+  google::ParseCommandLineFlags(&argc, &argv, true);
+
+  size_t mem_size = (size_t)FLAGS_table_mb * 1024 * 1024;
+  uint64_t compact_bucket_num = mem_size / sizeof(CompactPageTableBucket);
+  uint64_t page_num = compact_bucket_num * COMPACT_PAGE_TABLE_SLOT_NUM * FLAGS_fill_ratio;
+  RDMA_LOG(INFO) << "sizeof(PageTableNode): " << sizeof(PageTableNode)
+                 << ", sizeof(CompactPageTableBucket): " << sizeof(CompactPageTableBucket) << ", pages: " << page_num;
+
+  std::mt19937_64 rand(2024);
+  std::vector<uint64_t> lookups(FLAGS_lookup_num);
+  for (auto& lookup : lookups) lookup = rand() % page_num;
+
+  std::stringstream layout_list(FLAGS_layout);
+  std::string layout;
+  while (std::getline(layout_list, layout, ',')) {
+    uint64_t inserted = 0;
+    uint64_t checksum = 0;
+    uint64_t read_bytes = 0;
+    if (layout == "node") {
+      NodeLayoutTable table(mem_size);
+      for (uint64_t i = 0; i < page_num; i++) {
+        if (table.Insert(MakePageId(i), PageAddress{0, (frame_id_t)i})) inserted++;
+      }
+      auto start = std::chrono::steady_clock::now();
+      for (auto i : lookups) {
+        PageAddress page_address{-1, INVALID_FRAME_ID};
+        read_bytes += table.Lookup(MakePageId(i), page_address) * sizeof(PageTableNode);
+        checksum += page_address.frame_id;
+      }
+      double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+      PrintResult(layout, page_num, inserted, (double)inserted / table.GetSlotNum(), (double)read_bytes / lookups.size(),
+                  ns / lookups.size(), checksum);
+    } else if (layout == "compact") {
+      char* region = (char*)malloc(mem_size);
+      MemStoreAllocParam param(region, region, 0, region + mem_size);
+      CompactPageTableStore table(compact_bucket_num, &param);
+      for (uint64_t i = 0; i < page_num; i++) {
+        if (table.LocalInsertPageTableItem(MakePageId(i), PageAddress{0, (frame_id_t)i})) inserted++;
+      }
+      auto start = std::chrono::steady_clock::now();
+      for (auto i : lookups) {
+        checksum += table.LocalGetPageFrame(MakePageId(i)).frame_id;
+      }
+      double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+      // 两个候选桶在一个doorbell中读取
+      read_bytes = 2 * sizeof(CompactPageTableBucket);
+      PrintResult(layout, page_num, inserted, (double)inserted / (compact_bucket_num * COMPACT_PAGE_TABLE_SLOT_NUM),
+                  (double)read_bytes, ns / lookups.size(), checksum);
+      free(region);
+    } else {
+      RDMA_LOG(FATAL) << "unknown page table layout: " << layout;
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,129 @@
+#include <gflags/gflags.h>
+
+#include <iostream>
+#include <set>
+#include <vector>
+
+#include "cache/read_ahead.h"
+#include "util/debug.h"
+
+DEFINE_int32(table_page_num, 1000, "Number of pages of the simulated table");
+
+/**
+ * ReadAheadDetector的正确性测试, 访问与DTX::IssueReadAhead一样通过OnAccesses交给检测器,
+ * 装入结果模拟DTX::InstallReadAheadPages对OnInstalled的调用
+ * 预读的页面在下一次访问之前全部装入共享内存池(超出表末尾的除外), 之后对它们的访问不再缺页
+ * 1. 顺序扫描: 只有开始的READ_AHEAD_TRIGGER_MISS次缺页, 窗口增长到READ_AHEAD_MAX_WINDOW, 超出表末尾的预读计为浪费
+ * 2. 跳跃访问: 不触发预读
+ * 3. 扫描中断: 还没有被访问的预读页面计为浪费
+ * 4. 一次请求中的页面乱序给出: 按页号排序之后仍然识别为顺序扫描
+ */
+
+static void Check(bool cond, const char* what) {
+  if (!cond) RDMA_LOG(FATAL) << "check fails: " << what;
+}
+
+struct SimStream {
+  ReadAheadDetector* detector;
+  coro_id_t stream_id;
+  table_id_t table_id;
+  // 已经装入共享内存池的页面
+  std::set<page_id_t> in_memory;
+  uint64_t miss_num = 0;
+
+  // 一次请求访问的页面, 可以乱序
+  void AccessBatch(const std::vector<page_id_t>& page_nos) {
+    std::vector<std::pair<PageId, bool>> accesses;
+    for (auto page_no : page_nos) {
+      bool miss = in_memory.count(page_no) == 0;
+      if (miss) {
+        miss_num++;
+        in_memory.insert(page_no);
+      }
+      accesses.emplace_back(PageId(table_id, page_no), miss);
+    }
+    std::vector<PageId> read_ahead_page_ids;
+    detector->OnAccesses(stream_id, accesses, read_ahead_page_ids);
+    for (auto& page_id : read_ahead_page_ids) {
+      Check(page_id.table_id == table_id, "read-ahead stays in the accessed table");
+      bool installed = page_id.page_no < FLAGS_table_page_num && in_memory.count(page_id.page_no) == 0;
+      if (installed) in_memory.insert(page_id.page_no);
+      detector->OnInstalled(stream_id, table_id, page_id.page_no, installed);
+    }
+  }
+
+  void Access(page_id_t page_no) { AccessBatch({page_no}); }
+};
+
+int main(int argc, char* argv[]) {
+  google::ParseCommandLineFlags(&argc, &argv, true);
+
+  // 1. 顺序扫描
+  {
+    ReadAheadDetector detector;
+    SimStream scan{&detector, 0, 1};
+    for (page_id_t page_no = 0; page_no < FLAGS_table_page_num; page_no++) scan.Access(page_no);
+    auto& stat = detector.GetStat();
+    Check(scan.miss_num == READ_AHEAD_TRIGGER_MISS, "sequential scan misses only before the first read-ahead");
+    Check(stat.used_page_num == (uint64_t)FLAGS_table_page_num - READ_AHEAD_TRIGGER_MISS, "every read-ahead page in the table is used");
+    Check(stat.installed_page_num == stat.used_page_num, "installed pages are all used");
+    Check(stat.issued_page_num == stat.installed_page_num + stat.wasted_page_num, "issued pages are installed or wasted");
+    // 访问到窗口的第一个页面就发起下一个窗口, 最多有两个窗口超出表的末尾
+    Check(stat.wasted_page_num > 0 && stat.wasted_page_num <= 2 * READ_AHEAD_MAX_WINDOW, "only pages past the end are wasted");
+    // 窗口翻倍增长, 发起的次数远小于页面数
+    Check(stat.trigger_num < (uint64_t)FLAGS_table_page_num / READ_AHEAD_MAX_WINDOW + 8, "window grows to the max");
+    std::cout << "sequential: misses " << scan.miss_num << ", triggers " << stat.trigger_num << ", issued "
+              << stat.issued_page_num << ", used " << stat.used_page_num << ", wasted " << stat.wasted_page_num
+              << std::endl;
+  }
+
+  // 2. 跳跃访问
+  {
+    ReadAheadDetector detector;
+    SimStream random{&detector, 1, 1};
+    for (int i = 0; i < FLAGS_table_page_num; i++) random.Access((page_id_t)((i * 7) % FLAGS_table_page_num));
+    auto& stat = detector.GetStat();
+    Check(stat.trigger_num == 0, "strided access does not trigger read-ahead");
+    Check(random.miss_num == (uint64_t)FLAGS_table_page_num, "every strided access misses");
+    std::cout << "strided: misses " << random.miss_num << ", triggers " << stat.trigger_num << std::endl;
+  }
+
+  // 3. 扫描中断, 另一个表上的stream互不影响
+  {
+    ReadAheadDetector detector;
+    SimStream scan{&detector, 2, 1};
+    SimStream other{&detector, 2, 2};
+    for (page_id_t page_no = 0; page_no < 20; page_no++) {
+      scan.Access(page_no);
+      other.Access(page_no);
+    }
+    auto before = detector.GetStat();
+    // 跳到很远的位置缺页, 之前预读而没有被访问的页面都浪费了
+    scan.Access(FLAGS_table_page_num / 2);
+    auto& stat = detector.GetStat();
+    Check(stat.wasted_page_num > before.wasted_page_num, "interrupted scan reports wasted read-ahead");
+    uint64_t other_miss_num = other.miss_num;
+    other.Access(20);
+    Check(other.miss_num == other_miss_num, "the stream on the other table keeps its read-ahead");
+    std::cout << "interrupted: issued " << stat.issued_page_num << ", used " << stat.used_page_num << ", wasted "
+              << stat.wasted_page_num << std::endl;
+  }
+
+  // 4. 每次请求访问连续的4个页面, 但是逆序给出
+  {
+    ReadAheadDetector detector;
+    SimStream scan{&detector, 3, 1};
+    for (page_id_t page_no = 0; page_no + 4 <= FLAGS_table_page_num; page_no += 4) {
+      scan.AccessBatch({page_no + 3, page_no + 2, page_no + 1, page_no});
+    }
+    auto& stat = detector.GetStat();
+    Check(scan.miss_num == 4, "only the first request misses");
+    Check(stat.used_page_num == (uint64_t)FLAGS_table_page_num / 4 * 4 - READ_AHEAD_TRIGGER_MISS,
+          "unordered requests use the read-ahead");
+    std::cout << "unordered batch: misses " << scan.miss_num << ", triggers " << stat.trigger_num << ", used "
+              << stat.used_page_num << std::endl;
+  }
+
+  std::cout << "PASS" << std::endl;
+  return 0;
+}
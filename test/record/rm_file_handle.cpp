@@ -85,7 +85,7 @@ Rid RmFileHandle::insert_record(itemkey_t key, char* buf, BatchTxn* txn) {
 
     if(txn != nullptr){
         RmRecord record(key, file_hdr_.record_size_, buf);
-        InsertLogRecord* log = new InsertLogRecord(txn->batch_id_, 1, txn->batch_id_, record, rid, "table");
+        InsertLogRecord* log = new InsertLogRecord(txn->batch_id_, 1, txn->batch_id_, std::move(record), rid, "table");
         int bucket_no = Bitmap::get_bucket(slot_no);
         log->set_meta(OFFSET_BITMAP + bucket_no, page_handle.bitmap[bucket_no], 
                         page_handle.page_hdr->num_records_, file_hdr_.first_free_page_no_);
@@ -173,7 +173,7 @@ void RmFileHandle::update_record(const Rid& rid, char* buf, BatchTxn* txn) {
     // context->txn_->append_write_record(write_record);
 
 
-    UpdateLogRecord* log = new UpdateLogRecord(txn->batch_id_, 1, txn->batch_id_, new_record, rid, "table");
+    UpdateLogRecord* log = new UpdateLogRecord(txn->batch_id_, 1, txn->batch_id_, std::move(new_record), rid, "table");
     txn->logs.push_back(log);
 }
 
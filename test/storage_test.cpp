@@ -4,6 +4,7 @@
 #include "record/rm_manager.h"
 #include "record/rm_file_handle.h"
 #include "util/debug.h"
+#include "log/log_builder.h"
 #include "log/log_record.h"
 #include "storage/storage_service.pb.h"
 
@@ -94,6 +95,7 @@ void* generate_redo_logs(void* arg) {
     storage_service::LogWriteRequest request;
     storage_service::LogWriteResponse response;
     brpc::Controller cntl;
+    LogBuilder log_builder;
 
     BatchTxn* txn1 = new BatchTxn(1);
 
@@ -120,7 +122,8 @@ void* generate_redo_logs(void* arg) {
     txn1->logs.push_back(batch1_end_log);
     // end log
 
-    request.set_log(txn1->get_log_string());
+    txn1->build_log(&log_builder);
+    log_builder.move_to(&cntl.request_attachment());
     stub.LogWrite(&cntl, &request, &response, NULL);
 
     if(!cntl.Failed()) {
@@ -157,7 +160,8 @@ void* generate_redo_logs(void* arg) {
     BatchEndLogRecord* batch2_end_log = new BatchEndLogRecord(2, 1, 2);
     txn2->logs.push_back(batch2_end_log);
     
-    request.set_log(txn2->get_log_string());
+    txn2->build_log(&log_builder);
+    log_builder.move_to(&cntl.request_attachment());
     stub.LogWrite(&cntl, &request, &response, NULL);
 
     if(!cntl.Failed()) {
@@ -184,7 +188,8 @@ void* generate_redo_logs(void* arg) {
     BatchEndLogRecord* batch3_end_log = new BatchEndLogRecord(3, 1, 3);
     txn3->logs.push_back(batch3_end_log);
 
-    request.set_log(txn3->get_log_string());
+    txn3->build_log(&log_builder);
+    log_builder.move_to(&cntl.request_attachment());
     stub.LogWrite(&cntl, &request, &response, NULL);
 
     if(!cntl.Failed()) {